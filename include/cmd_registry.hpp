@@ -0,0 +1,124 @@
+#ifndef CMD_REGISTRY_HPP
+#define CMD_REGISTRY_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <string.h>
+
+#include "tonkey.hpp"
+
+// 커맨드 테이블 기반 디스패치
+// - 모듈마다 { 해시, 이름, 사용법, 핸들러 } 테이블을 const 배열로 선언 (해시는 컴파일 타임 계산)
+// - 토큰 해시를 한 번 계산해 정수 비교로 찾고, 충돌 대비로 이름을 한 번 더 확인
+// - 테이블은 많아야 스무 개 남짓이라 선언 순서대로 선형 탐색 (순서가 곧 help / 사용법 순서)
+//   해시 정렬 + 이진 탐색은 비교 몇 번을 줄일 뿐이고, 펌웨어 툴체인(gnu++11)에서는
+//   constexpr 정렬을 쓸 수 없어 테이블을 손으로 정렬해 두어야 한다
+// - help / 오류 메시지의 명령 목록은 테이블에서 생성
+
+// FNV-1a 32bit
+constexpr uint32_t cmdHash(const char *_str, uint32_t _hash = 2166136261u)
+{
+    return *_str ? cmdHash(_str + 1, (_hash ^ (uint8_t)*_str) * 16777619u) : _hash;
+}
+
+template <typename Handler>
+struct CmdEntry
+{
+    uint32_t hash;
+    const char *name;
+    const char *usage;
+    Handler handler;
+};
+
+#define CMD_ENTRY(_name, _usage, _handler) { cmdHash(_name), _name, _usage, _handler }
+#define CMD_COUNT(_table) (sizeof(_table) / sizeof((_table)[0]))
+
+template <typename Entry>
+const Entry *findCmd(const Entry *_table, size_t _count, const TokenView &_name)
+{
+    uint32_t hash = cmdHash(_name.c_str());
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (_table[i].hash == hash && strcmp(_table[i].name, _name.c_str()) == 0)
+        {
+            return &_table[i];
+        }
+    }
+    return nullptr;
+}
+
+// "a/b/c" (오류 메시지용)
+template <typename Entry>
+String cmdNames(const Entry *_table, size_t _count)
+{
+    String names;
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (i > 0)
+        {
+            names += '/';
+        }
+        names += _table[i].name;
+    }
+    return names;
+}
+
+// "usage1, usage2" (help 용)
+template <typename Entry>
+String cmdUsage(const Entry *_table, size_t _count)
+{
+    String usage;
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (i > 0)
+        {
+            usage += ", ";
+        }
+        usage += _table[i].usage;
+    }
+    return usage;
+}
+
+// tokens[1] 에 해당하는 엔트리 (없으면 오류 응답을 채우고 nullptr)
+template <typename Entry>
+const Entry *findSubCmd(const Entry *_table, size_t _count, const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() < 2)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need sub command (" + cmdNames(_table, _count) + ")";
+        return nullptr;
+    }
+
+    const Entry *entry = findCmd(_table, _count, tokens[1]);
+    if (!entry)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "unknown sub command (" + cmdNames(_table, _count) + ")";
+    }
+    return entry;
+}
+
+// 모듈 서브 커맨드 디스패치 (멤버 함수 핸들러)
+template <typename Owner, typename Entry>
+void dispatchSubCmd(Owner *_owner, const Entry *_table, size_t _count, const tonkey &tokens, JsonDocument &_res_doc)
+{
+    const Entry *entry = findSubCmd(_table, _count, tokens, _res_doc);
+    if (entry)
+    {
+        (_owner->*(entry->handler))(tokens, _res_doc);
+    }
+}
+
+// 자유 함수 핸들러 테이블용
+template <typename Entry>
+void dispatchSubCmd(const Entry *_table, size_t _count, const tonkey &tokens, JsonDocument &_res_doc)
+{
+    const Entry *entry = findSubCmd(_table, _count, tokens, _res_doc);
+    if (entry)
+    {
+        entry->handler(tokens, _res_doc);
+    }
+}
+
+#endif // CMD_REGISTRY_HPP
@@ -1,34 +1,111 @@
 #ifndef TONKEY_HPP
 #define TONKEY_HPP
 
+#include <Arduino.h>
+#include <string.h>
+#include <stdlib.h>
+
 #define MAXTOKENS 64
+#define MAXLINE 256
+
+// 라인 버퍼 안을 가리키는 토큰 (복사 없음, 항상 '\0' 으로 끝남)
+class TokenView {
+private:
+    const char *mPtr = "";
+    size_t mLen = 0;
+
+public:
+    TokenView() {}
+    TokenView(const char *_ptr, size_t _len) : mPtr(_ptr), mLen(_len) {}
 
+    inline const char *c_str() const { return mPtr; }
+    inline size_t length() const { return mLen; }
+    inline bool operator==(const char *_str) const { return strcmp(mPtr, _str) == 0; }
+    inline bool operator!=(const char *_str) const { return strcmp(mPtr, _str) != 0; }
+    inline long toInt() const { return atol(mPtr); }
+    inline float toFloat() const { return atof(mPtr); }
+
+    // 값을 보관해야 할 때만 String 으로 복사
+    inline operator String() const { return String(mPtr); }
+};
+
+// 공백으로 구분된 명령 라인 토크나이저
+// - 라인을 내부 버퍼에 한 번 복사하고 토큰은 그 버퍼를 가리킨다 (힙 할당 없음)
+// - "..." 로 공백이 들어간 인자 지원 (\" \\ 이스케이프)
+// - 토큰/라인 길이 초과, 닫히지 않은 따옴표는 parse() 가 false 를 반환
 class tonkey {
 private:
-    String mTokens[MAXTOKENS];
+    char mLine[MAXLINE];
+    TokenView mTokens[MAXTOKENS];
     int mTokenCount = 0;
+    const char *mError = nullptr;
 
 public:
-    tonkey() {}
+    tonkey() { mLine[0] = '\0'; }
     ~tonkey() {}
 
-    inline void parse(String _strLine) {
-        int StringCount = 0;
-        while (_strLine.length() > 0) {
-            int index = _strLine.indexOf(' ');
-            if (index == -1) {
-                mTokens[StringCount++] = _strLine;
-                break;
-            } else {
-                mTokens[StringCount++] = _strLine.substring(0, index);
-                _strLine = _strLine.substring(index + 1);
+    inline bool parse(const char *_line, size_t _len) {
+        mTokenCount = 0;
+        mError = nullptr;
+
+        if (_len >= MAXLINE) {
+            mError = "line too long";
+            return false;
+        }
+        memcpy(mLine, _line, _len);
+        mLine[_len] = '\0';
+
+        char *p = mLine;
+        while (*p) {
+            while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+            if (!*p) break;
+
+            if (mTokenCount >= MAXTOKENS) {
+                mError = "too many tokens";
+                mTokenCount = 0;
+                return false;
             }
+
+            // 따옴표를 벗겨내며 제자리에서 압축
+            char *start = p;
+            char *out = p;
+            bool quoted = false;
+            while (*p && (quoted || (*p != ' ' && *p != '\t' && *p != '\r'))) {
+                if (*p == '"') {
+                    quoted = !quoted;
+                    p++;
+                    continue;
+                }
+                if (quoted && *p == '\\' && (p[1] == '"' || p[1] == '\\')) {
+                    p++;
+                }
+                *out++ = *p++;
+            }
+
+            if (quoted) {
+                mError = "unterminated quote";
+                mTokenCount = 0;
+                return false;
+            }
+
+            bool atEnd = (*p == '\0');
+            *out = '\0';
+            mTokens[mTokenCount++] = TokenView(start, out - start);
+            if (atEnd) break;
+            p++;
         }
-        mTokenCount = StringCount;
+        return true;
     }
 
+    inline bool parse(const String &_strLine) { return parse(_strLine.c_str(), _strLine.length()); }
+
     inline int getTokenCount() const { return mTokenCount; }
     inline String getToken(int _index) const { return mTokens[_index]; }
+    inline const char *getError() const { return mError; }
+
+    // 토큰 목록 인터페이스 (모듈 parseCmd 에서 사용)
+    inline int size() const { return mTokenCount; }
+    inline const TokenView &operator[](int _index) const { return mTokens[_index]; }
 };
 
 #endif // TONKEY_HPP
@@ -0,0 +1,34 @@
+// 호스트 빌드용 전역 객체
+// main.cpp 의 전역 객체를 그대로 둔다 (스케줄러/태스크와 setup()/loop() 는 펌웨어 전용).
+// parseCmd.cpp 의 콘솔 명령과 시험/벤치는 펌웨어와 같은 모듈 인스턴스를 쓴다.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "config.hpp"
+#include "camera_module.hpp"
+#include "wifi_module.hpp"
+#include "http_upload.hpp"
+#include "upload_pipeline.hpp"
+#include "stream_server.hpp"
+#include "luma_thumb.hpp"
+#include "motion_detector.hpp"
+#include "dup_filter.hpp"
+#include "resolution_ladder.hpp"
+#include "frame_spool.hpp"
+#include "duty_cycle.hpp"
+#include "serial_cmd.hpp"
+
+Config g_config;
+CameraModule g_camera;
+WifiModule g_wifi;
+HttpUploader g_uploader;
+LumaThumbnail g_thumb;
+MotionDetector g_motion(g_thumb);
+DuplicateFilter g_dedup(g_thumb);
+ResolutionLadder g_ladder(g_camera, g_wifi);
+FrameSpool g_spool(LittleFS);
+UploadPipeline g_pipeline(g_camera, g_uploader, g_thumb, g_motion, g_dedup, g_ladder, g_spool);
+StreamServer g_stream(g_camera);
+DutyCycle g_duty(g_camera, g_wifi, g_uploader, g_spool);
+SerialCmdReader g_cmdReader;
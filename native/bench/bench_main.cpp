@@ -0,0 +1,250 @@
+// 호스트 처리량 벤치마크
+// 카메라 재생 → HttpUploader → 루프백(또는 지정한) 서버로 프레임을 올리고
+// frames/s, bytes/s, 프레임당 할당 수와 단계별 지연을 출력한다.
+//
+// 사용법: pio run -e native && .pio/build/native/program [옵션]
+//   --frames DIR     JPEG 디렉터리 재생 (없으면 합성 프레임)
+//   --fps N          캡처 속도 제한 (0 = 제한 없음, 기본 0)
+//   --count N        업로드할 프레임 수 (기본 200)
+//   --url URL        업로드 서버 (없으면 내장 루프백 서버)
+//   --chunked        chunked 전송
+//   --res NAME       해상도 (qvga, vga, svga ...)
+//   --quality Q      JPEG 품질
+//   --target BYTES   프레임 크기 목표 (품질 자동 조정)
+//   --profile NAME   센서 프로필 (day, night, flash)
+//
+// 가짜 센서의 set_*() 호출 수로 초기화와 프로필 전환의 센서 쓰기 횟수도 출력한다.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "camera_module.hpp"
+#include "http_upload.hpp"
+#include "config.hpp"
+#include "latency_stats.hpp"
+#include "native_host.hpp"
+
+// 전역 객체는 native/app/host_app.cpp
+extern Config g_config;
+extern CameraModule g_camera;
+extern HttpUploader g_uploader;
+
+struct BenchOptions
+{
+    const char *framesDir = nullptr;
+    float fps = 0;
+    int count = 200;
+    String url;
+    bool chunked = false;
+    String resolution = "vga";
+    int quality = 0;
+    uint32_t targetBytes = 0;
+    String profile = "day";
+};
+
+static void printUsage()
+{
+    Serial.println("usage: program [--frames DIR] [--fps N] [--count N] [--url URL] [--chunked]");
+    Serial.println("               [--res NAME] [--quality Q] [--target BYTES] [--profile NAME]");
+}
+
+static bool parseArgs(int argc, char **argv, BenchOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        String arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--chunked")
+        {
+            opt.chunked = true;
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            opt.framesDir = argv[++i];
+        }
+        else if (arg == "--fps" && hasValue)
+        {
+            opt.fps = atof(argv[++i]);
+        }
+        else if (arg == "--count" && hasValue)
+        {
+            opt.count = atoi(argv[++i]);
+        }
+        else if (arg == "--url" && hasValue)
+        {
+            opt.url = argv[++i];
+        }
+        else if (arg == "--res" && hasValue)
+        {
+            opt.resolution = argv[++i];
+        }
+        else if (arg == "--quality" && hasValue)
+        {
+            opt.quality = atoi(argv[++i]);
+        }
+        else if (arg == "--target" && hasValue)
+        {
+            opt.targetBytes = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--profile" && hasValue)
+        {
+            opt.profile = argv[++i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return opt.count > 0;
+}
+
+// 펌웨어와 같은 설정 키로 저장한 뒤 모듈에 반영 (loadSettingsToModules 와 같은 경로)
+static void applySettings(const BenchOptions &opt)
+{
+    g_config.set("server_url", opt.url);
+    g_config.set("server_chunked", opt.chunked ? 1 : 0);
+    g_config.set("resolution", opt.resolution);
+    g_config.set("sensor_profile", opt.profile);
+    if (opt.quality > 0)
+    {
+        g_config.set("jpeg_quality", opt.quality);
+    }
+    if (opt.targetBytes > 0)
+    {
+        g_config.set("target_bytes", opt.targetBytes);
+    }
+    g_config.flush();
+
+    g_uploader.setServerUrl(g_config.get<String>("server_url"));
+    g_uploader.setChunked(g_config.get<int>("server_chunked") == 1);
+    g_uploader.setDeviceId("native-bench");
+    if (g_config.hasKey("jpeg_quality"))
+    {
+        g_camera.setJpegQuality(g_config.get<int>("jpeg_quality"));
+    }
+    if (g_config.hasKey("target_bytes"))
+    {
+        g_camera.setTargetBytes(g_config.get<uint32_t>("target_bytes"));
+    }
+    g_camera.setProfile(g_config.get<String>("sensor_profile"));
+}
+
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char **argv)
+{
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (!nativeCameraReplay(opt.framesDir, opt.fps))
+    {
+        Serial.printf("No JPEG frames in %s\n", opt.framesDir);
+        return 1;
+    }
+
+    bool loopback = opt.url.isEmpty();
+    if (loopback)
+    {
+        uint16_t port = nativeLoopbackServerStart();
+        if (port == 0)
+        {
+            Serial.println("Loopback server start failed");
+            return 1;
+        }
+        opt.url = "http://127.0.0.1:" + String((unsigned int)port);
+    }
+
+    applySettings(opt);
+    uint32_t sensorWritesStart = nativeSensorWrites();
+    if (!g_camera.init() || !g_camera.setResolutionByName(g_config.get<String>("resolution")))
+    {
+        Serial.println("Camera init failed");
+        return 1;
+    }
+    uint32_t initSensorWrites = nativeSensorWrites() - sensorWritesStart;
+
+    // 첫 요청의 연결/버퍼 할당이 측정에 섞이지 않도록 한 장 먼저 보냄
+    camera_fb_t *fb = g_camera.grab();
+    if (fb)
+    {
+        g_uploader.uploadImage(fb->buf, fb->len);
+        g_camera.returnFrame(fb);
+    }
+    LatencyStats::reset();
+
+    int uploaded = 0;
+    int failures = 0;
+    uint64_t bytes = 0;
+    uint64_t allocStart = nativeAllocCount();
+    uint64_t allocBytesStart = nativeAllocBytes();
+    unsigned long startUs = micros();
+
+    for (int i = 0; i < opt.count; i++)
+    {
+        fb = g_camera.grab();
+        if (!fb)
+        {
+            failures++;
+            continue;
+        }
+        int httpCode = g_uploader.uploadImage(fb->buf, fb->len);
+        if (httpCode >= 200 && httpCode < 300)
+        {
+            uploaded++;
+            bytes += fb->len;
+        }
+        else
+        {
+            failures++;
+        }
+        g_camera.returnFrame(fb);
+    }
+
+    unsigned long elapsedUs = micros() - startUs;
+    uint64_t allocs = nativeAllocCount() - allocStart;
+    uint64_t allocBytes = nativeAllocBytes() - allocBytesStart;
+    double seconds = elapsedUs / 1e6;
+
+    JsonDocument doc;
+    doc["url"] = g_uploader.getFullUrl();
+    doc["source"] = opt.framesDir ? opt.framesDir : "synthetic";
+    doc["frames_loaded"] = nativeCameraFrameCount();
+    doc["resolution"] = CameraModule::frameSizeName(g_camera.getFrameSize());
+    doc["jpeg_quality"] = g_camera.getJpegQuality();
+    doc["chunked"] = g_uploader.isChunked();
+    doc["frames"] = uploaded;
+    doc["failures"] = failures;
+    doc["elapsed_s"] = seconds;
+    doc["frames_per_s"] = seconds > 0 ? uploaded / seconds : 0;
+    doc["bytes_per_s"] = seconds > 0 ? bytes / seconds : 0;
+    doc["avg_frame_bytes"] = uploaded ? bytes / uploaded : 0;
+    doc["allocs_per_frame"] = opt.count ? (double)allocs / opt.count : 0;
+    doc["alloc_bytes_per_frame"] = opt.count ? (double)allocBytes / opt.count : 0;
+    doc["connections"] = g_uploader.getConnectionsOpened();
+    doc["profile"] = g_camera.getProfileName();
+    doc["init_sensor_writes"] = initSensorWrites;
+
+    // 프로필을 한 바퀴 전환하며 바뀐 항목만 쓰는지 확인
+    JsonObject switchWrites = doc["profile_switch_writes"].to<JsonObject>();
+    String startProfile = g_camera.getProfileName();
+    for (int i = 0; i <= SensorProfile::COUNT; i++)
+    {
+        const char *name = i < SensorProfile::COUNT ? SensorProfile::at(i).name : startProfile.c_str();
+        uint32_t before = nativeSensorWrites();
+        g_camera.setProfile(name);
+        switchWrites[String(i) + ":" + name] = nativeSensorWrites() - before;
+    }
+    if (loopback)
+    {
+        doc["server_requests"] = nativeLoopbackRequests();
+        doc["server_body_bytes"] = nativeLoopbackBodyBytes();
+    }
+    LatencyStats::toJson(doc["latency"].to<JsonObject>());
+
+    serializeJsonPretty(doc, Serial);
+    Serial.println();
+    return failures ? 1 : 0;
+}
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,187 @@
+// 움직임 감지 벤치마크 (호스트)
+// JPEG 디렉터리를 카메라 재생으로 돌려 LumaThumbnail(1/8 DC 디코드) → MotionDetector 를 통과시키고
+// 프레임별 판정, 썸네일 디코드 시간, 스칼라/SWAR SAD 커널 시간(같은 합인지)을 출력한다.
+//
+// 사용법: pio run -e native_bench_motion && .pio/build/native_bench_motion/program --frames DIR [옵션]
+//   --frames DIR     JPEG 디렉터리 (baseline JPEG, 이름 순서로 재생)
+//   --grid N         motion_grid (기본 8)
+//   --thresh N       motion_thresh (기본 15)
+//   --blocks N       motion_blocks (기본 2)
+//   --iterations N   프레임마다 SAD 커널 반복 횟수 (기본 100)
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "camera_module.hpp"
+#include "luma_thumb.hpp"
+#include "motion_detector.hpp"
+#include "native_host.hpp"
+
+struct BenchOptions
+{
+    const char *framesDir = nullptr;
+    int grid = 8;
+    int threshold = 15;
+    int minBlocks = 2;
+    int iterations = 100;
+};
+
+static void printUsage()
+{
+    Serial.println("usage: program --frames DIR [--grid N] [--thresh N] [--blocks N] [--iterations N]");
+}
+
+static bool parseArgs(int argc, char **argv, BenchOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        String arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue)
+        {
+            opt.framesDir = argv[++i];
+        }
+        else if (arg == "--grid" && hasValue)
+        {
+            opt.grid = atoi(argv[++i]);
+        }
+        else if (arg == "--thresh" && hasValue)
+        {
+            opt.threshold = atoi(argv[++i]);
+        }
+        else if (arg == "--blocks" && hasValue)
+        {
+            opt.minBlocks = atoi(argv[++i]);
+        }
+        else if (arg == "--iterations" && hasValue)
+        {
+            opt.iterations = atoi(argv[++i]);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return opt.framesDir && opt.iterations > 0;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (!nativeCameraReplay(opt.framesDir, 0))
+    {
+        Serial.printf("No JPEG frames in %s\n", opt.framesDir);
+        return 1;
+    }
+
+    CameraModule camera;
+    LumaThumbnail thumb;
+    MotionDetector motion(thumb);
+    if (!camera.init())
+    {
+        Serial.println("Camera init failed");
+        return 1;
+    }
+    motion.setEnabled(true);
+    motion.setGrid(opt.grid);
+    motion.setThreshold(opt.threshold);
+    motion.setMinBlocks(opt.minBlocks);
+
+    JsonDocument doc;
+    JsonArray frames = doc["frames"].to<JsonArray>();
+    std::vector<uint8_t> previous;
+    int count = nativeCameraFrameCount();
+    int decodeFailures = 0;
+    int motions = 0;
+    int mismatches = 0;
+    uint64_t decodeUs = 0;
+    uint64_t scalarUs = 0;
+    uint64_t swarUs = 0;
+    int timed = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        camera_fb_t *fb = camera.grab();
+        if (!fb)
+        {
+            decodeFailures++;
+            continue;
+        }
+        bool decoded = thumb.decode(fb);
+        camera.returnFrame(fb);
+
+        JsonObject frame = frames.add<JsonObject>();
+        frame["index"] = i;
+        if (!decoded)
+        {
+            // 판정 없이 업로드되는 프레임 (펌웨어와 같음)
+            decodeFailures++;
+            frame["decoded"] = false;
+            frame["motion"] = motion.check();
+            continue;
+        }
+        decodeUs += thumb.getDecodeUs();
+
+        // 이전 썸네일과 전체 프레임 SAD 를 두 커널로 (같은 크기일 때만)
+        size_t pixels = (size_t)thumb.width() * thumb.height();
+        if (previous.size() == pixels)
+        {
+            uint32_t scalarSum = 0;
+            uint32_t swarSum = 0;
+            unsigned long startUs = micros();
+            for (int n = 0; n < opt.iterations; n++)
+            {
+                scalarSum = MotionDetector::sadScalar(thumb.gray(), previous.data(), thumb.width(), thumb.width(), thumb.height());
+            }
+            scalarUs += micros() - startUs;
+            startUs = micros();
+            for (int n = 0; n < opt.iterations; n++)
+            {
+                swarSum = MotionDetector::sadSwar(thumb.gray(), previous.data(), thumb.width(), thumb.width(), thumb.height());
+            }
+            swarUs += micros() - startUs;
+            timed++;
+            if (scalarSum != swarSum)
+            {
+                mismatches++;
+            }
+            frame["sad_per_pixel"] = (double)scalarSum / pixels;
+        }
+        previous.assign(thumb.gray(), thumb.gray() + pixels);
+
+        bool moved = motion.check();
+        frame["motion"] = moved;
+        if (moved)
+        {
+            motions++;
+        }
+    }
+
+    doc["source"] = opt.framesDir;
+    doc["frames_loaded"] = count;
+    doc["decode_failures"] = decodeFailures;
+    doc["motions"] = motions;
+    doc["thumb_width"] = thumb.width();
+    doc["thumb_height"] = thumb.height();
+    doc["decode_us_avg"] = count > decodeFailures ? (double)decodeUs / (count - decodeFailures) : 0;
+    doc["scalar_us_avg"] = timed ? (double)scalarUs / timed / opt.iterations : 0;
+    doc["swar_us_avg"] = timed ? (double)swarUs / timed / opt.iterations : 0;
+    doc["kernel_mismatches"] = mismatches;
+
+    // 감지기 자체 통계 (motion status 와 같은 내용)
+    tonkey tokens;
+    tokens.parse("motion status", 13);
+    JsonDocument status;
+    motion.parseCmd(tokens, status);
+    doc["detector"] = status;
+
+    serializeJsonPretty(doc, Serial);
+    Serial.println();
+    return mismatches ? 1 : 0;
+}
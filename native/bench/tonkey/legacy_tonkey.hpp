@@ -0,0 +1,40 @@
+#ifndef LEGACY_TONKEY_HPP
+#define LEGACY_TONKEY_HPP
+
+#include <Arduino.h>
+
+// 비교용: String 기반 이전 토크나이저 (include/tonkey.hpp 교체 전 구현 그대로)
+// 토큰마다 substring() 으로 String 을 만들고 남은 라인도 매번 다시 복사한다.
+// 벤치마크에서만 사용 — 펌웨어 빌드에는 들어가지 않는다.
+
+#define LEGACY_MAXTOKENS 64
+
+class legacy_tonkey {
+private:
+    String mTokens[LEGACY_MAXTOKENS];
+    int mTokenCount = 0;
+
+public:
+    legacy_tonkey() {}
+    ~legacy_tonkey() {}
+
+    inline void parse(String _strLine) {
+        int StringCount = 0;
+        while (_strLine.length() > 0) {
+            int index = _strLine.indexOf(' ');
+            if (index == -1) {
+                mTokens[StringCount++] = _strLine;
+                break;
+            } else {
+                mTokens[StringCount++] = _strLine.substring(0, index);
+                _strLine = _strLine.substring(index + 1);
+            }
+        }
+        mTokenCount = StringCount;
+    }
+
+    inline int getTokenCount() const { return mTokenCount; }
+    inline String getToken(int _index) const { return mTokens[_index]; }
+};
+
+#endif // LEGACY_TONKEY_HPP
@@ -0,0 +1,136 @@
+// 명령 토크나이저 벤치마크 (호스트)
+// 콘솔 명령 라인 묶음을 이전 String 기반 토크나이저(legacy_tonkey.hpp)와
+// 현재 제자리 토크나이저(include/tonkey.hpp)로 반복 파싱하고
+// 라인당 할당 수, 할당 바이트, ns 를 출력한다.
+// 파싱 후에는 모듈 parseCmd 처럼 모든 토큰을 한 번씩 읽는다 (이전 구현은 getToken() 이 복사).
+//
+// 사용법: pio run -e native_bench_tonkey && .pio/build/native_bench_tonkey/program [옵션]
+//   --iterations N   라인 묶음 반복 횟수 (기본 20000)
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "tonkey.hpp"
+#include "legacy_tonkey.hpp"
+#include "native_host.hpp"
+
+// 콘솔/MessagePack 으로 들어오는 명령과 같은 모양
+static const char *const LINES[] = {
+    "camera capture",
+    "camera status",
+    "config get upload_interval",
+    "config set upload_interval 30",
+    "config set wifi_ssid \"home network\"",
+    "config set server_url http://192.168.0.10:8080/api/v1/camera/upload",
+    "wifi connect home_network_5g verylongpassword1234",
+    "pipeline start",
+    "server upload",
+    "stats cmd",
+    "motion threshold 12 blocks 4",
+    "sleep interval 300",
+};
+static const int LINE_COUNT = sizeof(LINES) / sizeof(LINES[0]);
+
+struct BenchResult
+{
+    double nsPerLine = 0;
+    double allocsPerLine = 0;
+    double allocBytesPerLine = 0;
+    uint64_t tokens = 0;
+    uint64_t checksum = 0;   // 최적화로 루프가 사라지지 않도록
+};
+
+template <typename ParseLine>
+static BenchResult runBench(const String *lines, int iterations, ParseLine parseLine)
+{
+    BenchResult result;
+    uint64_t allocStart = nativeAllocCount();
+    uint64_t allocBytesStart = nativeAllocBytes();
+    unsigned long startUs = micros();
+
+    for (int i = 0; i < iterations; i++)
+    {
+        for (int l = 0; l < LINE_COUNT; l++)
+        {
+            parseLine(lines[l], result);
+        }
+    }
+
+    unsigned long elapsedUs = micros() - startUs;
+    double lineCount = (double)iterations * LINE_COUNT;
+    result.nsPerLine = elapsedUs * 1000.0 / lineCount;
+    result.allocsPerLine = (nativeAllocCount() - allocStart) / lineCount;
+    result.allocBytesPerLine = (nativeAllocBytes() - allocBytesStart) / lineCount;
+    return result;
+}
+
+static void toJson(const BenchResult &result, JsonObject obj)
+{
+    obj["ns_per_line"] = result.nsPerLine;
+    obj["allocs_per_line"] = result.allocsPerLine;
+    obj["alloc_bytes_per_line"] = result.allocBytesPerLine;
+    obj["tokens"] = result.tokens;
+    obj["checksum"] = result.checksum;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 20000;
+    for (int i = 1; i < argc; i++)
+    {
+        String arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+        }
+        else
+        {
+            Serial.println("usage: program [--iterations N]");
+            return 2;
+        }
+    }
+    if (iterations <= 0)
+    {
+        Serial.println("usage: program [--iterations N]");
+        return 2;
+    }
+
+    // 펌웨어처럼 라인은 String 으로 받은 상태에서 시작
+    String lines[LINE_COUNT];
+    for (int l = 0; l < LINE_COUNT; l++)
+    {
+        lines[l] = LINES[l];
+    }
+
+    // 토크나이저 객체는 명령 태스크처럼 한 번만 만들고 재사용
+    legacy_tonkey legacy;
+    tonkey current;
+
+    BenchResult legacyResult = runBench(lines, iterations, [&](const String &line, BenchResult &result) {
+        legacy.parse(line);
+        for (int t = 0; t < legacy.getTokenCount(); t++)
+        {
+            result.checksum += legacy.getToken(t).length();
+        }
+        result.tokens += legacy.getTokenCount();
+    });
+
+    BenchResult currentResult = runBench(lines, iterations, [&](const String &line, BenchResult &result) {
+        current.parse(line.c_str(), line.length());
+        for (int t = 0; t < current.size(); t++)
+        {
+            result.checksum += current[t].length();
+        }
+        result.tokens += current.size();
+    });
+
+    JsonDocument doc;
+    doc["lines"] = LINE_COUNT;
+    doc["iterations"] = iterations;
+    toJson(legacyResult, doc["legacy_string"].to<JsonObject>());
+    toJson(currentResult, doc["in_place"].to<JsonObject>());
+    doc["speedup"] = currentResult.nsPerLine > 0 ? legacyResult.nsPerLine / currentResult.nsPerLine : 0;
+
+    serializeJsonPretty(doc, Serial);
+    Serial.println();
+    return 0;
+}
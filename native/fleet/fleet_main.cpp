@@ -0,0 +1,384 @@
+// 가상 디바이스 fleet 시뮬레이터 (수집 서버 부하 시험)
+// 한 프로세스, 한 스레드의 epoll 루프에서 수백~수천 대의 esp32cam<chipid> 디바이스가
+// task_AutoUpload 주기로 같은 헤더/JPEG 본문을 업로드한다.
+//
+// 사용법: pio run -e native_fleet && .pio/build/native_fleet/program [옵션]
+//   --devices N      가상 디바이스 수 (기본 100)
+//   --interval SEC   upload_interval (기본 60)
+//   --duration SEC   시험 시간 (기본 120)
+//   --ramp SEC       부팅 시각 분산 구간 (기본 = interval)
+//   --url URL        수집 서버 (없으면 내장 루프백 서버)
+//   --path PATH      server_path (기본 /api/v1/camera/upload)
+//   --token TOKEN    auth_token
+//   --frames DIR     업로드할 JPEG 디렉터리 (없으면 합성 프레임)
+//   --res NAME       합성 프레임 해상도 (기본 vga)
+//   --chunked        chunked 전송
+//   --timeout MS     요청 타임아웃 (기본 30000)
+//   --depth N        디바이스별 업로드 큐 (기본 2 = PSRAM 보드 fb_count)
+//   --report SEC     진행 상황 출력 주기 (기본 10, 0 = 끔)
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include "camera_module.hpp"
+#include "latency_stats.hpp"
+#include "native_host.hpp"
+#include "virtual_device.hpp"
+
+#include <memory>
+#include <queue>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+CameraModule g_camera;
+
+struct FleetOptions
+{
+    int devices = 100;
+    uint32_t intervalSec = 60;
+    uint32_t durationSec = 120;
+    int32_t rampSec = -1;
+    String url;
+    String path = "/api/v1/camera/upload";
+    String token;
+    const char *framesDir = nullptr;
+    String resolution = "vga";
+    bool chunked = false;
+    uint32_t timeoutMs = 30000;
+    int depth = 2;
+    uint32_t reportSec = 10;
+};
+
+static const int SYNTHETIC_PAYLOADS = 8;
+static const int MAX_EVENTS = 256;
+static const uint32_t TIMEOUT_SWEEP_MS = 100;
+
+static void printUsage()
+{
+    Serial.println("usage: program [--devices N] [--interval SEC] [--duration SEC] [--ramp SEC]");
+    Serial.println("               [--url URL] [--path PATH] [--token TOKEN] [--frames DIR] [--res NAME]");
+    Serial.println("               [--chunked] [--timeout MS] [--depth N] [--report SEC]");
+}
+
+static bool parseArgs(int argc, char **argv, FleetOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        String arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--chunked")
+        {
+            opt.chunked = true;
+        }
+        else if (arg == "--devices" && hasValue)
+        {
+            opt.devices = atoi(argv[++i]);
+        }
+        else if (arg == "--interval" && hasValue)
+        {
+            opt.intervalSec = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--duration" && hasValue)
+        {
+            opt.durationSec = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--ramp" && hasValue)
+        {
+            opt.rampSec = atoi(argv[++i]);
+        }
+        else if (arg == "--url" && hasValue)
+        {
+            opt.url = argv[++i];
+        }
+        else if (arg == "--path" && hasValue)
+        {
+            opt.path = argv[++i];
+        }
+        else if (arg == "--token" && hasValue)
+        {
+            opt.token = argv[++i];
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            opt.framesDir = argv[++i];
+        }
+        else if (arg == "--res" && hasValue)
+        {
+            opt.resolution = argv[++i];
+        }
+        else if (arg == "--timeout" && hasValue)
+        {
+            opt.timeoutMs = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--depth" && hasValue)
+        {
+            opt.depth = atoi(argv[++i]);
+        }
+        else if (arg == "--report" && hasValue)
+        {
+            opt.reportSec = strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (opt.rampSec < 0)
+    {
+        opt.rampSec = opt.intervalSec;
+    }
+    return opt.devices > 0 && opt.intervalSec > 0 && opt.durationSec > 0 && opt.depth > 0;
+}
+
+// 카메라 재생 경로(CameraModule::grab)로 본문을 미리 받아 둔다
+static bool loadPayloads(const FleetOptions &opt, FleetContext &ctx)
+{
+    if (!nativeCameraReplay(opt.framesDir, 0) || !g_camera.init() ||
+        !g_camera.setResolutionByName(opt.resolution))
+    {
+        return false;
+    }
+
+    int count = opt.framesDir ? nativeCameraFrameCount() : SYNTHETIC_PAYLOADS;
+    for (int i = 0; i < count; i++)
+    {
+        camera_fb_t *fb = g_camera.grab();
+        if (!fb)
+        {
+            return false;
+        }
+
+        FleetPayload payload;
+        payload.raw.assign(fb->buf, fb->buf + fb->len);
+        g_camera.returnFrame(fb);
+
+        // HttpUploader::sendBody 와 같은 청크 크기
+        for (size_t offset = 0; offset < payload.raw.size(); offset += HttpUploader::BOUNCE_PAYLOAD)
+        {
+            size_t n = std::min(HttpUploader::BOUNCE_PAYLOAD, payload.raw.size() - offset);
+            char hex[HttpUploader::CHUNK_HEADER_SIZE + 1];
+            int hexLen = snprintf(hex, sizeof(hex), "%X\r\n", (unsigned)n);
+            payload.chunked.insert(payload.chunked.end(), hex, hex + hexLen);
+            payload.chunked.insert(payload.chunked.end(), payload.raw.begin() + offset, payload.raw.begin() + offset + n);
+            payload.chunked.push_back('\r');
+            payload.chunked.push_back('\n');
+        }
+        static const char LAST_CHUNK[] = "0\r\n\r\n";
+        payload.chunked.insert(payload.chunked.end(), LAST_CHUNK, LAST_CHUNK + 5);
+
+        ctx.payloads.push_back(std::move(payload));
+    }
+    return !ctx.payloads.empty();
+}
+
+static bool resolveServer(const String &host, uint16_t port, struct sockaddr_in &addr)
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res)
+    {
+        return false;
+    }
+    memcpy(&addr, res->ai_addr, sizeof(addr));
+    addr.sin_port = htons(port);
+    freeaddrinfo(res);
+    return true;
+}
+
+// 디바이스마다 연결 하나씩 쓰므로 열린 파일 수 제한을 최대로
+static void raiseFdLimit(int devices)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)devices + 64)
+    {
+        Serial.printf("Warning: open file limit %lu < devices %d\n", (unsigned long)limit.rlim_cur, devices);
+    }
+}
+
+static void printProgress(const FleetContext &ctx, uint32_t elapsedMs, uint64_t prevCompleted, uint32_t windowMs, int busy)
+{
+    const FleetStats &s = ctx.stats;
+    uint64_t errors = s.completed - s.ok;
+    Serial.printf("[%5us] req/s %.1f  done %llu  ok %llu  err %llu  dropped %llu  in-flight %d\n",
+                  elapsedMs / 1000, windowMs ? (s.completed - prevCompleted) * 1000.0 / windowMs : 0.0,
+                  (unsigned long long)s.completed, (unsigned long long)s.ok, (unsigned long long)errors,
+                  (unsigned long long)s.dropped, busy);
+}
+
+int main(int argc, char **argv)
+{
+    FleetOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage();
+        return 2;
+    }
+
+    FleetContext ctx;
+    ctx.intervalMs = opt.intervalSec * 1000;
+    ctx.timeoutMs = opt.timeoutMs;
+    ctx.queueDepth = opt.depth;
+
+    if (!loadPayloads(opt, ctx))
+    {
+        Serial.println("Payload load failed");
+        return 1;
+    }
+
+    bool loopback = opt.url.isEmpty();
+    if (loopback)
+    {
+        uint16_t port = nativeLoopbackServerStart();
+        if (port == 0)
+        {
+            Serial.println("Loopback server start failed");
+            return 1;
+        }
+        opt.url = "http://127.0.0.1:" + String((unsigned int)port);
+    }
+
+    HttpUploader target;
+    target.setServerUrl(opt.url);
+    if (!target.parseServerUrl() || !resolveServer(target.getHost(), target.getPort(), ctx.server))
+    {
+        Serial.printf("Invalid server URL: %s\n", opt.url.c_str());
+        return 1;
+    }
+
+    raiseFdLimit(opt.devices);
+    ctx.epollFd = epoll_create1(0);
+
+    // 부팅 시각을 ramp 구간에 고르게 흩어 놓는다
+    std::vector<std::unique_ptr<VirtualDevice>> devices;
+    devices.reserve(opt.devices);
+    uint32_t rampMs = (uint32_t)opt.rampSec * 1000;
+    for (int i = 0; i < opt.devices; i++)
+    {
+        uint32_t bootOffset = rampMs ? (uint32_t)((uint64_t)rampMs * i / opt.devices) : 0;
+        devices.emplace_back(new VirtualDevice(ctx, i, bootOffset, opt.url, opt.path, opt.token, opt.chunked));
+    }
+
+    Serial.printf("Fleet: %d devices (%s ... %s) -> %s%s, interval %us, ramp %ds, %d payloads (%u bytes)\n",
+                  opt.devices, devices.front()->getDeviceId().c_str(), devices.back()->getDeviceId().c_str(),
+                  opt.url.c_str(), opt.path.c_str(), opt.intervalSec, opt.rampSec,
+                  (int)ctx.payloads.size(), (unsigned)ctx.payloads[0].raw.size());
+
+    // 다음 틱 순서로 정렬된 힙
+    typedef std::pair<uint32_t, int> TickEntry;
+    auto later = [](const TickEntry &a, const TickEntry &b) { return (int32_t)(a.first - b.first) > 0; };
+    std::priority_queue<TickEntry, std::vector<TickEntry>, decltype(later)> ticks(later);
+    for (int i = 0; i < opt.devices; i++)
+    {
+        ticks.push(TickEntry(devices[i]->nextTickMs(), i));
+    }
+
+    LatencyStats::reset();
+    uint32_t startMs = millis();
+    uint32_t endMs = startMs + opt.durationSec * 1000;
+    uint32_t lastSweepMs = startMs;
+    uint32_t lastReportMs = startMs;
+    uint64_t lastReportCompleted = 0;
+    struct epoll_event events[MAX_EVENTS];
+
+    for (;;)
+    {
+        uint32_t nowMs = millis();
+        if (ctx.ticking && (int32_t)(nowMs - endMs) >= 0)
+        {
+            ctx.ticking = false;
+        }
+
+        // 틱
+        while (ctx.ticking && !ticks.empty() && (int32_t)(ticks.top().first - nowMs) <= 0)
+        {
+            int index = ticks.top().second;
+            ticks.pop();
+            devices[index]->tick(nowMs);
+            ticks.push(TickEntry(devices[index]->nextTickMs(), index));
+        }
+
+        // 타임아웃 검사 + 진행 상황 (주기적으로 전체 순회)
+        if (nowMs - lastSweepMs >= TIMEOUT_SWEEP_MS || !ctx.ticking)
+        {
+            lastSweepMs = nowMs;
+            int busy = 0;
+            for (auto &device : devices)
+            {
+                device->checkTimeout(nowMs);
+                busy += device->isBusy() ? 1 : 0;
+            }
+            if (!ctx.ticking && busy == 0)
+            {
+                break;
+            }
+
+            if (opt.reportSec && nowMs - lastReportMs >= opt.reportSec * 1000)
+            {
+                printProgress(ctx, nowMs - startMs, lastReportCompleted, nowMs - lastReportMs, busy);
+                lastReportMs = nowMs;
+                lastReportCompleted = ctx.stats.completed;
+            }
+        }
+
+        // 다음 틱 또는 타임아웃 검사까지 대기
+        int waitMs = TIMEOUT_SWEEP_MS;
+        if (ctx.ticking && !ticks.empty())
+        {
+            int32_t untilTick = (int32_t)(ticks.top().first - nowMs);
+            waitMs = std::max(0, std::min(waitMs, (int)untilTick));
+        }
+        int n = epoll_wait(ctx.epollFd, events, MAX_EVENTS, waitMs);
+        for (int i = 0; i < n; i++)
+        {
+            static_cast<VirtualDevice *>(events[i].data.ptr)->onEvent(events[i].events);
+        }
+    }
+
+    uint32_t elapsedMs = millis() - startMs;
+    double seconds = elapsedMs / 1000.0;
+    const FleetStats &s = ctx.stats;
+
+    JsonDocument doc;
+    doc["url"] = opt.url + opt.path;
+    doc["devices"] = opt.devices;
+    doc["interval_s"] = opt.intervalSec;
+    doc["elapsed_s"] = seconds;
+    doc["chunked"] = opt.chunked;
+    doc["payload_bytes"] = (uint32_t)ctx.payloads[0].raw.size();
+    doc["ticks"] = s.ticks;
+    doc["dropped"] = s.dropped;
+    doc["requests"] = s.completed;
+    doc["requests_per_s"] = seconds > 0 ? s.completed / seconds : 0;
+    doc["ok"] = s.ok;
+    doc["error_rate"] = s.completed ? (double)(s.completed - s.ok) / s.completed : 0;
+    doc["bytes_per_s"] = seconds > 0 ? s.bodyBytes / seconds : 0;
+    doc["connections"] = s.connections;
+    doc["reconnects"] = s.reconnects;
+    JsonObject codes = doc["codes"].to<JsonObject>();
+    for (const auto &entry : s.codes)
+    {
+        String key = entry.first > 0 ? String(entry.first) : HTTPClient::errorToString(entry.first);
+        codes[key] = entry.second;
+    }
+    if (loopback)
+    {
+        doc["server_requests"] = nativeLoopbackRequests();
+    }
+    LatencyStats::toJson(doc["latency"].to<JsonObject>());
+
+    serializeJsonPretty(doc, Serial);
+    Serial.println();
+
+    devices.clear();
+    close(ctx.epollFd);
+    return 0;
+}
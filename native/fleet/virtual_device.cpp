@@ -0,0 +1,414 @@
+#include "virtual_device.hpp"
+#include "latency_stats.hpp"
+
+#include <errno.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+VirtualDevice::VirtualDevice(FleetContext &ctx, int index, uint32_t bootOffsetMs,
+                             const String &url, const String &path, const String &token, bool chunked)
+    : m_ctx(ctx)
+{
+    // getChipID() 와 같은 형식 (efuse MAC 상위 16비트 + 하위 32비트)
+    uint64_t chipid = 0xA4CF12000000ULL + (uint64_t)index;
+    char chipidStr[13];
+    snprintf(chipidStr, sizeof(chipidStr), "%04X%08X", (uint16_t)(chipid >> 32), (uint32_t)chipid);
+
+    m_uploader.setServerUrl(url);
+    m_uploader.setUploadPath(path);
+    m_uploader.setAuthToken(token);
+    m_uploader.setChunked(chunked);
+    m_uploader.setDeviceId(String("esp32cam") + chipidStr);
+    m_uploader.parseServerUrl();
+
+    m_payloadIndex = (size_t)index % ctx.payloads.size();
+    m_nextTickMs = millis() + bootOffsetMs;
+}
+
+VirtualDevice::~VirtualDevice()
+{
+    closeConnection();
+}
+
+// ===========================================
+// 스케줄
+// ===========================================
+void VirtualDevice::tick(uint32_t nowMs)
+{
+    m_nextTickMs += m_ctx.intervalMs;
+    if ((int32_t)(m_nextTickMs - nowMs) <= 0)
+    {
+        m_nextTickMs = nowMs + m_ctx.intervalMs;
+    }
+
+    m_ctx.stats.ticks++;
+    if (m_pending >= m_ctx.queueDepth)
+    {
+        m_ctx.stats.dropped++;
+        return;
+    }
+    m_pending++;
+    if (m_state == IDLE)
+    {
+        startRequest();
+    }
+}
+
+void VirtualDevice::checkTimeout(uint32_t nowMs)
+{
+    if (m_state == IDLE || (int32_t)(m_deadlineMs - nowMs) > 0)
+    {
+        return;
+    }
+    if (m_state == CONNECTING)
+    {
+        fail(HTTPC_ERROR_CONNECTION_REFUSED);
+    }
+    else
+    {
+        fail(HTTPC_ERROR_READ_TIMEOUT);
+    }
+}
+
+// ===========================================
+// 요청
+// ===========================================
+void VirtualDevice::startRequest()
+{
+    const FleetPayload &payload = m_ctx.payloads[m_payloadIndex];
+    m_payloadIndex = (m_payloadIndex + 1) % m_ctx.payloads.size();
+
+    m_header = m_uploader.buildRequestHeader(payload.raw.size(), "image/jpeg", "", 0);
+    m_body = m_uploader.isChunked() ? &payload.chunked : &payload.raw;
+    m_bodyLen = payload.raw.size();
+    m_retried = false;
+    m_startUs = micros();
+    m_ctx.stats.requests++;
+
+    m_reused = m_fd >= 0;
+    if (m_reused)
+    {
+        m_sent = 0;
+        m_rx.clear();
+        m_statusSeen = false;
+        m_phaseUs = m_startUs;
+        m_state = SENDING;
+        m_deadlineMs = millis() + m_ctx.timeoutMs;
+        sendMore();
+    }
+    else
+    {
+        openConnection();
+    }
+}
+
+void VirtualDevice::openConnection()
+{
+    m_sent = 0;
+    m_rx.clear();
+    m_statusSeen = false;
+    m_phaseUs = micros();
+    m_deadlineMs = millis() + m_ctx.timeoutMs;
+
+    m_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (m_fd < 0)
+    {
+        fail(HTTPC_ERROR_CONNECTION_REFUSED);
+        return;
+    }
+    int flag = 1;
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLOUT;
+    ev.data.ptr = this;
+    epoll_ctl(m_ctx.epollFd, EPOLL_CTL_ADD, m_fd, &ev);
+
+    m_ctx.stats.connections++;
+    int rc = connect(m_fd, (const struct sockaddr *)&m_ctx.server, sizeof(m_ctx.server));
+    if (rc < 0 && errno != EINPROGRESS)
+    {
+        fail(HTTPC_ERROR_CONNECTION_REFUSED);
+        return;
+    }
+    m_state = CONNECTING;
+}
+
+void VirtualDevice::onEvent(uint32_t events)
+{
+    switch (m_state)
+    {
+        case CONNECTING:
+        {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0)
+            {
+                fail(HTTPC_ERROR_CONNECTION_REFUSED);
+                return;
+            }
+            uint32_t nowUs = micros();
+            LatencyStats::record(LatencyStats::CONNECT, nowUs - m_phaseUs);
+            m_phaseUs = nowUs;
+            m_state = SENDING;
+            sendMore();
+            break;
+        }
+        case SENDING:
+            sendMore();
+            break;
+        case WAITING:
+            readMore();
+            break;
+        case IDLE:
+            // 유휴 keep-alive 연결에 데이터/종료가 오면 서버가 닫은 것
+            closeConnection();
+            break;
+    }
+}
+
+void VirtualDevice::sendMore()
+{
+    size_t headerLen = m_header.length();
+    size_t total = headerLen + m_body->size();
+    while (m_sent < total)
+    {
+        struct iovec iov[2];
+        int count = 0;
+        if (m_sent < headerLen)
+        {
+            iov[count].iov_base = (void *)(m_header.c_str() + m_sent);
+            iov[count].iov_len = headerLen - m_sent;
+            count++;
+        }
+        size_t bodyOffset = m_sent > headerLen ? m_sent - headerLen : 0;
+        iov[count].iov_base = (void *)(m_body->data() + bodyOffset);
+        iov[count].iov_len = m_body->size() - bodyOffset;
+        count++;
+
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(m_fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                watch(EPOLLOUT);
+                return;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fail(m_sent < headerLen ? HTTPC_ERROR_SEND_HEADER_FAILED : HTTPC_ERROR_SEND_PAYLOAD_FAILED);
+            return;
+        }
+        m_sent += (size_t)n;
+    }
+
+    uint32_t nowUs = micros();
+    LatencyStats::record(LatencyStats::SEND, nowUs - m_phaseUs);
+    m_phaseUs = nowUs;
+    m_state = WAITING;
+    m_deadlineMs = millis() + m_ctx.timeoutMs;
+    watch(EPOLLIN);
+}
+
+void VirtualDevice::readMore()
+{
+    char buf[4096];
+    bool eof = false;
+    for (;;)
+    {
+        ssize_t n = recv(m_fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+        {
+            m_rx.append(buf, n);
+            if (m_rx.size() > MAX_RESPONSE_SIZE)
+            {
+                fail(HTTPC_ERROR_TOO_LESS_RAM);
+                return;
+            }
+            continue;
+        }
+        if (n == 0)
+        {
+            eof = true;
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            eof = true;
+        }
+        break;
+    }
+
+    if (!m_statusSeen && m_rx.find('\n') != std::string::npos)
+    {
+        m_statusSeen = true;
+        uint32_t nowUs = micros();
+        LatencyStats::record(LatencyStats::RESPONSE, nowUs - m_phaseUs);
+        m_phaseUs = nowUs;
+    }
+
+    int httpCode = parseResponse(eof);
+    if (httpCode != 0)
+    {
+        if (httpCode > 0)
+        {
+            LatencyStats::record(LatencyStats::READ, micros() - m_phaseUs);
+            finish(httpCode);
+        }
+        else
+        {
+            fail(httpCode);
+        }
+    }
+    else if (eof)
+    {
+        fail(m_rx.empty() ? HTTPC_ERROR_CONNECTION_LOST : HTTPC_ERROR_NO_HTTP_SERVER);
+    }
+}
+
+// 0: 아직 덜 옴, > 0: HTTP 코드 (응답 완료), < 0: 오류
+int VirtualDevice::parseResponse(bool eof)
+{
+    size_t headerEnd = m_rx.find("\r\n\r\n");
+    if (headerEnd == std::string::npos)
+    {
+        return 0;
+    }
+
+    int httpCode = 0;
+    if (m_rx.compare(0, 5, "HTTP/") != 0 || sscanf(m_rx.c_str(), "HTTP/%*s %d", &httpCode) != 1 || httpCode <= 0)
+    {
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+    m_keepAlive = m_rx.compare(0, 8, "HTTP/1.1") == 0;
+
+    long contentLength = -1;
+    bool chunked = false;
+    size_t pos = m_rx.find("\r\n") + 2;
+    while (pos < headerEnd)
+    {
+        size_t end = m_rx.find("\r\n", pos);
+        const char *line = m_rx.c_str() + pos;
+        if (strncasecmp(line, "Content-Length:", 15) == 0)
+        {
+            contentLength = strtol(line + 15, nullptr, 10);
+        }
+        else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0)
+        {
+            chunked = strstr(std::string(line, end - pos).c_str(), "chunked") != nullptr;
+        }
+        else if (strncasecmp(line, "Connection:", 11) == 0)
+        {
+            m_keepAlive = strstr(std::string(line, end - pos).c_str(), "close") == nullptr;
+        }
+        pos = end + 2;
+    }
+
+    size_t body = headerEnd + 4;
+    if (chunked)
+    {
+        // 크기 0 청크 + 빈 줄까지 와야 완료
+        while (body < m_rx.size())
+        {
+            size_t lineEnd = m_rx.find("\r\n", body);
+            if (lineEnd == std::string::npos)
+            {
+                return 0;
+            }
+            size_t size = strtoul(m_rx.c_str() + body, nullptr, 16);
+            if (size == 0)
+            {
+                return m_rx.find("\r\n", lineEnd + 2) != std::string::npos ? httpCode : 0;
+            }
+            body = lineEnd + 2 + size + 2;
+        }
+        return 0;
+    }
+    if (contentLength >= 0)
+    {
+        return m_rx.size() >= body + (size_t)contentLength ? httpCode : 0;
+    }
+
+    // 길이 정보가 없으면 서버가 닫을 때까지
+    m_keepAlive = false;
+    return eof ? httpCode : 0;
+}
+
+void VirtualDevice::finish(int httpCode)
+{
+    LatencyStats::record(LatencyStats::UPLOAD, micros() - m_startUs);
+    m_ctx.stats.completed++;
+    m_ctx.stats.codes[httpCode]++;
+    if (httpCode >= 200 && httpCode < 300)
+    {
+        m_ctx.stats.ok++;
+        m_ctx.stats.bodyBytes += m_bodyLen;
+    }
+
+    if (httpCode < 0 || !m_keepAlive)
+    {
+        closeConnection();
+    }
+    else
+    {
+        // 유휴 중 서버가 닫는 것을 알아채도록 읽기 감시는 유지
+        watch(EPOLLIN | EPOLLRDHUP);
+    }
+    m_state = IDLE;
+    m_body = nullptr;
+
+    m_pending--;
+    if (m_pending > 0)
+    {
+        startRequest();
+    }
+}
+
+// 재사용한 연결이 이미 닫혀 있었으면 새 연결로 한 번 더 (HttpUploader::request 와 같은 규칙)
+void VirtualDevice::fail(int error)
+{
+    closeConnection();
+    if (m_reused && !m_retried &&
+        (error == HTTPC_ERROR_CONNECTION_LOST ||
+         error == HTTPC_ERROR_SEND_HEADER_FAILED ||
+         error == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+         error == HTTPC_ERROR_NOT_CONNECTED))
+    {
+        m_retried = true;
+        m_reused = false;
+        m_ctx.stats.reconnects++;
+        openConnection();
+        return;
+    }
+    finish(error);
+}
+
+void VirtualDevice::closeConnection()
+{
+    if (m_fd >= 0)
+    {
+        epoll_ctl(m_ctx.epollFd, EPOLL_CTL_DEL, m_fd, nullptr);
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void VirtualDevice::watch(uint32_t events)
+{
+    struct epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = this;
+    epoll_ctl(m_ctx.epollFd, EPOLL_CTL_MOD, m_fd, &ev);
+}
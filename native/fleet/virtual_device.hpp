@@ -0,0 +1,109 @@
+#ifndef VIRTUAL_DEVICE_HPP
+#define VIRTUAL_DEVICE_HPP
+
+#include <Arduino.h>
+#include <netinet/in.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "http_upload.hpp"
+
+// 모든 가상 디바이스가 공유하는 업로드 본문 (재생 JPEG 한 장)
+struct FleetPayload
+{
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> chunked;   // HttpUploader::sendBody 와 같은 크기로 나눈 chunked 본문
+};
+
+struct FleetStats
+{
+    uint64_t ticks = 0;          // task_AutoUpload 실행 횟수
+    uint64_t dropped = 0;        // 큐가 가득 차서 건너뛴 틱 (pipeline busy)
+    uint64_t requests = 0;       // 시작한 업로드
+    uint64_t completed = 0;      // 결과가 나온 업로드 (성공 + 실패)
+    uint64_t ok = 0;             // 2xx
+    uint64_t reconnects = 0;     // 끊긴 keep-alive 연결 재시도
+    uint64_t connections = 0;    // 새로 연 TCP 연결
+    uint64_t bodyBytes = 0;      // 2xx 로 끝난 요청의 본문 바이트
+    std::map<int, uint64_t> codes;   // HTTP 코드 또는 HTTPC_ERROR_* 별 횟수
+};
+
+struct FleetContext
+{
+    int epollFd = -1;
+    struct sockaddr_in server;
+    uint32_t intervalMs = 60000;
+    uint32_t timeoutMs = 30000;
+    int queueDepth = 2;
+    bool ticking = true;         // false 면 새 틱을 내지 않음 (종료 중)
+    std::vector<FleetPayload> payloads;
+    FleetStats stats;
+};
+
+// 가상 esp32cam 디바이스 하나
+// - 헤더는 디바이스마다 설정한 HttpUploader 가 만든다 (device-id, auth-token 이 펌웨어와 동일)
+// - 전송은 비차단 소켓 + epoll 이벤트 루프 (스레드 없음)
+// - task_AutoUpload 처럼 interval 마다 틱, 파이프라인 큐(queueDepth)가 차 있으면 건너뜀
+class VirtualDevice
+{
+public:
+    enum State
+    {
+        IDLE,
+        CONNECTING,
+        SENDING,
+        WAITING
+    };
+
+    static const size_t MAX_RESPONSE_SIZE = 16 * 1024;
+
+private:
+    FleetContext &m_ctx;
+    HttpUploader m_uploader;
+    State m_state = IDLE;
+    int m_fd = -1;
+    int m_pending = 0;               // 큐에 있거나 전송 중인 프레임
+    size_t m_payloadIndex;
+    uint32_t m_nextTickMs;
+    uint32_t m_deadlineMs = 0;
+
+    // 진행 중인 요청
+    String m_header;
+    const std::vector<uint8_t> *m_body = nullptr;   // 전송할 본문 (chunked 면 틀 포함)
+    size_t m_bodyLen = 0;                            // JPEG 크기
+    size_t m_sent = 0;
+    std::string m_rx;
+    bool m_reused = false;
+    bool m_retried = false;
+    bool m_statusSeen = false;
+    bool m_keepAlive = true;
+    uint32_t m_startUs = 0;
+    uint32_t m_phaseUs = 0;
+
+    void startRequest();
+    void openConnection();
+    void sendMore();
+    void readMore();
+    int parseResponse(bool eof);
+    void finish(int httpCode);
+    void fail(int error);
+    void closeConnection();
+    void watch(uint32_t events);
+
+public:
+    VirtualDevice(FleetContext &ctx, int index, uint32_t bootOffsetMs,
+                  const String &url, const String &path, const String &token, bool chunked);
+    ~VirtualDevice();
+    VirtualDevice(const VirtualDevice &) = delete;
+    VirtualDevice &operator=(const VirtualDevice &) = delete;
+
+    inline uint32_t nextTickMs() const { return m_nextTickMs; }
+    inline bool isBusy() const { return m_state != IDLE || m_pending > 0; }
+    inline String getDeviceId() const { return m_uploader.getDeviceId(); }
+
+    void tick(uint32_t nowMs);
+    void onEvent(uint32_t events);
+    void checkTimeout(uint32_t nowMs);
+};
+
+#endif // VIRTUAL_DEVICE_HPP
@@ -0,0 +1,239 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// 호스트(PC) 빌드용 Arduino 코어 대용
+// 펌웨어 모듈이 쓰는 만큼만 구현한다 (String, Serial, 시간, ESP, PSRAM 할당).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+// PROGMEM 은 호스트에서 일반 메모리
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+inline bool isAlphaNumeric(int c) { return isalnum(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high)
+{
+    return value < (T)low ? (T)low : (value > (T)high ? (T)high : value);
+}
+
+// ===========================================
+// String
+// ===========================================
+class String
+{
+private:
+    std::string m_str;
+
+public:
+    String() {}
+    String(const char *str) : m_str(str ? str : "") {}
+    String(const char *str, size_t len) : m_str(str ? str : "", str ? len : 0) {}
+    String(const std::string &str) : m_str(str) {}
+    String(const __FlashStringHelper *str) : m_str(reinterpret_cast<const char *>(str)) {}
+    explicit String(char c) : m_str(1, c) {}
+    explicit String(int value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(long long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(unsigned long long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(float value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+    explicit String(double value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+
+    inline unsigned int length() const { return (unsigned int)m_str.size(); }
+    inline const char *c_str() const { return m_str.c_str(); }
+    inline bool reserve(unsigned int size) { m_str.reserve(size); return true; }
+    inline bool isEmpty() const { return m_str.empty(); }
+
+    inline char charAt(unsigned int index) const { return index < m_str.size() ? m_str[index] : 0; }
+    inline char operator[](unsigned int index) const { return charAt(index); }
+    inline char &operator[](unsigned int index) { return m_str[index]; }
+
+    // 연결
+    inline bool concat(const String &str) { m_str += str.m_str; return true; }
+    inline bool concat(const char *str) { if (str) m_str += str; return str != nullptr; }
+    inline bool concat(const char *str, unsigned int len) { m_str.append(str, len); return true; }
+    inline bool concat(char c) { m_str += c; return true; }
+    inline bool concat(int value) { return concat(String(value)); }
+    inline bool concat(unsigned int value) { return concat(String(value)); }
+    inline bool concat(long value) { return concat(String(value)); }
+    inline bool concat(unsigned long value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value) { concat(value); return *this; }
+
+    // 비교
+    inline bool equals(const String &str) const { return m_str == str.m_str; }
+    inline bool equals(const char *str) const { return m_str == (str ? str : ""); }
+    inline bool operator==(const String &str) const { return equals(str); }
+    inline bool operator==(const char *str) const { return equals(str); }
+    inline bool operator!=(const String &str) const { return !equals(str); }
+    inline bool operator!=(const char *str) const { return !equals(str); }
+    inline bool operator<(const String &str) const { return m_str < str.m_str; }
+    bool equalsIgnoreCase(const String &str) const;
+    inline explicit operator bool() const { return true; }
+
+    // 검색
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String &str) const;
+    inline bool startsWith(const String &prefix) const { return m_str.compare(0, prefix.m_str.size(), prefix.m_str) == 0; }
+    bool endsWith(const String &suffix) const;
+    String substring(unsigned int begin) const;
+    String substring(unsigned int begin, unsigned int end) const;
+
+    // 변경
+    void replace(char find, char with);
+    void replace(const String &find, const String &with);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    // 변환
+    inline long toInt() const { return strtol(m_str.c_str(), nullptr, 10); }
+    inline float toFloat() const { return (float)strtod(m_str.c_str(), nullptr); }
+    inline double toDouble() const { return strtod(m_str.c_str(), nullptr); }
+
+private:
+    void fromSigned(long long value, unsigned char base);
+    void fromUnsigned(unsigned long long value, unsigned char base);
+    void fromDouble(double value, unsigned int decimals);
+};
+
+inline String operator+(const String &a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, const char *b) { String r(a); r.concat(b); return r; }
+inline String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, char b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, int b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, unsigned int b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, long b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, unsigned long b) { String r(a); r.concat(b); return r; }
+
+// ===========================================
+// Print / Serial (stdout)
+// ===========================================
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    inline size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const String &str) { return write((const uint8_t *)str.c_str(), str.length()); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char *>(str)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned int value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(long value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = 10) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, (unsigned int)decimals)); }
+
+    size_t println() { return write("\n"); }
+    template <typename T>
+    size_t println(const T &value) { size_t n = print(value); return n + println(); }
+};
+
+// 출력은 stdout, 입력은 native_host.hpp 의 nativeSerialInput() 으로 넣은 바이트
+class HardwareSerial : public Print
+{
+private:
+    std::function<void()> m_onReceive;
+
+public:
+    using Print::write;
+    void begin(unsigned long baud) {}
+    void setDebugOutput(bool enable) {}
+    void flush() { fflush(stdout); }
+    // 수신 바이트가 들어오면 넣은 스레드에서 바로 호출 (UART 이벤트 태스크 역할)
+    void onReceive(std::function<void()> callback) { m_onReceive = callback; }
+    int available();
+    int read();
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    operator bool() const { return true; }
+
+    friend void nativeSerialInput(const uint8_t *data, size_t len);
+};
+
+extern HardwareSerial Serial;
+
+// ===========================================
+// 시간 / GPIO
+// ===========================================
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+inline void yield() {}
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {}
+inline int digitalRead(uint8_t pin) { return LOW; }
+
+// ===========================================
+// ESP / PSRAM
+// ===========================================
+bool psramFound();
+void *ps_malloc(size_t size);
+void *ps_calloc(size_t count, size_t size);
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap();
+    uint32_t getHeapSize();
+    uint32_t getPsramSize();
+    uint32_t getFreePsram();
+    uint64_t getEfuseMac();
+    const char *getChipModel() { return "native"; }
+    uint8_t getChipRevision() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,38 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// 호스트 빌드용 EEPROM 대용 (지워진 플래시처럼 0xFF 로 시작)
+class EEPROMClass
+{
+private:
+    std::vector<uint8_t> m_data;
+
+public:
+    bool begin(size_t size)
+    {
+        if (m_data.size() < size)
+        {
+            m_data.resize(size, 0xFF);
+        }
+        return true;
+    }
+    void end() {}
+    bool commit() { return true; }
+    uint8_t read(int address) { return address >= 0 && (size_t)address < m_data.size() ? m_data[address] : 0xFF; }
+    void write(int address, uint8_t value)
+    {
+        if (address >= 0 && (size_t)address < m_data.size())
+        {
+            m_data[address] = value;
+        }
+    }
+    size_t length() const { return m_data.size(); }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_EEPROM_H
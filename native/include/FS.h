@@ -0,0 +1,73 @@
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+// 호스트 빌드용 파일시스템: 호스트 디렉터리 하나를 FS 루트로 쓴다
+// 전원 차단 시험은 native_host.hpp 의 nativeFsFailAfter() 로 쓰기를 중간에 끊는다
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+namespace fs
+{
+
+struct FileHandle;
+
+class File : public Print
+{
+private:
+    std::shared_ptr<FileHandle> m_handle;
+
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileHandle> handle) : m_handle(handle) {}
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available();
+    int read();
+    size_t read(uint8_t *buffer, size_t size);
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+
+    bool isDirectory() const;
+    const char *name() const;    // 마지막 경로 요소
+    const char *path() const;    // FS 루트 기준 경로
+    File openNextFile(const char *mode = "r");
+
+    operator bool() const;
+};
+
+class FS
+{
+protected:
+    std::string m_root;          // 호스트 디렉터리 (끝에 '/' 없음)
+
+    std::string hostPath(const char *path) const;
+
+public:
+    explicit FS(const std::string &root) : m_root(root) {}
+    virtual ~FS() {}
+
+    File open(const char *path, const char *mode = "r", bool create = false);
+    File open(const String &path, const char *mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool rmdir(const char *path);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // NATIVE_FS_H
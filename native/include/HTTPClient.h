@@ -0,0 +1,44 @@
+#ifndef NATIVE_HTTPCLIENT_H
+#define NATIVE_HTTPCLIENT_H
+
+// 호스트 빌드용: HttpUploader 는 WiFiClient 로 직접 요청하므로 오류 코드만 필요
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+class HTTPClient
+{
+public:
+    static String errorToString(int error)
+    {
+        switch (error)
+        {
+            case HTTPC_ERROR_CONNECTION_REFUSED:  return F("connection refused");
+            case HTTPC_ERROR_SEND_HEADER_FAILED:  return F("send header failed");
+            case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return F("send payload failed");
+            case HTTPC_ERROR_NOT_CONNECTED:       return F("not connected");
+            case HTTPC_ERROR_CONNECTION_LOST:     return F("connection lost");
+            case HTTPC_ERROR_NO_STREAM:           return F("no stream");
+            case HTTPC_ERROR_NO_HTTP_SERVER:      return F("no HTTP server");
+            case HTTPC_ERROR_TOO_LESS_RAM:        return F("too less ram");
+            case HTTPC_ERROR_ENCODING:            return F("Transfer-Encoding not supported");
+            case HTTPC_ERROR_STREAM_WRITE:        return F("Stream write error");
+            case HTTPC_ERROR_READ_TIMEOUT:        return F("read Timeout");
+            default:                              return String();
+        }
+    }
+};
+
+#endif // NATIVE_HTTPCLIENT_H
@@ -0,0 +1,39 @@
+#ifndef NATIVE_IPADDRESS_H
+#define NATIVE_IPADDRESS_H
+
+// ESP32 IPAddress 와 같이 첫 옥텟이 uint32_t 의 최하위 바이트
+
+#include <Arduino.h>
+
+class IPAddress
+{
+private:
+    uint8_t m_bytes[4] = { 0, 0, 0, 0 };
+
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : m_bytes{ a, b, c, d } {}
+    IPAddress(uint32_t address) { memcpy(m_bytes, &address, sizeof(m_bytes)); }
+
+    operator uint32_t() const
+    {
+        uint32_t address;
+        memcpy(&address, m_bytes, sizeof(address));
+        return address;
+    }
+    inline bool operator==(const IPAddress &other) const { return memcmp(m_bytes, other.m_bytes, sizeof(m_bytes)) == 0; }
+    inline bool operator!=(const IPAddress &other) const { return !(*this == other); }
+    inline uint8_t operator[](int index) const { return m_bytes[index]; }
+    inline uint8_t &operator[](int index) { return m_bytes[index]; }
+
+    bool fromString(const char *address);
+    inline bool fromString(const String &address) { return fromString(address.c_str()); }
+    String toString() const;
+};
+
+// POSIX <netinet/in.h> 의 INADDR_NONE 매크로와 겹치면 그쪽을 쓴다
+#ifndef INADDR_NONE
+extern const IPAddress INADDR_NONE;
+#endif
+
+#endif // NATIVE_IPADDRESS_H
@@ -0,0 +1,37 @@
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+void nativeFsSetRoot(const char *dir);
+
+namespace fs
+{
+
+// 파티션 크기는 default_8MB.csv 의 spiffs 파티션과 같게 보고한다
+class LittleFSFS : public FS
+{
+private:
+    bool m_mounted = false;
+
+public:
+    static const size_t PARTITION_SIZE = 1536 * 1024;
+
+    LittleFSFS();
+
+    // 루트 디렉터리가 없으면 마운트 실패 (formatOnFail 이면 만든다)
+    bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = nullptr);
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+    void end();
+
+    friend void ::nativeFsSetRoot(const char *dir);
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_H
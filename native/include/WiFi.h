@@ -0,0 +1,100 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+// 호스트 빌드용 WiFi (전송은 호스트 네트워크)
+// 처음에는 연결된 상태로 시작해 벤치/fleet 은 접속 절차 없이 바로 올린다.
+// begin() 은 요청만 기록하고 끊긴 상태로 바꾸며, 이후 상태는 시험 코드가
+// native_host.hpp 의 nativeWifiEvent() 로 STA 이벤트를 보내 바꾼다.
+
+#include <Arduino.h>
+#include <functional>
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_OFF = 0,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA
+} wifi_mode_t;
+
+typedef enum
+{
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK
+} wifi_auth_mode_t;
+
+typedef enum
+{
+    ARDUINO_EVENT_NONE = 0,
+    ARDUINO_EVENT_WIFI_STA_START = 2,
+    ARDUINO_EVENT_WIFI_STA_STOP,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_AUTHMODE_CHANGE,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP
+} arduino_event_id_t;
+
+// 쓰는 필드만 (실제는 이벤트별 union)
+typedef struct
+{
+    struct
+    {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+typedef size_t wifi_event_id_t;
+
+class WiFiClass
+{
+public:
+    wl_status_t status();
+    int8_t RSSI();
+    IPAddress localIP();
+    IPAddress gatewayIP();
+    IPAddress subnetMask();
+    IPAddress dnsIP(uint8_t index = 0);
+    String macAddress();
+    uint8_t *BSSID();
+    String BSSIDstr();
+    int32_t channel();
+
+    bool mode(wifi_mode_t mode) { return true; }
+    bool persistent(bool persistent) { return true; }
+    bool setAutoReconnect(bool autoReconnect) { return true; }
+    wl_status_t begin(const char *ssid, const char *passphrase = nullptr, int32_t channel = 0,
+                      const uint8_t *bssid = nullptr, bool connect = true);
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    bool config(IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1 = (uint32_t)0,
+                IPAddress dns2 = (uint32_t)0);
+    wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_NONE);
+
+    // 스캔 결과는 마지막으로 begin() 에 넘긴 SSID 하나 (없으면 0개)
+    int16_t scanNetworks(bool async = false, bool showHidden = false);
+    String SSID(uint8_t index);
+    int32_t RSSI(uint8_t index);
+    wifi_auth_mode_t encryptionType(uint8_t index);
+    void scanDelete() {}
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
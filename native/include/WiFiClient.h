@@ -0,0 +1,52 @@
+#ifndef NATIVE_WIFICLIENT_H
+#define NATIVE_WIFICLIENT_H
+
+// 호스트 빌드용 WiFiClient: POSIX TCP 소켓
+// ESP32 와 같이 복사본끼리 소켓과 수신 버퍼를 공유하고, 마지막 복사본이 사라질 때 닫는다
+
+#include <Arduino.h>
+#include <memory>
+#include "IPAddress.h"
+
+class WiFiClient
+{
+private:
+    static const size_t RX_BUFFER_SIZE = 1024;
+
+    struct Socket
+    {
+        int fd = -1;
+        uint8_t rx[RX_BUFFER_SIZE];
+        size_t rxPos = 0;
+        size_t rxLen = 0;
+
+        explicit Socket(int socketFd) : fd(socketFd) {}
+        ~Socket();
+    };
+
+    std::shared_ptr<Socket> m_socket;
+
+    bool fillRx();
+
+public:
+    WiFiClient() {}
+    explicit WiFiClient(int fd);   // accept() 한 소켓 (WiFiServer)
+    ~WiFiClient() {}
+
+    int connect(const char *host, uint16_t port, int32_t timeoutMs = 3000);
+    void stop();
+    uint8_t connected();
+    int setNoDelay(bool noDelay);
+    int fd() const { return m_socket ? m_socket->fd : -1; }
+    IPAddress remoteIP() const;
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size);
+    int available();
+    int read();
+    int read(uint8_t *buffer, size_t size);
+    void flush() {}
+    operator bool() { return connected(); }
+};
+
+#endif // NATIVE_WIFICLIENT_H
@@ -0,0 +1,27 @@
+#ifndef NATIVE_WIFISERVER_H
+#define NATIVE_WIFISERVER_H
+
+// 호스트 빌드용 WiFiServer: 비차단 accept (0.0.0.0:port)
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+class WiFiServer
+{
+private:
+    int m_fd = -1;
+    uint16_t m_port;
+    bool m_noDelay = false;
+
+public:
+    WiFiServer(uint16_t port = 80, uint8_t maxClients = 4) : m_port(port) {}
+    ~WiFiServer() { end(); }
+
+    void begin(uint16_t port = 0);
+    void end();
+    inline void setNoDelay(bool noDelay) { m_noDelay = noDelay; }
+    WiFiClient available();     // 대기 중인 연결이 없으면 빈 클라이언트
+    operator bool() { return m_fd >= 0; }
+};
+
+#endif // NATIVE_WIFISERVER_H
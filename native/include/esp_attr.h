@@ -0,0 +1,11 @@
+#ifndef NATIVE_ESP_ATTR_H
+#define NATIVE_ESP_ATTR_H
+
+// 메모리 배치 속성은 호스트에서 의미가 없다
+// RTC_DATA_ATTR 변수는 프로세스가 살아 있는 동안만 유지 (deep sleep 은 프로세스 종료)
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+#endif // NATIVE_ESP_ATTR_H
@@ -0,0 +1,9 @@
+#ifndef NATIVE_ESP_IDF_VERSION_H
+#define NATIVE_ESP_IDF_VERSION_H
+
+// 호스트 빌드는 IDF 5 API (nvs_entry_find 가 esp_err_t 반환) 를 따른다
+#define ESP_IDF_VERSION_MAJOR 5
+#define ESP_IDF_VERSION_MINOR 1
+#define ESP_IDF_VERSION_PATCH 0
+
+#endif // NATIVE_ESP_IDF_VERSION_H
@@ -0,0 +1,9 @@
+#ifndef NATIVE_ESP_ROM_CRC_H
+#define NATIVE_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+// ROM 의 CRC-32 (zlib 과 같은 다항식/반전, 이어서 호출 가능)
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+#endif // NATIVE_ESP_ROM_CRC_H
@@ -0,0 +1,46 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+// 호스트 빌드용 FreeRTOS 대용 (틱 = 1ms)
+
+#include <stdint.h>
+#include <atomic>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// 임계 구역: 스핀락 (호스트에서는 코어 구분 없음)
+typedef struct
+{
+    std::atomic<int> locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+inline void nativeMuxLock(portMUX_TYPE *mux)
+{
+    while (mux->locked.exchange(1, std::memory_order_acquire))
+    {
+    }
+}
+
+inline void nativeMuxUnlock(portMUX_TYPE *mux)
+{
+    mux->locked.store(0, std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux) nativeMuxLock(mux)
+#define portEXIT_CRITICAL(mux) nativeMuxUnlock(mux)
+#define portENTER_CRITICAL_ISR(mux) nativeMuxLock(mux)
+#define portEXIT_CRITICAL_ISR(mux) nativeMuxUnlock(mux)
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,20 @@
+#ifndef NATIVE_IMG_CONVERTERS_H
+#define NATIVE_IMG_CONVERTERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+    JPG_SCALE_NONE,
+    JPG_SCALE_2X,
+    JPG_SCALE_4X,
+    JPG_SCALE_8X,
+    JPG_SCALE_MAX = JPG_SCALE_8X
+} jpg_scale_t;
+
+// 호스트 구현은 JPG_SCALE_8X (블록 DC 만 쓰는 1/8 디코드) 만 지원 (native/src/jpeg_dc_host.cpp)
+// 재생한 JPEG 로 썸네일/움직임 감지/중복 필터를 돌릴 수 있다. 합성 프레임은 디코드에 실패해 그대로 통과.
+bool jpg2rgb565(const uint8_t *src, size_t srcLen, uint8_t *out, jpg_scale_t scale);
+
+#endif // NATIVE_IMG_CONVERTERS_H
@@ -0,0 +1,61 @@
+#ifndef NATIVE_HOST_HPP
+#define NATIVE_HOST_HPP
+
+// 호스트 빌드 전용 제어 함수 (벤치마크/시험에서 사용)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>
+#include <WiFi.h>
+
+// 카메라 재생: dir 의 *.jpg/*.jpeg 를 이름 순서로 반복 재생
+// dir 이 비어 있거나 null 이면 현재 해상도 크기의 합성 프레임 사용
+// fps 가 0 이면 기다리지 않고 바로 다음 프레임
+bool nativeCameraReplay(const char *dir, float fps);
+int nativeCameraFrameCount();
+// 가짜 센서의 set_*() 호출 수 (SCCB 쓰기)
+uint32_t nativeSensorWrites();
+
+// 할당 횟수 (operator new + ps_malloc + heap_caps_malloc)
+// 루프백 서버처럼 펌웨어가 아닌 스레드는 nativeAllocExcludeThread() 로 제외
+uint64_t nativeAllocCount();
+uint64_t nativeAllocBytes();
+void nativeAllocExcludeThread();
+
+// 루프백 HTTP 서버 (127.0.0.1, 별도 스레드)
+// 요청 본문을 읽고 버린 뒤 200 {"result":"ok"} 로 응답, keep-alive 지원
+// 실패하면 0, 성공하면 바인딩된 포트
+uint16_t nativeLoopbackServerStart(uint16_t port = 0);
+uint64_t nativeLoopbackRequests();
+uint64_t nativeLoopbackBodyBytes();
+// 이후 응답 코드 (기본 200), 마지막 요청 라인의 경로
+void nativeLoopbackSetStatus(int code);
+// 다음 응답 하나는 Content-Length 보다 missing 바이트 짧게 보내고 (최대 32),
+// 모자란 바이트는 같은 연결의 다음 응답 앞에 늦게 보낸다
+void nativeLoopbackShortBody(size_t missing);
+String nativeLoopbackLastPath();
+
+// 가상 시계: millis()/micros()/xTaskGetTickCount() 를 ms 만큼 앞당긴다 (타임아웃 시험)
+void nativeTimeAdvance(uint32_t ms);
+
+// 시리얼 입력: RX 버퍼에 넣고 onReceive() 콜백을 호출한 스레드에서 바로 부른다
+void nativeSerialInput(const uint8_t *data, size_t len);
+// 시리얼 출력: 켜면 stdout 대신 버퍼에 모으고 nativeSerialTakeOutput() 으로 꺼낸다
+void nativeSerialCapture(bool enabled);
+String nativeSerialTakeOutput();
+
+// WiFi: STA 이벤트를 보내 상태를 바꾸고 onEvent() 콜백을 호출 (reason 은 DISCONNECTED 용)
+// CONNECTED 는 연결 중, GOT_IP 부터 WL_CONNECTED, DISCONNECTED 는 WL_DISCONNECTED
+void nativeWifiEvent(arduino_event_id_t event, uint8_t reason = 0);
+uint32_t nativeWifiBeginCount();
+int32_t nativeWifiLastChannel();     // 마지막 begin() 의 채널 (0 = 스캔 접속)
+
+// NVS: 앞으로 writes 번만 더 성공하고 그 뒤 nvs_set_*() 는 NOT_ENOUGH_SPACE (-1 = 해제)
+void nativeNvsFailAfter(long writes);
+
+// 파일시스템 (LittleFS): 호스트 디렉터리를 루트로 지정 (기본 $TMPDIR/native_littlefs)
+void nativeFsSetRoot(const char *dir);
+// 앞으로 bytes 만 더 쓰고 그 뒤 쓰기는 잘린다 (전원 차단 흉내, -1 = 해제)
+void nativeFsFailAfter(long bytes);
+
+#endif // NATIVE_HOST_HPP
@@ -0,0 +1,744 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+#include <esp_sleep.h>
+#include <freertos/queue.h>
+#include "native_host.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+// ===========================================
+// 할당 카운터
+// ===========================================
+static std::atomic<uint64_t> s_allocCount(0);
+static std::atomic<uint64_t> s_allocBytes(0);
+static thread_local bool t_allocExcluded = false;
+
+static inline void countAlloc(size_t size)
+{
+    if (t_allocExcluded)
+    {
+        return;
+    }
+    s_allocCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+uint64_t nativeAllocCount()
+{
+    return s_allocCount.load(std::memory_order_relaxed);
+}
+
+uint64_t nativeAllocBytes()
+{
+    return s_allocBytes.load(std::memory_order_relaxed);
+}
+
+void nativeAllocExcludeThread()
+{
+    t_allocExcluded = true;
+}
+
+void *operator new(size_t size)
+{
+    countAlloc(size);
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    countAlloc(size);
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// ===========================================
+// 전역 객체
+// ===========================================
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+WiFiClass WiFi;
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+// ===========================================
+// String
+// ===========================================
+bool String::equalsIgnoreCase(const String &str) const
+{
+    if (m_str.size() != str.m_str.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < m_str.size(); i++)
+    {
+        if (tolower((unsigned char)m_str[i]) != tolower((unsigned char)str.m_str[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t pos = m_str.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &str, unsigned int from) const
+{
+    size_t pos = m_str.find(str.m_str, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const
+{
+    size_t pos = m_str.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    size_t pos = m_str.rfind(str.m_str);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return m_str.size() >= suffix.m_str.size() &&
+           m_str.compare(m_str.size() - suffix.m_str.size(), suffix.m_str.size(), suffix.m_str) == 0;
+}
+
+String String::substring(unsigned int begin) const
+{
+    return substring(begin, (unsigned int)m_str.size());
+}
+
+String String::substring(unsigned int begin, unsigned int end) const
+{
+    if (begin > end)
+    {
+        std::swap(begin, end);
+    }
+    if (begin >= m_str.size())
+    {
+        return String();
+    }
+    if (end > m_str.size())
+    {
+        end = (unsigned int)m_str.size();
+    }
+    return String(m_str.substr(begin, end - begin));
+}
+
+void String::replace(char find, char with)
+{
+    std::replace(m_str.begin(), m_str.end(), find, with);
+}
+
+void String::replace(const String &find, const String &with)
+{
+    if (find.m_str.empty())
+    {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = m_str.find(find.m_str, pos)) != std::string::npos)
+    {
+        m_str.replace(pos, find.m_str.size(), with.m_str);
+        pos += with.m_str.size();
+    }
+}
+
+void String::remove(unsigned int index)
+{
+    if (index < m_str.size())
+    {
+        m_str.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < m_str.size())
+    {
+        m_str.erase(index, count);
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : m_str)
+    {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : m_str)
+    {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::trim()
+{
+    size_t begin = 0;
+    while (begin < m_str.size() && isspace((unsigned char)m_str[begin]))
+    {
+        begin++;
+    }
+    size_t end = m_str.size();
+    while (end > begin && isspace((unsigned char)m_str[end - 1]))
+    {
+        end--;
+    }
+    m_str = m_str.substr(begin, end - begin);
+}
+
+void String::fromSigned(long long value, unsigned char base)
+{
+    if (value < 0 && base == 10)
+    {
+        fromUnsigned((unsigned long long)(-(value + 1)) + 1, base);
+        m_str.insert(m_str.begin(), '-');
+        return;
+    }
+    fromUnsigned((unsigned long long)value, base);
+}
+
+void String::fromUnsigned(unsigned long long value, unsigned char base)
+{
+    if (base < 2 || base > 36)
+    {
+        base = 10;
+    }
+    char buf[65];
+    int pos = 64;
+    buf[pos] = '\0';
+    do
+    {
+        int digit = (int)(value % base);
+        buf[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value);
+    m_str = &buf[pos];
+}
+
+void String::fromDouble(double value, unsigned int decimals)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    m_str = buf;
+}
+
+// ===========================================
+// Print
+// ===========================================
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        if (!write(*buffer++))
+        {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char stackBuf[128];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuf, sizeof(stackBuf), format, args);
+    va_end(args);
+    if (len < 0)
+    {
+        return 0;
+    }
+    if ((size_t)len < sizeof(stackBuf))
+    {
+        return write((const uint8_t *)stackBuf, len);
+    }
+
+    std::string heapBuf(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&heapBuf[0], heapBuf.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)heapBuf.data(), len);
+}
+
+// ===========================================
+// Serial
+// ===========================================
+// 전역 생성자와 종료 중인 분리 스레드에서도 쓰이므로 해제하지 않는다
+struct SerialState
+{
+    std::mutex lock;
+    std::deque<uint8_t> rx;
+    bool capture = false;
+    std::string tx;
+};
+
+static SerialState &serialState()
+{
+    static SerialState *state = new SerialState();
+    return *state;
+}
+
+int HardwareSerial::available()
+{
+    SerialState &state = serialState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return (int)state.rx.size();
+}
+
+int HardwareSerial::read()
+{
+    SerialState &state = serialState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.rx.empty())
+    {
+        return -1;
+    }
+    uint8_t c = state.rx.front();
+    state.rx.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    SerialState &state = serialState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.capture)
+    {
+        state.tx.append((const char *)buffer, size);
+        return size;
+    }
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void nativeSerialInput(const uint8_t *data, size_t len)
+{
+    SerialState &state = serialState();
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.rx.insert(state.rx.end(), data, data + len);
+    }
+    if (Serial.m_onReceive)
+    {
+        Serial.m_onReceive();
+    }
+}
+
+void nativeSerialCapture(bool enabled)
+{
+    SerialState &state = serialState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.capture = enabled;
+    state.tx.clear();
+}
+
+String nativeSerialTakeOutput()
+{
+    SerialState &state = serialState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    String out(state.tx.data(), state.tx.size());
+    state.tx.clear();
+    return out;
+}
+
+// ===========================================
+// 시간
+// ===========================================
+// 전역 생성자에서 불려도 되도록 첫 호출 시각을 부팅 시각으로 본다
+static std::chrono::steady_clock::time_point bootTime()
+{
+    static const auto boot = std::chrono::steady_clock::now();
+    return boot;
+}
+
+static std::atomic<uint32_t> s_timeOffsetMs(0);
+
+void nativeTimeAdvance(uint32_t ms)
+{
+    s_timeOffsetMs.fetch_add(ms);
+}
+
+// ESP32 와 같이 32비트에서 넘어간다
+unsigned long millis()
+{
+    return (unsigned long)(uint32_t)(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime()).count() + s_timeOffsetMs.load());
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(uint32_t)(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime()).count() + (uint64_t)s_timeOffsetMs.load() * 1000);
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// ===========================================
+// FreeRTOS
+// ===========================================
+// 태스크 = 분리된 스레드 + 알림 카운터
+struct NativeTask
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+};
+
+static thread_local NativeTask *t_currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char *name, uint32_t stackSize, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    NativeTask *task = new NativeTask();
+    std::thread([task, entry, arg]() {
+        t_currentTask = task;
+        entry(arg);
+    }).detach();
+    if (handle)
+    {
+        *handle = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    // 태스크 함수가 반환하면 스레드도 끝난다
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    if (!t_currentTask)
+    {
+        // 메인 스레드처럼 xTaskCreatePinnedToCore 로 만들지 않은 스레드
+        t_currentTask = new NativeTask();
+    }
+    return t_currentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+    NativeTask *task = static_cast<NativeTask *>(handle);
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notify++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    NativeTask *task = static_cast<NativeTask *>(xTaskGetCurrentTaskHandle());
+    std::unique_lock<std::mutex> guard(task->lock);
+    auto ready = [task]() { return task->notify > 0; };
+    if (ticks == portMAX_DELAY)
+    {
+        task->cv.wait(guard, ready);
+    }
+    else
+    {
+        task->cv.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+    }
+
+    uint32_t count = task->notify;
+    if (count > 0)
+    {
+        task->notify = clearOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+// 큐: 고정 크기 항목을 복사해서 보관
+struct NativeQueue
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    size_t length;
+    size_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+template <typename Pred>
+static bool waitFor(std::condition_variable &cv, std::unique_lock<std::mutex> &guard, TickType_t ticks, Pred pred)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        cv.wait(guard, pred);
+        return true;
+    }
+    return cv.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), pred);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    NativeQueue *queue = new NativeQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void *item, TickType_t ticks)
+{
+    NativeQueue *queue = static_cast<NativeQueue *>(handle);
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue->cv, guard, ticks, [queue]() { return queue->items.size() < queue->length; }))
+    {
+        return pdFALSE;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(item);
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void *item, TickType_t ticks)
+{
+    NativeQueue *queue = static_cast<NativeQueue *>(handle);
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue->cv, guard, ticks, [queue]() { return !queue->items.empty(); }))
+    {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->cv.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle)
+{
+    NativeQueue *queue = static_cast<NativeQueue *>(handle);
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return (UBaseType_t)queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t handle)
+{
+    delete static_cast<NativeQueue *>(handle);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new std::timed_mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    std::timed_mutex *mutex = static_cast<std::timed_mutex *>(semaphore);
+    if (ticks == portMAX_DELAY)
+    {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    static_cast<std::timed_mutex *>(semaphore)->unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete static_cast<std::timed_mutex *>(semaphore);
+}
+
+// ===========================================
+// ESP / PSRAM
+// 호스트 메모리는 8MB PSRAM 보드처럼 보고한다
+// ===========================================
+static const uint32_t HOST_HEAP_SIZE = 320 * 1024;
+static const uint32_t HOST_PSRAM_SIZE = 8 * 1024 * 1024;
+
+bool psramFound()
+{
+    return true;
+}
+
+void *ps_malloc(size_t size)
+{
+    countAlloc(size);
+    return malloc(size);
+}
+
+void *ps_calloc(size_t count, size_t size)
+{
+    countAlloc(count * size);
+    return calloc(count, size);
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    countAlloc(size);
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t count, size_t size, uint32_t caps)
+{
+    countAlloc(count * size);
+    return calloc(count, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? HOST_PSRAM_SIZE : HOST_HEAP_SIZE;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+uint32_t EspClass::getFreeHeap() { return HOST_HEAP_SIZE; }
+uint32_t EspClass::getHeapSize() { return HOST_HEAP_SIZE; }
+uint32_t EspClass::getPsramSize() { return HOST_PSRAM_SIZE; }
+uint32_t EspClass::getFreePsram() { return HOST_PSRAM_SIZE; }
+uint64_t EspClass::getEfuseMac() { return 0x0000AABBCCDDEEFFULL; }
+
+void EspClass::restart()
+{
+    fflush(stdout);
+    exit(0);
+}
+
+// ===========================================
+// ESP-IDF 시스템 / sleep / ROM
+// ===========================================
+esp_reset_reason_t esp_reset_reason()
+{
+    return ESP_RST_POWERON;
+}
+
+uint32_t esp_random()
+{
+    static std::mutex lock;
+    static std::mt19937 rng(std::random_device{}());
+    std::lock_guard<std::mutex> guard(lock);
+    return rng();
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs)
+{
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start()
+{
+    fflush(stdout);
+    exit(0);
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// ===========================================
+// IPAddress
+// ===========================================
+bool IPAddress::fromString(const char *address)
+{
+    unsigned int parts[4];
+    char tail;
+    if (!address || sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4)
+    {
+        return false;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        if (parts[i] > 255)
+        {
+            return false;
+        }
+        m_bytes[i] = (uint8_t)parts[i];
+    }
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", m_bytes[0], m_bytes[1], m_bytes[2], m_bytes[3]);
+    return String(buf);
+}
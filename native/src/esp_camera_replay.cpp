@@ -0,0 +1,389 @@
+#include <esp_camera.h>
+#include <img_converters.h>
+#include <Arduino.h>
+#include "native_host.hpp"
+
+#include <atomic>
+#include <dirent.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 호스트 카메라: JPEG 파일을 순서대로 돌려주는 재생 드라이버
+// 실제 드라이버처럼 fb_count 개의 버퍼만 있고, 모두 대여 중이면 fb_get 이 실패한다.
+
+const resolution_info_t resolution[FRAMESIZE_INVALID] = {
+    {96, 96},     // 96X96
+    {160, 120},   // QQVGA
+    {176, 144},   // QCIF
+    {240, 176},   // HQVGA
+    {240, 240},   // 240X240
+    {320, 240},   // QVGA
+    {400, 296},   // CIF
+    {480, 320},   // HVGA
+    {640, 480},   // VGA
+    {800, 600},   // SVGA
+    {1024, 768},  // XGA
+    {1280, 720},  // HD
+    {1280, 1024}, // SXGA
+    {1600, 1200}, // UXGA
+};
+
+struct ReplayFrame
+{
+    std::vector<uint8_t> data;
+    uint16_t width;
+    uint16_t height;
+};
+
+struct ReplaySlot
+{
+    camera_fb_t fb;
+    std::vector<uint8_t> buffer;
+    bool inUse;
+};
+
+// 파이프라인 태스크(스레드)가 종료 시점에도 프레임을 돌려주므로 컨테이너는 소멸시키지 않는다
+static std::mutex &s_camLock = *new std::mutex();
+static bool s_initialized = false;
+static sensor_t s_sensor;
+static std::vector<ReplayFrame> &s_frames = *new std::vector<ReplayFrame>();
+static size_t s_nextFrame = 0;
+static std::vector<ReplaySlot> &s_slots = *new std::vector<ReplaySlot>();
+static float s_fps = 0;
+static unsigned long s_nextDueUs = 0;
+static uint32_t s_synthSeed = 1;
+
+// ===========================================
+// 파일 로드
+// ===========================================
+
+// SOF0/SOF2 마커에서 크기를 읽는다 (찾지 못하면 false)
+static bool parseJpegSize(const std::vector<uint8_t> &data, uint16_t &width, uint16_t &height)
+{
+    size_t i = 2;
+    while (i + 9 < data.size())
+    {
+        if (data[i] != 0xFF)
+        {
+            return false;
+        }
+        uint8_t marker = data[i + 1];
+        size_t segLen = ((size_t)data[i + 2] << 8) | data[i + 3];
+        if (marker == 0xC0 || marker == 0xC2)
+        {
+            height = (uint16_t)((data[i + 5] << 8) | data[i + 6]);
+            width = (uint16_t)((data[i + 7] << 8) | data[i + 8]);
+            return true;
+        }
+        i += 2 + segLen;
+    }
+    return false;
+}
+
+static bool endsWithJpeg(const std::string &name)
+{
+    std::string lower = name;
+    for (char &c : lower)
+    {
+        c = (char)tolower((unsigned char)c);
+    }
+    return (lower.size() > 4 && lower.compare(lower.size() - 4, 4, ".jpg") == 0) ||
+           (lower.size() > 5 && lower.compare(lower.size() - 5, 5, ".jpeg") == 0);
+}
+
+bool nativeCameraReplay(const char *dir, float fps)
+{
+    std::lock_guard<std::mutex> guard(s_camLock);
+    s_fps = fps > 0 ? fps : 0;
+    s_frames.clear();
+    s_nextFrame = 0;
+
+    if (!dir || !*dir)
+    {
+        return true;   // 합성 프레임
+    }
+
+    DIR *d = opendir(dir);
+    if (!d)
+    {
+        return false;
+    }
+    std::vector<std::string> names;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != nullptr)
+    {
+        if (endsWithJpeg(entry->d_name))
+        {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (const std::string &name : names)
+    {
+        std::string path = std::string(dir) + "/" + name;
+        FILE *f = fopen(path.c_str(), "rb");
+        if (!f)
+        {
+            continue;
+        }
+        ReplayFrame frame;
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        frame.data.resize(size > 0 ? (size_t)size : 0);
+        size_t n = fread(frame.data.data(), 1, frame.data.size(), f);
+        fclose(f);
+        if (n != frame.data.size() || n < 4 || frame.data[0] != 0xFF || frame.data[1] != 0xD8 ||
+            !parseJpegSize(frame.data, frame.width, frame.height))
+        {
+            Serial.printf("Skip %s (not a baseline JPEG)\n", path.c_str());
+            continue;
+        }
+        s_frames.push_back(std::move(frame));
+    }
+    return !s_frames.empty();
+}
+
+int nativeCameraFrameCount()
+{
+    std::lock_guard<std::mutex> guard(s_camLock);
+    return (int)s_frames.size();
+}
+
+// ===========================================
+// 합성 프레임
+// 크기는 화소 수 / 품질 값에 비례 (실제 OV2640 출력과 대략 같은 범위)
+// ===========================================
+static void makeSynthetic(ReplaySlot &slot)
+{
+    framesize_t size = s_sensor.status.framesize;
+    uint16_t width = resolution[size].width;
+    uint16_t height = resolution[size].height;
+    int quality = s_sensor.status.quality > 0 ? s_sensor.status.quality : 12;
+    size_t len = (size_t)width * height / quality + 620;
+
+    static const uint8_t HEADER[] = {
+        0xFF, 0xD8,                                     // SOI
+        0xFF, 0xC0, 0x00, 0x11, 0x08,                   // SOF0, 8bit
+    };
+    slot.buffer.resize(len);
+    uint8_t *p = slot.buffer.data();
+    memcpy(p, HEADER, sizeof(HEADER));
+    p[7] = (uint8_t)(height >> 8);
+    p[8] = (uint8_t)height;
+    p[9] = (uint8_t)(width >> 8);
+    p[10] = (uint8_t)width;
+    for (size_t i = 11; i < len - 2; i++)
+    {
+        s_synthSeed = s_synthSeed * 1103515245u + 12345u;
+        uint8_t b = (uint8_t)(s_synthSeed >> 16);
+        p[i] = b == 0xFF ? 0xFE : b;
+    }
+    p[len - 2] = 0xFF;                                  // EOI
+    p[len - 1] = 0xD9;
+
+    slot.fb.width = width;
+    slot.fb.height = height;
+    slot.fb.len = len;
+}
+
+// ===========================================
+// 센서
+// ===========================================
+// set_*() 한 번 = SCCB 쓰기 (드라이버처럼 성공하면 상태 갱신)
+static std::atomic<uint32_t> s_sensorWrites(0);
+
+static int sensorSetFramesize(sensor_t *s, framesize_t size)
+{
+    if (size >= FRAMESIZE_INVALID)
+    {
+        return -1;
+    }
+    s->status.framesize = size;
+    s_sensorWrites++;
+    return 0;
+}
+
+static int sensorSetQuality(sensor_t *s, int quality) { s->status.quality = quality; s_sensorWrites++; return 0; }
+static int sensorSetBrightness(sensor_t *s, int level) { s->status.brightness = level; s_sensorWrites++; return 0; }
+static int sensorSetContrast(sensor_t *s, int level) { s->status.contrast = level; s_sensorWrites++; return 0; }
+static int sensorSetSaturation(sensor_t *s, int level) { s->status.saturation = level; s_sensorWrites++; return 0; }
+static int sensorSetSpecialEffect(sensor_t *s, int effect) { s->status.special_effect = effect; s_sensorWrites++; return 0; }
+static int sensorSetWhitebal(sensor_t *s, int enable) { s->status.awb = enable; s_sensorWrites++; return 0; }
+static int sensorSetAwbGain(sensor_t *s, int enable) { s->status.awb_gain = enable; s_sensorWrites++; return 0; }
+static int sensorSetWbMode(sensor_t *s, int mode) { s->status.wb_mode = mode; s_sensorWrites++; return 0; }
+static int sensorSetExposureCtrl(sensor_t *s, int enable) { s->status.aec = enable; s_sensorWrites++; return 0; }
+static int sensorSetAec2(sensor_t *s, int enable) { s->status.aec2 = enable; s_sensorWrites++; return 0; }
+static int sensorSetAeLevel(sensor_t *s, int level) { s->status.ae_level = level; s_sensorWrites++; return 0; }
+static int sensorSetAecValue(sensor_t *s, int value) { s->status.aec_value = value; s_sensorWrites++; return 0; }
+static int sensorSetGainCtrl(sensor_t *s, int enable) { s->status.agc = enable; s_sensorWrites++; return 0; }
+static int sensorSetAgcGain(sensor_t *s, int gain) { s->status.agc_gain = gain; s_sensorWrites++; return 0; }
+static int sensorSetGainceiling(sensor_t *s, gainceiling_t value) { s->status.gainceiling = value; s_sensorWrites++; return 0; }
+static int sensorSetBpc(sensor_t *s, int enable) { s->status.bpc = enable; s_sensorWrites++; return 0; }
+static int sensorSetWpc(sensor_t *s, int enable) { s->status.wpc = enable; s_sensorWrites++; return 0; }
+static int sensorSetRawGma(sensor_t *s, int enable) { s->status.raw_gma = enable; s_sensorWrites++; return 0; }
+static int sensorSetLenc(sensor_t *s, int enable) { s->status.lenc = enable; s_sensorWrites++; return 0; }
+static int sensorSetHmirror(sensor_t *s, int enable) { s->status.hmirror = enable; s_sensorWrites++; return 0; }
+static int sensorSetVflip(sensor_t *s, int enable) { s->status.vflip = enable; s_sensorWrites++; return 0; }
+static int sensorSetDcw(sensor_t *s, int enable) { s->status.dcw = enable; s_sensorWrites++; return 0; }
+static int sensorSetColorbar(sensor_t *s, int enable) { s->status.colorbar = enable; s_sensorWrites++; return 0; }
+static int sensorGetReg(sensor_t *s, int reg, int mask) { return 0; }
+static int sensorSetReg(sensor_t *s, int reg, int mask, int value) { s_sensorWrites++; return 0; }
+
+uint32_t nativeSensorWrites()
+{
+    return s_sensorWrites.load();
+}
+
+static void initSensor()
+{
+    memset(&s_sensor, 0, sizeof(s_sensor));
+    s_sensor.id.PID = 0x26;   // OV2640
+
+    // OV2640 리셋 직후 상태 (드라이버 init_status 가 레지스터에서 읽는 값)
+    s_sensor.status.awb = 1;
+    s_sensor.status.awb_gain = 1;
+    s_sensor.status.aec = 1;
+    s_sensor.status.agc = 1;
+    s_sensor.status.aec_value = 600;
+    s_sensor.status.wpc = 1;
+    s_sensor.status.raw_gma = 1;
+    s_sensor.status.lenc = 1;
+    s_sensor.status.dcw = 1;
+
+    s_sensor.set_framesize = sensorSetFramesize;
+    s_sensor.set_quality = sensorSetQuality;
+    s_sensor.set_brightness = sensorSetBrightness;
+    s_sensor.set_contrast = sensorSetContrast;
+    s_sensor.set_saturation = sensorSetSaturation;
+    s_sensor.set_special_effect = sensorSetSpecialEffect;
+    s_sensor.set_whitebal = sensorSetWhitebal;
+    s_sensor.set_awb_gain = sensorSetAwbGain;
+    s_sensor.set_wb_mode = sensorSetWbMode;
+    s_sensor.set_exposure_ctrl = sensorSetExposureCtrl;
+    s_sensor.set_aec2 = sensorSetAec2;
+    s_sensor.set_ae_level = sensorSetAeLevel;
+    s_sensor.set_aec_value = sensorSetAecValue;
+    s_sensor.set_gain_ctrl = sensorSetGainCtrl;
+    s_sensor.set_agc_gain = sensorSetAgcGain;
+    s_sensor.set_gainceiling = sensorSetGainceiling;
+    s_sensor.set_bpc = sensorSetBpc;
+    s_sensor.set_wpc = sensorSetWpc;
+    s_sensor.set_raw_gma = sensorSetRawGma;
+    s_sensor.set_lenc = sensorSetLenc;
+    s_sensor.set_hmirror = sensorSetHmirror;
+    s_sensor.set_vflip = sensorSetVflip;
+    s_sensor.set_dcw = sensorSetDcw;
+    s_sensor.set_colorbar = sensorSetColorbar;
+    s_sensor.get_reg = sensorGetReg;
+    s_sensor.set_reg = sensorSetReg;
+}
+
+// ===========================================
+// 드라이버 API
+// ===========================================
+esp_err_t esp_camera_init(const camera_config_t *config)
+{
+    std::lock_guard<std::mutex> guard(s_camLock);
+    initSensor();
+    s_sensor.status.framesize = config->frame_size;
+    s_sensor.status.quality = config->jpeg_quality;
+
+    s_slots.clear();
+    s_slots.resize(config->fb_count > 0 ? config->fb_count : 1);
+    for (ReplaySlot &slot : s_slots)
+    {
+        memset(&slot.fb, 0, sizeof(slot.fb));
+        slot.fb.format = PIXFORMAT_JPEG;
+        slot.inUse = false;
+    }
+    s_nextDueUs = micros();
+    s_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_camera_deinit()
+{
+    std::lock_guard<std::mutex> guard(s_camLock);
+    s_slots.clear();
+    s_initialized = false;
+    return ESP_OK;
+}
+
+camera_fb_t *esp_camera_fb_get()
+{
+    // 설정된 fps 에 맞춰 다음 프레임 시각까지 대기 (잠금 밖에서)
+    if (s_fps > 0)
+    {
+        unsigned long periodUs = (unsigned long)(1000000.0f / s_fps);
+        long waitUs = (long)(s_nextDueUs - micros());
+        if (waitUs > 0)
+        {
+            delayMicroseconds((uint32_t)waitUs);
+        }
+        // 뒤처졌으면 밀린 프레임을 몰아서 내지 않고 현재 시각부터 다시 센다
+        s_nextDueUs = waitUs > -(long)periodUs ? s_nextDueUs + periodUs : micros() + periodUs;
+    }
+
+    std::lock_guard<std::mutex> guard(s_camLock);
+    if (!s_initialized)
+    {
+        return nullptr;
+    }
+
+    ReplaySlot *slot = nullptr;
+    for (ReplaySlot &candidate : s_slots)
+    {
+        if (!candidate.inUse)
+        {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (!slot)
+    {
+        return nullptr;   // 모든 버퍼 대여 중
+    }
+
+    if (s_frames.empty())
+    {
+        makeSynthetic(*slot);
+    }
+    else
+    {
+        const ReplayFrame &frame = s_frames[s_nextFrame];
+        s_nextFrame = (s_nextFrame + 1) % s_frames.size();
+        slot->buffer.assign(frame.data.begin(), frame.data.end());
+        slot->fb.width = frame.width;
+        slot->fb.height = frame.height;
+        slot->fb.len = frame.data.size();
+    }
+
+    unsigned long now = micros();
+    slot->fb.buf = slot->buffer.data();
+    slot->fb.timestamp.tv_sec = now / 1000000;
+    slot->fb.timestamp.tv_usec = now % 1000000;
+    slot->inUse = true;
+    return &slot->fb;
+}
+
+void esp_camera_fb_return(camera_fb_t *fb)
+{
+    std::lock_guard<std::mutex> guard(s_camLock);
+    for (ReplaySlot &slot : s_slots)
+    {
+        if (&slot.fb == fb)
+        {
+            slot.inUse = false;
+            return;
+        }
+    }
+}
+
+sensor_t *esp_camera_sensor_get()
+{
+    return s_initialized ? &s_sensor : nullptr;
+}
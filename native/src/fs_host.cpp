@@ -0,0 +1,389 @@
+#include <FS.h>
+#include <LittleFS.h>
+#include "native_host.hpp"
+
+#include <atomic>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 호스트 파일시스템
+// 경로는 FS 루트 기준 ("/spool/1.seg" → <root>/spool/1.seg)
+
+// 남은 쓰기 바이트 (-1 = 제한 없음), 모든 File 이 공유
+static std::atomic<long> s_writeBudget(-1);
+
+void nativeFsFailAfter(long bytes)
+{
+    s_writeBudget.store(bytes);
+}
+
+namespace fs
+{
+
+struct FileHandle
+{
+    FILE *file = nullptr;
+    DIR *dir = nullptr;
+    std::string hostPath;
+    std::string path;
+    std::string name;
+
+    ~FileHandle()
+    {
+        if (file)
+        {
+            fclose(file);
+        }
+        if (dir)
+        {
+            closedir(dir);
+        }
+    }
+};
+
+static std::string baseName(const std::string &path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    if (!m_handle || !m_handle->file)
+    {
+        return 0;
+    }
+
+    // 전원 차단 흉내: 남은 만큼만 쓰고 나머지는 버린다
+    long budget = s_writeBudget.load();
+    if (budget >= 0)
+    {
+        if ((long)size > budget)
+        {
+            size = (size_t)budget;
+        }
+        s_writeBudget.store(budget - (long)size);
+    }
+    return fwrite(buffer, 1, size, m_handle->file);
+}
+
+int File::available()
+{
+    if (!m_handle || !m_handle->file)
+    {
+        return 0;
+    }
+    long remain = (long)size() - (long)position();
+    return remain > 0 ? (int)remain : 0;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    if (!m_handle || !m_handle->file)
+    {
+        return 0;
+    }
+    return fread(buffer, 1, size, m_handle->file);
+}
+
+bool File::seek(uint32_t pos)
+{
+    return m_handle && m_handle->file && fseek(m_handle->file, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const
+{
+    if (!m_handle || !m_handle->file)
+    {
+        return 0;
+    }
+    long pos = ftell(m_handle->file);
+    return pos > 0 ? (size_t)pos : 0;
+}
+
+size_t File::size() const
+{
+    if (!m_handle)
+    {
+        return 0;
+    }
+    if (m_handle->file)
+    {
+        fflush(m_handle->file);
+    }
+    struct stat st;
+    return stat(m_handle->hostPath.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush()
+{
+    if (m_handle && m_handle->file)
+    {
+        fflush(m_handle->file);
+    }
+}
+
+void File::close()
+{
+    m_handle.reset();
+}
+
+bool File::isDirectory() const
+{
+    return m_handle && m_handle->dir;
+}
+
+const char *File::name() const
+{
+    return m_handle ? m_handle->name.c_str() : "";
+}
+
+const char *File::path() const
+{
+    return m_handle ? m_handle->path.c_str() : "";
+}
+
+File File::openNextFile(const char *mode)
+{
+    if (!m_handle || !m_handle->dir)
+    {
+        return File();
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(m_handle->dir)) != nullptr)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        std::string path = m_handle->path;
+        if (path.empty() || path.back() != '/')
+        {
+            path += '/';
+        }
+        path += entry->d_name;
+
+        std::shared_ptr<FileHandle> handle = std::make_shared<FileHandle>();
+        handle->path = path;
+        handle->name = entry->d_name;
+        handle->hostPath = m_handle->hostPath + "/" + entry->d_name;
+
+        struct stat st;
+        if (stat(handle->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+        {
+            handle->dir = opendir(handle->hostPath.c_str());
+        }
+        else
+        {
+            handle->file = fopen(handle->hostPath.c_str(), "rb");
+        }
+        return File(handle);
+    }
+    return File();
+}
+
+File::operator bool() const
+{
+    return m_handle && (m_handle->file || m_handle->dir);
+}
+
+std::string FS::hostPath(const char *path) const
+{
+    std::string full = m_root;
+    if (path && path[0] != '/')
+    {
+        full += '/';
+    }
+    if (path)
+    {
+        full += path;
+    }
+    while (full.size() > 1 && full.back() == '/')
+    {
+        full.pop_back();
+    }
+    return full;
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+    std::shared_ptr<FileHandle> handle = std::make_shared<FileHandle>();
+    handle->hostPath = hostPath(path);
+    handle->path = path ? path : "/";
+    handle->name = baseName(handle->path);
+
+    struct stat st;
+    bool exists = stat(handle->hostPath.c_str(), &st) == 0;
+    if (exists && S_ISDIR(st.st_mode))
+    {
+        handle->dir = opendir(handle->hostPath.c_str());
+        return File(handle);
+    }
+
+    // Arduino FS 모드: "r", "w" (자르고 새로), "a" (이어 쓰기), "r+"/"w+"/"a+"
+    std::string fmode = mode ? mode : "r";
+    if (fmode.find('b') == std::string::npos)
+    {
+        fmode += 'b';
+    }
+    if (fmode[0] == 'r' && !exists)
+    {
+        return File();
+    }
+    handle->file = fopen(handle->hostPath.c_str(), fmode.c_str());
+    return handle->file ? File(handle) : File();
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return ::unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool FS::rmdir(const char *path)
+{
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+// ===========================================
+// LittleFS
+// ===========================================
+static std::string defaultRoot()
+{
+    const char *tmp = getenv("TMPDIR");
+    return std::string(tmp && tmp[0] ? tmp : "/tmp") + "/native_littlefs";
+}
+
+LittleFSFS::LittleFSFS() : FS(defaultRoot())
+{
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+    struct stat st;
+    if (stat(m_root.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        m_mounted = true;
+    }
+    else if (formatOnFail)
+    {
+        m_mounted = format();
+    }
+    return m_mounted;
+}
+
+static void removeTree(const std::string &path)
+{
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+    {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+        std::string child = path + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+        {
+            removeTree(child);
+            ::rmdir(child.c_str());
+        }
+        else
+        {
+            ::unlink(child.c_str());
+        }
+    }
+    closedir(dir);
+}
+
+// 루트 디렉터리를 비운다 (없으면 만든다)
+bool LittleFSFS::format()
+{
+    removeTree(m_root);
+    ::mkdir(m_root.c_str(), 0755);
+    struct stat st;
+    return stat(m_root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+size_t LittleFSFS::totalBytes()
+{
+    return PARTITION_SIZE;
+}
+
+static size_t treeBytes(const std::string &path)
+{
+    size_t total = 0;
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+    {
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        {
+            continue;
+        }
+        std::string child = path + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) == 0)
+        {
+            total += S_ISDIR(st.st_mode) ? treeBytes(child) : (size_t)st.st_size;
+        }
+    }
+    closedir(dir);
+    return total;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+    return m_mounted ? treeBytes(m_root) : 0;
+}
+
+void LittleFSFS::end()
+{
+    m_mounted = false;
+}
+
+} // namespace fs
+
+fs::LittleFSFS LittleFS;
+
+// 마운트 해제 상태가 되므로 다시 begin() 해야 한다
+void nativeFsSetRoot(const char *dir)
+{
+    LittleFS.m_mounted = false;
+    LittleFS.m_root = dir;
+}
@@ -0,0 +1,483 @@
+#include <img_converters.h>
+
+#include <string.h>
+#include <vector>
+
+// 호스트 jpg2rgb565: 1/8 스케일(JPG_SCALE_8X)만 지원하는 baseline JPEG DC 디코더
+// 펌웨어의 1/8 디코드처럼 8x8 블록의 DC 계수만 써서 블록당 픽셀 하나를 만든다.
+// AC 계수는 허프만 부호만 읽고 버린다 (IDCT 없음). progressive/산술 부호는 실패.
+// 출력은 RGB565, 픽셀당 상위 바이트 먼저 (esp32-camera 와 같음).
+
+namespace
+{
+
+struct HuffTable
+{
+    bool defined = false;
+    int maxCode[18];
+    int valPtr[17];
+    int minCode[17];
+    uint8_t values[256];
+};
+
+struct Component
+{
+    uint8_t id;
+    int h;
+    int v;
+    int tq;
+    int td;
+    int ta;
+    int pred;
+    int blocksW;                // 블록 단위 평면 크기 (MCU 경계까지)
+    int blocksH;
+    std::vector<uint8_t> plane;   // 블록 평균값 (0~255)
+};
+
+class BitReader
+{
+private:
+    const uint8_t *m_data;
+    size_t m_len;
+    size_t m_pos;
+    uint32_t m_bits = 0;
+    int m_count = 0;
+    bool m_marker = false;   // 엔트로피 데이터 끝의 마커에 도달
+
+public:
+    BitReader(const uint8_t *data, size_t len, size_t pos) : m_data(data), m_len(len), m_pos(pos) {}
+
+    inline size_t pos() const { return m_pos; }
+
+    int bit()
+    {
+        if (m_count == 0)
+        {
+            uint8_t byte = 0;
+            if (!m_marker && m_pos < m_len)
+            {
+                byte = m_data[m_pos];
+                if (byte == 0xFF)
+                {
+                    uint8_t next = m_pos + 1 < m_len ? m_data[m_pos + 1] : 0xD9;
+                    if (next == 0x00)
+                    {
+                        m_pos += 2;
+                    }
+                    else
+                    {
+                        // 마커 앞에서 멈추고 0 을 채움
+                        m_marker = true;
+                        byte = 0;
+                    }
+                }
+                else
+                {
+                    m_pos++;
+                }
+            }
+            m_bits = byte;
+            m_count = 8;
+        }
+        m_count--;
+        return (m_bits >> m_count) & 1;
+    }
+
+    int bits(int n)
+    {
+        int v = 0;
+        for (int i = 0; i < n; i++)
+        {
+            v = (v << 1) | bit();
+        }
+        return v;
+    }
+
+    // RSTn 마커를 건너뛰고 바이트 경계에서 다시 시작
+    bool restart()
+    {
+        m_count = 0;
+        m_marker = false;
+        if (m_pos + 1 < m_len && m_data[m_pos] == 0xFF && m_data[m_pos + 1] >= 0xD0 && m_data[m_pos + 1] <= 0xD7)
+        {
+            m_pos += 2;
+            return true;
+        }
+        return false;
+    }
+};
+
+static bool buildTable(HuffTable &table, const uint8_t *counts, const uint8_t *symbols, int total)
+{
+    if (total > 256)
+    {
+        return false;
+    }
+    memcpy(table.values, symbols, total);
+
+    int code = 0;
+    int k = 0;
+    for (int len = 1; len <= 16; len++)
+    {
+        table.valPtr[len] = k;
+        table.minCode[len] = code;
+        code += counts[len - 1];
+        k += counts[len - 1];
+        table.maxCode[len] = counts[len - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    table.maxCode[17] = 0x7FFFFFFF;
+    table.defined = true;
+    return true;
+}
+
+static int decodeSymbol(BitReader &reader, const HuffTable &table)
+{
+    int code = 0;
+    for (int len = 1; len <= 16; len++)
+    {
+        code = (code << 1) | reader.bit();
+        if (table.maxCode[len] >= 0 && code <= table.maxCode[len])
+        {
+            return table.values[table.valPtr[len] + code - table.minCode[len]];
+        }
+    }
+    return -1;
+}
+
+static inline int extend(int v, int size)
+{
+    return v < (1 << (size - 1)) ? v - (1 << size) + 1 : v;
+}
+
+static inline uint8_t clamp255(int v)
+{
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// 블록 하나: DC 는 예측값을 갱신하고, AC 는 부호만 소비
+static bool decodeBlock(BitReader &reader, Component &c, const HuffTable &dc, const HuffTable &ac, int quantDc, uint8_t &out)
+{
+    int size = decodeSymbol(reader, dc);
+    if (size < 0 || size > 11)
+    {
+        return false;
+    }
+    if (size > 0)
+    {
+        c.pred += extend(reader.bits(size), size);
+    }
+
+    for (int k = 1; k < 64;)
+    {
+        int rs = decodeSymbol(reader, ac);
+        if (rs < 0)
+        {
+            return false;
+        }
+        int run = rs >> 4;
+        int bitsLen = rs & 0x0F;
+        if (bitsLen == 0)
+        {
+            if (run != 15)
+            {
+                break;   // EOB
+            }
+            k += 16;
+            continue;
+        }
+        reader.bits(bitsLen);
+        k += run + 1;
+    }
+
+    // 8x8 IDCT 의 DC 항 = DC / 8 (반올림), 레벨 시프트 +128
+    int dcv = c.pred * quantDc;
+    out = clamp255(128 + (dcv >= 0 ? (dcv + 4) / 8 : -((4 - dcv) / 8)));
+    return true;
+}
+
+} // namespace
+
+bool jpg2rgb565(const uint8_t *src, size_t srcLen, uint8_t *out, jpg_scale_t scale)
+{
+    if (scale != JPG_SCALE_8X || !src || srcLen < 4 || src[0] != 0xFF || src[1] != 0xD8)
+    {
+        return false;
+    }
+
+    uint16_t quant[4][64] = {};
+    HuffTable dcTables[4];
+    HuffTable acTables[4];
+    std::vector<Component> comps;
+    int width = 0;
+    int height = 0;
+    int restartInterval = 0;
+    std::vector<int> scanOrder;
+
+    size_t pos = 2;
+    bool scanFound = false;
+    while (!scanFound)
+    {
+        if (pos + 4 > srcLen || src[pos] != 0xFF)
+        {
+            return false;
+        }
+        uint8_t marker = src[pos + 1];
+        if (marker == 0xFF)
+        {
+            pos++;
+            continue;
+        }
+        size_t segLen = ((size_t)src[pos + 2] << 8) | src[pos + 3];
+        const uint8_t *seg = src + pos + 4;
+        size_t dataLen = segLen - 2;
+        if (segLen < 2 || pos + 2 + segLen > srcLen)
+        {
+            return false;
+        }
+
+        switch (marker)
+        {
+        case 0xDB: // DQT
+            for (size_t i = 0; i < dataLen;)
+            {
+                int precision = seg[i] >> 4;
+                int id = seg[i] & 0x0F;
+                if (id > 3)
+                {
+                    return false;
+                }
+                i++;
+                for (int k = 0; k < 64 && i < dataLen; k++)
+                {
+                    quant[id][k] = precision ? (uint16_t)((seg[i] << 8) | seg[i + 1]) : seg[i];
+                    i += precision ? 2 : 1;
+                }
+            }
+            break;
+
+        case 0xC4: // DHT
+            for (size_t i = 0; i + 17 <= dataLen;)
+            {
+                int tableClass = seg[i] >> 4;
+                int id = seg[i] & 0x0F;
+                const uint8_t *counts = seg + i + 1;
+                int total = 0;
+                for (int k = 0; k < 16; k++)
+                {
+                    total += counts[k];
+                }
+                if (id > 3 || i + 17 + total > dataLen)
+                {
+                    return false;
+                }
+                HuffTable &table = tableClass ? acTables[id] : dcTables[id];
+                if (!buildTable(table, counts, seg + i + 17, total))
+                {
+                    return false;
+                }
+                i += 17 + total;
+            }
+            break;
+
+        case 0xC0: // SOF0 baseline
+        case 0xC1: // SOF1 extended (허프만)
+        {
+            if (dataLen < 6 || seg[0] != 8)
+            {
+                return false;
+            }
+            height = (seg[1] << 8) | seg[2];
+            width = (seg[3] << 8) | seg[4];
+            int count = seg[5];
+            if (count != 1 && count != 3)
+            {
+                return false;
+            }
+            if (dataLen < 6 + (size_t)count * 3)
+            {
+                return false;
+            }
+            comps.resize(count);
+            for (int i = 0; i < count; i++)
+            {
+                comps[i].id = seg[6 + i * 3];
+                comps[i].h = seg[7 + i * 3] >> 4;
+                comps[i].v = seg[7 + i * 3] & 0x0F;
+                comps[i].tq = seg[8 + i * 3] & 0x03;
+                if (comps[i].h < 1 || comps[i].h > 4 || comps[i].v < 1 || comps[i].v > 4)
+                {
+                    return false;
+                }
+            }
+            break;
+        }
+
+        case 0xC2: // progressive 등은 지원하지 않음
+        case 0xC3:
+        case 0xC5:
+        case 0xC6:
+        case 0xC7:
+        case 0xC9:
+        case 0xCA:
+        case 0xCB:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            return false;
+
+        case 0xDD: // DRI
+            if (dataLen < 2)
+            {
+                return false;
+            }
+            restartInterval = (seg[0] << 8) | seg[1];
+            break;
+
+        case 0xDA: // SOS
+        {
+            if (comps.empty() || dataLen < 1)
+            {
+                return false;
+            }
+            int count = seg[0];
+            // 한 스캔에 모든 성분이 들어 있어야 한다 (baseline interleaved)
+            if (count != (int)comps.size() || dataLen < 1 + (size_t)count * 2)
+            {
+                return false;
+            }
+            for (int i = 0; i < count; i++)
+            {
+                uint8_t id = seg[1 + i * 2];
+                int found = -1;
+                for (int c = 0; c < (int)comps.size(); c++)
+                {
+                    if (comps[c].id == id)
+                    {
+                        found = c;
+                    }
+                }
+                if (found < 0)
+                {
+                    return false;
+                }
+                comps[found].td = seg[2 + i * 2] >> 4;
+                comps[found].ta = seg[2 + i * 2] & 0x0F;
+                if (comps[found].td > 3 || comps[found].ta > 3 ||
+                    !dcTables[comps[found].td].defined || !acTables[comps[found].ta].defined)
+                {
+                    return false;
+                }
+                scanOrder.push_back(found);
+            }
+            scanFound = true;
+            break;
+        }
+
+        case 0xD9: // EOI
+            return false;
+
+        default:
+            break;
+        }
+        pos += 2 + segLen;
+    }
+
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    int hMax = 1;
+    int vMax = 1;
+    for (const Component &c : comps)
+    {
+        hMax = c.h > hMax ? c.h : hMax;
+        vMax = c.v > vMax ? c.v : vMax;
+    }
+    // 성분이 하나면 MCU 는 블록 하나
+    if (comps.size() == 1)
+    {
+        comps[0].h = comps[0].v = hMax = vMax = 1;
+    }
+
+    int mcuW = 8 * hMax;
+    int mcuH = 8 * vMax;
+    int mcusX = (width + mcuW - 1) / mcuW;
+    int mcusY = (height + mcuH - 1) / mcuH;
+    for (Component &c : comps)
+    {
+        c.pred = 0;
+        c.blocksW = mcusX * c.h;
+        c.blocksH = mcusY * c.v;
+        c.plane.assign((size_t)c.blocksW * c.blocksH, 128);
+    }
+
+    BitReader reader(src, srcLen, pos);
+    int mcuCount = mcusX * mcusY;
+    for (int m = 0; m < mcuCount; m++)
+    {
+        if (restartInterval > 0 && m > 0 && m % restartInterval == 0)
+        {
+            if (!reader.restart())
+            {
+                return false;
+            }
+            for (Component &c : comps)
+            {
+                c.pred = 0;
+            }
+        }
+
+        int mx = m % mcusX;
+        int my = m / mcusX;
+        for (int index : scanOrder)
+        {
+            Component &c = comps[index];
+            for (int by = 0; by < c.v; by++)
+            {
+                for (int bx = 0; bx < c.h; bx++)
+                {
+                    uint8_t value;
+                    if (!decodeBlock(reader, c, dcTables[c.td], acTables[c.ta], quant[c.tq][0], value))
+                    {
+                        return false;
+                    }
+                    int px = mx * c.h + bx;
+                    int py = my * c.v + by;
+                    c.plane[(size_t)py * c.blocksW + px] = value;
+                }
+            }
+        }
+    }
+
+    // 출력 픽셀 = 8x8 영역 하나 (휘도 블록 해상도), 색차는 샘플링 비율만큼 늘려 씀
+    int outW = width / 8;
+    int outH = height / 8;
+    const Component &y = comps[0];
+    for (int oy = 0; oy < outH; oy++)
+    {
+        for (int ox = 0; ox < outW; ox++)
+        {
+            int lum = y.plane[(size_t)(oy * y.v / vMax) * y.blocksW + ox * y.h / hMax];
+            int cb = 128;
+            int cr = 128;
+            if (comps.size() == 3)
+            {
+                const Component &b = comps[1];
+                const Component &r = comps[2];
+                cb = b.plane[(size_t)(oy * b.v / vMax) * b.blocksW + ox * b.h / hMax];
+                cr = r.plane[(size_t)(oy * r.v / vMax) * r.blocksW + ox * r.h / hMax];
+            }
+
+            // JFIF YCbCr → RGB
+            int red = clamp255(lum + ((91881 * (cr - 128)) >> 16));
+            int green = clamp255(lum - ((22554 * (cb - 128) + 46802 * (cr - 128)) >> 16));
+            int blue = clamp255(lum + ((116130 * (cb - 128)) >> 16));
+            uint16_t rgb = (uint16_t)(((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3));
+            *out++ = (uint8_t)(rgb >> 8);
+            *out++ = (uint8_t)rgb;
+        }
+    }
+    return true;
+}
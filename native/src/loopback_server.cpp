@@ -0,0 +1,275 @@
+#include "native_host.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// 루프백 업로드 서버
+// 연결마다 스레드 하나, 요청 본문(Content-Length 또는 chunked)을 읽어 버리고 200 을 돌려준다.
+// 시험에서는 nativeLoopbackSetStatus() 로 응답 코드를 바꾸고,
+// nativeLoopbackShortBody() 로 Content-Length 보다 짧은 본문을 보내게 한다.
+
+static std::atomic<uint64_t> s_requests(0);
+static std::atomic<uint64_t> s_bodyBytes(0);
+static std::atomic<int> s_status(200);
+static std::atomic<size_t> s_shortBody(0);
+
+// 서버 스레드가 종료 시점에도 돌고 있으므로 정적 소멸 순서를 타지 않게 둔다
+struct LastPath
+{
+    std::mutex lock;
+    std::string path;
+};
+static LastPath *s_lastPath = new LastPath();
+
+void nativeLoopbackSetStatus(int code)
+{
+    s_status.store(code);
+}
+
+String nativeLoopbackLastPath()
+{
+    std::lock_guard<std::mutex> guard(s_lastPath->lock);
+    return String(s_lastPath->path.c_str());
+}
+
+void nativeLoopbackShortBody(size_t missing)
+{
+    s_shortBody.store(missing);
+}
+
+uint64_t nativeLoopbackRequests()
+{
+    return s_requests.load();
+}
+
+uint64_t nativeLoopbackBodyBytes()
+{
+    return s_bodyBytes.load();
+}
+
+class LineReader
+{
+private:
+    int m_fd;
+    char m_buf[16 * 1024];
+    size_t m_pos = 0;
+    size_t m_len = 0;
+
+    bool fill()
+    {
+        if (m_pos < m_len)
+        {
+            return true;
+        }
+        ssize_t n = recv(m_fd, m_buf, sizeof(m_buf), 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        m_pos = 0;
+        m_len = (size_t)n;
+        return true;
+    }
+
+public:
+    explicit LineReader(int fd) : m_fd(fd) {}
+
+    bool readLine(std::string &line)
+    {
+        line.clear();
+        while (fill())
+        {
+            char c = m_buf[m_pos++];
+            if (c == '\n')
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                return true;
+            }
+            line += c;
+        }
+        return false;
+    }
+
+    bool skip(size_t count)
+    {
+        while (count > 0)
+        {
+            if (!fill())
+            {
+                return false;
+            }
+            size_t n = std::min(count, m_len - m_pos);
+            m_pos += n;
+            count -= n;
+            s_bodyBytes.fetch_add(n);
+        }
+        return true;
+    }
+};
+
+static bool headerIs(const std::string &line, const char *name, std::string &value)
+{
+    size_t nameLen = strlen(name);
+    if (line.size() <= nameLen || line[nameLen] != ':' || strncasecmp(line.c_str(), name, nameLen) != 0)
+    {
+        return false;
+    }
+    size_t start = nameLen + 1;
+    while (start < line.size() && isspace((unsigned char)line[start]))
+    {
+        start++;
+    }
+    value = line.substr(start);
+    return true;
+}
+
+static bool readBody(LineReader &reader, bool chunked, size_t contentLength)
+{
+    if (!chunked)
+    {
+        return reader.skip(contentLength);
+    }
+
+    std::string line;
+    while (reader.readLine(line))
+    {
+        size_t size = strtoul(line.c_str(), nullptr, 16);
+        if (size == 0)
+        {
+            // 트레일러 끝의 빈 줄까지
+            while (reader.readLine(line) && !line.empty())
+            {
+            }
+            return true;
+        }
+        if (!reader.skip(size) || !reader.readLine(line))
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+static void serveConnection(int fd)
+{
+    nativeAllocExcludeThread();
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    LineReader reader(fd);
+    std::string line;
+    size_t lateBytes = 0;   // 앞 응답에서 보내지 않은 본문 (다음 응답 앞에 늦게 보냄)
+    while (reader.readLine(line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        // 요청 라인: POST <path> HTTP/1.1
+        size_t pathStart = line.find(' ');
+        size_t pathEnd = line.rfind(' ');
+        if (pathStart != std::string::npos && pathEnd > pathStart)
+        {
+            std::lock_guard<std::mutex> guard(s_lastPath->lock);
+            s_lastPath->path = line.substr(pathStart + 1, pathEnd - pathStart - 1);
+        }
+
+        bool chunked = false;
+        bool keepAlive = line.find("HTTP/1.1") != std::string::npos;
+        size_t contentLength = 0;
+        std::string value;
+        while (reader.readLine(line) && !line.empty())
+        {
+            if (headerIs(line, "Content-Length", value))
+            {
+                contentLength = strtoul(value.c_str(), nullptr, 10);
+            }
+            else if (headerIs(line, "Transfer-Encoding", value))
+            {
+                chunked = value.find("chunked") != std::string::npos;
+            }
+            else if (headerIs(line, "Connection", value))
+            {
+                keepAlive = strcasecmp(value.c_str(), "close") != 0;
+            }
+        }
+
+        if (!readBody(reader, chunked, contentLength))
+        {
+            break;
+        }
+        s_requests.fetch_add(1);
+
+        int status = s_status.load();
+        const char *body = status < 300 ? "{\"result\":\"ok\"}" : "{\"result\":\"fail\"}";
+        size_t missing = s_shortBody.exchange(0);
+        char response[256];
+        int len = snprintf(response, sizeof(response), "%.*s", (int)lateBytes, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        len += snprintf(response + len, sizeof(response) - len,
+                        "HTTP/1.1 %d %s\r\n"
+                        "Content-Type: application/json\r\n"
+                        "Content-Length: %u\r\n"
+                        "Connection: %s\r\n\r\n%s",
+                        status, status < 300 ? "OK" : "Error", (unsigned)(strlen(body) + missing),
+                        keepAlive ? "keep-alive" : "close", body);
+        lateBytes = missing;
+        if (send(fd, response, len, MSG_NOSIGNAL) != len || !keepAlive)
+        {
+            break;
+        }
+    }
+    ::close(fd);
+}
+
+uint16_t nativeLoopbackServerStart(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &addrLen) < 0)
+    {
+        ::close(fd);
+        return 0;
+    }
+
+    std::thread([fd]() {
+        nativeAllocExcludeThread();
+        while (true)
+        {
+            int client = accept(fd, nullptr, nullptr);
+            if (client < 0)
+            {
+                continue;
+            }
+            std::thread(serveConnection, client).detach();
+        }
+    }).detach();
+
+    return ntohs(addr.sin_port);
+}
@@ -0,0 +1,319 @@
+#include <nvs.h>
+#include <nvs_flash.h>
+#include "native_host.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <string.h>
+
+// 메모리 NVS: (네임스페이스, 키) -> 타입 + 바이트열
+struct NvsValue
+{
+    nvs_type_t type;
+    std::vector<uint8_t> data;
+};
+
+typedef std::map<std::string, NvsValue> NvsNamespace;
+
+// 전역 Config 생성자에서 바로 쓰이므로 함수 내 정적 객체로 초기화 순서를 보장
+struct NvsState
+{
+    std::mutex lock;
+    std::map<std::string, NvsNamespace> store;
+    std::vector<std::string> handles;   // 핸들 - 1 = 인덱스
+    long writeBudget = -1;              // 남은 성공 쓰기 수 (-1 = 제한 없음)
+};
+
+static NvsState &nvs()
+{
+    static NvsState state;
+    return state;
+}
+
+struct nvs_opaque_iterator_t
+{
+    std::string ns;
+    nvs_type_t type;
+    std::vector<std::pair<std::string, nvs_type_t>> entries;
+    size_t index;
+};
+
+static NvsNamespace *lookup(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > nvs().handles.size())
+    {
+        return nullptr;
+    }
+    return &nvs().store[nvs().handles[handle - 1]];
+}
+
+static esp_err_t setValue(nvs_handle_t handle, const char *key, nvs_type_t type, const void *data, size_t len)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    NvsNamespace *ns = lookup(handle);
+    if (!ns)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (!key || strlen(key) >= NVS_KEY_NAME_MAX_SIZE)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (nvs().writeBudget == 0)
+    {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    if (nvs().writeBudget > 0)
+    {
+        nvs().writeBudget--;
+    }
+    NvsValue &value = (*ns)[key];
+    value.type = type;
+    value.data.assign((const uint8_t *)data, (const uint8_t *)data + len);
+    return ESP_OK;
+}
+
+static esp_err_t getValue(nvs_handle_t handle, const char *key, nvs_type_t type, std::vector<uint8_t> &out)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    NvsNamespace *ns = lookup(handle);
+    if (!ns)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    auto it = ns->find(key);
+    if (it == ns->end())
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.type != type)
+    {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    out = it->second.data;
+    return ESP_OK;
+}
+
+template <typename T>
+static esp_err_t getScalar(nvs_handle_t handle, const char *key, nvs_type_t type, T *out)
+{
+    std::vector<uint8_t> data;
+    esp_err_t err = getValue(handle, key, type, data);
+    if (err == ESP_OK)
+    {
+        memcpy(out, data.data(), sizeof(T));
+    }
+    return err;
+}
+
+void nativeNvsFailAfter(long writes)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    nvs().writeBudget = writes;
+}
+
+esp_err_t nvs_flash_init()
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase()
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    nvs().store.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    nvs().handles.push_back(namespace_name);
+    nvs().store[namespace_name];
+    *out_handle = (nvs_handle_t)nvs().handles.size();
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    NvsNamespace *ns = lookup(handle);
+    if (!ns)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    NvsNamespace *ns = lookup(handle);
+    if (!ns)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    ns->clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return setValue(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    return getScalar(handle, key, NVS_TYPE_U8, out_value);
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value)
+{
+    return setValue(handle, key, NVS_TYPE_I32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *key, int32_t *out_value)
+{
+    return getScalar(handle, key, NVS_TYPE_I32, out_value);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return setValue(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    return getScalar(handle, key, NVS_TYPE_U32, out_value);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return setValue(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    std::vector<uint8_t> data;
+    esp_err_t err = getValue(handle, key, NVS_TYPE_STR, data);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (!out_value)
+    {
+        *length = data.size();
+        return ESP_OK;
+    }
+    if (*length < data.size())
+    {
+        *length = data.size();
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, data.data(), data.size());
+    *length = data.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return setValue(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    std::vector<uint8_t> data;
+    esp_err_t err = getValue(handle, key, NVS_TYPE_BLOB, data);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (out_value)
+    {
+        if (*length < data.size())
+        {
+            *length = data.size();
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        memcpy(out_value, data.data(), data.size());
+    }
+    *length = data.size();
+    return ESP_OK;
+}
+
+// 반복자는 생성 시점의 키 목록 스냅샷을 돈다
+esp_err_t nvs_entry_find(const char *part_name, const char *namespace_name, nvs_type_t type, nvs_iterator_t *output_iterator)
+{
+    std::lock_guard<std::mutex> guard(nvs().lock);
+    *output_iterator = nullptr;
+
+    auto nsIt = nvs().store.find(namespace_name ? namespace_name : "");
+    if (nsIt == nvs().store.end())
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    nvs_iterator_t it = new nvs_opaque_iterator_t();
+    it->ns = nsIt->first;
+    it->type = type;
+    it->index = 0;
+    for (const auto &entry : nsIt->second)
+    {
+        if (type == NVS_TYPE_ANY || entry.second.type == type)
+        {
+            it->entries.push_back(std::make_pair(entry.first, entry.second.type));
+        }
+    }
+    if (it->entries.empty())
+    {
+        delete it;
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *output_iterator = it;
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_next(nvs_iterator_t *iterator)
+{
+    if (!iterator || !*iterator)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (++(*iterator)->index >= (*iterator)->entries.size())
+    {
+        delete *iterator;
+        *iterator = nullptr;
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_info(const nvs_iterator_t iterator, nvs_entry_info_t *out_info)
+{
+    if (!iterator || !out_info)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const auto &entry = iterator->entries[iterator->index];
+    strncpy(out_info->namespace_name, iterator->ns.c_str(), sizeof(out_info->namespace_name) - 1);
+    out_info->namespace_name[sizeof(out_info->namespace_name) - 1] = '\0';
+    strncpy(out_info->key, entry.first.c_str(), sizeof(out_info->key) - 1);
+    out_info->key[sizeof(out_info->key) - 1] = '\0';
+    out_info->type = entry.second;
+    return ESP_OK;
+}
+
+void nvs_release_iterator(nvs_iterator_t iterator)
+{
+    delete iterator;
+}
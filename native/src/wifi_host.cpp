@@ -0,0 +1,461 @@
+#include <WiFi.h>
+#include "native_host.hpp"
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+// ===========================================
+// WiFiClient
+// ===========================================
+WiFiClient::Socket::~Socket()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+}
+
+WiFiClient::WiFiClient(int fd)
+{
+    if (fd >= 0)
+    {
+        m_socket = std::make_shared<Socket>(fd);
+    }
+}
+
+int WiFiClient::connect(const char *host, uint16_t port, int32_t timeoutMs)
+{
+    stop();
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = nullptr;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res)
+    {
+        return 0;
+    }
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd < 0)
+    {
+        freeaddrinfo(res);
+        return 0;
+    }
+
+    // 비차단 connect + poll 로 타임아웃 적용
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int rc = ::connect(fd, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+    if (rc < 0 && errno != EINPROGRESS)
+    {
+        ::close(fd);
+        return 0;
+    }
+    if (rc < 0)
+    {
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (poll(&pfd, 1, timeoutMs) <= 0 ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0)
+        {
+            ::close(fd);
+            return 0;
+        }
+    }
+    fcntl(fd, F_SETFL, flags);
+
+    m_socket = std::make_shared<Socket>(fd);
+    return 1;
+}
+
+// 이 복사본만 놓는다 (다른 복사본이 없으면 소켓이 닫힘)
+void WiFiClient::stop()
+{
+    m_socket.reset();
+}
+
+int WiFiClient::setNoDelay(bool noDelay)
+{
+    int flag = noDelay ? 1 : 0;
+    return m_socket ? setsockopt(m_socket->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) : -1;
+}
+
+IPAddress WiFiClient::remoteIP() const
+{
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    if (!m_socket || getpeername(m_socket->fd, (struct sockaddr *)&addr, &len) < 0)
+    {
+        return IPAddress();
+    }
+    return IPAddress((uint32_t)addr.sin_addr.s_addr);
+}
+
+// 수신 버퍼가 비었을 때만 소켓을 들여다봐서 상대가 닫았는지 확인
+uint8_t WiFiClient::connected()
+{
+    if (!m_socket)
+    {
+        return 0;
+    }
+    if (m_socket->rxPos < m_socket->rxLen)
+    {
+        return 1;
+    }
+
+    uint8_t probe;
+    ssize_t n = recv(m_socket->fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    if (!m_socket)
+    {
+        return 0;
+    }
+    size_t sent = 0;
+    while (sent < size)
+    {
+        ssize_t n = send(m_socket->fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            stop();
+            break;
+        }
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+bool WiFiClient::fillRx()
+{
+    if (!m_socket)
+    {
+        return false;
+    }
+    Socket &socket = *m_socket;
+    if (socket.rxPos < socket.rxLen)
+    {
+        return true;
+    }
+    ssize_t n = recv(socket.fd, socket.rx, RX_BUFFER_SIZE, MSG_DONTWAIT);
+    if (n > 0)
+    {
+        socket.rxPos = 0;
+        socket.rxLen = (size_t)n;
+        return true;
+    }
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        stop();
+    }
+    return false;
+}
+
+int WiFiClient::available()
+{
+    if (!fillRx())
+    {
+        return 0;
+    }
+    return (int)(m_socket->rxLen - m_socket->rxPos);
+}
+
+int WiFiClient::read()
+{
+    if (!fillRx())
+    {
+        return -1;
+    }
+    return m_socket->rx[m_socket->rxPos++];
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    if (!fillRx())
+    {
+        return -1;
+    }
+    Socket &socket = *m_socket;
+    size_t n = std::min(size, socket.rxLen - socket.rxPos);
+    memcpy(buffer, socket.rx + socket.rxPos, n);
+    socket.rxPos += n;
+    return (int)n;
+}
+
+// ===========================================
+// WiFiServer
+// ===========================================
+void WiFiServer::begin(uint16_t port)
+{
+    end();
+    if (port)
+    {
+        m_port = port;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(m_port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0)
+    {
+        ::close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    m_fd = fd;
+}
+
+void WiFiServer::end()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+WiFiClient WiFiServer::available()
+{
+    if (m_fd < 0)
+    {
+        return WiFiClient();
+    }
+    int fd = accept(m_fd, nullptr, nullptr);
+    if (fd < 0)
+    {
+        return WiFiClient();
+    }
+    // 받은 소켓은 차단 모드로 (ESP32 lwip 와 같음)
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    WiFiClient client(fd);
+    client.setNoDelay(m_noDelay);
+    return client;
+}
+
+// ===========================================
+// WiFiClass
+// 시험 코드가 nativeWifiEvent() 로 STA 이벤트를 보낸다
+// ===========================================
+struct WifiEventHandler
+{
+    WiFiEventFuncCb callback;
+    arduino_event_id_t event;
+};
+
+struct WifiState
+{
+    std::mutex lock;
+    wl_status_t status = WL_CONNECTED;
+    std::string ssid;
+    int32_t channel = 0;
+    uint8_t bssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    uint32_t begins = 0;
+    IPAddress localIp = IPAddress(127, 0, 0, 1);
+    std::vector<WifiEventHandler> handlers;
+};
+
+static WifiState &wifiState()
+{
+    static WifiState *state = new WifiState();
+    return *state;
+}
+
+wl_status_t WiFiClass::status()
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.status;
+}
+
+int8_t WiFiClass::RSSI()
+{
+    return status() == WL_CONNECTED ? -50 : 0;
+}
+
+IPAddress WiFiClass::localIP()
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.status == WL_CONNECTED ? state.localIp : IPAddress();
+}
+
+IPAddress WiFiClass::gatewayIP()
+{
+    return status() == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+IPAddress WiFiClass::subnetMask()
+{
+    return status() == WL_CONNECTED ? IPAddress(255, 0, 0, 0) : IPAddress();
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t index)
+{
+    return status() == WL_CONNECTED ? IPAddress(127, 0, 0, 53) : IPAddress();
+}
+
+String WiFiClass::macAddress()
+{
+    return "AA:BB:CC:DD:EE:FF";
+}
+
+uint8_t *WiFiClass::BSSID()
+{
+    return wifiState().bssid;
+}
+
+String WiFiClass::BSSIDstr()
+{
+    const uint8_t *b = BSSID();
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+    return String(buf);
+}
+
+int32_t WiFiClass::channel()
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.channel ? state.channel : 6;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid,
+                             bool connect)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.ssid = ssid ? ssid : "";
+    state.channel = channel;
+    if (bssid)
+    {
+        memcpy(state.bssid, bssid, sizeof(state.bssid));
+    }
+    state.begins++;
+    state.status = WL_DISCONNECTED;
+    return state.status;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.status = WL_DISCONNECTED;
+    return true;
+}
+
+bool WiFiClass::config(IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.localIp = (uint32_t)localIp ? localIp : IPAddress(127, 0, 0, 1);
+    return true;
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback, arduino_event_id_t event)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.handlers.push_back({ callback, event });
+    return state.handlers.size();
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool showHidden)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.ssid.empty() ? 0 : 1;
+}
+
+String WiFiClass::SSID(uint8_t index)
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return String(state.ssid.c_str());
+}
+
+int32_t WiFiClass::RSSI(uint8_t index)
+{
+    return -50;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t index)
+{
+    return WIFI_AUTH_WPA2_PSK;
+}
+
+void nativeWifiEvent(arduino_event_id_t event, uint8_t reason)
+{
+    WifiState &state = wifiState();
+    std::vector<WifiEventHandler> handlers;
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+        {
+            state.status = WL_CONNECTED;
+        }
+        else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+        {
+            state.status = WL_DISCONNECTED;
+        }
+        handlers = state.handlers;
+    }
+
+    arduino_event_info_t info = {};
+    info.wifi_sta_disconnected.reason = reason;
+    for (const WifiEventHandler &handler : handlers)
+    {
+        if (handler.event == ARDUINO_EVENT_NONE || handler.event == event)
+        {
+            handler.callback(event, info);
+        }
+    }
+}
+
+uint32_t nativeWifiBeginCount()
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.begins;
+}
+
+int32_t nativeWifiLastChannel()
+{
+    WifiState &state = wifiState();
+    std::lock_guard<std::mutex> guard(state.lock);
+    return state.channel;
+}
@@ -0,0 +1,87 @@
+#include "boot_timeline.hpp"
+#include <esp_system.h>
+
+BootTimeline::Span BootTimeline::s_spans[PHASE_COUNT] = {
+    { NOT_SET, NOT_SET }, { NOT_SET, NOT_SET }, { NOT_SET, NOT_SET }, { NOT_SET, NOT_SET },
+    { NOT_SET, NOT_SET }, { NOT_SET, NOT_SET }, { NOT_SET, NOT_SET },
+};
+
+void BootTimeline::start(Phase phase)
+{
+    s_spans[phase].startMs = millis();
+    s_spans[phase].endMs = NOT_SET;
+}
+
+void BootTimeline::end(Phase phase)
+{
+    if (!isStarted(phase) || isDone(phase))
+    {
+        return;
+    }
+    s_spans[phase].endMs = millis();
+    Serial.printf("Boot %s: %ums (at %ums)\n", phaseName(phase),
+                  (unsigned)(s_spans[phase].endMs - s_spans[phase].startMs), (unsigned)s_spans[phase].endMs);
+}
+
+void BootTimeline::set(Phase phase, uint32_t startMs, uint32_t endMs)
+{
+    s_spans[phase].startMs = startMs;
+    s_spans[phase].endMs = endMs;
+    Serial.printf("Boot %s: %ums (at %ums)\n", phaseName(phase), (unsigned)(endMs - startMs), (unsigned)endMs);
+}
+
+void BootTimeline::toJson(JsonObject obj)
+{
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+        const Span &span = s_spans[i];
+        if (span.startMs == NOT_SET)
+        {
+            continue;
+        }
+
+        JsonObject phase = obj[phaseName((Phase)i)].to<JsonObject>();
+        phase["start_ms"] = span.startMs;
+        if (span.endMs != NOT_SET)
+        {
+            phase["end_ms"] = span.endMs;
+            phase["ms"] = span.endMs - span.startMs;
+        }
+        else
+        {
+            phase["running_ms"] = millis() - span.startMs;
+        }
+    }
+}
+
+const char *BootTimeline::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case SETUP:        return "setup";
+        case CONFIG:       return "config";
+        case CAMERA:       return "camera";
+        case WIFI:         return "wifi";
+        case SPOOL:        return "spool";
+        case PIPELINE:     return "pipeline";
+        case FIRST_UPLOAD: return "first_upload";
+        default:           return "unknown";
+    }
+}
+
+const char *BootTimeline::resetReason()
+{
+    switch (esp_reset_reason())
+    {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        default:                return "unknown";
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef BOOT_TIMELINE_HPP
+#define BOOT_TIMELINE_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// 부팅 단계별 시작/끝 시각 (millis, 리셋 후 ms)
+// 카메라 초기화와 WiFi 접속은 동시에 진행되므로 구간이 겹칠 수 있다.
+// first_upload 는 리셋부터 첫 업로드 성공까지 (전원 재인가 후 복구 시간 지표).
+// 부팅 중 한 번씩만 기록하므로 정적 메모리에 둔다.
+class BootTimeline
+{
+public:
+    enum Phase
+    {
+        SETUP = 0,      // setup() 전체
+        CONFIG,         // 설정 → 모듈 적용
+        CAMERA,         // 카메라 초기화 (APP CPU 태스크)
+        WIFI,           // 접속 시작 → IP 획득
+        SPOOL,          // LittleFS 마운트 + 스풀 복구
+        PIPELINE,       // 링 버퍼 할당 + 파이프라인 태스크 시작
+        FIRST_UPLOAD,   // 리셋 → 첫 업로드 성공
+        PHASE_COUNT
+    };
+
+    static const uint32_t NOT_SET = 0xFFFFFFFF;
+
+    static void start(Phase phase);
+    static void end(Phase phase);
+    static void set(Phase phase, uint32_t startMs, uint32_t endMs);
+    static inline bool isStarted(Phase phase) { return s_spans[phase].startMs != NOT_SET; }
+    static inline bool isDone(Phase phase) { return s_spans[phase].endMs != NOT_SET; }
+
+    static void toJson(JsonObject obj);
+    static const char *phaseName(Phase phase);
+    static const char *resetReason();
+
+private:
+    struct Span
+    {
+        uint32_t startMs;
+        uint32_t endMs;
+    };
+
+    static Span s_spans[PHASE_COUNT];
+};
+
+#endif // BOOT_TIMELINE_HPP
@@ -1,4 +1,5 @@
 #include "camera_module.hpp"
+#include "latency_stats.hpp"
 
 bool CameraModule::init()
 {
@@ -25,7 +26,7 @@ bool CameraModule::init()
     config.xclk_freq_hz = 20000000;
     config.pixel_format = PIXFORMAT_JPEG;
     config.frame_size = m_frameSize;
-    config.jpeg_quality = 12;  // 0-63, 낮을수록 고품질
+    config.jpeg_quality = 12;  // 0-63, 낮을수록 고품질 (저장된 값이 없을 때)
     config.fb_count = 1;
     config.fb_location = CAMERA_FB_IN_PSRAM;
     config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
@@ -46,6 +47,12 @@ bool CameraModule::init()
         config.fb_location = CAMERA_FB_IN_DRAM;
     }
 
+    // 저장된 품질 또는 품질 제어가 마지막으로 정한 값
+    if (m_quality.getQuality() > 0)
+    {
+        config.jpeg_quality = m_quality.getQuality();
+    }
+
     // 카메라 초기화
     esp_err_t err = esp_camera_init(&config);
     if (err != ESP_OK)
@@ -54,6 +61,17 @@ bool CameraModule::init()
         m_initialized = false;
         return false;
     }
+    m_fbCount = config.fb_count;
+
+    // 품질을 바꾸면 드라이버가 이미 채운 버퍼 수만큼은 이전 품질 프레임
+    // (이미 정해 둔 품질로 열었으면 복원한 평균을 그대로 둔다)
+    portENTER_CRITICAL(&m_qualityLock);
+    m_quality.setSettleFrames(m_fbCount);
+    if (m_quality.getQuality() != config.jpeg_quality)
+    {
+        m_quality.setQuality(config.jpeg_quality);
+    }
+    portEXIT_CRITICAL(&m_qualityLock);
 
     // 센서 설정
     sensor_t *s = esp_camera_sensor_get();
@@ -61,29 +79,10 @@ bool CameraModule::init()
     {
         // 센서 정보 출력
         Serial.printf("Camera PID: 0x%02X\n", s->id.PID);
-        
-        s->set_brightness(s, 0);     // -2 to 2
-        s->set_contrast(s, 0);       // -2 to 2
-        s->set_saturation(s, 0);     // -2 to 2
-        s->set_special_effect(s, 0); // 0: No Effect
-        s->set_whitebal(s, 1);       // 0: disable, 1: enable
-        s->set_awb_gain(s, 1);       // 0: disable, 1: enable
-        s->set_wb_mode(s, 0);        // 0: Auto
-        s->set_exposure_ctrl(s, 1);  // 0: disable, 1: enable
-        s->set_aec2(s, 0);           // 0: disable, 1: enable
-        s->set_ae_level(s, 0);       // -2 to 2
-        s->set_aec_value(s, 300);    // 0 to 1200
-        s->set_gain_ctrl(s, 1);      // 0: disable, 1: enable
-        s->set_agc_gain(s, 0);       // 0 to 30
-        s->set_gainceiling(s, (gainceiling_t)0);
-        s->set_bpc(s, 0);            // 0: disable, 1: enable
-        s->set_wpc(s, 1);            // 0: disable, 1: enable
-        s->set_raw_gma(s, 1);        // 0: disable, 1: enable
-        s->set_lenc(s, 1);           // 0: disable, 1: enable
-        s->set_hmirror(s, 0);        // 0: disable, 1: enable
-        s->set_vflip(s, 0);          // 0: disable, 1: enable
-        s->set_dcw(s, 1);            // 0: disable, 1: enable
-        s->set_colorbar(s, 0);       // 0: disable, 1: enable
+
+        // 센서 상태(기본값)와 다른 항목만 씀
+        m_profileWrites = SensorProfile::apply(s, *m_profile);
+        Serial.printf("Sensor profile: %s (%d writes)\n", m_profile->name, m_profileWrites);
     }
 
     // Flash LED 핀 설정
@@ -97,6 +96,40 @@ bool CameraModule::init()
     return true;
 }
 
+bool CameraModule::initAsync(int warmupFrames)
+{
+    if (m_initState == INIT_RUNNING)
+    {
+        return true;
+    }
+
+    m_initWarmup = warmupFrames;
+    m_initState = INIT_RUNNING;
+    TaskHandle_t task = nullptr;
+    xTaskCreatePinnedToCore(initTaskEntry, "caminit", INIT_STACK_SIZE, this, 2, &task, INIT_CORE);
+    if (!task)
+    {
+        Serial.println("Camera init task create failed");
+        m_initState = INIT_FAILED;
+        return false;
+    }
+    return true;
+}
+
+void CameraModule::initTaskEntry(void *arg)
+{
+    CameraModule *camera = static_cast<CameraModule *>(arg);
+    uint32_t startMs = millis();
+    bool ok = camera->init();
+    if (ok)
+    {
+        camera->discardFrames(camera->m_initWarmup);
+    }
+    camera->m_initMs = millis() - startMs;
+    camera->m_initState = ok ? INIT_OK : INIT_FAILED;
+    vTaskDelete(nullptr);
+}
+
 bool CameraModule::capture()
 {
     if (!m_initialized)
@@ -106,21 +139,21 @@ bool CameraModule::capture()
     }
 
     // 이전 프레임 해제
-    if (m_fb)
-    {
-        esp_camera_fb_return(m_fb);
-        m_fb = nullptr;
-    }
+    releaseBuffer();
 
     // 새 프레임 캡처
+    uint32_t startUs = micros();
     m_fb = esp_camera_fb_get();
+    LatencyStats::record(LatencyStats::FB_GET, micros() - startUs);
     if (!m_fb)
     {
         Serial.println("Camera capture failed");
         return false;
     }
+    m_framesOut++;
 
     Serial.printf("Captured image: %d bytes\n", m_fb->len);
+    observeFrame(m_fb);
     return true;
 }
 
@@ -130,11 +163,236 @@ void CameraModule::releaseBuffer()
     {
         esp_camera_fb_return(m_fb);
         m_fb = nullptr;
+        m_framesOut--;
+    }
+}
+
+camera_fb_t* CameraModule::grab()
+{
+    if (!m_initialized)
+    {
+        return nullptr;
+    }
+
+    uint32_t startUs = micros();
+    camera_fb_t *fb = esp_camera_fb_get();
+    LatencyStats::record(LatencyStats::FB_GET, micros() - startUs);
+    if (!fb)
+    {
+        Serial.println("Camera capture failed");
+        return nullptr;
+    }
+    m_framesOut++;
+
+    observeFrame(fb);
+    return fb;
+}
+
+void CameraModule::returnFrame(camera_fb_t *fb)
+{
+    if (fb)
+    {
+        esp_camera_fb_return(fb);
+        m_framesOut--;
     }
 }
 
+void CameraModule::discardFrames(int count)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    // 품질 제어 평균에 넣지 않음
+    for (int i = 0; i < count; i++)
+    {
+        camera_fb_t *fb = esp_camera_fb_get();
+        if (fb)
+        {
+            esp_camera_fb_return(fb);
+        }
+    }
+}
+
+bool CameraModule::initFrameRing()
+{
+    if (m_ringBase)
+    {
+        return true;
+    }
+
+    if (!psramFound())
+    {
+        Serial.println("Frame ring disabled (no PSRAM)");
+        return false;
+    }
+
+    // 슬롯 크기: 현재 해상도의 JPEG 최대 크기 추정치 (픽셀 수 / 5, 4KB 정렬)
+    size_t pixels = (size_t)resolution[m_frameSize].width * resolution[m_frameSize].height;
+    size_t slotSize = ((pixels / 5) + 4095) & ~(size_t)4095;
+    if (slotSize < 32 * 1024)
+    {
+        slotSize = 32 * 1024;
+    }
+
+    size_t budget = (size_t)ESP.getFreePsram() / 100 * RING_PSRAM_PERCENT;
+    int slots = budget / slotSize;
+    if (slots > RING_MAX_SLOTS)
+    {
+        slots = RING_MAX_SLOTS;
+    }
+    if (slots < 2)
+    {
+        Serial.println("Frame ring disabled (not enough PSRAM)");
+        return false;
+    }
+
+    m_ringBase = (uint8_t *)ps_malloc(slotSize * slots);
+    if (!m_ringBase)
+    {
+        Serial.println("Frame ring alloc failed");
+        return false;
+    }
+
+    m_ringSlotSize = slotSize;
+    m_ringFrameSize = m_frameSize;
+    m_ringSlots = slots;
+    for (int i = 0; i < slots; i++)
+    {
+        m_ring[i].frame.data = m_ringBase + slotSize * i;
+        m_ring[i].frame.len = 0;
+        m_ring[i].frame.timestamp = 0;
+        m_ring[i].state = SLOT_FREE;
+    }
+
+    Serial.printf("Frame ring: %d slots x %u bytes\n", slots, (unsigned)slotSize);
+    return true;
+}
+
+bool CameraModule::storeFrame(const uint8_t *data, size_t len, uint32_t timestamp)
+{
+    if (!m_ringBase || len > m_ringSlotSize)
+    {
+        portENTER_CRITICAL(&m_ringLock);
+        m_ringRejected++;
+        portEXIT_CRITICAL(&m_ringLock);
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_ringLock);
+    if (m_ringCount == m_ringSlots)
+    {
+        // 가득 차면 업로드 중인 tail 쪽 슬롯 바로 다음의 가장 오래된 프레임을 버린다
+        int victim = (m_ringTail + m_ringReading) % m_ringSlots;
+        if (m_ringReading >= m_ringCount || m_ring[victim].state != SLOT_READY)
+        {
+            m_ringRejected++;
+            portEXIT_CRITICAL(&m_ringLock);
+            return false;
+        }
+
+        // 잠긴 슬롯 기술자를 한 칸씩 뒤로 밀고 비운 버퍼를 tail 자리로 옮긴다
+        // (읽는 쪽은 data 포인터 사본을 들고 있으므로 버퍼 내용은 그대로)
+        uint8_t *freed = m_ring[victim].frame.data;
+        for (int i = m_ringReading; i > 0; i--)
+        {
+            m_ring[(m_ringTail + i) % m_ringSlots] = m_ring[(m_ringTail + i - 1) % m_ringSlots];
+        }
+        m_ring[m_ringTail].frame.data = freed;
+        m_ring[m_ringTail].state = SLOT_FREE;
+        m_ringTail = (m_ringTail + 1) % m_ringSlots;
+        m_ringCount--;
+        m_ringOverwritten++;
+    }
+
+    // 슬롯 예약: head 를 먼저 넘기므로 다른 태스크는 같은 슬롯을 받지 못한다
+    int index = m_ringHead;
+    RingSlot &slot = m_ring[index];
+    slot.state = SLOT_WRITING;
+    uint8_t *dst = slot.frame.data;
+    m_ringHead = (m_ringHead + 1) % m_ringSlots;
+    m_ringCount++;
+    portEXIT_CRITICAL(&m_ringLock);
+
+    // WRITING 슬롯은 읽기/덮어쓰기 대상이 아니므로 잠금 없이 복사
+    memcpy(dst, data, len);
+
+    portENTER_CRITICAL(&m_ringLock);
+    slot.frame.len = len;
+    slot.frame.timestamp = timestamp;
+    slot.state = SLOT_READY;
+    m_ringStored++;
+    portEXIT_CRITICAL(&m_ringLock);
+    return true;
+}
+
+bool CameraModule::peekStoredFrame(StoredFrame &frame)
+{
+    return peekStoredFrames(&frame, 1) == 1;
+}
+
+int CameraModule::peekStoredFrames(StoredFrame *frames, int maxCount)
+{
+    // tail 부터 복사가 끝난 슬롯만 (쓰는 중인 슬롯에서 멈춤)
+    portENTER_CRITICAL(&m_ringLock);
+    int n = 0;
+    while (n < m_ringCount && n < maxCount)
+    {
+        const RingSlot &slot = m_ring[(m_ringTail + n) % m_ringSlots];
+        if (slot.state != SLOT_READY)
+        {
+            break;
+        }
+        frames[n++] = slot.frame;
+    }
+    m_ringReading = n;
+    portEXIT_CRITICAL(&m_ringLock);
+    return n;
+}
+
+void CameraModule::popStoredFrame()
+{
+    portENTER_CRITICAL(&m_ringLock);
+    int n = m_ringReading < m_ringCount ? m_ringReading : m_ringCount;
+    for (int i = 0; i < n; i++)
+    {
+        m_ring[(m_ringTail + i) % m_ringSlots].state = SLOT_FREE;
+    }
+    m_ringTail = (m_ringTail + n) % m_ringSlots;
+    m_ringCount -= n;
+    m_ringReading = 0;
+    portEXIT_CRITICAL(&m_ringLock);
+}
+
+void CameraModule::releaseStoredFrame()
+{
+    portENTER_CRITICAL(&m_ringLock);
+    m_ringReading = 0;
+    portEXIT_CRITICAL(&m_ringLock);
+}
+
+uint32_t CameraModule::getOldestStoredTimestamp()
+{
+    uint32_t ts = millis();
+    portENTER_CRITICAL(&m_ringLock);
+    if (m_ringCount > 0 && m_ring[m_ringTail].state == SLOT_READY)
+    {
+        ts = m_ring[m_ringTail].frame.timestamp;
+    }
+    portEXIT_CRITICAL(&m_ringLock);
+    return ts;
+}
+
 bool CameraModule::setResolution(framesize_t size)
 {
+    // 초기화 전이면 이 해상도로 연다
+    if (!m_initialized)
+    {
+        m_frameSize = size;
+        return true;
+    }
+
     sensor_t *s = esp_camera_sensor_get();
     if (!s)
     {
@@ -149,10 +407,46 @@ bool CameraModule::setResolution(framesize_t size)
     return false;
 }
 
+bool CameraModule::setProfile(const String& name)
+{
+    const SensorProfile *profile = SensorProfile::find(name.c_str());
+    if (!profile)
+    {
+        return false;
+    }
+
+    if (!m_initialized)
+    {
+        m_profile = profile;
+        return true;
+    }
+
+    // esp_camera_deinit 없이 바뀌는 항목만 씀
+    sensor_t *s = esp_camera_sensor_get();
+    int writes = SensorProfile::apply(s, *profile);
+    if (writes < 0)
+    {
+        // 중간까지 쓴 항목을 이전 프로필로 되돌리고 프로필은 바꾸지 않음 (저장되지 않도록)
+        SensorProfile::apply(s, *m_profile);
+        return false;
+    }
+    m_profile = profile;
+    m_profileWrites = writes;
+    return true;
+}
+
 bool CameraModule::setResolutionByName(const String& name)
 {
     framesize_t size;
-    
+    if (!parseResolution(name, size))
+    {
+        return false;
+    }
+    return setResolution(size);
+}
+
+bool CameraModule::parseResolution(const String& name, framesize_t &size)
+{
     if (name == "QQVGA" || name == "qqvga")
         size = FRAMESIZE_QQVGA;    // 160x120
     else if (name == "QCIF" || name == "qcif")
@@ -176,7 +470,25 @@ bool CameraModule::setResolutionByName(const String& name)
     else
         return false;
 
-    return setResolution(size);
+    return true;
+}
+
+const char* CameraModule::frameSizeName(framesize_t size)
+{
+    switch (size)
+    {
+        case FRAMESIZE_QQVGA: return "QQVGA";
+        case FRAMESIZE_QCIF:  return "QCIF";
+        case FRAMESIZE_HQVGA: return "HQVGA";
+        case FRAMESIZE_QVGA:  return "QVGA";
+        case FRAMESIZE_CIF:   return "CIF";
+        case FRAMESIZE_VGA:   return "VGA";
+        case FRAMESIZE_SVGA:  return "SVGA";
+        case FRAMESIZE_XGA:   return "XGA";
+        case FRAMESIZE_SXGA:  return "SXGA";
+        case FRAMESIZE_UXGA:  return "UXGA";
+        default: return "Unknown";
+    }
 }
 
 String CameraModule::getResolutionName() const
@@ -197,6 +509,70 @@ String CameraModule::getResolutionName() const
     }
 }
 
+void CameraModule::observeFrame(const camera_fb_t *fb)
+{
+    // 파이프라인/스트림 태스크에서 동시에 호출될 수 있음
+    portENTER_CRITICAL(&m_qualityLock);
+    bool changed = m_quality.update(fb->len);
+    int quality = m_quality.getQuality();
+    portEXIT_CRITICAL(&m_qualityLock);
+
+    if (changed)
+    {
+        applyQuality(quality);
+    }
+}
+
+bool CameraModule::applyQuality(int quality)
+{
+    sensor_t *s = esp_camera_sensor_get();
+    if (!s)
+    {
+        return false;
+    }
+    return s->set_quality(s, quality) == 0;
+}
+
+void CameraModule::setJpegQuality(int quality)
+{
+    portENTER_CRITICAL(&m_qualityLock);
+    m_quality.setQuality(quality);
+    quality = m_quality.getQuality();
+    portEXIT_CRITICAL(&m_qualityLock);
+
+    if (m_initialized)
+    {
+        applyQuality(quality);
+    }
+}
+
+void CameraModule::restoreQualityState(int quality, uint32_t avgBytes)
+{
+    portENTER_CRITICAL(&m_qualityLock);
+    m_quality.restore(quality, avgBytes);
+    quality = m_quality.getQuality();
+    portEXIT_CRITICAL(&m_qualityLock);
+
+    if (m_initialized)
+    {
+        applyQuality(quality);
+    }
+}
+
+void CameraModule::setTargetBytes(uint32_t bytes)
+{
+    portENTER_CRITICAL(&m_qualityLock);
+    m_quality.setTarget(bytes);
+    portEXIT_CRITICAL(&m_qualityLock);
+}
+
+void CameraModule::setTargetHysteresis(int percent)
+{
+    portENTER_CRITICAL(&m_qualityLock);
+    m_quality.setHysteresis(percent);
+    portEXIT_CRITICAL(&m_qualityLock);
+}
+
 void CameraModule::flashOn()
 {
 #if FLASH_GPIO_NUM >= 0
@@ -225,122 +601,236 @@ void CameraModule::flashBlink(int times, int delayMs)
 #endif
 }
 
-void CameraModule::parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc)
+const CmdEntry<CameraModule::CmdHandler> CameraModule::COMMANDS[] = {
+    CMD_ENTRY("init", "init", &CameraModule::cmdInit),
+    CMD_ENTRY("capture", "capture", &CameraModule::cmdCapture),
+    CMD_ENTRY("status", "status", &CameraModule::cmdStatus),
+    CMD_ENTRY("resolution", "resolution [name]", &CameraModule::cmdResolution),
+    CMD_ENTRY("profile", "profile [day/night/flash]", &CameraModule::cmdProfile),
+    CMD_ENTRY("flash", "flash on/off/blink [n]", &CameraModule::cmdFlash),
+    CMD_ENTRY("quality", "quality [q]", &CameraModule::cmdQuality),
+    CMD_ENTRY("target", "target <bytes> [hyst%]", &CameraModule::cmdTarget),
+};
+
+void CameraModule::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
 {
-    int _tokenCount = tokens.size();
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
 
-    if (_tokenCount > 1)
+String CameraModule::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void CameraModule::cmdInit(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (init())
     {
-        String subCmd = tokens[1];
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = "camera initialized";
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "camera init failed";
+    }
+}
+
+void CameraModule::cmdCapture(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (capture())
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = "captured";
+        _res_doc["size"] = (unsigned long)getImageSize();
+
+        // 드라이버 버퍼를 쥐고 있으면 캡처 태스크가 남은 하나로만 돌게 되므로 바로 반환
+        releaseBuffer();
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "capture failed";
+    }
+}
 
-        if (subCmd == "init")
+void CameraModule::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["initialized"] = m_initialized;
+    _res_doc["resolution"] = getResolutionName();
+    _res_doc["profile"] = getProfileName();
+    _res_doc["psram"] = psramFound();
+    if (psramFound())
+    {
+        _res_doc["psram_size"] = ESP.getPsramSize();
+        _res_doc["psram_free"] = ESP.getFreePsram();
+    }
+    if (hasFrameRing())
+    {
+        JsonObject ring = _res_doc["ring"].to<JsonObject>();
+        ring["slots"] = m_ringSlots;
+        ring["slot_size"] = (unsigned long)m_ringSlotSize;
+        ring["count"] = m_ringCount;
+        ring["stored"] = m_ringStored;
+        ring["overwritten"] = m_ringOverwritten;
+        ring["rejected"] = m_ringRejected;
+    }
+}
+
+void CameraModule::cmdResolution(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        if (setResolutionByName(tokens[2]))
         {
-            if (init())
-            {
-                _res_doc["result"] = "ok";
-                _res_doc["ms"] = "camera initialized";
-            }
-            else
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "camera init failed";
-            }
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "resolution set";
+            _res_doc["resolution"] = getResolutionName();
         }
-        else if (subCmd == "capture")
+        else
         {
-            if (capture())
-            {
-                _res_doc["result"] = "ok";
-                _res_doc["ms"] = "captured";
-                _res_doc["size"] = (unsigned long)getImageSize();
-            }
-            else
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "capture failed";
-            }
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "invalid resolution";
+            _res_doc["available"] = "QQVGA,QCIF,HQVGA,QVGA,CIF,VGA,SVGA,XGA,SXGA,UXGA";
         }
-        else if (subCmd == "status")
+    }
+    else
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["resolution"] = getResolutionName();
+    }
+}
+
+void CameraModule::cmdProfile(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        if (setProfile(tokens[2]))
         {
             _res_doc["result"] = "ok";
-            _res_doc["initialized"] = m_initialized;
-            _res_doc["resolution"] = getResolutionName();
-            _res_doc["psram"] = psramFound();
-            if (psramFound())
-            {
-                _res_doc["psram_size"] = ESP.getPsramSize();
-                _res_doc["psram_free"] = ESP.getFreePsram();
-            }
+            _res_doc["profile"] = getProfileName();
+            _res_doc["writes"] = m_profileWrites;
         }
-        else if (subCmd == "resolution")
+        else
         {
-            if (_tokenCount > 2)
-            {
-                String res = tokens[2];
-                if (setResolutionByName(res))
-                {
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "resolution set";
-                    _res_doc["resolution"] = getResolutionName();
-                }
-                else
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "invalid resolution";
-                    _res_doc["available"] = "QQVGA,QCIF,HQVGA,QVGA,CIF,VGA,SVGA,XGA,SXGA,UXGA";
-                }
-            }
-            else
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = SensorProfile::find(tokens[2].c_str()) ? "sensor write failed" : "unknown profile";
+            JsonArray available = _res_doc["available"].to<JsonArray>();
+            for (int i = 0; i < SensorProfile::COUNT; i++)
             {
-                _res_doc["result"] = "ok";
-                _res_doc["resolution"] = getResolutionName();
+                available.add(SensorProfile::at(i).name);
             }
         }
-        else if (subCmd == "flash")
+    }
+    else
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["profile"] = getProfileName();
+        _res_doc["writes"] = m_profileWrites;
+    }
+}
+
+void CameraModule::cmdFlash(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        const TokenView &action = tokens[2];
+        if (action == "on")
         {
-            if (_tokenCount > 2)
-            {
-                String action = tokens[2];
-                if (action == "on")
-                {
-                    flashOn();
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "flash on";
-                }
-                else if (action == "off")
-                {
-                    flashOff();
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "flash off";
-                }
-                else if (action == "blink")
-                {
-                    int times = (_tokenCount > 3) ? tokens[3].toInt() : 3;
-                    flashBlink(times);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "flash blinked";
-                }
-                else
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "unknown flash command (on/off/blink)";
-                }
-            }
-            else
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "need flash command (on/off/blink)";
-            }
+            flashOn();
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "flash on";
+        }
+        else if (action == "off")
+        {
+            flashOff();
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "flash off";
+        }
+        else if (action == "blink")
+        {
+            int times = (tokens.size() > 3) ? tokens[3].toInt() : 3;
+            flashBlink(times);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "flash blinked";
         }
         else
         {
             _res_doc["result"] = "fail";
-            _res_doc["ms"] = "unknown sub command";
+            _res_doc["ms"] = "unknown flash command (on/off/blink)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need flash command (on/off/blink)";
+    }
+}
+
+void CameraModule::cmdQuality(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        // 수동 품질 지정 시 폐루프 제어는 끈다
+        setTargetBytes(0);
+        setJpegQuality(tokens[2].toInt());
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = "fixed quality";
+        _res_doc["jpeg_quality"] = getJpegQuality();
+        return;
+    }
+
+    _res_doc["result"] = "ok";
+    _res_doc["jpeg_quality"] = getJpegQuality();
+    _res_doc["target_bytes"] = getTargetBytes();
+    _res_doc["target_hyst"] = getTargetHysteresis();
+    portENTER_CRITICAL(&m_qualityLock);
+    uint32_t frames = m_quality.getFrames();
+    uint32_t inBand = m_quality.getInBand();
+    uint32_t adjustments = m_quality.getAdjustments();
+    uint32_t lastBytes = m_quality.getLastBytes();
+    uint32_t avgBytes = m_quality.getAvgBytes();
+    uint32_t minBytes = m_quality.getMinBytes();
+    uint32_t maxBytes = m_quality.getMaxBytes();
+    portEXIT_CRITICAL(&m_qualityLock);
+    _res_doc["frames"] = frames;
+    _res_doc["in_band"] = inBand;
+    _res_doc["adjustments"] = adjustments;
+    _res_doc["last_bytes"] = lastBytes;
+    _res_doc["avg_bytes"] = avgBytes;
+    _res_doc["min_bytes"] = minBytes;
+    _res_doc["max_bytes"] = maxBytes;
+}
+
+void CameraModule::cmdTarget(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        long bytes = tokens[2].toInt();
+        if (bytes < 0)
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "invalid target bytes";
+            return;
+        }
+        if (tokens.size() > 3)
+        {
+            setTargetHysteresis(tokens[3].toInt());
         }
+        setTargetBytes((uint32_t)bytes);
+        portENTER_CRITICAL(&m_qualityLock);
+        m_quality.resetStats();
+        portEXIT_CRITICAL(&m_qualityLock);
+
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = bytes > 0 ? "quality control on" : "quality control off";
+        _res_doc["target_bytes"] = getTargetBytes();
+        _res_doc["target_hyst"] = getTargetHysteresis();
     }
     else
     {
         _res_doc["result"] = "fail";
-        _res_doc["ms"] = "need sub command (init/capture/status/resolution/flash)";
+        _res_doc["ms"] = "need target bytes (0 = off)";
     }
 }
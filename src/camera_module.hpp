@@ -3,8 +3,13 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <vector>          
+#include <vector>
+#include <atomic>
 #include "esp_camera.h"
+#include "quality_controller.hpp"
+#include "sensor_profile.hpp"
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
 
 // ===========================================
 // 카메라 핀 정의 - 보드별 설정
@@ -162,12 +167,80 @@
 
 #endif
 
+// PSRAM 링 버퍼에 저장된 프레임 (store-and-forward 용)
+struct StoredFrame
+{
+    uint8_t *data = nullptr;
+    size_t len = 0;
+    uint32_t timestamp = 0;   // 캡처 시각 (millis)
+};
+
 class CameraModule
 {
+public:
+    static const int RING_MAX_SLOTS = 64;
+    static const int RING_PSRAM_PERCENT = 50;  // 링 버퍼에 쓸 여유 PSRAM 비율
+    static const BaseType_t INIT_CORE = 1;      // 비동기 초기화 태스크 (WiFi 스택과 다른 코어)
+    static const uint32_t INIT_STACK_SIZE = 4096;
+
+    enum InitState
+    {
+        INIT_IDLE,
+        INIT_RUNNING,
+        INIT_OK,
+        INIT_FAILED
+    };
+
 private:
     bool m_initialized = false;
     camera_fb_t *m_fb = nullptr;
     framesize_t m_frameSize = FRAMESIZE_VGA;  // 기본 해상도
+    int m_fbCount = 1;                        // 드라이버 프레임 버퍼 수
+    std::atomic<int> m_framesOut{0};          // grab()/capture() 로 빌려 간 프레임 수 (모든 태스크 합계)
+
+    // 비동기 초기화 (SCCB 레지스터 설정 동안 다른 초기화를 막지 않음)
+    volatile InitState m_initState = INIT_IDLE;
+    int m_initWarmup = 0;
+    uint32_t m_initMs = 0;                    // 초기화 + 워밍업 소요 시간
+    static void initTaskEntry(void *arg);
+
+    // 센서 설정 프로필 (init 과 전환 때 센서 상태와 다른 항목만 씀)
+    const SensorProfile *m_profile = &SensorProfile::defaultProfile();
+    int m_profileWrites = 0;                  // 마지막 적용에서 호출한 set_*() 수
+
+    // JPEG 품질 제어 (target_bytes 가 0 이면 고정 품질)
+    QualityController m_quality;
+    portMUX_TYPE m_qualityLock = portMUX_INITIALIZER_UNLOCKED;
+    void observeFrame(const camera_fb_t *fb);
+    bool applyQuality(int quality);
+
+    // 프레임 링 버퍼 (PSRAM, 한 번만 할당)
+    // 슬롯은 잠금 안에서 WRITING 으로 예약하고 head 를 넘긴 뒤 잠금 밖에서 복사,
+    // 복사가 끝나면 READY 로 바꾼다. 읽기/덮어쓰기는 READY 슬롯만 대상으로 한다.
+    enum SlotState : uint8_t
+    {
+        SLOT_FREE,
+        SLOT_WRITING,
+        SLOT_READY
+    };
+    struct RingSlot
+    {
+        StoredFrame frame;
+        SlotState state = SLOT_FREE;
+    };
+    uint8_t *m_ringBase = nullptr;
+    size_t m_ringSlotSize = 0;
+    framesize_t m_ringFrameSize = FRAMESIZE_INVALID;  // 슬롯 크기를 정한 해상도
+    int m_ringSlots = 0;
+    RingSlot m_ring[RING_MAX_SLOTS];
+    int m_ringHead = 0;                       // 다음에 쓸 슬롯
+    int m_ringTail = 0;                       // 가장 오래된 슬롯
+    int m_ringCount = 0;                      // 쓰는 중인 슬롯 포함
+    int m_ringReading = 0;                    // 업로드 중(잠긴) tail 쪽 슬롯 수
+    uint32_t m_ringStored = 0;
+    uint32_t m_ringOverwritten = 0;
+    uint32_t m_ringRejected = 0;
+    portMUX_TYPE m_ringLock = portMUX_INITIALIZER_UNLOCKED;
 
 public:
     CameraModule() {}
@@ -177,22 +250,72 @@ public:
         {
             esp_camera_fb_return(m_fb);
         }
+        if (m_ringBase)
+        {
+            free(m_ringBase);
+        }
     }
 
     bool init();
+    // APP CPU 태스크에서 init() 후 warmupFrames 장을 버리고 끝남 (바로 반환, 결과는 getInitState())
+    bool initAsync(int warmupFrames = 0);
+    inline InitState getInitState() const { return m_initState; }
+    inline uint32_t getInitMs() const { return m_initMs; }
     bool capture();
     void releaseBuffer();
+
+    // 파이프라인용: m_fb 와 무관하게 프레임을 직접 가져오고 반환
+    camera_fb_t* grab();
+    void returnFrame(camera_fb_t *fb);
+    void discardFrames(int count);             // 초기화 직후 AE/AWB 가 자리 잡는 동안의 프레임 버림
+
+    // 프레임 링 버퍼 (업링크 장애 시 보관 후 재전송)
+    bool initFrameRing();
+    // 가득 차면 가장 오래된 프레임을 덮어씀 (업로드 중인 프레임은 건너뜀), 여러 태스크에서 호출 가능
+    bool storeFrame(const uint8_t *data, size_t len, uint32_t timestamp);
+    bool peekStoredFrame(StoredFrame &frame);  // 가장 오래된 프레임 (pop/release 전까지 잠김)
+    int peekStoredFrames(StoredFrame *frames, int maxCount);  // 오래된 순서로 최대 maxCount 개
+    void popStoredFrame();                     // 잠긴 프레임을 모두 제거
+    void releaseStoredFrame();
+    uint32_t getOldestStoredTimestamp();
+    inline bool hasFrameRing() const { return m_ringBase != nullptr; }
+    inline int getStoredCount() const { return m_ringCount; }
+    inline bool isRingFull() const { return m_ringCount >= m_ringSlots; }
+    inline int getRingSlots() const { return m_ringSlots; }
+    inline framesize_t getRingFrameSize() const { return m_ringFrameSize; }
     
     // Getters
     inline bool isInitialized() const { return m_initialized; }
     inline camera_fb_t* getFrameBuffer() const { return m_fb; }
     inline size_t getImageSize() const { return m_fb ? m_fb->len : 0; }
     inline uint8_t* getImageData() const { return m_fb ? m_fb->buf : nullptr; }
+    inline int getFrameBufferCount() const { return m_fbCount; }
+    // 아직 빌려 가지 않은 드라이버 버퍼 수 (0 이면 esp_camera_fb_get() 이 막힌다)
+    inline int getFreeFrameBuffers() const { return m_fbCount - m_framesOut.load(); }
     
     // 해상도 설정
     bool setResolution(framesize_t size);
     bool setResolutionByName(const String& name);
     String getResolutionName() const;
+    inline framesize_t getFrameSize() const { return m_frameSize; }
+    static bool parseResolution(const String& name, framesize_t &size);
+    static const char* frameSizeName(framesize_t size);
+
+    // 센서 프로필 (day / night / flash, 초기화 중이면 바로 적용)
+    bool setProfile(const String& name);
+    inline const char* getProfileName() const { return m_profile->name; }
+
+    // JPEG 품질 (낮을수록 고품질) / 프레임 크기 목표
+    void setJpegQuality(int quality);
+    void setTargetBytes(uint32_t bytes);
+    void setTargetHysteresis(int percent);
+    inline int getJpegQuality() const { return m_quality.getQuality(); }
+    inline uint32_t getTargetBytes() const { return m_quality.getTarget(); }
+    inline int getTargetHysteresis() const { return m_quality.getHysteresis(); }
+
+    // 품질 제어 상태 (deep sleep 동안 RTC 메모리에 보관, init 전에 복원)
+    void restoreQualityState(int quality, uint32_t avgBytes);
+    inline uint32_t getQualityAvgBytes() const { return m_quality.getAvgBytes(); }
     
     // Flash LED 제어
     void flashOn();
@@ -200,7 +323,22 @@ public:
     void flashBlink(int times, int delayMs = 100);
 
     // 커맨드 파싱
-    void parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc);
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (CameraModule::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdInit(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdCapture(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdResolution(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdProfile(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdFlash(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdQuality(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdTarget(const tonkey &tokens, JsonDocument &_res_doc);
 };
 
 #endif // CAMERA_MODULE_HPP
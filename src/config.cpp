@@ -1,102 +1,406 @@
 #include "config.hpp"
+#include <esp_idf_version.h>
+#include <esp_rom_crc.h>
 
-void Config::parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc)
+void Config::load()
 {
-    int _tokenCount = tokens.size();
+    m_doc.clear();
+    m_doc.to<JsonObject>();
+    m_dirtyKeys.clear();
 
-    if (_tokenCount > 1)
+    if (!m_nvsOpen)
     {
-        String subCmd = tokens[1];
-        
-        if (subCmd == "load")
+        Serial.println("Config NVS open failed");
+        return;
+    }
+
+    uint8_t migrated = 0;
+    if (nvs_get_u8(m_nvs, MIGRATED_KEY, &migrated) != ESP_OK)
+    {
+        // 첫 부팅: 이전 EEPROM JSON 을 NVS 로 옮김
+        // 모든 키를 쓰고 커밋까지 성공했을 때만 표시 (아니면 다음 부팅에 다시 시도)
+        if (!migrateFromEeprom() || nvs_set_u8(m_nvs, MIGRATED_KEY, 1) != ESP_OK || nvs_commit(m_nvs) != ESP_OK)
         {
-            load();
-            _res_doc["result"] = "ok";
-            _res_doc["ms"] = "config loaded";
+            Serial.println("Config migration incomplete, retry on next boot");
         }
-        else if (subCmd == "save")
-        {
-            save();
-            _res_doc["result"] = "ok";
-            _res_doc["ms"] = "config saved";
-        }
-        else if (subCmd == "dump")
+    }
+
+    loadFromNvs();
+}
+
+void Config::loadFromNvs()
+{
+    // 이 네임스페이스의 모든 항목을 타입에 맞게 문서로 읽음
+#if ESP_IDF_VERSION_MAJOR >= 5
+    nvs_iterator_t it = nullptr;
+    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, NVS_NAMESPACE, NVS_TYPE_ANY, &it);
+    while (err == ESP_OK)
+    {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+#else
+    nvs_iterator_t it = nvs_entry_find(NVS_DEFAULT_PART_NAME, NVS_NAMESPACE, NVS_TYPE_ANY);
+    while (it != nullptr)
+    {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+#endif
+        String key(info.key);
+        if (info.key[0] == HASHED_PREFIX)
         {
-            String jsonStr = dump();
-            DeserializationError error = deserializeJson(_res_doc["ms"], jsonStr);
-            if (error)
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "json parse error";
-            }
-            else
+            // 이름 맵에서 원래 이름을 찾음 (맵이 없으면 버림)
+            if (!readStr(("_n" + String(info.key + 1)).c_str(), key))
             {
-                _res_doc["result"] = "ok";
+                key = "";
             }
         }
-        else if (subCmd == "clear")
+        else if (info.key[0] == '_')
         {
-            clear();
-            _res_doc["result"] = "ok";
-            _res_doc["ms"] = "config cleared";
+            key = "";
         }
-        else if (subCmd == "set")
+
+        if (key.length() > 0)
         {
-            if (_tokenCount > 3)
+            if (info.type == NVS_TYPE_I32)
             {
-                String key = tokens[2];
-                String value = tokens[3];
-
-                if (isNumber(value))
-                {
-                    set(key.c_str(), value.toInt());
-                }
-                else
+                int32_t value = 0;
+                if (nvs_get_i32(m_nvs, info.key, &value) == ESP_OK)
                 {
-                    set(key.c_str(), value);
+                    m_doc[key] = value;
                 }
-
-                _res_doc["result"] = "ok";
-                _res_doc["ms"] = "config set";
             }
-            else
+            else if (info.type == NVS_TYPE_STR)
             {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "need key and value";
+                String value;
+                if (readStr(info.key, value))
+                {
+                    m_doc[key] = value;   // 문서 안으로 복사됨
+                }
             }
         }
-        else if (subCmd == "get")
+#if ESP_IDF_VERSION_MAJOR >= 5
+        err = nvs_entry_next(&it);
+    }
+#else
+        it = nvs_entry_next(it);
+    }
+#endif
+    nvs_release_iterator(it);
+}
+
+// 옮길 내용이 없거나 모두 옮겨 커밋했으면 true
+bool Config::migrateFromEeprom()
+{
+    EEPROM.begin(EEPROM_SIZE);
+
+    char buffer[EEPROM_SIZE];
+    for (size_t i = 0; i < EEPROM_SIZE; ++i)
+    {
+        buffer[i] = EEPROM.read(EEPROM_START_ADDRESS + i);
+    }
+    buffer[EEPROM_SIZE - 1] = 0;
+    EEPROM.end();
+
+    if (buffer[0] != '{')
+    {
+        return true;
+    }
+
+    JsonDocument legacy;
+    m_parseCount++;
+    DeserializationError error = deserializeJson(legacy, (const char *)buffer);
+    if (error)
+    {
+        // 다시 읽어도 같으므로 옮길 것이 없는 것으로 처리
+        Serial.print(F("Legacy config parse failed: "));
+        Serial.println(error.f_str());
+        return true;
+    }
+
+    int count = 0;
+    int failed = 0;
+    for (JsonPair kv : legacy.as<JsonObject>())
+    {
+        String key(kv.key().c_str());
+        m_doc[key] = kv.value();
+        if (writeKey(key))
         {
-            if (_tokenCount > 2)
-            {
-                String key = tokens[2];
+            count++;
+        }
+        else
+        {
+            failed++;
+        }
+    }
+    if (nvs_commit(m_nvs) != ESP_OK)
+    {
+        failed++;
+    }
+    m_commitCount++;
 
-                if (!hasKey(key.c_str()))
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "key not exist";
-                }
-                else
-                {
-                    _res_doc["result"] = "ok";
-                    _res_doc["value"] = get<String>(key.c_str());
-                }
-            }
-            else
+    Serial.printf("Config migrated from EEPROM: %d keys, %d failed\n", count, failed);
+    return failed == 0;
+}
+
+bool Config::readStr(const char *nvsKey, String &value) const
+{
+    size_t len = 0;
+    if (nvs_get_str(m_nvs, nvsKey, nullptr, &len) != ESP_OK)
+    {
+        return false;
+    }
+    char *buffer = (char *)malloc(len);
+    bool ok = buffer && nvs_get_str(m_nvs, nvsKey, buffer, &len) == ESP_OK;
+    if (ok)
+    {
+        value = buffer;
+    }
+    free(buffer);
+    return ok;
+}
+
+// NVS 에 그대로 쓸 수 없는 이름은 "~xxxxxxxx" (이름의 CRC32)
+String Config::nvsKey(const String &key) const
+{
+    if (key.length() <= MAX_KEY_LENGTH && key[0] != '_' && key[0] != HASHED_PREFIX)
+    {
+        return key;
+    }
+    char hashed[MAX_KEY_LENGTH + 1];
+    snprintf(hashed, sizeof(hashed), "%c%08lx", HASHED_PREFIX,
+             (unsigned long)esp_rom_crc32_le(0, (const uint8_t *)key.c_str(), key.length()));
+    return String(hashed);
+}
+
+bool Config::writeKey(const String &key)
+{
+    JsonVariantConst value = m_doc[key];
+    String nk = nvsKey(key);
+    esp_err_t err;
+
+    if (nk != key)
+    {
+        // 이름 맵 "_nxxxxxxxx" → 원래 이름 (다른 이름이 같은 CRC 를 쓰고 있으면 실패)
+        String mapKey = "_n" + nk.substring(1);
+        String mapped;
+        if (!readStr(mapKey.c_str(), mapped))
+        {
+            err = nvs_set_str(m_nvs, mapKey.c_str(), key.c_str());
+            if (err != ESP_OK)
             {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "need key";
+                Serial.printf("Config write failed: %s (%s)\n", key.c_str(), esp_err_to_name(err));
+                return false;
             }
         }
+        else if (mapped != key)
+        {
+            Serial.printf("Config key hash collision: %s / %s\n", key.c_str(), mapped.c_str());
+            return false;
+        }
+    }
+
+    if (value.is<int>())
+    {
+        err = nvs_set_i32(m_nvs, nk.c_str(), value.as<int32_t>());
+        if (err == ESP_ERR_NVS_TYPE_MISMATCH)
+        {
+            // 같은 키가 다른 타입으로 저장되어 있으면 지우고 다시 기록
+            nvs_erase_key(m_nvs, nk.c_str());
+            err = nvs_set_i32(m_nvs, nk.c_str(), value.as<int32_t>());
+        }
+    }
+    else
+    {
+        String str = value.as<String>();
+        err = nvs_set_str(m_nvs, nk.c_str(), str.c_str());
+        if (err == ESP_ERR_NVS_TYPE_MISMATCH)
+        {
+            nvs_erase_key(m_nvs, nk.c_str());
+            err = nvs_set_str(m_nvs, nk.c_str(), str.c_str());
+        }
+    }
+
+    if (err != ESP_OK)
+    {
+        Serial.printf("Config write failed: %s (%s)\n", key.c_str(), esp_err_to_name(err));
+        return false;
+    }
+    m_keyWrites++;
+    return true;
+}
+
+bool Config::save()
+{
+    if (!m_nvsOpen)
+    {
+        return false;
+    }
+
+    // 실패한 키는 남겨 두었다가 다음 커밋 때 다시 기록
+    std::vector<String> failed;
+    for (const String &key : m_dirtyKeys)
+    {
+        if (!writeKey(key))
+        {
+            failed.push_back(key);
+        }
+    }
+    if (nvs_commit(m_nvs) != ESP_OK)
+    {
+        Serial.println("Config commit failed");
+        failed = m_dirtyKeys;
+    }
+    m_commitCount++;
+
+    m_dirtyKeys.swap(failed);
+    if (!m_dirtyKeys.empty())
+    {
+        m_writeFailures++;
+        m_lastChangeMs = millis();   // COMMIT_DELAY_MS 뒤에 재시도
+        return false;
+    }
+    return true;
+}
+
+void Config::clear()
+{
+    m_doc.clear();
+    m_doc.to<JsonObject>();
+    m_dirtyKeys.clear();
+
+    if (m_nvsOpen)
+    {
+        nvs_erase_all(m_nvs);
+        // 이전 EEPROM 내용이 다시 옮겨지지 않도록 표시는 유지
+        nvs_set_u8(m_nvs, MIGRATED_KEY, 1);
+        nvs_commit(m_nvs);
+        m_commitCount++;
+    }
+}
+
+const CmdEntry<Config::CmdHandler> Config::COMMANDS[] = {
+    CMD_ENTRY("load", "load", &Config::cmdLoad),
+    CMD_ENTRY("save", "save", &Config::cmdSave),
+    CMD_ENTRY("dump", "dump", &Config::cmdDump),
+    CMD_ENTRY("stats", "stats", &Config::cmdStats),
+    CMD_ENTRY("clear", "clear", &Config::cmdClear),
+    CMD_ENTRY("set", "set <key> <value>", &Config::cmdSet),
+    CMD_ENTRY("get", "get <key>", &Config::cmdGet),
+};
+
+void Config::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String Config::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void Config::cmdLoad(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 커밋되지 않은 변경은 버리고 플래시 내용으로 되돌림
+    load();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "config loaded";
+}
+
+void Config::cmdSave(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (!save())
+    {
+        _res_doc["result"] = "error";
+        _res_doc["ms"] = "config save failed: " + String((int)m_dirtyKeys.size()) + " keys pending";
+        return;
+    }
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "config saved";
+}
+
+void Config::cmdDump(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 상주 문서를 그대로 복사 (다시 파싱하지 않음)
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = doc();
+}
+
+void Config::cmdStats(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["parse_count"] = m_parseCount;
+    _res_doc["commit_count"] = m_commitCount;
+    _res_doc["key_writes"] = m_keyWrites;
+    _res_doc["write_failures"] = m_writeFailures;
+    JsonArray dirty = _res_doc["dirty"].to<JsonArray>();
+    for (const String &key : m_dirtyKeys)
+    {
+        dirty.add(key);
+    }
+}
+
+void Config::cmdClear(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    clear();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "config cleared";
+}
+
+void Config::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        bool ok;
+        if (isNumber(value))
+        {
+            ok = set(key.c_str(), value.toInt());
+        }
         else
+        {
+            ok = set<String>(key.c_str(), value);
+        }
+
+        if (ok)
+        {
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "config set";
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "invalid key (1-64 chars)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void Config::cmdGet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        const TokenView &key = tokens[2];
+
+        if (!hasKey(key.c_str()))
         {
             _res_doc["result"] = "fail";
-            _res_doc["ms"] = "unknown sub command";
+            _res_doc["ms"] = "key not exist";
+        }
+        else
+        {
+            _res_doc["result"] = "ok";
+            _res_doc["value"] = get<String>(key.c_str());
         }
     }
     else
     {
         _res_doc["result"] = "fail";
-        _res_doc["ms"] = "need sub command";
+        _res_doc["ms"] = "need key";
     }
 }
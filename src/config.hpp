@@ -5,16 +5,65 @@
 #include <EEPROM.h>
 #include <vector>
 #include <nvs_flash.h>
+#include <nvs.h>
 
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 설정 저장소
+// - 키마다 타입이 있는 NVS 항목(i32/str)으로 저장: 쓰기는 바뀐 키만, 읽기는 JSON 파싱 없음
+// - 메모리에는 JsonDocument 하나로 상주 (config dump 는 기존과 같은 JSON)
+// - 이전 펌웨어의 EEPROM JSON 은 첫 부팅 때 NVS 로 옮긴다
+// - NVS 키로 쓸 수 없는 이름(15 자 초과, '_'/'~' 시작)은 "~" + CRC32 키에 저장하고
+//   "_n" + CRC32 항목에 원래 이름을 남겨 읽을 때 되돌린다
 class Config
 {
 public:
-    const static int SystemVersion = 1;
-    static const size_t EEPROM_SIZE = 2048;
+    const static int SystemVersion = 2;
+    static const size_t EEPROM_SIZE = 2048;        // 이전 저장 형식 (마이그레이션 용)
     static const int EEPROM_START_ADDRESS = 0;
+    static const uint32_t COMMIT_DELAY_MS = 2000;  // 마지막 변경 후 커밋까지 대기 (debounce)
+    static const size_t MAX_KEY_LENGTH = 15;       // NVS 키 길이 제한 (NVS_KEY_NAME_MAX_SIZE - 1)
+    static const size_t MAX_NAME_LENGTH = 64;      // set() 으로 쓸 수 있는 설정 이름 길이
+
+private:
+    static constexpr const char *NVS_NAMESPACE = "config";
+    static constexpr const char *MIGRATED_KEY = "_migrated";   // '_' 로 시작하는 키는 내부용
+    static const char HASHED_PREFIX = '~';                     // 이름 대신 CRC32 로 저장한 키
+
+    nvs_handle_t m_nvs = 0;
+    bool m_nvsOpen = false;
+
+    // 설정 문서 (부팅 시 한 번 읽은 후 상주)
+    JsonDocument m_doc;
+    std::vector<String> m_dirtyKeys;   // 아직 플래시에 커밋되지 않은 키
+    uint32_t m_lastChangeMs = 0;
+    uint32_t m_parseCount = 0;
+    uint32_t m_commitCount = 0;
+    uint32_t m_keyWrites = 0;
+    uint32_t m_writeFailures = 0;   // 키가 남은 채로 끝난 커밋 수
+
+    inline void markDirty(const String &key)
+    {
+        for (const String &k : m_dirtyKeys)
+        {
+            if (k == key)
+            {
+                m_lastChangeMs = millis();
+                return;
+            }
+        }
+        m_dirtyKeys.push_back(key);
+        m_lastChangeMs = millis();
+    }
 
-    String jsonDoc;
+    void loadFromNvs();
+    bool migrateFromEeprom();   // 끝났으면 true (실패한 키가 있으면 false)
+    bool writeKey(const String &key);
+    String nvsKey(const String &key) const;
+    bool readStr(const char *nvsKey, String &value) const;
 
+public:
     Config()
     {
         // NVS 초기화
@@ -26,106 +75,109 @@ public:
         }
         ESP_ERROR_CHECK(err);
 
-        EEPROM.begin(EEPROM_SIZE);
+        m_nvsOpen = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &m_nvs) == ESP_OK;
         load();
     }
 
-    void load()
+    ~Config()
     {
-        char buffer[EEPROM_SIZE];
-        for (size_t i = 0; i < EEPROM_SIZE; ++i)
+        if (m_nvsOpen)
         {
-            buffer[i] = EEPROM.read(i);
+            nvs_close(m_nvs);
         }
+    }
 
-        if (buffer[0] != '{' && buffer[0] != '[')
-        {
-            jsonDoc = "{}";
-        }
-        else
+    // NVS 에서 다시 읽음 (커밋되지 않은 변경은 버림)
+    void load();
+    // 바뀐 키만 NVS 에 기록 (실패한 키는 dirty 로 남기고 false)
+    bool save();
+
+    // 변경 후 COMMIT_DELAY_MS 가 지나면 커밋 (스케줄러 태스크에서 주기 호출)
+    inline void commitIfDue()
+    {
+        if (!m_dirtyKeys.empty() && millis() - m_lastChangeMs >= COMMIT_DELAY_MS)
         {
-            jsonDoc = String(buffer);
+            save();
         }
     }
 
-    void save()
+    // 밀린 변경을 즉시 커밋
+    inline void flush()
     {
-        for (size_t i = 0; i < EEPROM_SIZE; ++i)
+        if (!m_dirtyKeys.empty())
         {
-            if (i < jsonDoc.length())
-            {
-                EEPROM.write(i, jsonDoc[i]);
-            }
-            else
-            {
-                EEPROM.write(i, 0);
-            }
+            save();
         }
-        EEPROM.commit();
     }
 
+    inline bool isDirty() const { return !m_dirtyKeys.empty(); }
+
     template <typename T>
-    void set(const char *key, T value)
+    bool set(const char *key, T value)
     {
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, jsonDoc);
-        if (error)
+        if (strlen(key) == 0 || strlen(key) > MAX_NAME_LENGTH || key[0] == '_' || key[0] == HASHED_PREFIX)
         {
-            Serial.print(F("deserializeJson() failed: "));
-            Serial.println(error.f_str());
-            return;
+            Serial.printf("Invalid config key: %s (max %d chars)\n", key, (int)MAX_NAME_LENGTH);
+            return false;
         }
 
-        doc[key] = value;
-        serializeJson(doc, jsonDoc);
-        save();
+        // 키는 String 으로 넘겨 문서 안에 복사되도록 함 (호출자 버퍼 수명과 무관)
+        String k(key);
+        JsonVariant current = m_doc[k];
+        if (!current.isNull() && current == value)
+        {
+            return true;
+        }
+        m_doc[k] = value;
+        markDirty(k);
+        return true;
     }
 
     template <typename T>
     T get(const char *key, T defaultValue = T()) const
     {
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, jsonDoc);
-        if (error)
-        {
-            Serial.print(F("deserializeJson() failed: "));
-            Serial.println(error.f_str());
-            return defaultValue;
-        }
-
         // 키가 존재하는지 확인 (타입 체크 대신 키 존재 여부만 체크)
-        if (!doc.containsKey(key))
+        JsonVariantConst value = m_doc[key];
+        if (value.isNull())
         {
             return defaultValue;
         }
 
         // as<T>()가 자동으로 타입 변환(숫자 -> 문자열)을 처리합니다.
-        return doc[key].as<T>();
+        return value.as<T>();
     }
 
     inline bool hasKey(const char *key) const
     {
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, jsonDoc);
-        if (error)
-        {
-            return false;
-        }
-        return doc[key].is<JsonVariant>();
+        return !m_doc[key].isNull();
     }
 
     inline String dump() const
     {
+        String jsonDoc;
+        serializeJson(m_doc, jsonDoc);
         return jsonDoc;
     }
 
-    inline void clear()
-    {
-        jsonDoc = "{}";
-        save();
-    }
+    inline JsonVariantConst doc() const { return m_doc.as<JsonVariantConst>(); }
+
+    void clear();
+
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (Config::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
 
-    void parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc);
+    void cmdLoad(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdSave(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdDump(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStats(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdClear(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdGet(const tonkey &tokens, JsonDocument &_res_doc);
 };
 
 // 숫자 체크 유틸리티
@@ -0,0 +1,182 @@
+#include "dup_filter.hpp"
+
+uint64_t DuplicateFilter::fingerprint(const uint8_t *gray, int width, int height)
+{
+    // 9x8 칸 평균 밝기
+    uint32_t cells[8][9];
+    for (int cy = 0; cy < 8; cy++)
+    {
+        int y0 = cy * height / 8;
+        int y1 = (cy + 1) * height / 8;
+        for (int cx = 0; cx < 9; cx++)
+        {
+            int x0 = cx * width / 9;
+            int x1 = (cx + 1) * width / 9;
+            uint32_t sum = 0;
+            for (int y = y0; y < y1; y++)
+            {
+                const uint8_t *row = gray + (size_t)y * width;
+                for (int x = x0; x < x1; x++)
+                {
+                    sum += row[x];
+                }
+            }
+            uint32_t count = (uint32_t)(y1 - y0) * (x1 - x0);
+            cells[cy][cx] = count ? sum / count : 0;
+        }
+    }
+
+    // 가로로 이웃한 칸의 밝기 증감 (전체 밝기 변화에 둔감)
+    uint64_t hash = 0;
+    for (int cy = 0; cy < 8; cy++)
+    {
+        for (int cx = 0; cx < 8; cx++)
+        {
+            hash <<= 1;
+            if (cells[cy][cx] < cells[cy][cx + 1])
+            {
+                hash |= 1;
+            }
+        }
+    }
+    return hash;
+}
+
+bool DuplicateFilter::check()
+{
+    m_checks++;
+
+    if (!m_thumb.isValid() || m_thumb.width() < 9 || m_thumb.height() < 8)
+    {
+        m_errors++;
+        return true;
+    }
+
+    uint32_t startUs = micros();
+    uint64_t hash = fingerprint(m_thumb.gray(), m_thumb.width(), m_thumb.height());
+    m_lastHashUs = m_thumb.getDecodeUs() + (micros() - startUs);
+    m_totalHashUs += m_lastHashUs;
+    if (m_lastHashUs > m_maxHashUs)
+    {
+        m_maxHashUs = m_lastHashUs;
+    }
+
+    uint32_t now = millis();
+    if (m_hasReference)
+    {
+        m_lastDistance = __builtin_popcountll(hash ^ m_reference);
+        if (m_lastDistance <= m_maxDistance)
+        {
+            if (now - m_referenceMs < m_heartbeat * 1000)
+            {
+                // 기준 프레임은 그대로 두어 조금씩 변하는 장면도 누적되면 업로드
+                m_skipped++;
+                return false;
+            }
+            m_heartbeats++;
+        }
+    }
+
+    m_reference = hash;
+    m_referenceMs = now;
+    m_hasReference = true;
+    m_passed++;
+    return true;
+}
+
+void DuplicateFilter::resetStats()
+{
+    m_checks = 0;
+    m_passed = 0;
+    m_skipped = 0;
+    m_heartbeats = 0;
+    m_errors = 0;
+    m_lastDistance = -1;
+    m_lastHashUs = 0;
+    m_maxHashUs = 0;
+    m_totalHashUs = 0;
+}
+
+const CmdEntry<DuplicateFilter::CmdHandler> DuplicateFilter::COMMANDS[] = {
+    CMD_ENTRY("set", "set enabled/dist/heartbeat <value>", &DuplicateFilter::cmdSet),
+    CMD_ENTRY("status", "status", &DuplicateFilter::cmdStatus),
+    CMD_ENTRY("reset", "reset", &DuplicateFilter::cmdReset),
+};
+
+void DuplicateFilter::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String DuplicateFilter::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void DuplicateFilter::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        if (key == "enabled" || key == "dedup")
+        {
+            setEnabled(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["dedup"] = m_enabled;
+        }
+        else if (key == "dist" || key == "dedup_dist")
+        {
+            setMaxDistance(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["dedup_dist"] = m_maxDistance;
+        }
+        else if (key == "heartbeat" || key == "dedup_heartbeat")
+        {
+            setHeartbeat(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["dedup_heartbeat"] = m_heartbeat;
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown key (enabled/dist/heartbeat)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void DuplicateFilter::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%08x%08x", (uint32_t)(m_reference >> 32), (uint32_t)m_reference);
+
+    _res_doc["result"] = "ok";
+    _res_doc["enabled"] = m_enabled;
+    _res_doc["max_dist"] = m_maxDistance;
+    _res_doc["heartbeat"] = m_heartbeat;
+    _res_doc["checks"] = m_checks;
+    _res_doc["passed"] = m_passed;
+    _res_doc["skipped"] = m_skipped;
+    _res_doc["heartbeats"] = m_heartbeats;
+    _res_doc["errors"] = m_errors;
+    _res_doc["last_dist"] = m_lastDistance;
+    _res_doc["reference"] = m_hasReference ? hex : "";
+    _res_doc["fingerprint_us"] = m_lastHashUs;
+    uint32_t hashed = m_passed + m_skipped;
+    _res_doc["fingerprint_avg_us"] = hashed ? (uint32_t)(m_totalHashUs / hashed) : 0;
+    _res_doc["fingerprint_max_us"] = m_maxHashUs;
+}
+
+void DuplicateFilter::cmdReset(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    resetReference();
+    resetStats();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "dedup reference reset";
+}
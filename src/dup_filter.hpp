@@ -0,0 +1,79 @@
+#ifndef DUP_FILTER_HPP
+#define DUP_FILTER_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "luma_thumb.hpp"
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 거의 같은 프레임 업로드 생략
+// - 1/8 썸네일(블록 DC 밝기)을 9x8 칸으로 줄여 64bit 차분 해시(dHash) 계산
+// - 마지막으로 업로드한 프레임과의 해밍 거리가 max_dist 이하이면 업로드 생략
+// - 그래도 heartbeat 초마다 한 장은 올려 카메라가 살아 있음을 알린다
+// 파이프라인 캡처 태스크에서 호출된다.
+class DuplicateFilter
+{
+public:
+    static const int MAX_DISTANCE = 32;
+
+    // 64bit 차분 해시 (gray: width x height, 최소 9x8)
+    static uint64_t fingerprint(const uint8_t *gray, int width, int height);
+
+private:
+    bool m_enabled = false;
+    int m_maxDistance = 4;          // 같은 장면으로 볼 최대 해밍 거리
+    uint32_t m_heartbeat = 600;     // 생략 중에도 최소 이 간격(초)으로 한 장 업로드
+
+    LumaThumbnail &m_thumb;
+
+    bool m_hasReference = false;
+    uint64_t m_reference = 0;       // 마지막으로 통과한 프레임의 해시
+    uint32_t m_referenceMs = 0;
+
+    // 통계
+    uint32_t m_checks = 0;
+    uint32_t m_passed = 0;
+    uint32_t m_skipped = 0;
+    uint32_t m_heartbeats = 0;
+    uint32_t m_errors = 0;
+    int m_lastDistance = -1;
+    uint32_t m_lastHashUs = 0;      // 디코드 + 해시
+    uint32_t m_maxHashUs = 0;
+    uint64_t m_totalHashUs = 0;
+
+public:
+    DuplicateFilter(LumaThumbnail &thumb) : m_thumb(thumb) {}
+    ~DuplicateFilter() {}
+
+    // 현재 썸네일 검사 (true = 업로드 대상)
+    // 썸네일 디코드에 실패했으면 놓치지 않도록 true
+    bool check();
+    inline void resetReference() { m_hasReference = false; }
+    void resetStats();
+
+    // 설정
+    inline void setEnabled(bool enabled) { m_enabled = enabled; m_hasReference = false; }
+    inline void setMaxDistance(int distance) { m_maxDistance = constrain(distance, 0, MAX_DISTANCE); }
+    inline void setHeartbeat(uint32_t sec) { m_heartbeat = sec < 10 ? 10 : sec; }
+
+    inline bool isEnabled() const { return m_enabled; }
+    inline int getMaxDistance() const { return m_maxDistance; }
+    inline uint32_t getHeartbeat() const { return m_heartbeat; }
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (DuplicateFilter::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdReset(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // DUP_FILTER_HPP
@@ -0,0 +1,339 @@
+#include "duty_cycle.hpp"
+#include <esp_sleep.h>
+#include <esp_rom_crc.h>
+
+// deep sleep 에서 깨어나도 남는 상태 (전원 인가 직후에는 쓰레기 값이므로 CRC 로 확인)
+static RTC_DATA_ATTR DutyCycleRtc s_rtc;
+
+uint32_t DutyCycle::rtcCrc(const DutyCycleRtc &rtc)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)&rtc, offsetof(DutyCycleRtc, crc));
+}
+
+void DutyCycle::loadRtc()
+{
+    if (s_rtc.magic == MAGIC && s_rtc.crc == rtcCrc(s_rtc))
+    {
+        m_rtc = s_rtc;
+        return;
+    }
+
+    memset(&m_rtc, 0, sizeof(m_rtc));
+    m_rtc.magic = MAGIC;
+    for (int i = 0; i < WakeCycle::MARK_COUNT; i++)
+    {
+        m_rtc.timeline[i] = WakeCycle::NOT_REACHED;
+    }
+}
+
+void DutyCycle::saveRtc(uint32_t awakeMs, uint32_t sleepMs)
+{
+    m_rtc.quality = m_camera.getJpegQuality();
+    m_rtc.avgBytes = m_camera.getQualityAvgBytes();
+    m_rtc.lastAwakeMs = awakeMs;
+    m_rtc.lastSleepMs = sleepMs;
+    for (int i = 0; i < WakeCycle::MARK_COUNT; i++)
+    {
+        m_rtc.timeline[i] = m_cycle.getMark((WakeCycle::Mark)i);
+    }
+    m_rtc.crc = rtcCrc(m_rtc);
+    s_rtc = m_rtc;
+}
+
+bool DutyCycle::begin()
+{
+    if (!m_enabled)
+    {
+        return false;
+    }
+
+    loadRtc();
+    m_rtc.wakes++;
+    m_active = true;
+
+    // 전원 인가/리셋으로 켜졌으면 잠시 깨어 있음 (콘솔 접근)
+    m_timerWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+    m_holdUntilMs = m_timerWake ? 0 : millis() + HOLD_MS;
+
+    // 깨어난 시각은 부팅 시점 (타임라인/budget 은 millis 0 기준)
+    m_cycle.begin(0, m_intervalMs, m_budgetMs);
+
+    // 지난 주기에 품질 제어가 정한 값으로 바로 시작 (재수렴 생략)
+    if (m_rtc.quality > 0)
+    {
+        m_camera.restoreQualityState(m_rtc.quality, m_rtc.avgBytes);
+    }
+
+    // 카메라 초기화는 APP CPU 태스크에서, WiFi 접속은 task_Wifi 에서 동시에 진행
+    m_camera.initAsync(m_warmup);
+
+    if (m_wifi.getSSID().length() > 0)
+    {
+        m_wifi.connect();
+    }
+
+    Serial.printf("Duty cycle wake #%u (%s, interval %ums, budget %ums)\n", (unsigned)m_rtc.wakes,
+                  m_timerWake ? "timer" : "reset", (unsigned)m_intervalMs, (unsigned)m_budgetMs);
+    return true;
+}
+
+bool DutyCycle::tick()
+{
+    if (!m_active)
+    {
+        return false;
+    }
+
+    uint32_t now = millis();
+
+    // 잠들 차례지만 콘솔 대기 중이거나 주기 모드를 끈 경우
+    if (m_cycle.getState() == WakeCycle::STATE_DONE && (!m_enabled || (m_holdUntilMs && now < m_holdUntilMs)))
+    {
+        return false;
+    }
+
+    CameraModule::InitState camera = m_camera.getInitState();
+    WakeCycle::Action action = m_cycle.step(now, camera == CameraModule::INIT_OK, camera == CameraModule::INIT_FAILED,
+                                            m_wifi.isConnected());
+    switch (action)
+    {
+    case WakeCycle::ACTION_CAPTURE:
+        capture();
+        break;
+    case WakeCycle::ACTION_UPLOAD:
+        upload();
+        break;
+    case WakeCycle::ACTION_SPOOL:
+        spoolFrame();
+        break;
+    case WakeCycle::ACTION_SLEEP:
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+void DutyCycle::capture()
+{
+    m_fb = m_camera.grab();
+    m_capturedAt = millis();
+    if (m_fb)
+    {
+        m_rtc.frameSeq++;
+    }
+    m_cycle.onCaptured(m_capturedAt, m_fb != nullptr);
+}
+
+void DutyCycle::upload()
+{
+    String fileName = "frame_" + String(m_rtc.frameSeq) + ".jpg";
+    String response;
+    int httpCode = m_uploader.uploadImage(m_fb->buf, m_fb->len, response, fileName, millis() - m_capturedAt);
+    bool ok = httpCode == 200 || httpCode == 201;
+
+    if (ok)
+    {
+        m_rtc.uploaded++;
+        m_rtc.failures = 0;
+        releaseFrame();
+    }
+    else
+    {
+        m_rtc.failures++;
+        Serial.printf("Duty cycle upload failed: %d\n", httpCode);
+        // 서버가 거부한 프레임은 다시 보내지 않음
+        if (httpCode >= 400 && httpCode < 500)
+        {
+            releaseFrame();
+        }
+    }
+    m_cycle.onUploaded(millis(), ok);
+
+    if (ok)
+    {
+        drainSpool();
+    }
+}
+
+void DutyCycle::spoolFrame()
+{
+    if (!m_fb)
+    {
+        return;
+    }
+
+    if (m_spool.isEnabled() && m_spool.append(m_fb->buf, m_fb->len, m_capturedAt))
+    {
+        m_rtc.spooled++;
+    }
+    releaseFrame();
+}
+
+void DutyCycle::drainSpool()
+{
+    for (int i = 0; i < MAX_DRAIN_PER_WAKE && m_wifi.isConnected() && millis() < m_budgetMs; i++)
+    {
+        SpoolRecord record;
+        if (!m_spool.peek(record))
+        {
+            return;
+        }
+
+        UploadReader reader = [this, &record](uint8_t *dst, size_t offset, size_t maxLen) -> size_t
+        {
+            return m_spool.read(record, offset, dst, maxLen);
+        };
+
+        String response;
+        int httpCode = m_uploader.uploadImageStream(reader, record.len, response, "", 0);
+        if (httpCode == 200 || httpCode == 201 || (httpCode >= 400 && httpCode < 500))
+        {
+            m_spool.pop(record);
+            continue;
+        }
+
+        m_spool.release();
+        return;
+    }
+}
+
+void DutyCycle::releaseFrame()
+{
+    if (m_fb)
+    {
+        m_camera.returnFrame(m_fb);
+        m_fb = nullptr;
+    }
+}
+
+void DutyCycle::sleep()
+{
+    releaseFrame();
+
+    uint32_t now = millis();
+    uint32_t sleepMs = m_cycle.sleepMs(now);
+    saveRtc(now, sleepMs);
+
+    Serial.printf("Wake #%u timeline:", (unsigned)m_rtc.wakes);
+    for (int i = 0; i < WakeCycle::MARK_COUNT; i++)
+    {
+        uint32_t mark = m_rtc.timeline[i];
+        if (mark != WakeCycle::NOT_REACHED)
+        {
+            Serial.printf(" %s %ums", WakeCycle::markName((WakeCycle::Mark)i), (unsigned)mark);
+        }
+    }
+    Serial.printf(" (camera init %ums, wifi %s %ums)\n", (unsigned)m_camera.getInitMs(),
+                  m_wifi.getLastJoin().method, (unsigned)m_wifi.getLastJoin().totalMs);
+    Serial.printf("Sleeping %ums\n", (unsigned)sleepMs);
+    Serial.flush();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+void DutyCycle::timelineToJson(const uint32_t *marks, JsonObject obj) const
+{
+    for (int i = 0; i < WakeCycle::MARK_COUNT; i++)
+    {
+        if (marks[i] != WakeCycle::NOT_REACHED)
+        {
+            obj[WakeCycle::markName((WakeCycle::Mark)i)] = marks[i];
+        }
+    }
+}
+
+const CmdEntry<DutyCycle::CmdHandler> DutyCycle::COMMANDS[] = {
+    CMD_ENTRY("set", "set enabled/budget/warmup <value>", &DutyCycle::cmdSet),
+    CMD_ENTRY("status", "status", &DutyCycle::cmdStatus),
+};
+
+void DutyCycle::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String DutyCycle::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void DutyCycle::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        if (key == "enabled" || key == "sleep_mode")
+        {
+            // 켜는 것은 다음 부팅부터 (saveall 후 reboot), 끄면 이번 주기부터 잠들지 않음
+            setEnabled(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["sleep_mode"] = m_enabled;
+        }
+        else if (key == "budget" || key == "sleep_budget")
+        {
+            setBudgetMs(value.toInt() < 1000 ? 1000 : value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["sleep_budget"] = m_budgetMs;
+        }
+        else if (key == "warmup" || key == "sleep_warmup")
+        {
+            setWarmup(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["sleep_warmup"] = m_warmup;
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown key (enabled/budget/warmup)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void DutyCycle::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["enabled"] = m_enabled;
+    _res_doc["active"] = m_active;
+    _res_doc["interval_ms"] = m_intervalMs;
+    _res_doc["budget_ms"] = m_budgetMs;
+    _res_doc["warmup"] = m_warmup;
+    if (!m_active)
+    {
+        return;
+    }
+
+    uint32_t now = millis();
+    _res_doc["wake"] = m_timerWake ? "timer" : "reset";
+    _res_doc["hold_ms"] = m_holdUntilMs > now ? m_holdUntilMs - now : 0;
+    _res_doc["wakes"] = m_rtc.wakes;
+    _res_doc["seq"] = m_rtc.frameSeq;
+    _res_doc["uploaded"] = m_rtc.uploaded;
+    _res_doc["spooled"] = m_rtc.spooled;
+    _res_doc["failures"] = m_rtc.failures;
+    _res_doc["camera_init_ms"] = m_camera.getInitMs();
+
+    uint32_t marks[WakeCycle::MARK_COUNT];
+    for (int i = 0; i < WakeCycle::MARK_COUNT; i++)
+    {
+        marks[i] = m_cycle.getMark((WakeCycle::Mark)i);
+    }
+    timelineToJson(marks, _res_doc["timeline"].to<JsonObject>());
+
+    // 지난 주기 (첫 부팅이면 없음)
+    if (m_rtc.lastAwakeMs > 0)
+    {
+        JsonObject last = _res_doc["last"].to<JsonObject>();
+        last["awake_ms"] = m_rtc.lastAwakeMs;
+        last["sleep_ms"] = m_rtc.lastSleepMs;
+        timelineToJson(m_rtc.timeline, last["timeline"].to<JsonObject>());
+    }
+}
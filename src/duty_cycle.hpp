@@ -0,0 +1,112 @@
+#ifndef DUTY_CYCLE_HPP
+#define DUTY_CYCLE_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "camera_module.hpp"
+#include "wifi_module.hpp"
+#include "http_upload.hpp"
+#include "frame_spool.hpp"
+#include "wake_cycle.hpp"
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// deep sleep 동안 RTC 메모리에 남기는 상태
+struct DutyCycleRtc
+{
+    uint32_t magic;
+    uint32_t wakes;
+    uint32_t frameSeq;        // 업로드 파일 이름 번호 (frame_<seq>.jpg)
+    int32_t quality;          // 품질 제어가 마지막으로 정한 값
+    uint32_t avgBytes;        // 품질 제어 프레임 크기 평균
+    uint32_t uploaded;
+    uint32_t spooled;
+    uint32_t failures;        // 연속 업로드 실패
+    uint32_t lastAwakeMs;     // 지난 주기에 깨어 있던 시간
+    uint32_t lastSleepMs;
+    uint32_t timeline[WakeCycle::MARK_COUNT];
+    uint32_t crc;
+};
+
+// deep sleep 주기 모드 (sleep_mode = 1)
+// 깨어나면 카메라 초기화(APP CPU 태스크)와 WiFi 접속을 동시에 시작하고,
+// 한 장 캡처 → 업로드 → upload_interval 에서 깨어 있던 시간을 뺀 만큼 잔다.
+// 진행 순서는 WakeCycle 이 정하고, 여기서는 카메라/WiFi/업로더/스풀에 연결만 한다.
+// - 품질 제어 상태, 파일 번호, 지난 주기 타임라인은 RTC 메모리에 보관 (WiFi 접속 캐시는 WifiModule)
+// - budget 안에 링크가 없거나 업로드가 실패하면 프레임을 스풀에 넣고, 성공한 주기에 몇 장씩 다시 보낸다
+// - 타이머가 아닌 이유로 깨어났으면(전원 인가/리셋) HOLD_MS 동안 잠들지 않는다 (콘솔로 설정 변경 가능)
+class DutyCycle
+{
+public:
+    static const uint32_t MAGIC = 0x44555459;     // "DUTY"
+    static const uint32_t HOLD_MS = 30000;
+    static const int MAX_DRAIN_PER_WAKE = 4;      // 한 주기에 다시 보낼 스풀 프레임 수
+
+private:
+    CameraModule &m_camera;
+    WifiModule &m_wifi;
+    HttpUploader &m_uploader;
+    FrameSpool &m_spool;
+    WakeCycle m_cycle;
+    DutyCycleRtc m_rtc;
+
+    bool m_enabled = false;
+    bool m_active = false;                    // 이번 부팅을 주기 모드로 시작했는지
+    uint32_t m_intervalMs = 60000;
+    uint32_t m_budgetMs = 15000;
+    int m_warmup = 2;                         // 초기화 후 버릴 프레임 수
+    uint32_t m_holdUntilMs = 0;
+    bool m_timerWake = false;
+
+    camera_fb_t *m_fb = nullptr;
+    uint32_t m_capturedAt = 0;
+
+    void capture();
+    void upload();
+    void spoolFrame();
+    void drainSpool();
+    void releaseFrame();
+    void loadRtc();
+    void saveRtc(uint32_t awakeMs, uint32_t sleepMs);
+    static uint32_t rtcCrc(const DutyCycleRtc &rtc);
+    void timelineToJson(const uint32_t *marks, JsonObject obj) const;
+
+public:
+    DutyCycle(CameraModule &camera, WifiModule &wifi, HttpUploader &uploader, FrameSpool &spool)
+        : m_camera(camera), m_wifi(wifi), m_uploader(uploader), m_spool(spool) {}
+    ~DutyCycle() {}
+
+    // 설정 로드 후 setup 에서 호출 (카메라 태스크 시작 + WiFi 접속)
+    bool begin();
+    inline bool isActive() const { return m_active; }
+
+    // 스케줄러 태스크에서 호출, 잠들 차례가 되면 true
+    bool tick();
+    // 타임라인/상태를 RTC 에 남기고 deep sleep (돌아오지 않음)
+    void sleep();
+
+    // 설정
+    inline void setEnabled(bool enabled) { m_enabled = enabled; }
+    inline void setIntervalMs(uint32_t ms) { m_intervalMs = ms; }
+    inline void setBudgetMs(uint32_t ms) { m_budgetMs = ms; }
+    inline void setWarmup(int frames) { m_warmup = frames < 0 ? 0 : frames; }
+
+    inline bool isEnabled() const { return m_enabled; }
+    inline uint32_t getBudgetMs() const { return m_budgetMs; }
+    inline int getWarmup() const { return m_warmup; }
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (DutyCycle::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // DUTY_CYCLE_HPP
@@ -0,0 +1,665 @@
+#include "frame_spool.hpp"
+#include <esp_rom_crc.h>
+
+static const char *SPOOL_DIR = "/spool";
+static const char *CURSOR_PATH = "/spool/cursor";
+
+// 읽기 위치 파일 (세그먼트 번호 + 오프셋)
+// 덮어쓰다 전원이 꺼져 CRC 가 맞지 않으면 가장 오래된 세그먼트 처음부터 다시 보낸다
+struct SpoolCursor
+{
+    uint32_t seq;
+    uint32_t offset;
+    uint32_t crc;
+};
+
+bool FrameSpool::lock()
+{
+    return xSemaphoreTake(m_lock, portMAX_DELAY) == pdTRUE;
+}
+
+void FrameSpool::unlock()
+{
+    xSemaphoreGive(m_lock);
+}
+
+uint32_t FrameSpool::maxBytes() const
+{
+    if (m_maxKb > 0)
+    {
+        return m_maxKb * 1024;
+    }
+    return (uint32_t)((uint64_t)m_capacity * AUTO_PERCENT / 100);
+}
+
+uint32_t FrameSpool::headerCrc(const RecordHeader &header)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)&header, offsetof(RecordHeader, headerCrc));
+}
+
+String FrameSpool::segmentPath(uint32_t seq)
+{
+    char path[24];
+    snprintf(path, sizeof(path), "%s/%08x.seg", SPOOL_DIR, (unsigned)seq);
+    return String(path);
+}
+
+bool FrameSpool::readHeader(File &file, uint32_t offset, uint32_t limit, RecordHeader &header)
+{
+    if (offset + sizeof(RecordHeader) > limit)
+    {
+        return false;
+    }
+    if (!file.seek(offset) || file.read((uint8_t *)&header, sizeof(header)) != sizeof(header))
+    {
+        return false;
+    }
+    return header.magic == MAGIC && header.headerCrc == headerCrc(header) &&
+           header.len > 0 && header.len <= SEGMENT_SIZE - sizeof(RecordHeader) &&
+           offset + sizeof(RecordHeader) + header.len <= limit;
+}
+
+bool FrameSpool::begin(size_t capacity)
+{
+    if (!m_lock)
+    {
+        m_lock = xSemaphoreCreateMutex();
+        if (!m_lock)
+        {
+            return false;
+        }
+    }
+
+    m_capacity = capacity;
+    m_bootId = esp_random() | 1;
+
+    if (!m_fs.exists(SPOOL_DIR) && !m_fs.mkdir(SPOOL_DIR))
+    {
+        Serial.println("Spool dir create failed");
+        return false;
+    }
+
+    lock();
+    recover();
+    m_ready = true;
+    unlock();
+
+    Serial.printf("Spool ready: %u frames pending, %u KB used (limit %u KB)\n",
+                  (unsigned)m_pending, (unsigned)(m_usedBytes / 1024), (unsigned)(maxBytes() / 1024));
+    return true;
+}
+
+// ===========================================
+// 부팅 시 복구
+// ===========================================
+void FrameSpool::scanSegment(Segment &seg)
+{
+    seg.bytes = 0;
+    seg.size = 0;
+    seg.records = 0;
+
+    File file = m_fs.open(segmentPath(seg.seq), "r");
+    if (!file)
+    {
+        return;
+    }
+
+    // 헤더만 따라가며 온전한 레코드 끝을 찾는다 (본문 CRC 는 재전송 직전에 확인)
+    seg.size = file.size();
+    RecordHeader header;
+    while (readHeader(file, seg.bytes, seg.size, header))
+    {
+        seg.bytes += sizeof(RecordHeader) + header.len;
+        seg.records++;
+    }
+    file.close();
+
+    if (seg.bytes < seg.size)
+    {
+        m_tornBytes += seg.size - seg.bytes;
+    }
+}
+
+void FrameSpool::recover()
+{
+    uint32_t cursorSeq = 0;
+    uint32_t cursorOffset = 0;
+    loadCursor(cursorSeq, cursorOffset);
+
+    // 세그먼트 목록 (번호 오름차순)
+    m_segCount = 0;
+    uint32_t maxSeq = cursorSeq;
+    File dir = m_fs.open(SPOOL_DIR);
+    File entry = dir ? dir.openNextFile() : File();
+    while (entry)
+    {
+        String name = entry.name();
+        int slash = name.lastIndexOf('/');
+        if (slash >= 0)
+        {
+            name = name.substring(slash + 1);
+        }
+        bool isSegment = !entry.isDirectory() && name.endsWith(".seg");
+        entry.close();
+
+        uint32_t seq = strtoul(name.c_str(), nullptr, 16);
+        if (isSegment && seq > 0 && m_segCount < MAX_SEGMENTS)
+        {
+            int i = m_segCount++;
+            while (i > 0 && m_segs[i - 1].seq > seq)
+            {
+                m_segs[i] = m_segs[i - 1];
+                i--;
+            }
+            m_segs[i].seq = seq;
+            if (seq > maxSeq)
+            {
+                maxSeq = seq;
+            }
+        }
+        entry = dir.openNextFile();
+    }
+    if (dir)
+    {
+        dir.close();
+    }
+    m_nextSeq = maxSeq + 1;
+
+    // 이미 보낸 세그먼트와 빈 세그먼트는 지우고 나머지는 레코드를 센다
+    int kept = 0;
+    for (int i = 0; i < m_segCount; i++)
+    {
+        Segment seg = m_segs[i];
+        if (seg.seq >= cursorSeq)
+        {
+            scanSegment(seg);
+        }
+        if (seg.seq < cursorSeq || seg.records == 0)
+        {
+            m_fs.remove(segmentPath(seg.seq));
+            continue;
+        }
+        m_segs[kept++] = seg;
+        m_usedBytes += seg.size;
+        m_pending += seg.records;
+    }
+    m_segCount = kept;
+
+    // 읽기 위치가 레코드 경계와 맞으면 이어서, 아니면 세그먼트 처음부터
+    m_readOffset = 0;
+    m_readIndex = 0;
+    if (m_segCount > 0 && m_segs[0].seq == cursorSeq && cursorOffset > 0)
+    {
+        File file = m_fs.open(segmentPath(cursorSeq), "r");
+        uint32_t offset = 0;
+        uint32_t index = 0;
+        RecordHeader header;
+        while (file && offset < cursorOffset && readHeader(file, offset, m_segs[0].bytes, header))
+        {
+            offset += sizeof(RecordHeader) + header.len;
+            index++;
+        }
+        if (file)
+        {
+            file.close();
+        }
+        if (offset == cursorOffset)
+        {
+            m_readOffset = offset;
+            m_readIndex = index;
+            m_pending -= index;
+        }
+    }
+    m_recovered = m_pending;
+}
+
+bool FrameSpool::loadCursor(uint32_t &seq, uint32_t &offset)
+{
+    File file = m_fs.open(CURSOR_PATH, "r");
+    if (!file)
+    {
+        return false;
+    }
+    SpoolCursor cursor;
+    bool ok = file.read((uint8_t *)&cursor, sizeof(cursor)) == sizeof(cursor) &&
+              cursor.crc == esp_rom_crc32_le(0, (const uint8_t *)&cursor, offsetof(SpoolCursor, crc));
+    file.close();
+    if (ok)
+    {
+        seq = cursor.seq;
+        offset = cursor.offset;
+    }
+    return ok;
+}
+
+void FrameSpool::saveCursor()
+{
+    SpoolCursor cursor;
+    cursor.seq = m_segCount > 0 ? m_segs[0].seq : m_nextSeq;
+    cursor.offset = m_segCount > 0 ? m_readOffset : 0;
+    cursor.crc = esp_rom_crc32_le(0, (const uint8_t *)&cursor, offsetof(SpoolCursor, crc));
+
+    File file = m_fs.open(CURSOR_PATH, "w");
+    if (!file || file.write((const uint8_t *)&cursor, sizeof(cursor)) != sizeof(cursor))
+    {
+        m_writeErrors++;
+    }
+    if (file)
+    {
+        file.close();
+    }
+}
+
+// ===========================================
+// 세그먼트 관리 (잠금 상태에서 호출)
+// ===========================================
+bool FrameSpool::openSegment()
+{
+    if (m_writeFile)
+    {
+        m_writeFile.close();
+    }
+    if (m_segCount == MAX_SEGMENTS && !dropOldest())
+    {
+        return false;
+    }
+
+    uint32_t seq = m_nextSeq++;
+    m_writeFile = m_fs.open(segmentPath(seq), "w");
+    if (!m_writeFile)
+    {
+        m_writeErrors++;
+        return false;
+    }
+
+    Segment &seg = m_segs[m_segCount++];
+    seg.seq = seq;
+    seg.bytes = 0;
+    seg.size = 0;
+    seg.records = 0;
+    return true;
+}
+
+void FrameSpool::closeFiles()
+{
+    if (m_writeFile)
+    {
+        m_writeFile.close();
+    }
+    if (m_readFile)
+    {
+        m_readFile.close();
+    }
+}
+
+bool FrameSpool::dropOldest()
+{
+    // 업로드 중인 레코드가 있는 세그먼트는 버리지 않음
+    if (m_segCount == 0 || m_reading)
+    {
+        return false;
+    }
+    m_dropped += m_segs[0].records - m_readIndex;
+    removeOldest();
+    return true;
+}
+
+void FrameSpool::removeOldest()
+{
+    if (m_readFile)
+    {
+        m_readFile.close();
+    }
+    if (m_segCount == 1 && m_writeFile)
+    {
+        m_writeFile.close();
+    }
+
+    m_pending -= m_segs[0].records - m_readIndex;
+    m_usedBytes -= m_segs[0].size;
+    m_fs.remove(segmentPath(m_segs[0].seq));
+
+    m_segCount--;
+    memmove(&m_segs[0], &m_segs[1], m_segCount * sizeof(Segment));
+    m_readOffset = 0;
+    m_readIndex = 0;
+}
+
+// ===========================================
+// 기록 / 재전송
+// ===========================================
+bool FrameSpool::append(const uint8_t *data, size_t len, uint32_t timestamp)
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    uint32_t recordLen = sizeof(RecordHeader) + len;
+    if (len == 0 || recordLen > SEGMENT_SIZE)
+    {
+        m_rejected++;
+        return false;
+    }
+
+    // CRC 는 잠금 밖에서 계산
+    uint32_t startMs = millis();
+    RecordHeader header;
+    header.magic = MAGIC;
+    header.len = len;
+    header.timestamp = timestamp;
+    header.bootId = m_bootId;
+    header.dataCrc = esp_rom_crc32_le(0, data, len);
+    header.headerCrc = headerCrc(header);
+
+    lock();
+
+    // 보관 한도를 넘으면 가장 오래된 세그먼트부터 버림
+    while (m_usedBytes + recordLen > maxBytes())
+    {
+        if (!dropOldest())
+        {
+            unlock();
+            m_rejected++;
+            return false;
+        }
+    }
+
+    if (!m_writeFile || m_segs[m_segCount - 1].bytes + recordLen > SEGMENT_SIZE)
+    {
+        if (!openSegment())
+        {
+            unlock();
+            m_rejected++;
+            return false;
+        }
+    }
+
+    // 헤더 + 본문을 이어서 쓰고 한 번만 flush
+    Segment &seg = m_segs[m_segCount - 1];
+    size_t written = m_writeFile.write((const uint8_t *)&header, sizeof(header));
+    if (written == sizeof(header))
+    {
+        written += m_writeFile.write(data, len);
+    }
+    m_writeFile.flush();
+
+    seg.size += written;
+    m_usedBytes += written;
+    if (written != recordLen)
+    {
+        // 일부만 쓰인 레코드는 읽지 않으며, 다음 레코드는 새 세그먼트에 쓴다
+        m_writeFile.close();
+        m_writeErrors++;
+        unlock();
+        m_rejected++;
+        return false;
+    }
+
+    seg.bytes += recordLen;
+    seg.records++;
+    m_pending++;
+    m_appended++;
+    unlock();
+
+    m_lastWriteMs = millis() - startMs;
+    if (m_lastWriteMs > m_maxWriteMs)
+    {
+        m_maxWriteMs = m_lastWriteMs;
+    }
+    return true;
+}
+
+bool FrameSpool::peek(SpoolRecord &record)
+{
+    if (!m_ready || m_pending == 0)
+    {
+        return false;
+    }
+
+    lock();
+    while (m_pending > 0 && m_segCount > 0)
+    {
+        Segment &seg = m_segs[0];
+        if (m_readIndex >= seg.records)
+        {
+            removeOldest();
+            saveCursor();
+            continue;
+        }
+
+        // 쓰는 중인 세그먼트는 길이가 늘었으면 다시 연다
+        if (!m_readFile || m_readSeq != seg.seq || m_readLimit < seg.bytes)
+        {
+            if (m_readFile)
+            {
+                m_readFile.close();
+            }
+            m_readFile = m_fs.open(segmentPath(seg.seq), "r");
+            m_readSeq = seg.seq;
+            m_readLimit = seg.bytes;
+            if (!m_readFile)
+            {
+                break;
+            }
+        }
+
+        RecordHeader header;
+        if (!readHeader(m_readFile, m_readOffset, seg.bytes, header))
+        {
+            // 헤더가 깨지면 세그먼트 나머지는 따라갈 수 없음
+            uint32_t lost = seg.records - m_readIndex;
+            m_corrupt += lost;
+            m_pending -= lost;
+            m_readIndex = seg.records;
+            m_readOffset = seg.bytes;
+            continue;
+        }
+
+        // 본문 CRC 확인 (업로드 도중에는 되돌릴 수 없으므로 미리)
+        uint32_t crc = 0;
+        uint32_t remaining = header.len;
+        while (remaining > 0)
+        {
+            size_t chunk = remaining < sizeof(m_crcBuf) ? remaining : sizeof(m_crcBuf);
+            if (m_readFile.read(m_crcBuf, chunk) != chunk)
+            {
+                break;
+            }
+            crc = esp_rom_crc32_le(crc, m_crcBuf, chunk);
+            remaining -= chunk;
+        }
+        if (remaining > 0 || crc != header.dataCrc)
+        {
+            m_corrupt++;
+            advance(sizeof(RecordHeader) + header.len);
+            saveCursor();
+            continue;
+        }
+
+        record.seq = seg.seq;
+        record.offset = m_readOffset;
+        record.len = header.len;
+        record.timestamp = header.timestamp;
+        record.sameBoot = header.bootId == m_bootId;
+        m_reading = true;
+        unlock();
+        return true;
+    }
+    unlock();
+    return false;
+}
+
+size_t FrameSpool::read(const SpoolRecord &record, uint32_t offset, uint8_t *dst, size_t maxLen)
+{
+    if (offset >= record.len)
+    {
+        return 0;
+    }
+    if (maxLen > record.len - offset)
+    {
+        maxLen = record.len - offset;
+    }
+
+    size_t n = 0;
+    lock();
+    if (m_reading && m_readFile && m_readSeq == record.seq &&
+        m_readFile.seek(record.offset + sizeof(RecordHeader) + offset))
+    {
+        n = m_readFile.read(dst, maxLen);
+    }
+    unlock();
+    return n;
+}
+
+void FrameSpool::pop(const SpoolRecord &record)
+{
+    lock();
+    if (m_reading && m_segCount > 0 && m_segs[0].seq == record.seq && m_readOffset == record.offset)
+    {
+        advance(sizeof(RecordHeader) + record.len);
+        m_replayed++;
+        if (m_readIndex >= m_segs[0].records)
+        {
+            removeOldest();
+        }
+        saveCursor();
+    }
+    m_reading = false;
+    unlock();
+}
+
+void FrameSpool::release()
+{
+    lock();
+    m_reading = false;
+    unlock();
+}
+
+bool FrameSpool::clear()
+{
+    if (!m_ready)
+    {
+        return false;
+    }
+
+    lock();
+    if (m_reading)
+    {
+        unlock();
+        return false;
+    }
+    closeFiles();
+    while (m_segCount > 0)
+    {
+        removeOldest();
+    }
+    m_pending = 0;
+    m_usedBytes = 0;
+    m_fs.remove(CURSOR_PATH);
+    unlock();
+    return true;
+}
+
+// ===========================================
+// 커맨드
+// ===========================================
+const CmdEntry<FrameSpool::CmdHandler> FrameSpool::COMMANDS[] = {
+    CMD_ENTRY("set", "set enabled/max_kb <value>", &FrameSpool::cmdSet),
+    CMD_ENTRY("status", "status", &FrameSpool::cmdStatus),
+    CMD_ENTRY("flush", "flush", &FrameSpool::cmdFlush),
+    CMD_ENTRY("clear", "clear", &FrameSpool::cmdClear),
+};
+
+void FrameSpool::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String FrameSpool::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void FrameSpool::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        if (key == "enabled" || key == "spool")
+        {
+            setEnabled(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["spool"] = m_enabled;
+        }
+        else if (key == "max_kb" || key == "spool_max_kb")
+        {
+            setMaxKb(value.toInt() < 0 ? 0 : value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["spool_max_kb"] = m_maxKb;
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown key (enabled/max_kb)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void FrameSpool::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["enabled"] = m_enabled;
+    _res_doc["mounted"] = m_ready;
+    _res_doc["capacity_kb"] = (uint32_t)(m_capacity / 1024);
+    _res_doc["max_kb"] = maxBytes() / 1024;
+    _res_doc["used_kb"] = m_usedBytes / 1024;
+    _res_doc["segments"] = m_segCount;
+    _res_doc["pending"] = m_pending;
+    _res_doc["appended"] = m_appended;
+    _res_doc["replayed"] = m_replayed;
+    _res_doc["dropped"] = m_dropped;
+    _res_doc["rejected"] = m_rejected;
+    _res_doc["corrupt"] = m_corrupt;
+    _res_doc["write_errors"] = m_writeErrors;
+    _res_doc["recovered"] = m_recovered;
+    _res_doc["torn_bytes"] = m_tornBytes;
+    _res_doc["write_ms"] = m_lastWriteMs;
+    _res_doc["write_max_ms"] = m_maxWriteMs;
+}
+
+void FrameSpool::cmdFlush(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (!m_ready)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "spool not mounted";
+        return;
+    }
+    // 업로드 태스크가 재시도 대기를 건너뛰고 바로 재전송
+    m_replayRequested = true;
+    _res_doc["result"] = "ok";
+    _res_doc["pending"] = m_pending;
+}
+
+void FrameSpool::cmdClear(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    uint32_t pending = m_pending;
+    if (clear())
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["cleared"] = pending;
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = m_ready ? "spool busy (upload in progress)" : "spool not mounted";
+    }
+}
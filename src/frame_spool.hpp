@@ -0,0 +1,158 @@
+#ifndef FRAME_SPOOL_HPP
+#define FRAME_SPOOL_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 스풀에서 꺼낸 레코드 (pop/release 전까지 잠김)
+struct SpoolRecord
+{
+    uint32_t seq = 0;         // 세그먼트 번호
+    uint32_t offset = 0;      // 세그먼트 안의 레코드 시작 위치
+    uint32_t len = 0;         // JPEG 크기
+    uint32_t timestamp = 0;   // 캡처 시각 (millis, 기록한 부팅 기준)
+    bool sameBoot = false;    // 이번 부팅에 기록한 레코드인지 (frame-age-ms 계산 가능 여부)
+};
+
+// 플래시(LittleFS/SD) 업로드 스풀
+// PSRAM 링 버퍼로도 감당하지 못하는 긴 업링크 장애 동안 프레임을 보관한다.
+// - 고정 크기 세그먼트 파일(/spool/<seq>.seg)에 레코드를 이어 붙이기만 한다
+//   (프레임마다 파일을 만들지 않고, 헤더 + JPEG 를 순차 쓰기 후 한 번 flush)
+// - 레코드 헤더에 헤더 CRC 와 본문 CRC 를 두어 쓰는 도중 전원이 꺼져도
+//   부팅 시 마지막 온전한 레코드까지만 살린다
+// - 재전송은 가장 오래된 레코드부터, 서버 응답 후 읽기 위치(cursor)를 기록 (최소 1회 전송)
+// - 사용량이 max_kb 를 넘으면 가장 오래된 세그먼트부터 버린다
+// 캡처/업로드 태스크가 함께 쓰므로 파일 접근은 뮤텍스로 묶는다.
+class FrameSpool
+{
+public:
+    static const uint32_t SEGMENT_SIZE = 256 * 1024;
+    static const int MAX_SEGMENTS = 128;
+    static const int AUTO_PERCENT = 75;       // max_kb = 0 일 때 파일시스템 용량 중 사용할 비율
+    static const uint32_t MAGIC = 0x314C5053; // "SPL1"
+
+private:
+    // 레코드 헤더 (뒤에 JPEG 본문)
+    struct RecordHeader
+    {
+        uint32_t magic;
+        uint32_t len;
+        uint32_t timestamp;
+        uint32_t bootId;
+        uint32_t dataCrc;
+        uint32_t headerCrc;   // 앞 20바이트
+    };
+
+    struct Segment
+    {
+        uint32_t seq;
+        uint32_t bytes;       // 온전한 레코드가 끝나는 위치
+        uint32_t size;        // 플래시에서 차지하는 크기 (찢어진 꼬리 포함)
+        uint32_t records;
+    };
+
+    fs::FS &m_fs;
+    SemaphoreHandle_t m_lock = nullptr;
+    bool m_ready = false;
+    bool m_enabled = true;
+    uint32_t m_maxKb = 0;             // 0 = 자동
+    size_t m_capacity = 0;            // 파일시스템 전체 크기
+    uint32_t m_bootId = 0;
+
+    Segment m_segs[MAX_SEGMENTS];     // 오래된 순서
+    int m_segCount = 0;
+    uint32_t m_nextSeq = 1;
+    uint32_t m_usedBytes = 0;
+    uint32_t m_pending = 0;           // 보내지 않은 레코드 수
+
+    File m_writeFile;                 // 마지막 세그먼트 (열려 있을 때만 이어 쓰기)
+    File m_readFile;                  // 첫 세그먼트
+    uint32_t m_readSeq = 0;
+    uint32_t m_readLimit = 0;         // m_readFile 을 열 때의 세그먼트 길이
+    uint32_t m_readOffset = 0;        // 첫 세그먼트의 읽기 위치
+    uint32_t m_readIndex = 0;         // 첫 세그먼트에서 처리한 레코드 수
+    bool m_reading = false;
+    volatile bool m_replayRequested = false;
+    uint8_t m_crcBuf[1024];
+
+    // 통계
+    uint32_t m_appended = 0;
+    uint32_t m_replayed = 0;
+    uint32_t m_dropped = 0;           // 용량 초과로 버린 레코드
+    uint32_t m_rejected = 0;          // 기록하지 못한 프레임
+    uint32_t m_corrupt = 0;           // CRC 오류로 건너뛴 레코드
+    uint32_t m_writeErrors = 0;
+    uint32_t m_recovered = 0;         // 부팅 시 되살린 레코드
+    uint32_t m_tornBytes = 0;         // 부팅 시 버린 찢어진 꼬리
+    uint32_t m_lastWriteMs = 0;
+    uint32_t m_maxWriteMs = 0;
+
+    bool lock();
+    void unlock();
+    uint32_t maxBytes() const;
+    static uint32_t headerCrc(const RecordHeader &header);
+    static String segmentPath(uint32_t seq);
+    static bool readHeader(File &file, uint32_t offset, uint32_t limit, RecordHeader &header);
+
+    void recover();
+    void scanSegment(Segment &seg);
+    bool loadCursor(uint32_t &seq, uint32_t &offset);
+    void saveCursor();
+    bool openSegment();
+    void closeFiles();
+    bool dropOldest();
+    void removeOldest();
+    inline void advance(uint32_t recordLen) { m_readOffset += recordLen; m_readIndex++; m_pending--; }
+
+public:
+    FrameSpool(fs::FS &fs) : m_fs(fs) {}
+    ~FrameSpool() {}
+
+    // 파일시스템 마운트 후 호출 (capacity: 파일시스템 전체 바이트)
+    // 남아 있는 세그먼트를 검사해 읽기 위치와 대기 레코드 수를 복구
+    bool begin(size_t capacity);
+    inline bool isReady() const { return m_ready; }
+
+    // 캡처/업로드 태스크에서 호출
+    bool append(const uint8_t *data, size_t len, uint32_t timestamp);
+    bool peek(SpoolRecord &record);           // 가장 오래된 레코드 (본문 CRC 확인 후)
+    size_t read(const SpoolRecord &record, uint32_t offset, uint8_t *dst, size_t maxLen);
+    void pop(const SpoolRecord &record);      // 보냈거나 거부된 레코드 제거
+    void release();                           // 다음에 다시 시도
+    bool clear();
+
+    // 재전송 대기 중인 파이프라인을 깨움 (spool flush)
+    inline bool takeReplayRequest() { bool requested = m_replayRequested; m_replayRequested = false; return requested; }
+
+    // 설정
+    inline void setEnabled(bool enabled) { m_enabled = enabled; }
+    inline void setMaxKb(uint32_t kb) { m_maxKb = kb; }
+
+    inline bool isEnabled() const { return m_enabled && m_ready; }
+    inline bool getEnabled() const { return m_enabled; }
+    inline uint32_t getMaxKb() const { return m_maxKb; }
+    inline uint32_t getPendingCount() const { return m_pending; }
+    inline bool hasPending() const { return m_pending > 0; }
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (FrameSpool::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdFlush(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdClear(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // FRAME_SPOOL_HPP
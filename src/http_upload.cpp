@@ -1,4 +1,5 @@
 #include "http_upload.hpp"
+#include "latency_stats.hpp"
 #include <WiFi.h>
 
 int HttpUploader::uploadImage(uint8_t* data, size_t len, const String& fileName)
@@ -7,9 +8,32 @@ int HttpUploader::uploadImage(uint8_t* data, size_t len, const String& fileName)
     return uploadImage(data, len, response, fileName);
 }
 
-int HttpUploader::uploadImage(uint8_t* data, size_t len, String& response, const String& fileName)
+int HttpUploader::uploadImage(uint8_t* data, size_t len, String& response, const String& fileName, uint32_t ageMs)
 {
-    if (m_serverUrl.length() == 0)
+    UploadReader reader = [data, len](uint8_t *dst, size_t offset, size_t maxLen) -> size_t
+    {
+        size_t n = len - offset;
+        if (n > maxLen)
+        {
+            n = maxLen;
+        }
+        memcpy(dst, data + offset, n);
+        return n;
+    };
+    return uploadImageStream(reader, len, response, fileName, ageMs);
+}
+
+int HttpUploader::uploadImageStream(UploadReader reader, size_t len, String& response, const String& fileName, uint32_t ageMs)
+{
+    return request(reader, len, "image/jpeg", response, fileName, ageMs);
+}
+
+int HttpUploader::request(UploadReader &reader, size_t len, const String& contentType, String& response, const String& fileName, uint32_t ageMs)
+{
+    xSemaphoreTake(m_configLock, portMAX_DELAY);
+    bool hasUrl = m_serverUrl.length() > 0;
+    xSemaphoreGive(m_configLock);
+    if (!hasUrl)
     {
         Serial.println("Server URL not set");
         return -1;
@@ -21,130 +45,828 @@ int HttpUploader::uploadImage(uint8_t* data, size_t len, String& response, const
         return -2;
     }
 
-    HTTPClient http;
-    String fullUrl = getFullUrl();
-    
-    Serial.printf("Uploading to: %s\n", fullUrl.c_str());
+    // 파이프라인 업로드 태스크와 콘솔 upload 명령이 같은 연결을 공유
+    xSemaphoreTake(m_lock, portMAX_DELAY);
+
+    // 이 요청에 쓸 설정 사본 (요청 중에 콘솔에서 바꿔도 다음 요청부터 적용)
+    if (!parseServerUrl())
+    {
+        xSemaphoreGive(m_lock);
+        Serial.println("Invalid server URL (http://host[:port][/path])");
+        return -1;
+    }
+
+    if (len == 0 && !m_target.chunked)
+    {
+        xSemaphoreGive(m_lock);
+        Serial.println("Unknown body length requires chunked mode");
+        return HTTPC_ERROR_TOO_LESS_RAM;
+    }
+
+    if (!m_bounce)
+    {
+        m_bounce = (uint8_t *)heap_caps_malloc(CHUNK_HEADER_SIZE + BOUNCE_PAYLOAD + 2, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!m_bounce)
+        {
+            xSemaphoreGive(m_lock);
+            Serial.println("Upload bounce buffer alloc failed");
+            return HTTPC_ERROR_TOO_LESS_RAM;
+        }
+    }
+
+    // 서버가 바뀌었으면 기존 연결은 버림
+    if (m_connServerUrl != m_target.serverUrl)
+    {
+        m_client.stop();
+        m_connServerUrl = m_target.serverUrl;
+    }
+
+    m_lastTiming = UploadTiming();
+    m_lastTiming.bytes = len;
+
+    Serial.printf("Uploading to: %s%s\n", m_target.serverUrl.c_str(), m_target.path.c_str());
     Serial.printf("Image size: %d bytes\n", len);
 
-    http.begin(fullUrl);
-    http.setTimeout(m_timeout);
-    
-    // 헤더 설정
-    http.addHeader("Content-Type", "image/jpeg");
-    http.addHeader("device-id", m_deviceId);
+    uint32_t startUs = micros();
+    bool reused = m_client.connected();
+    int httpCode = post(reader, len, contentType, response, fileName, ageMs);
+
+    // 재사용한 연결을 서버가 이미 닫았으면 새 연결로 한 번 더 시도
+    if (reused && (httpCode == HTTPC_ERROR_CONNECTION_LOST ||
+                   httpCode == HTTPC_ERROR_SEND_HEADER_FAILED ||
+                   httpCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+                   httpCode == HTTPC_ERROR_NOT_CONNECTED))
+    {
+        Serial.println("Keep-alive connection lost, reconnecting");
+        m_client.stop();
+        m_reconnects++;
+        httpCode = post(reader, len, contentType, response, fileName, ageMs);
+    }
+    LatencyStats::record(LatencyStats::UPLOAD, micros() - startUs);
+
+    if (httpCode > 0)
+    {
+        Serial.printf("HTTP Response code: %d\n", httpCode);
+        Serial.println("Response: " + response);
+    }
+    else
+    {
+        Serial.printf("HTTP POST failed, error: %s\n", HTTPClient::errorToString(httpCode).c_str());
+        m_client.stop();
+    }
+
+    size_t internalFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (internalFree < m_minInternalFree)
+    {
+        m_minInternalFree = internalFree;
+    }
+
+    m_lastTiming.httpCode = httpCode;
+    if (m_firstOkMs == 0 && (httpCode == 200 || httpCode == 201))
+    {
+        m_firstOkMs = millis();
+    }
+    xSemaphoreGive(m_lock);
+    return httpCode;
+}
+
+int HttpUploader::uploadBatch(const UploadFrame *frames, int count, String& response)
+{
+    if (count <= 0)
+    {
+        return -1;
+    }
+
+    // 본문 = [파트 헤더][JPEG][CRLF] * count + [종료 경계]
+    // JPEG 는 복사하지 않고 원래 위치(PSRAM 링 버퍼)를 그대로 가리킨다
+    struct Segment
+    {
+        const uint8_t *data;
+        size_t len;
+    };
+
+    std::vector<String> headers;
+    std::vector<Segment> segments;
+    headers.reserve(count + 1);
+    segments.reserve(count * 3 + 1);
+
+    String deviceId = getDeviceId();
+    uint32_t now = millis();
+    for (int i = 0; i < count; i++)
+    {
+        const UploadFrame &f = frames[i];
+        String fileName = f.fileName.length() > 0 ? f.fileName : "frame_" + String(f.timestamp) + ".jpg";
+
+        String part;
+        part.reserve(256);
+        part += "--" BATCH_BOUNDARY "\r\n";
+        part += "Content-Disposition: form-data; name=\"image\"; filename=\"" + fileName + "\"\r\n";
+        part += "Content-Type: image/jpeg\r\n";
+        part += "file-name: " + fileName + "\r\n";
+        part += "device-id: " + deviceId + "\r\n";
+        part += "frame-timestamp: " + String(f.timestamp) + "\r\n";
+        part += "frame-age-ms: " + String(now - f.timestamp) + "\r\n\r\n";
+        headers.push_back(part);
+    }
+    headers.push_back("--" BATCH_BOUNDARY "--\r\n");
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        segments.push_back({ (const uint8_t *)headers[i].c_str(), headers[i].length() });
+        segments.push_back({ frames[i].data, frames[i].len });
+        segments.push_back({ (const uint8_t *)"\r\n", 2 });
+    }
+    segments.push_back({ (const uint8_t *)headers[count].c_str(), headers[count].length() });
+    for (const Segment &seg : segments)
+    {
+        total += seg.len;
+    }
+
+    // 순차 읽기이므로 현재 세그먼트 위치를 기억 (재연결 시 offset 0 이면 처음부터)
+    size_t segIndex = 0;
+    size_t segStart = 0;
+    UploadReader reader = [&](uint8_t *dst, size_t offset, size_t maxLen) -> size_t
+    {
+        if (offset < segStart)
+        {
+            segIndex = 0;
+            segStart = 0;
+        }
+        size_t written = 0;
+        while (written < maxLen && segIndex < segments.size())
+        {
+            const Segment &seg = segments[segIndex];
+            size_t inSeg = offset + written - segStart;
+            if (inSeg >= seg.len)
+            {
+                segStart += seg.len;
+                segIndex++;
+                continue;
+            }
+            size_t n = seg.len - inSeg;
+            if (n > maxLen - written)
+            {
+                n = maxLen - written;
+            }
+            memcpy(dst + written, seg.data + inSeg, n);
+            written += n;
+        }
+        return written;
+    };
+
+    int httpCode = request(reader, total, "multipart/form-data; boundary=" BATCH_BOUNDARY, response, "", 0);
+    if (httpCode == 200 || httpCode == 201)
+    {
+        m_batchRequests++;
+        m_batchFrames += count;
+    }
+    return httpCode;
+}
+
+bool HttpUploader::parseServerUrl()
+{
+    xSemaphoreTake(m_configLock, portMAX_DELAY);
+    bool urlChanged = m_target.serverUrl != m_serverUrl || m_target.host.length() == 0;
+    if (urlChanged)
+    {
+        m_target.serverUrl = m_serverUrl;
+    }
+    m_target.path = m_uploadPath;
+    m_target.authToken = m_authToken;
+    m_target.deviceId = m_deviceId;
+    xSemaphoreGive(m_configLock);
+    m_target.chunked = m_chunked;
+    m_target.timeout = m_timeout;
+
+    if (urlChanged)
+    {
+        // http://host[:port][/path] 만 지원 (setServerUrl 에서 다른 스킴은 거부)
+        String url = m_target.serverUrl;
+        if (url.startsWith("http://"))
+        {
+            url = url.substring(7);
+        }
+        else if (url.indexOf("://") >= 0)
+        {
+            m_target.host = "";
+            return false;
+        }
+
+        m_target.basePath = "";
+        int slash = url.indexOf('/');
+        if (slash >= 0)
+        {
+            m_target.basePath = url.substring(slash);
+            url = url.substring(0, slash);
+            while (m_target.basePath.endsWith("/"))
+            {
+                m_target.basePath.remove(m_target.basePath.length() - 1);
+            }
+        }
+
+        int colon = url.indexOf(':');
+        if (colon >= 0)
+        {
+            m_target.host = url.substring(0, colon);
+            m_target.port = url.substring(colon + 1).toInt();
+        }
+        else
+        {
+            m_target.host = url;
+            m_target.port = 80;
+        }
+        if (m_target.port == 0)
+        {
+            m_target.host = "";
+        }
+    }
+
+    // 요청 경로 = server_url 의 경로 + 업로드 경로 (http://h/cam + /upload → /cam/upload)
+    if (m_target.path.length() == 0 || m_target.path[0] != '/')
+    {
+        m_target.path = "/" + m_target.path;
+    }
+    if (m_target.basePath.length() > 0)
+    {
+        m_target.path = m_target.basePath + m_target.path;
+    }
+    return m_target.host.length() > 0;
+}
+
+String HttpUploader::readConfig(const String &field) const
+{
+    xSemaphoreTake(m_configLock, portMAX_DELAY);
+    String value = field;
+    xSemaphoreGive(m_configLock);
+    return value;
+}
+
+void HttpUploader::writeConfig(String &field, const String &value)
+{
+    xSemaphoreTake(m_configLock, portMAX_DELAY);
+    field = value;
+    xSemaphoreGive(m_configLock);
+}
+
+bool HttpUploader::setServerUrl(const String& url)
+{
+    // TLS 클라이언트(WiFiClientSecure)가 없으므로 https 로 평문을 보내지 않도록 거부
+    if (!url.startsWith("http://") && url.indexOf("://") >= 0)
+    {
+        Serial.printf("Unsupported server URL scheme (http:// only): %s\n", url.c_str());
+        return false;
+    }
+    writeConfig(m_serverUrl, url);
+    return true;
+}
+
+void HttpUploader::setUploadPath(const String& path)
+{
+    writeConfig(m_uploadPath, path);
+}
+
+void HttpUploader::setAuthToken(const String& token)
+{
+    writeConfig(m_authToken, token);
+}
+
+void HttpUploader::setDeviceId(const String& id)
+{
+    writeConfig(m_deviceId, id);
+}
+
+String HttpUploader::getServerUrl() const
+{
+    return readConfig(m_serverUrl);
+}
+
+String HttpUploader::getUploadPath() const
+{
+    return readConfig(m_uploadPath);
+}
+
+String HttpUploader::getAuthToken() const
+{
+    return readConfig(m_authToken);
+}
+
+String HttpUploader::getDeviceId() const
+{
+    return readConfig(m_deviceId);
+}
+
+String HttpUploader::getFullUrl() const
+{
+    xSemaphoreTake(m_configLock, portMAX_DELAY);
+    String url = m_serverUrl + m_uploadPath;
+    xSemaphoreGive(m_configLock);
+    return url;
+}
+
+bool HttpUploader::ensureConnected()
+{
+    if (m_client.connected())
+    {
+        return true;
+    }
+
+    m_client.stop();
+    if (!m_client.connect(m_target.host.c_str(), m_target.port, m_target.timeout))
+    {
+        return false;
+    }
+    // 마지막 부분 세그먼트가 Nagle 에 묶이지 않도록
+    m_client.setNoDelay(true);
+    m_connOpened++;
+    return true;
+}
+
+UploadTiming HttpUploader::getLastTiming()
+{
+    xSemaphoreTake(m_lock, portMAX_DELAY);
+    UploadTiming timing = m_lastTiming;
+    xSemaphoreGive(m_lock);
+    return timing;
+}
+
+// 요청 라인 + 헤더 (빈 줄까지)
+String HttpUploader::buildRequestHeader(size_t len, const String& contentType, const String& fileName, uint32_t ageMs) const
+{
+    String header;
+    header.reserve(256);
+    header += "POST " + m_target.path + " HTTP/1.1\r\n";
+    header += "Host: " + m_target.host + "\r\n";
+    header += "Connection: keep-alive\r\n";
+    header += "Content-Type: " + contentType + "\r\n";
+    header += "device-id: " + m_target.deviceId + "\r\n";
     
-    if (m_authToken.length() > 0)
+    if (m_target.authToken.length() > 0)
     {
-        http.addHeader("auth-token", m_authToken);
+        header += "auth-token: " + m_target.authToken + "\r\n";
     }
     
     if (fileName.length() > 0)
     {
-        http.addHeader("file-name", fileName);
+        header += "file-name: " + fileName + "\r\n";
     }
 
-    // POST 요청
-    int httpCode = http.POST(data, len);
+    if (ageMs > 0)
+    {
+        header += "frame-age-ms: " + String(ageMs) + "\r\n";
+    }
 
-    if (httpCode > 0)
+    if (m_target.chunked)
     {
-        response = http.getString();
-        Serial.printf("HTTP Response code: %d\n", httpCode);
-        Serial.println("Response: " + response);
+        header += "Transfer-Encoding: chunked\r\n\r\n";
     }
     else
     {
-        Serial.printf("HTTP POST failed, error: %s\n", http.errorToString(httpCode).c_str());
+        header += "Content-Length: " + String((unsigned long)len) + "\r\n\r\n";
+    }
+    return header;
+}
+
+int HttpUploader::post(UploadReader &reader, size_t len, const String& contentType, String& response, const String& fileName, uint32_t ageMs)
+{
+    uint32_t startUs = micros();
+    bool reused = m_client.connected();
+    if (!ensureConnected())
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    m_requests++;
+
+    uint32_t sendStartUs = micros();
+    m_lastTiming.connectMs = 0;
+    if (!reused)
+    {
+        LatencyStats::record(LatencyStats::CONNECT, sendStartUs - startUs);
+        m_lastTiming.connectMs = (sendStartUs - startUs) / 1000;
     }
 
-    http.end();
+    String header = buildRequestHeader(len, contentType, fileName, ageMs);
+    if (m_client.write((const uint8_t *)header.c_str(), header.length()) != header.length())
+    {
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+
+    int err = sendBody(reader, len);
+    if (err < 0)
+    {
+        return err;
+    }
+
+    uint32_t sentUs = micros();
+    LatencyStats::record(LatencyStats::SEND, sentUs - sendStartUs);
+    m_lastTiming.sendMs = (sentUs - sendStartUs) / 1000;
+    int httpCode = readResponse(response);
+    m_lastTiming.rttMs = (micros() - sentUs) / 1000;
     return httpCode;
 }
 
-void HttpUploader::parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc)
+int HttpUploader::sendBody(UploadReader &reader, size_t len)
 {
-    int _tokenCount = tokens.size();
+    uint8_t *payload = m_bounce + CHUNK_HEADER_SIZE;
+    size_t offset = 0;
 
-    if (_tokenCount > 1)
+    for (;;)
     {
-        String subCmd = tokens[1];
+        size_t want = BOUNCE_PAYLOAD;
+        if (len > 0)
+        {
+            if (offset >= len)
+            {
+                break;
+            }
+            if (len - offset < want)
+            {
+                want = len - offset;
+            }
+        }
 
-        if (subCmd == "set")
+        size_t n = reader(payload, offset, want);
+        if (n == 0)
         {
-            if (_tokenCount > 3)
+            if (len > 0)
             {
-                String key = tokens[2];
-                String value = tokens[3];
+                // 길이를 알려준 본문이 모자라면 요청이 깨진 것
+                return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+            }
+            break;
+        }
 
-                // [수정] Config 키와 이름을 통일 (server_url, server_path, auth_token, device_id)
-                // 기존 짧은 이름(url, path 등)도 호환성을 위해 유지하거나 제거할 수 있습니다.
-                // 여기서는 명확한 관리를 위해 Config 키를 우선으로 처리하도록 변경합니다.
+        const uint8_t *out = payload;
+        size_t outLen = n;
+        if (m_target.chunked)
+        {
+            // 청크 크기(hex)를 페이로드 바로 앞에 붙이고 뒤에 CRLF
+            char hex[CHUNK_HEADER_SIZE + 1];
+            int hexLen = snprintf(hex, sizeof(hex), "%X\r\n", (unsigned)n);
+            memcpy(payload - hexLen, hex, hexLen);
+            payload[n] = '\r';
+            payload[n + 1] = '\n';
+            out = payload - hexLen;
+            outLen = hexLen + n + 2;
+        }
 
-                if (key == "server_url" || key == "url") // url은 편의상 허용하되 저장은 server_url 개념
-                {
-                    setServerUrl(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "server url set";
-                    _res_doc["server_url"] = value; // 응답 키도 server_url로 통일
-                }
-                else if (key == "server_path" || key == "path")
-                {
-                    setUploadPath(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "upload path set";
-                    _res_doc["server_path"] = value;
-                }
-                else if (key == "auth_token" || key == "token")
-                {
-                    setAuthToken(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "auth token set";
-                }
-                else if (key == "device_id" || key == "deviceid" || key == "device")
-                {
-                    setDeviceId(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "device id set";
-                    _res_doc["device_id"] = value;
-                }
-                else if (key == "timeout")
-                {
-                    setTimeout(value.toInt());
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "timeout set";
-                }
-                else
+        if (m_client.write(out, outLen) != outLen)
+        {
+            return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+        }
+        offset += n;
+    }
+
+    if (m_target.chunked)
+    {
+        if (m_client.write((const uint8_t *)"0\r\n\r\n", 5) != 5)
+        {
+            return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+        }
+    }
+    return 0;
+}
+
+bool HttpUploader::readLine(String& line, uint32_t deadline)
+{
+    line = "";
+    while ((int32_t)(deadline - millis()) > 0)
+    {
+        if (!m_client.available())
+        {
+            if (!m_client.connected())
+            {
+                return false;
+            }
+            delay(1);
+            continue;
+        }
+
+        char c = m_client.read();
+        if (c == '\n')
+        {
+            line.trim();
+            return true;
+        }
+        if (line.length() >= MAX_LINE_LENGTH)
+        {
+            // 줄 끝이 오지 않는 응답: 더 읽지 않고 실패 (호출자가 연결을 버림)
+            return false;
+        }
+        line += c;
+    }
+    return false;
+}
+
+// 본문 len 바이트를 읽는다, 시간 초과나 연결 끊김으로 남은 바이트 수 (0 = 다 읽음)
+long HttpUploader::readBody(String& response, long len, uint32_t deadline)
+{
+    while (len > 0 && (int32_t)(deadline - millis()) > 0)
+    {
+        int c = m_client.read();
+        if (c < 0)
+        {
+            if (!m_client.connected())
+            {
+                break;
+            }
+            delay(1);
+            continue;
+        }
+        if (response.length() < MAX_RESPONSE_SIZE)
+        {
+            response += (char)c;
+        }
+        len--;
+    }
+    return len;
+}
+
+int HttpUploader::readResponse(String& response)
+{
+    uint32_t startUs = micros();
+    uint32_t deadline = millis() + m_target.timeout;
+    String line;
+
+    // 상태 라인: HTTP/1.1 200 OK
+    if (!readLine(line, deadline))
+    {
+        return m_client.connected() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+    }
+    if (!line.startsWith("HTTP/1.") || line.length() < 12)
+    {
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+    int httpCode = line.substring(9, 12).toInt();
+    bool keepAlive = line.startsWith("HTTP/1.1");
+
+    uint32_t statusUs = micros();
+    LatencyStats::record(LatencyStats::RESPONSE, statusUs - startUs);
+
+    // 헤더
+    long contentLength = -1;
+    bool chunked = false;
+    for (;;)
+    {
+        if (!readLine(line, deadline))
+        {
+            return HTTPC_ERROR_READ_TIMEOUT;
+        }
+        if (line.length() == 0)
+        {
+            break;
+        }
+
+        int colon = line.indexOf(':');
+        if (colon < 0)
+        {
+            continue;
+        }
+        String name = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        name.toLowerCase();
+        value.trim();
+        value.toLowerCase();
+
+        if (name == "content-length")
+        {
+            contentLength = value.toInt();
+        }
+        else if (name == "transfer-encoding")
+        {
+            chunked = value.indexOf("chunked") >= 0;
+        }
+        else if (name == "connection")
+        {
+            keepAlive = value.indexOf("close") < 0;
+        }
+    }
+
+    // 본문 (응답은 짧은 JSON 이므로 String 으로 받음, MAX_RESPONSE_SIZE 넘는 부분은 읽고 버림)
+    // 끝까지 읽지 못하면 남은 바이트가 다음 요청의 상태 라인으로 읽히므로 연결을 재사용하지 않는다
+    response = "";
+    bool complete = false;
+    if (chunked)
+    {
+        for (;;)
+        {
+            if (!readLine(line, deadline))
+            {
+                break;
+            }
+            long size = strtol(line.c_str(), nullptr, 16);
+            if (size <= 0)
+            {
+                // 트레일러는 빈 줄까지 건너뜀
+                while (readLine(line, deadline))
                 {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "unknown key (server_url/server_path/auth_token/device_id/timeout)";
+                    if (line.length() == 0)
+                    {
+                        complete = true;
+                        break;
+                    }
                 }
+                break;
+            }
+            if (readBody(response, size, deadline) > 0 || !readLine(line, deadline) || line.length() != 0)
+            {
+                break;  // 청크가 잘렸거나 청크 끝 CRLF 가 없음
+            }
+        }
+    }
+    else if (contentLength >= 0)
+    {
+        response.reserve(contentLength < (long)MAX_RESPONSE_SIZE ? contentLength : MAX_RESPONSE_SIZE);
+        complete = readBody(response, contentLength, deadline) == 0;
+    }
+    else
+    {
+        // 길이 정보가 없으면 서버가 연결을 닫을 때까지 읽음
+        keepAlive = false;
+        complete = true;
+        while (m_client.connected() && (int32_t)(deadline - millis()) > 0)
+        {
+            int c = m_client.read();
+            if (c < 0)
+            {
+                delay(1);
+                continue;
             }
-            else
+            if (response.length() < MAX_RESPONSE_SIZE)
+            {
+                response += (char)c;
+            }
+        }
+    }
+
+    if (!complete)
+    {
+        Serial.println("Response body incomplete, dropping connection");
+        m_partialResponses++;
+        keepAlive = false;
+    }
+    if (!keepAlive)
+    {
+        m_client.stop();
+    }
+    LatencyStats::record(LatencyStats::READ, micros() - statusUs);
+    return httpCode;
+}
+
+void HttpUploader::close()
+{
+    xSemaphoreTake(m_lock, portMAX_DELAY);
+    m_client.stop();
+    xSemaphoreGive(m_lock);
+}
+
+const CmdEntry<HttpUploader::CmdHandler> HttpUploader::COMMANDS[] = {
+    CMD_ENTRY("set", "set url/path/token/deviceid/timeout/chunked/batch_size/batch_max_age <value>", &HttpUploader::cmdSet),
+    CMD_ENTRY("status", "status", &HttpUploader::cmdStatus),
+    CMD_ENTRY("batch", "batch", &HttpUploader::cmdBatch),
+    CMD_ENTRY("close", "close", &HttpUploader::cmdClose),
+};
+
+void HttpUploader::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String HttpUploader::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void HttpUploader::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        // [수정] Config 키와 이름을 통일 (server_url, server_path, auth_token, device_id)
+        // 기존 짧은 이름(url, path 등)도 호환성을 위해 유지하거나 제거할 수 있습니다.
+        // 여기서는 명확한 관리를 위해 Config 키를 우선으로 처리하도록 변경합니다.
+
+        if (key == "server_url" || key == "url") // url은 편의상 허용하되 저장은 server_url 개념
+        {
+            if (!setServerUrl(value))
             {
                 _res_doc["result"] = "fail";
-                _res_doc["ms"] = "need key and value";
+                _res_doc["ms"] = "only http:// server urls are supported";
+                return;
             }
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "server url set";
+            _res_doc["server_url"] = value.c_str(); // 응답 키도 server_url로 통일
+        }
+        else if (key == "server_path" || key == "path")
+        {
+            setUploadPath(value);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "upload path set";
+            _res_doc["server_path"] = value.c_str();
         }
-        else if (subCmd == "status")
+        else if (key == "auth_token" || key == "token")
         {
+            setAuthToken(value);
             _res_doc["result"] = "ok";
-            _res_doc["server_url"] = m_serverUrl;   // 키 이름 통일
-            _res_doc["server_path"] = m_uploadPath; // 키 이름 통일
-            _res_doc["fullUrl"] = getFullUrl();
-            _res_doc["device_id"] = m_deviceId;     // 키 이름 통일
-            _res_doc["auth_token"] = m_authToken;
-            _res_doc["timeout"] = m_timeout;
+            _res_doc["ms"] = "auth token set";
+        }
+        else if (key == "device_id" || key == "deviceid" || key == "device")
+        {
+            setDeviceId(value);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "device id set";
+            _res_doc["device_id"] = value.c_str();
+        }
+        else if (key == "timeout")
+        {
+            setTimeout(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "timeout set";
+        }
+        else if (key == "batch_size")
+        {
+            setBatchSize(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "batch size set";
+            _res_doc["batch_size"] = getBatchSize();
+        }
+        else if (key == "batch_max_age")
+        {
+            setBatchMaxAge(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "batch max age set";
+            _res_doc["batch_max_age"] = getBatchMaxAge();
+        }
+        else if (key == "chunked" || key == "server_chunked")
+        {
+            setChunked(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "chunked mode set";
+            _res_doc["chunked"] = isChunked();
         }
         else
         {
             _res_doc["result"] = "fail";
-            _res_doc["ms"] = "unknown sub command (set/status)";
+            _res_doc["ms"] = "unknown key (server_url/server_path/auth_token/device_id/timeout/chunked/batch_size/batch_max_age)";
         }
     }
     else
     {
         _res_doc["result"] = "fail";
-        _res_doc["ms"] = "need sub command (set/status)";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void HttpUploader::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["server_url"] = getServerUrl();   // 키 이름 통일
+    _res_doc["server_path"] = getUploadPath(); // 키 이름 통일
+    _res_doc["fullUrl"] = getFullUrl();
+    _res_doc["device_id"] = getDeviceId();     // 키 이름 통일
+    _res_doc["auth_token"] = getAuthToken();
+    _res_doc["timeout"] = m_timeout.load();
+    _res_doc["keep_alive"] = m_client.connected();
+    _res_doc["conn_opened"] = m_connOpened;
+    _res_doc["requests"] = m_requests;
+    _res_doc["reconnects"] = m_reconnects;
+    _res_doc["partial_responses"] = m_partialResponses;
+    _res_doc["chunked"] = isChunked();
+    _res_doc["bounce_size"] = (unsigned long)BOUNCE_PAYLOAD;
+    if (m_minInternalFree != SIZE_MAX)
+    {
+        _res_doc["min_internal_free"] = (unsigned long)m_minInternalFree;
     }
-}
\ No newline at end of file
+
+    UploadTiming timing = getLastTiming();
+    if (timing.bytes > 0)
+    {
+        JsonObject last = _res_doc["last"].to<JsonObject>();
+        last["bytes"] = timing.bytes;
+        last["code"] = timing.httpCode;
+        last["connect_ms"] = timing.connectMs;
+        last["send_ms"] = timing.sendMs;
+        last["rtt_ms"] = timing.rttMs;
+        last["bps"] = timing.throughput();
+    }
+}
+
+void HttpUploader::cmdBatch(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["batch_size"] = getBatchSize();
+    _res_doc["batch_max_age"] = getBatchMaxAge();
+    _res_doc["requests"] = m_batchRequests;
+    _res_doc["frames"] = m_batchFrames;
+    _res_doc["frames_per_request"] = m_batchRequests ? (float)m_batchFrames / m_batchRequests : 0.0f;
+}
+
+void HttpUploader::cmdClose(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    close();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "connection closed";
+}
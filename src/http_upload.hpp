@@ -3,46 +3,194 @@
 
 #include <Arduino.h>
 #include <HTTPClient.h>
+#include <WiFiClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <ArduinoJson.h>
 #include <vector>
+#include <atomic>
+#include <functional>
+#include <esp_heap_caps.h>
+
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 업로드 본문 공급 콜백
+// offset 위치부터 최대 maxLen 바이트를 dst 에 채우고 채운 길이를 반환 (0 = 끝)
+// 재연결 시 offset 0 부터 다시 호출될 수 있다
+typedef std::function<size_t(uint8_t *dst, size_t offset, size_t maxLen)> UploadReader;
+
+// 배치 업로드 프레임 (data 는 호출이 끝날 때까지 유효해야 함)
+struct UploadFrame
+{
+    const uint8_t *data;
+    size_t len;
+    uint32_t timestamp;    // 캡처 시각 (millis)
+    String fileName;       // 비어 있으면 frame_<timestamp>.jpg
+};
+
+// 마지막 요청의 전송 측정값 (해상도 적응에 사용)
+struct UploadTiming
+{
+    uint32_t bytes = 0;        // 본문 크기
+    uint32_t connectMs = 0;    // TCP 연결 (keep-alive 재사용이면 0)
+    uint32_t sendMs = 0;       // 헤더 + 본문 write
+    uint32_t rttMs = 0;        // 본문을 다 보낸 뒤 응답을 받기까지
+    int httpCode = 0;
+
+    // 본문 전송 속도 (bytes/s)
+    inline uint32_t throughput() const { return (uint32_t)((uint64_t)bytes * 1000 / (sendMs ? sendMs : 1)); }
+};
+
+#define BATCH_BOUNDARY "esp32cam-batch-7f3a9c"
 
 class HttpUploader
 {
 private:
-    String m_serverUrl;     // 예: http://192.168.1.100:8080
+    // 설정 (콘솔/설정 로드가 쓰고 업로드 태스크가 읽음)
+    // 문자열은 m_configLock 아래에서만 접근, 요청은 parseServerUrl() 의 사본(m_target)을 쓴다
+    String m_serverUrl;     // 예: http://192.168.1.100:8080 (경로가 있으면 업로드 경로 앞에 붙음)
     String m_uploadPath;    // 예: /api/v1/camera/upload
     String m_authToken;     // 인증 토큰
     String m_deviceId;      // 디바이스 ID
-    int m_timeout = 30000;  // 30초 타임아웃
+    SemaphoreHandle_t m_configLock = nullptr;
+    std::atomic<int> m_timeout{30000};  // 30초 타임아웃
+
+    // 요청 하나 동안 쓰는 설정 사본
+    struct Target
+    {
+        String serverUrl;
+        String host;
+        uint16_t port = 80;
+        String basePath;   // server_url 의 경로 부분 (끝의 / 제외)
+        String path;       // 요청 라인 경로 = basePath + 업로드 경로
+        String authToken;
+        String deviceId;
+        bool chunked = false;
+        int timeout = 30000;
+    };
+
+    // keep-alive 연결 (업로드 간 재사용)
+    WiFiClient m_client;
+    String m_connServerUrl;            // 현재 연결이 맺어진 서버
+    Target m_target;
+    SemaphoreHandle_t m_lock = nullptr;
+    uint32_t m_connOpened = 0;         // 새로 연 TCP 연결 수
+    uint32_t m_requests = 0;           // 보낸 요청 수
+    uint32_t m_reconnects = 0;         // 끊긴 연결 재시도 횟수
+    uint32_t m_partialResponses = 0;   // 본문을 끝까지 읽지 못해 닫은 연결 수
+    uint32_t m_firstOkMs = 0;          // 부팅 후 첫 업로드 성공 시각 (millis, 0 = 아직 없음)
+    UploadTiming m_lastTiming;
+
+    // 본문 전송용 바운스 버퍼 (내부 RAM, DMA 가능, 한 번만 할당)
+    // [청크 헤더 예약][MSS * N 페이로드][CRLF] 형태로 써서 청크 하나를 write 한 번으로 보낸다
+    uint8_t *m_bounce = nullptr;
+    std::atomic<bool> m_chunked{false};  // Transfer-Encoding: chunked 사용
+    size_t m_minInternalFree = SIZE_MAX;
+
+    // 배치(multipart) 업로드
+    std::atomic<int> m_batchSize{1};     // 1 = 배치 사용 안 함
+    std::atomic<int> m_batchMaxAge{300}; // 가장 오래된 프레임 최대 대기 시간 (초)
+    uint32_t m_batchRequests = 0;
+    uint32_t m_batchFrames = 0;
+
+    String readConfig(const String &field) const;
+    void writeConfig(String &field, const String &value);
+    bool ensureConnected();
+    int request(UploadReader &reader, size_t len, const String& contentType, String& response, const String& fileName, uint32_t ageMs);
+    int post(UploadReader &reader, size_t len, const String& contentType, String& response, const String& fileName, uint32_t ageMs);
+    int sendBody(UploadReader &reader, size_t len);
+    int readResponse(String& response);
+    bool readLine(String& line, uint32_t deadline);
+    long readBody(String& response, long len, uint32_t deadline);
 
 public:
+#ifdef CONFIG_LWIP_TCP_MSS
+    static const size_t UPLOAD_MSS = CONFIG_LWIP_TCP_MSS;
+#else
+    static const size_t UPLOAD_MSS = 1436;
+#endif
+    static const size_t BOUNCE_SEGMENTS = 4;
+    static const size_t BOUNCE_PAYLOAD = UPLOAD_MSS * BOUNCE_SEGMENTS;
+    static const size_t CHUNK_HEADER_SIZE = 8;   // "XXXXX\r\n" 예약
+    static const int MAX_BATCH_SIZE = 50;
+    static const size_t MAX_LINE_LENGTH = 512;     // 응답 상태/헤더 줄
+    static const size_t MAX_RESPONSE_SIZE = 4096;  // 응답 본문 중 보관하는 크기
+
     HttpUploader() 
     {
         m_uploadPath = "/api/v1/camera/upload";
         m_deviceId = "";
+        m_lock = xSemaphoreCreateMutex();
+        m_configLock = xSemaphoreCreateMutex();
+    }
+    ~HttpUploader() 
+    {
+        m_client.stop();
+        if (m_bounce)
+        {
+            heap_caps_free(m_bounce);
+        }
     }
-    ~HttpUploader() {}
 
-    // 설정
-    inline void setServerUrl(const String& url) { m_serverUrl = url; }
-    inline void setUploadPath(const String& path) { m_uploadPath = path; }
-    inline void setAuthToken(const String& token) { m_authToken = token; }
-    inline void setDeviceId(const String& id) { m_deviceId = id; }
+    // 설정 (다른 태스크에서 업로드 중에 바꿔도 다음 요청부터 적용)
+    // server_url 은 http:// 만 받는다 (TLS 클라이언트가 없으므로 https:// 등은 거부하고 false)
+    bool setServerUrl(const String& url);
+    void setUploadPath(const String& path);
+    void setAuthToken(const String& token);
+    void setDeviceId(const String& id);
     inline void setTimeout(int timeout) { m_timeout = timeout; }
+    inline void setChunked(bool chunked) { m_chunked = chunked; }
+    inline void setBatchSize(int size) { m_batchSize = constrain(size, 1, MAX_BATCH_SIZE); }
+    inline void setBatchMaxAge(int seconds) { m_batchMaxAge = seconds > 0 ? seconds : 1; }
 
     // Getters
-    inline String getServerUrl() const { return m_serverUrl; }
-    inline String getUploadPath() const { return m_uploadPath; }
-    inline String getAuthToken() const { return m_authToken; }
-    inline String getDeviceId() const { return m_deviceId; }
-    inline String getFullUrl() const { return m_serverUrl + m_uploadPath; }
+    String getServerUrl() const;
+    String getUploadPath() const;
+    String getAuthToken() const;
+    String getDeviceId() const;
+    String getFullUrl() const;
+    inline uint32_t getConnectionsOpened() const { return m_connOpened; }
+    inline uint32_t getRequestCount() const { return m_requests; }
+    inline uint32_t getFirstSuccessMs() const { return m_firstOkMs; }
+    inline bool isChunked() const { return m_chunked; }
+    inline String getHost() const { return m_target.host; }
+    inline uint16_t getPort() const { return m_target.port; }
+    inline int getBatchSize() const { return m_batchSize; }
+    inline int getBatchMaxAge() const { return m_batchMaxAge; }
+    UploadTiming getLastTiming();
+
+    // 요청 형식 (호스트 fleet 시뮬레이터도 같은 헤더를 쓴다)
+    // 현재 설정을 m_target 으로 복사하고 server_url 에서 host/port/경로 추출 (요청마다 자동 호출)
+    bool parseServerUrl();
+    // 요청 라인 + 헤더 (빈 줄까지, parseServerUrl 이후 유효)
+    String buildRequestHeader(size_t len, const String& contentType, const String& fileName, uint32_t ageMs) const;
 
     // 업로드
     int uploadImage(uint8_t* data, size_t len, const String& fileName = "");
-    int uploadImage(uint8_t* data, size_t len, String& response, const String& fileName = "");
+    // ageMs: 링 버퍼에서 재전송하는 경우 캡처 후 경과 시간 (frame-age-ms 헤더)
+    int uploadImage(uint8_t* data, size_t len, String& response, const String& fileName = "", uint32_t ageMs = 0);
+    // PSRAM 등에 있는 본문을 reader 로 조금씩 읽어 바운스 버퍼를 통해 전송
+    int uploadImageStream(UploadReader reader, size_t len, String& response, const String& fileName = "", uint32_t ageMs = 0);
+    // 여러 프레임을 multipart/form-data 요청 하나로 전송
+    int uploadBatch(const UploadFrame *frames, int count, String& response);
+
+    // keep-alive 연결 종료
+    void close();
 
     // 커맨드 파싱
-    void parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc);
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (HttpUploader::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdBatch(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdClose(const tonkey &tokens, JsonDocument &_res_doc);
 };
 
 #endif // HTTP_UPLOAD_HPP
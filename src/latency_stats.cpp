@@ -0,0 +1,124 @@
+#include "latency_stats.hpp"
+
+// 버킷 상한 (us), 10배마다 1/1.5/2/3/5/7
+static const uint32_t BUCKET_UPPER_US[LatencyStats::BUCKET_COUNT - 1] = {
+    100, 150, 200, 300, 500, 700,
+    1000, 1500, 2000, 3000, 5000, 7000,
+    10000, 15000, 20000, 30000, 50000, 70000,
+    100000, 150000, 200000, 300000, 500000, 700000,
+    1000000, 1500000, 2000000, 3000000, 5000000, 7000000,
+    10000000, 15000000, 20000000, 30000000, 50000000, 70000000,
+};
+
+LatencyStats::Histogram LatencyStats::s_hist[LatencyStats::STAGE_COUNT];
+portMUX_TYPE LatencyStats::s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+int LatencyStats::bucketIndex(uint32_t us)
+{
+    // 버킷이 적으므로 이진 탐색
+    int low = 0;
+    int high = BUCKET_COUNT - 1;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (us <= BUCKET_UPPER_US[mid])
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+uint32_t LatencyStats::bucketUpperUs(int index)
+{
+    return index < BUCKET_COUNT - 1 ? BUCKET_UPPER_US[index] : UINT32_MAX;
+}
+
+void LatencyStats::record(Stage stage, uint32_t us)
+{
+    int index = bucketIndex(us);
+
+    portENTER_CRITICAL(&s_lock);
+    Histogram &hist = s_hist[stage];
+    hist.buckets[index]++;
+    hist.count++;
+    hist.totalUs += us;
+    if (us > hist.maxUs)
+    {
+        hist.maxUs = us;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void LatencyStats::reset()
+{
+    portENTER_CRITICAL(&s_lock);
+    memset(s_hist, 0, sizeof(s_hist));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t LatencyStats::percentileUs(const Histogram &hist, int percent)
+{
+    if (hist.count == 0)
+    {
+        return 0;
+    }
+
+    // 올림: count 개 중 rank 번째 값이 들어 있는 버킷
+    uint32_t rank = (uint32_t)(((uint64_t)hist.count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += hist.buckets[i];
+        if (seen >= rank)
+        {
+            // 버킷 상한이 실제 최대값보다 크면 최대값으로
+            uint32_t upper = bucketUpperUs(i);
+            return upper < hist.maxUs ? upper : hist.maxUs;
+        }
+    }
+    return hist.maxUs;
+}
+
+const char *LatencyStats::stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case FB_GET:   return "fb_get";
+        case CONNECT:  return "connect";
+        case SEND:     return "send";
+        case RESPONSE: return "response";
+        case READ:     return "read";
+        case UPLOAD:   return "upload";
+        default:       return "unknown";
+    }
+}
+
+void LatencyStats::toJson(JsonObject obj)
+{
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        // 출력 중 기록이 섞이지 않도록 복사본 사용
+        Histogram hist;
+        portENTER_CRITICAL(&s_lock);
+        hist = s_hist[i];
+        portEXIT_CRITICAL(&s_lock);
+
+        JsonObject stage = obj[stageName((Stage)i)].to<JsonObject>();
+        stage["count"] = hist.count;
+        if (hist.count == 0)
+        {
+            continue;
+        }
+        // ms 단위
+        stage["avg_ms"] = (float)(hist.totalUs / hist.count) / 1000.0f;
+        stage["p50_ms"] = percentileUs(hist, 50) / 1000.0f;
+        stage["p95_ms"] = percentileUs(hist, 95) / 1000.0f;
+        stage["p99_ms"] = percentileUs(hist, 99) / 1000.0f;
+        stage["max_ms"] = hist.maxUs / 1000.0f;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LATENCY_STATS_HPP
+#define LATENCY_STATS_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// 캡처 → 업로드 단계별 지연 히스토그램
+// - 단계마다 고정 버킷(100us ~ 70s, 10배마다 1/1.5/2/3/5/7) 카운트를 정적 메모리에 보관
+// - 백분위수는 해당 버킷의 상한값 (최대 1.5배 오차), 최대값은 정확한 값
+// 여러 태스크(캡처/업로드/스트림)에서 기록하므로 임계 구역으로 보호한다.
+class LatencyStats
+{
+public:
+    enum Stage
+    {
+        FB_GET = 0,     // esp_camera_fb_get()
+        CONNECT,        // DNS + TCP 연결 (keep-alive 재사용 시 기록 안 함)
+        SEND,           // 요청 헤더 + 본문 write
+        RESPONSE,       // 본문 전송 후 상태 라인 수신까지 (서버 처리 + RTT)
+        READ,           // 응답 헤더/본문 읽기
+        UPLOAD,         // 업로드 요청 전체 (재연결 재시도 포함)
+        STAGE_COUNT
+    };
+
+    static const int BUCKET_COUNT = 37;     // 마지막 버킷은 70s 초과
+
+    static void record(Stage stage, uint32_t us);
+    static void reset();
+    static void toJson(JsonObject obj);
+    static const char *stageName(Stage stage);
+
+private:
+    struct Histogram
+    {
+        uint32_t buckets[BUCKET_COUNT];
+        uint32_t count;
+        uint32_t maxUs;
+        uint64_t totalUs;
+    };
+
+    static Histogram s_hist[STAGE_COUNT];
+    static portMUX_TYPE s_lock;
+
+    static int bucketIndex(uint32_t us);
+    static uint32_t bucketUpperUs(int index);
+    static uint32_t percentileUs(const Histogram &hist, int percent);
+};
+
+#endif // LATENCY_STATS_HPP
@@ -0,0 +1,78 @@
+#include "luma_thumb.hpp"
+#include <img_converters.h>
+
+bool LumaThumbnail::allocBuffers(int width, int height)
+{
+    if (m_rgb && width == m_width && height == m_height)
+    {
+        return true;
+    }
+
+    freeBuffers();
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    size_t pixels = (size_t)width * height;
+    // [RGB565 디코드][그레이] 한 번에 할당
+    size_t total = pixels * 3;
+    uint8_t *buf = psramFound() ? (uint8_t *)ps_malloc(total) : (uint8_t *)malloc(total);
+    if (!buf)
+    {
+        Serial.printf("Thumbnail alloc failed (%u bytes)\n", (unsigned)total);
+        return false;
+    }
+
+    m_rgb = buf;
+    m_gray = buf + pixels * 2;
+    m_width = width;
+    m_height = height;
+    return true;
+}
+
+void LumaThumbnail::freeBuffers()
+{
+    if (m_rgb)
+    {
+        free(m_rgb);
+    }
+    m_rgb = nullptr;
+    m_gray = nullptr;
+    m_width = 0;
+    m_height = 0;
+    m_valid = false;
+}
+
+bool LumaThumbnail::decode(camera_fb_t *fb)
+{
+    m_valid = false;
+
+    if (!allocBuffers(fb->width / 8, fb->height / 8))
+    {
+        return false;
+    }
+
+    uint32_t startUs = micros();
+    if (!jpg2rgb565(fb->buf, fb->len, m_rgb, JPG_SCALE_8X))
+    {
+        return false;
+    }
+
+    // jpg2rgb565 출력은 픽셀당 상위 바이트 먼저
+    size_t pixels = (size_t)m_width * m_height;
+    const uint8_t *src = m_rgb;
+    for (size_t i = 0; i < pixels; i++, src += 2)
+    {
+        uint16_t c = ((uint16_t)src[0] << 8) | src[1];
+        uint32_t r = (c >> 11) & 0x1F;
+        uint32_t g = (c >> 5) & 0x3F;
+        uint32_t b = c & 0x1F;
+        // Y = 0.30R + 0.59G + 0.11B (5/6bit → 8bit 스케일 포함)
+        m_gray[i] = (uint8_t)((r * 616 + g * 600 + b * 232) >> 8);
+    }
+
+    m_decodeUs = micros() - startUs;
+    m_valid = true;
+    return true;
+}
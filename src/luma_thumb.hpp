@@ -0,0 +1,39 @@
+#ifndef LUMA_THUMB_HPP
+#define LUMA_THUMB_HPP
+
+#include <Arduino.h>
+#include "esp_camera.h"
+
+// JPEG 프레임의 1/8 크기 그레이스케일 썸네일
+// - jpg2rgb565 의 1/8 스케일 디코드는 IDCT 없이 8x8 블록의 DC 계수만 쓰므로
+//   블록당 픽셀 하나 = 블록 평균 밝기 (전체 디코드보다 훨씬 가볍다)
+// - 움직임 감지/중복 프레임 필터가 같은 썸네일을 공유 (프레임당 디코드 한 번)
+// 파이프라인 캡처 태스크에서만 갱신한다.
+class LumaThumbnail
+{
+private:
+    uint8_t *m_rgb = nullptr;    // RGB565 디코드 버퍼
+    uint8_t *m_gray = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    bool m_valid = false;
+    uint32_t m_decodeUs = 0;
+
+    bool allocBuffers(int width, int height);
+    void freeBuffers();
+
+public:
+    LumaThumbnail() {}
+    ~LumaThumbnail() { freeBuffers(); }
+
+    // 실패하면 false (isValid() 도 false)
+    bool decode(camera_fb_t *fb);
+
+    inline bool isValid() const { return m_valid; }
+    inline const uint8_t *gray() const { return m_gray; }
+    inline int width() const { return m_width; }
+    inline int height() const { return m_height; }
+    inline uint32_t getDecodeUs() const { return m_decodeUs; }
+};
+
+#endif // LUMA_THUMB_HPP
@@ -2,11 +2,22 @@
 #include <WiFi.h>
 #include <TaskScheduler.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
 
 #include "config.hpp"
 #include "camera_module.hpp"
 #include "wifi_module.hpp"
 #include "http_upload.hpp"
+#include "upload_pipeline.hpp"
+#include "stream_server.hpp"
+#include "luma_thumb.hpp"
+#include "motion_detector.hpp"
+#include "dup_filter.hpp"
+#include "resolution_ladder.hpp"
+#include "frame_spool.hpp"
+#include "duty_cycle.hpp"
+#include "boot_timeline.hpp"
+#include "serial_cmd.hpp"
 #include "etc.hpp"
 
 // 전역 객체
@@ -15,9 +26,18 @@ Config g_config;
 CameraModule g_camera;
 WifiModule g_wifi;
 HttpUploader g_uploader;
+LumaThumbnail g_thumb;
+MotionDetector g_motion(g_thumb);
+DuplicateFilter g_dedup(g_thumb);
+ResolutionLadder g_ladder(g_camera, g_wifi);
+FrameSpool g_spool(LittleFS);
+UploadPipeline g_pipeline(g_camera, g_uploader, g_thumb, g_motion, g_dedup, g_ladder, g_spool);
+StreamServer g_stream(g_camera);
+DutyCycle g_duty(g_camera, g_wifi, g_uploader, g_spool);
+SerialCmdReader g_cmdReader;
 
 // 외부 함수 선언
-extern String parseCmd(String _strLine);
+extern bool serviceCmd();
 extern void loadSettingsToModules();
 
 // LED 핀 설정 (camera_module.hpp에서 정의됨)
@@ -74,24 +94,58 @@ Task task_LedBlink(500, TASK_FOREVER, []()
 }, &g_ts, false);
 
 // 시리얼 커맨드 처리 태스크
-Task task_Cmd(100, TASK_FOREVER, []()
+// 줄 조립은 g_cmdReader 가 RX 이벤트에서 하고, 여기서는 완성된 줄만 꺼내 바로 처리
+// 응답은 요청과 같은 인코딩(JSON 텍스트 / MessagePack 프레임)으로 직접 출력
+Task task_Cmd(TASK_IMMEDIATE, TASK_FOREVER, []()
 {
-    if (Serial.available() > 0)
+    serviceCmd();
+}, &g_ts, true);
+
+// WiFi 접속 상태 머신 (접속/재접속 진행, 백오프)
+Task task_Wifi(WifiModule::TICK_MS, TASK_FOREVER, []()
+{
+    g_wifi.tick();
+}, &g_ts, true);
+
+// deep sleep 주기 모드 태스크 (캡처/업로드 진행, 끝나면 설정 커밋 후 잠듦)
+Task task_Duty(WifiModule::TICK_MS, TASK_FOREVER, []()
+{
+    if (g_duty.tick())
     {
-        String _strLine = Serial.readStringUntil('\n');
-        _strLine.trim();
-        
-        if (_strLine.length() > 0)
-        {
-            Serial.println(parseCmd(_strLine));
-        }
+        g_config.flush();
+        g_duty.sleep();
     }
+}, &g_ts, false);
+
+// 설정 지연 커밋 태스크 (마지막 변경 후 Config::COMMIT_DELAY_MS 경과 시 한 번만 기록)
+Task task_ConfigCommit(500, TASK_FOREVER, []()
+{
+    g_config.commitIfDue();
 }, &g_ts, true);
 
+// 자동 업로드 주기 (움직임 감지 중이면 감지 주기로 캡처해 변화가 있을 때만 업로드)
+static uint32_t autoUploadInterval()
+{
+    if (g_motion.isEnabled())
+    {
+        return g_motion.getInterval();
+    }
+    return g_config.get<int>("upload_interval", 60) * 1000;
+}
+
 // 자동 업로드 태스크 (설정된 경우)
+// 캡처/업로드는 g_pipeline 태스크에서 처리하고 여기서는 트리거만 건다
 Task task_AutoUpload(60000, TASK_FOREVER, []()
 {
-    if (!g_camera.isInitialized() || !g_wifi.isConnected())
+    uint32_t interval = autoUploadInterval();
+    if (task_AutoUpload.getInterval() != interval)
+    {
+        task_AutoUpload.setInterval(interval);
+    }
+    g_ladder.setIntervalMs(interval);
+
+    // 링 버퍼가 있으면 WiFi가 끊겨도 캡처해서 보관 (복구 후 재전송)
+    if (!g_camera.isInitialized() || (!g_wifi.isConnected() && !g_camera.hasFrameRing()))
     {
         return;
     }
@@ -102,52 +156,76 @@ Task task_AutoUpload(60000, TASK_FOREVER, []()
         return;
     }
 
-    Serial.println("Auto upload triggered");
-    
-    bool useFlash = g_config.get<int>("use_flash", 0) == 1;
-    if (useFlash)
+    if (!g_motion.isEnabled())
     {
-        g_camera.flashOn();
-        delay(100);
+        Serial.println("Auto upload triggered");
     }
 
-    if (g_camera.capture())
+    bool useFlash = g_config.get<int>("use_flash", 0) == 1;
+    if (!g_pipeline.trigger(useFlash))
     {
-        if (useFlash)
-        {
-            g_camera.flashOff();
-        }
+        Serial.printf("Auto upload skipped: pipeline busy (in flight: %d)\n", g_pipeline.getInFlight());
+    }
+}, &g_ts, false);
 
-        String response;
-        int httpCode = g_uploader.uploadImage(
-            g_camera.getImageData(),
-            g_camera.getImageSize(),
-            response
-        );
+// 카메라 준비 후 링 버퍼/파이프라인/자동 업로드 시작
+static void startPipeline()
+{
+    BootTimeline::start(BootTimeline::PIPELINE);
 
-        g_camera.releaseBuffer();
+    // 업링크 장애 대비 프레임 링 버퍼 (해상도 적용 후 슬롯 크기 결정)
+    g_camera.initFrameRing();
 
-        if (httpCode == 200 || httpCode == 201)
-        {
-            Serial.println("Auto upload success");
-        }
-        else
-        {
-            Serial.printf("Auto upload failed: %d\n", httpCode);
-        }
+    // 캡처/업로드 파이프라인 시작
+    g_pipeline.begin();
+    BootTimeline::end(BootTimeline::PIPELINE);
+
+    // 자동 업로드 (enable 하면 첫 캡처는 바로 실행)
+    task_AutoUpload.setInterval(autoUploadInterval());
+    if (g_config.get<int>("auto_upload", 0) == 1)
+    {
+        task_AutoUpload.enable();
+        Serial.printf("Auto upload enabled (interval: %ums%s)\n", autoUploadInterval(), g_motion.isEnabled() ? ", motion gated" : "");
     }
-    else
+}
+
+// 부팅 진행 확인 (카메라/WiFi/첫 업로드 완료 시각 기록, 모두 끝나면 멈춤)
+Task task_Boot(WifiModule::TICK_MS, TASK_FOREVER, []()
+{
+    CameraModule::InitState camera = g_camera.getInitState();
+    if (!BootTimeline::isDone(BootTimeline::CAMERA) &&
+        (camera == CameraModule::INIT_OK || camera == CameraModule::INIT_FAILED))
     {
-        if (useFlash)
+        BootTimeline::end(BootTimeline::CAMERA);
+        Serial.println(camera == CameraModule::INIT_OK ? "Camera OK" : "Camera FAILED");
+        if (camera == CameraModule::INIT_OK && !g_duty.isActive())
         {
-            g_camera.flashOff();
+            startPipeline();
         }
-        Serial.println("Auto capture failed");
     }
-}, &g_ts, false);
+
+    if (BootTimeline::isStarted(BootTimeline::WIFI) && g_wifi.isConnected())
+    {
+        BootTimeline::end(BootTimeline::WIFI);
+    }
+
+    uint32_t firstUploadMs = g_uploader.getFirstSuccessMs();
+    if (firstUploadMs && !BootTimeline::isDone(BootTimeline::FIRST_UPLOAD))
+    {
+        BootTimeline::set(BootTimeline::FIRST_UPLOAD, 0, firstUploadMs);
+    }
+
+    bool wifiPending = BootTimeline::isStarted(BootTimeline::WIFI) && !BootTimeline::isDone(BootTimeline::WIFI);
+    if (BootTimeline::isDone(BootTimeline::CAMERA) && !wifiPending && BootTimeline::isDone(BootTimeline::FIRST_UPLOAD))
+    {
+        task_Boot.disable();
+    }
+}, &g_ts, true);
 
 void setup()
 {
+    BootTimeline::start(BootTimeline::SETUP);
+
     // 상태 LED 초기화
     pinMode(STATUS_LED_PIN, OUTPUT);
     digitalWrite(STATUS_LED_PIN, LED_OFF);
@@ -155,9 +233,44 @@ void setup()
     // 시리얼 초기화
     Serial.begin(115200);
     Serial.setDebugOutput(true);
-    
-    delay(500);
-    
+    g_cmdReader.begin();
+
+    // 설정은 Config 생성자에서 이미 읽었으므로 모듈에 적용만
+    BootTimeline::start(BootTimeline::CONFIG);
+    loadSettingsToModules();
+    BootTimeline::end(BootTimeline::CONFIG);
+
+    // 저장된 해상도 (초기화 전이면 이 해상도로 연다)
+    if (g_config.hasKey("resolution"))
+    {
+        g_camera.setResolutionByName(g_config.get<String>("resolution"));
+    }
+
+    // 카메라 초기화(APP CPU 태스크)와 WiFi 접속을 바로 시작하고 나머지 초기화는 그동안 진행
+    // 결과는 task_Boot 가 확인 (카메라가 준비되면 파이프라인 시작)
+    bool dutyCycle = g_duty.isEnabled();
+    bool autoConnect = (dutyCycle || g_config.get<int>("auto_connect", 0) == 1) && g_wifi.getSSID().length() > 0;
+    BootTimeline::start(BootTimeline::CAMERA);
+    if (autoConnect)
+    {
+        BootTimeline::start(BootTimeline::WIFI);
+    }
+    if (dutyCycle)
+    {
+        // deep sleep 주기 모드: 카메라/WiFi 는 g_duty 가 시작
+        g_duty.begin();
+    }
+    else
+    {
+        g_camera.initAsync();
+        if (autoConnect)
+        {
+            // 접속은 task_Wifi 에서 진행
+            Serial.println("Auto connecting WiFi...");
+            g_wifi.connect();
+        }
+    }
+
     Serial.println();
     Serial.println(":-]");
     Serial.println("========================================");
@@ -176,63 +289,42 @@ void setup()
     printHeapInfo();
     Serial.printf("Chip ID: %s\n", getChipID().c_str());
     Serial.printf("Config System Revision: %d\n", Config::SystemVersion);
+    Serial.printf("Reset reason: %s\n", BootTimeline::resetReason());
 
     // 칩 정보 출력
     Serial.printf("Chip Model: %s\n", ESP.getChipModel());
     Serial.printf("Chip Revision: %d\n", ESP.getChipRevision());
     Serial.printf("CPU Freq: %d MHz\n", ESP.getCpuFreqMHz());
 
-    // 설정 로드
-    g_config.load();
-    loadSettingsToModules();
-
-    // 카메라 초기화
-    Serial.println("Initializing camera...");
-    if (g_camera.init())
+    // 업로드 스풀 (LittleFS, 파티션이 없으면 스풀 없이 동작)
+    BootTimeline::start(BootTimeline::SPOOL);
+    if (LittleFS.begin(true))
     {
-        Serial.println("Camera OK");
-        
-        // 저장된 해상도 적용
-        if (g_config.hasKey("resolution"))
-        {
-            String res = g_config.get<String>("resolution");
-            g_camera.setResolutionByName(res);
-        }
+        g_spool.begin(LittleFS.totalBytes());
     }
     else
     {
-        Serial.println("Camera FAILED");
+        Serial.println("LittleFS mount failed (spool disabled)");
     }
+    BootTimeline::end(BootTimeline::SPOOL);
 
-    // 자동 WiFi 연결
-    int autoConnect = g_config.get<int>("auto_connect", 0);
-    if (autoConnect == 1 && g_wifi.getSSID().length() > 0)
+    if (dutyCycle)
     {
-        Serial.println("Auto connecting WiFi...");
-        if (g_wifi.connect())
-        {
-            Serial.printf("Connected! IP: %s\n", g_wifi.getIP().c_str());
-        }
+        task_Duty.enable();
+        Serial.println("Duty cycle mode (capture, upload, deep sleep)");
     }
-
-    // 자동 업로드 태스크 설정
-    int autoUploadInterval = g_config.get<int>("upload_interval", 60);
-    task_AutoUpload.setInterval(autoUploadInterval * 1000);
-    
-    int autoUpload = g_config.get<int>("auto_upload", 0);
-    if (autoUpload == 1)
+    else
     {
-        task_AutoUpload.enable();
-        Serial.printf("Auto upload enabled (interval: %ds)\n", autoUploadInterval);
+        // 상태 LED 블링크 시작
+        task_LedBlink.enable();
+
+        Serial.println("========================================");
+        Serial.println("Ready! Type 'help' for commands");
+        Serial.println("========================================");
     }
 
-    // 상태 LED 블링크 시작
-    task_LedBlink.enable();
+    BootTimeline::end(BootTimeline::SETUP);
 
-    Serial.println("========================================");
-    Serial.println("Ready! Type 'help' for commands");
-    Serial.println("========================================");
-    
     // 태스크 스케줄러 시작
     g_ts.startNow();
 }
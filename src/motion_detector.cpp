@@ -0,0 +1,331 @@
+#include "motion_detector.hpp"
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 16bit 레인 2개에 든 바이트(0~255)의 |a - b|
+// 레인마다 256 + a - b (1~511) 로 계산해 레인 간 빌림이 없고,
+// bit8 이 0 인 레인(a < b)만 2의 보수로 뒤집는다
+static inline uint32_t absDiffLanes(uint32_t a, uint32_t b)
+{
+    uint32_t t = (a + 0x01000100) - b;
+    uint32_t s = t & 0x00FF00FF;
+    uint32_t n = (~t >> 8) & 0x00010001;
+    return (s ^ (n * 0xFF)) + n;
+}
+
+uint32_t MotionDetector::sadScalar(const uint8_t *a, const uint8_t *b, int stride, int w, int h)
+{
+    uint32_t sum = 0;
+    for (int y = 0; y < h; y++)
+    {
+        const uint8_t *pa = a + y * stride;
+        const uint8_t *pb = b + y * stride;
+        for (int x = 0; x < w; x++)
+        {
+            sum += abs((int)pa[x] - (int)pb[x]);
+        }
+    }
+    return sum;
+}
+
+uint32_t MotionDetector::sadSwar(const uint8_t *a, const uint8_t *b, int stride, int w, int h)
+{
+    uint32_t sum = 0;
+    for (int y = 0; y < h; y++)
+    {
+        const uint8_t *pa = a + y * stride;
+        const uint8_t *pb = b + y * stride;
+        int x = 0;
+
+        while (x + 4 <= w)
+        {
+            // 레인 누적값이 16bit 를 넘지 않도록 64 워드(256픽셀)마다 합산
+            uint32_t acc = 0;
+            for (int n = 0; n < 64 && x + 4 <= w; n++, x += 4)
+            {
+                uint32_t va = load32(pa + x);
+                uint32_t vb = load32(pb + x);
+                acc += absDiffLanes(va & 0x00FF00FF, vb & 0x00FF00FF);
+                acc += absDiffLanes((va >> 8) & 0x00FF00FF, (vb >> 8) & 0x00FF00FF);
+            }
+            sum += (acc & 0xFFFF) + (acc >> 16);
+        }
+
+        for (; x < w; x++)
+        {
+            sum += abs((int)pa[x] - (int)pb[x]);
+        }
+    }
+    return sum;
+}
+
+#ifdef MOTION_SAD_SCALAR
+#define MOTION_SAD sadScalar
+#else
+#define MOTION_SAD sadSwar
+#endif
+
+bool MotionDetector::allocBackground(int width, int height)
+{
+    if (m_background && width == m_width && height == m_height)
+    {
+        return true;
+    }
+
+    freeBackground();
+    size_t pixels = (size_t)width * height;
+    m_background = psramFound() ? (uint8_t *)ps_malloc(pixels) : (uint8_t *)malloc(pixels);
+    if (!m_background)
+    {
+        Serial.printf("Motion background alloc failed (%u bytes)\n", (unsigned)pixels);
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_hasBackground = false;
+    return true;
+}
+
+void MotionDetector::freeBackground()
+{
+    if (m_background)
+    {
+        free(m_background);
+    }
+    m_background = nullptr;
+    m_width = 0;
+    m_height = 0;
+    m_hasBackground = false;
+}
+
+int MotionDetector::countChangedBlocks(const uint8_t *gray)
+{
+    int grid = m_grid;
+    if (grid > m_width)
+    {
+        grid = m_width;
+    }
+    if (grid > m_height)
+    {
+        grid = m_height;
+    }
+
+    int bw = m_width / grid;
+    int bh = m_height / grid;
+    uint32_t blockPixels = (uint32_t)bw * bh;
+
+    int changed = 0;
+    uint32_t maxDiff = 0;
+    for (int by = 0; by < grid; by++)
+    {
+        for (int bx = 0; bx < grid; bx++)
+        {
+            size_t offset = (size_t)by * bh * m_width + bx * bw;
+            uint32_t diff = MOTION_SAD(gray + offset, m_background + offset, m_width, bw, bh) / blockPixels;
+            if (diff > maxDiff)
+            {
+                maxDiff = diff;
+            }
+            if (diff > (uint32_t)m_threshold)
+            {
+                changed++;
+            }
+        }
+    }
+
+    m_lastMaxBlock = maxDiff;
+    return changed;
+}
+
+void MotionDetector::updateBackground(const uint8_t *gray)
+{
+    size_t pixels = (size_t)m_width * m_height;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        int diff = (int)gray[i] - (int)m_background[i];
+        m_background[i] = (uint8_t)(m_background[i] + (diff >> BG_LEARN_SHIFT));
+    }
+}
+
+bool MotionDetector::check()
+{
+    m_checks++;
+
+    if (!m_thumb.isValid() || !allocBackground(m_thumb.width(), m_thumb.height()))
+    {
+        m_errors++;
+        return true;
+    }
+
+    const uint8_t *gray = m_thumb.gray();
+    if (!m_hasBackground)
+    {
+        // 첫 프레임은 배경으로 쓰고 기준 프레임으로 업로드
+        memcpy(m_background, gray, (size_t)m_width * m_height);
+        m_hasBackground = true;
+        m_motions++;
+        return true;
+    }
+
+    uint32_t startUs = micros();
+    m_lastChanged = countChangedBlocks(gray);
+    m_lastSadUs = micros() - startUs;
+    updateBackground(gray);
+
+    if (m_lastChanged >= m_minBlocks)
+    {
+        m_motions++;
+        return true;
+    }
+
+    m_stills++;
+    return false;
+}
+
+void MotionDetector::resetStats()
+{
+    m_checks = 0;
+    m_motions = 0;
+    m_stills = 0;
+    m_errors = 0;
+    m_lastChanged = 0;
+    m_lastMaxBlock = 0;
+    m_lastSadUs = 0;
+}
+
+const CmdEntry<MotionDetector::CmdHandler> MotionDetector::COMMANDS[] = {
+    CMD_ENTRY("set", "set enabled/grid/thresh/blocks/interval <value>", &MotionDetector::cmdSet),
+    CMD_ENTRY("status", "status", &MotionDetector::cmdStatus),
+    CMD_ENTRY("reset", "reset", &MotionDetector::cmdReset),
+    CMD_ENTRY("bench", "bench [n]", &MotionDetector::cmdBench),
+};
+
+void MotionDetector::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String MotionDetector::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void MotionDetector::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        if (key == "enabled" || key == "motion")
+        {
+            setEnabled(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["motion"] = m_enabled;
+        }
+        else if (key == "grid" || key == "motion_grid")
+        {
+            setGrid(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["motion_grid"] = m_grid;
+        }
+        else if (key == "thresh" || key == "motion_thresh")
+        {
+            setThreshold(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["motion_thresh"] = m_threshold;
+        }
+        else if (key == "blocks" || key == "motion_blocks")
+        {
+            setMinBlocks(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["motion_blocks"] = m_minBlocks;
+        }
+        else if (key == "interval" || key == "motion_interval")
+        {
+            setInterval(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["motion_interval"] = m_interval;
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown key (enabled/grid/thresh/blocks/interval)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void MotionDetector::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["enabled"] = m_enabled;
+    _res_doc["grid"] = m_grid;
+    _res_doc["thresh"] = m_threshold;
+    _res_doc["blocks"] = m_minBlocks;
+    _res_doc["interval"] = m_interval;
+    _res_doc["width"] = m_width;
+    _res_doc["height"] = m_height;
+    _res_doc["checks"] = m_checks;
+    _res_doc["motions"] = m_motions;
+    _res_doc["stills"] = m_stills;
+    _res_doc["errors"] = m_errors;
+    _res_doc["last_changed"] = m_lastChanged;
+    _res_doc["last_max_diff"] = m_lastMaxBlock;
+    _res_doc["decode_us"] = m_thumb.getDecodeUs();
+    _res_doc["sad_us"] = m_lastSadUs;
+}
+
+void MotionDetector::cmdReset(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    resetBackground();
+    resetStats();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "motion background reset";
+}
+
+void MotionDetector::cmdBench(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 마지막으로 디코드한 썸네일과 배경으로 두 커널을 비교 (같은 결과여야 함)
+    if (!m_hasBackground || !m_thumb.isValid() || m_thumb.width() != m_width || m_thumb.height() != m_height)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "no frame yet";
+        return;
+    }
+
+    int iterations = (tokens.size() > 2) ? constrain((int)tokens[2].toInt(), 1, 10000) : 100;
+
+    uint32_t scalarSum = 0;
+    uint32_t startUs = micros();
+    for (int i = 0; i < iterations; i++)
+    {
+        scalarSum = sadScalar(m_thumb.gray(), m_background, m_width, m_width, m_height);
+    }
+    uint32_t scalarUs = micros() - startUs;
+
+    uint32_t swarSum = 0;
+    startUs = micros();
+    for (int i = 0; i < iterations; i++)
+    {
+        swarSum = sadSwar(m_thumb.gray(), m_background, m_width, m_width, m_height);
+    }
+    uint32_t swarUs = micros() - startUs;
+
+    _res_doc["result"] = "ok";
+    _res_doc["pixels"] = m_width * m_height;
+    _res_doc["iterations"] = iterations;
+    _res_doc["scalar_us"] = scalarUs / iterations;
+    _res_doc["swar_us"] = swarUs / iterations;
+    _res_doc["match"] = scalarSum == swarSum;
+}
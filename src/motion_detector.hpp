@@ -0,0 +1,99 @@
+#ifndef MOTION_DETECTOR_HPP
+#define MOTION_DETECTOR_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "luma_thumb.hpp"
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 블록 SAD 움직임 감지
+// - 캡처한 JPEG 의 1/8 그레이스케일 썸네일 사용 (센서 포맷 전환 없음)
+// - 배경 모델(이동 평균)과 grid x grid 블록 단위로 SAD 비교
+// - 픽셀당 평균 차이가 thresh 를 넘는 블록이 min_blocks 개 이상이면 움직임
+// 파이프라인 캡처 태스크에서 호출되며, 움직임이 없으면 업로드하지 않는다.
+class MotionDetector
+{
+public:
+    static const int MIN_GRID = 2;
+    static const int MAX_GRID = 16;
+    static const uint8_t BG_LEARN_SHIFT = 3;   // 배경 갱신 비율 1/8
+
+    // 블록 SAD 커널
+    // 스칼라: 픽셀 단위 기준 구현
+    // SWAR: 32bit 레지스터에 4픽셀씩 (16bit 레인 2개씩 나눠 부호 없는 절대 차)
+    // ESP32-S3 PIE 경로는 없다. 블록 한 줄이 width/grid 픽셀 (VGA 썸네일 8x8 격자에서 10픽셀) 로
+    // 128bit 레지스터 하나도 채우지 못하고 16바이트 정렬도 아니어서 이득이 작다.
+    // 속도는 native_bench_motion (녹화 JPEG 재생) 이나 기기에서 motion bench 로 잰다.
+    static uint32_t sadScalar(const uint8_t *a, const uint8_t *b, int stride, int w, int h);
+    static uint32_t sadSwar(const uint8_t *a, const uint8_t *b, int stride, int w, int h);
+
+private:
+    bool m_enabled = false;
+    int m_grid = 8;                 // grid x grid 블록
+    int m_threshold = 15;           // 블록 픽셀당 평균 절대 차 (0~255)
+    int m_minBlocks = 2;            // 움직임으로 볼 최소 변화 블록 수
+    uint32_t m_interval = 1000;     // 감지 주기 (ms)
+
+    LumaThumbnail &m_thumb;
+
+    // 배경 모델 (PSRAM 우선, 썸네일 크기가 바뀌면 다시 할당)
+    uint8_t *m_background = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    bool m_hasBackground = false;
+
+    // 통계
+    uint32_t m_checks = 0;
+    uint32_t m_motions = 0;
+    uint32_t m_stills = 0;
+    uint32_t m_errors = 0;
+    int m_lastChanged = 0;
+    uint32_t m_lastMaxBlock = 0;    // 가장 많이 변한 블록의 픽셀당 차이
+    uint32_t m_lastSadUs = 0;
+
+    bool allocBackground(int width, int height);
+    void freeBackground();
+    int countChangedBlocks(const uint8_t *gray);
+    void updateBackground(const uint8_t *gray);
+
+public:
+    MotionDetector(LumaThumbnail &thumb) : m_thumb(thumb) {}
+    ~MotionDetector() { freeBackground(); }
+
+    // 현재 썸네일 검사 (true = 움직임 있음, 업로드 대상)
+    // 배경이 없거나 썸네일 디코드에 실패했으면 놓치지 않도록 true
+    bool check();
+    void resetBackground() { m_hasBackground = false; }
+    void resetStats();
+
+    // 설정
+    inline void setEnabled(bool enabled) { m_enabled = enabled; m_hasBackground = false; }
+    inline void setGrid(int grid) { m_grid = constrain(grid, MIN_GRID, MAX_GRID); }
+    inline void setThreshold(int threshold) { m_threshold = constrain(threshold, 1, 255); }
+    inline void setMinBlocks(int blocks) { m_minBlocks = constrain(blocks, 1, MAX_GRID * MAX_GRID); }
+    inline void setInterval(uint32_t ms) { m_interval = ms < 100 ? 100 : ms; }
+
+    inline bool isEnabled() const { return m_enabled; }
+    inline int getGrid() const { return m_grid; }
+    inline int getThreshold() const { return m_threshold; }
+    inline int getMinBlocks() const { return m_minBlocks; }
+    inline uint32_t getInterval() const { return m_interval; }
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (MotionDetector::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdReset(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdBench(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // MOTION_DETECTOR_HPP
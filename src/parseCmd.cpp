@@ -2,10 +2,21 @@
 #include <vector>
 
 #include "tonkey.hpp"
+#include "cmd_registry.hpp"
 #include "config.hpp"
 #include "camera_module.hpp"
 #include "wifi_module.hpp"
 #include "http_upload.hpp"
+#include "upload_pipeline.hpp"
+#include "stream_server.hpp"
+#include "motion_detector.hpp"
+#include "dup_filter.hpp"
+#include "resolution_ladder.hpp"
+#include "frame_spool.hpp"
+#include "duty_cycle.hpp"
+#include "latency_stats.hpp"
+#include "boot_timeline.hpp"
+#include "serial_cmd.hpp"
 
 #include "etc.hpp"
 
@@ -15,6 +26,14 @@ extern Config g_config;
 extern CameraModule g_camera;
 extern WifiModule g_wifi;
 extern HttpUploader g_uploader;
+extern UploadPipeline g_pipeline;
+extern StreamServer g_stream;
+extern MotionDetector g_motion;
+extern DuplicateFilter g_dedup;
+extern ResolutionLadder g_ladder;
+extern FrameSpool g_spool;
+extern DutyCycle g_duty;
+extern SerialCmdReader g_cmdReader;
 
 // 설정값들을 모듈에 로드
 void loadSettingsToModules()
@@ -28,11 +47,24 @@ void loadSettingsToModules()
     {
         g_wifi.setPassword(g_config.get<String>("password"));
     }
+    if (g_config.hasKey("wifi_fast"))
+    {
+        g_wifi.setFastJoin(g_config.get<int>("wifi_fast") == 1);
+    }
+    if (g_config.hasKey("wifi_lease"))
+    {
+        g_wifi.setReuseLease(g_config.get<int>("wifi_lease") == 1);
+    }
+    if (g_config.hasKey("static_ip"))
+    {
+        g_wifi.setStaticIp(g_config.get<String>("static_ip"), g_config.get<String>("static_gw"),
+                           g_config.get<String>("static_mask"), g_config.get<String>("static_dns"));
+    }
 
     // 서버 설정 로드
-    if (g_config.hasKey("server_url"))
+    if (g_config.hasKey("server_url") && !g_uploader.setServerUrl(g_config.get<String>("server_url")))
     {
-        g_uploader.setServerUrl(g_config.get<String>("server_url"));
+        Serial.println("Saved server_url ignored (http:// only)");
     }
     
     if (g_config.hasKey("server_path"))
@@ -45,6 +77,128 @@ void loadSettingsToModules()
         g_uploader.setAuthToken(g_config.get<String>("auth_token"));
     }
 
+    if (g_config.hasKey("server_chunked"))
+    {
+        g_uploader.setChunked(g_config.get<int>("server_chunked") == 1);
+    }
+
+    if (g_config.hasKey("batch_size"))
+    {
+        g_uploader.setBatchSize(g_config.get<int>("batch_size"));
+    }
+
+    if (g_config.hasKey("batch_max_age"))
+    {
+        g_uploader.setBatchMaxAge(g_config.get<int>("batch_max_age"));
+    }
+
+    // 센서 프로필 (카메라 초기화 전에 로드하면 init 때 바로 적용)
+    if (g_config.hasKey("sensor_profile"))
+    {
+        g_camera.setProfile(g_config.get<String>("sensor_profile"));
+    }
+
+    // JPEG 품질 / 프레임 크기 목표 (카메라 초기화 전에 로드)
+    if (g_config.hasKey("jpeg_quality"))
+    {
+        g_camera.setJpegQuality(g_config.get<int>("jpeg_quality"));
+    }
+    if (g_config.hasKey("target_hyst"))
+    {
+        g_camera.setTargetHysteresis(g_config.get<int>("target_hyst"));
+    }
+    if (g_config.hasKey("target_bytes"))
+    {
+        g_camera.setTargetBytes(g_config.get<int>("target_bytes"));
+    }
+
+    // 해상도 자동 조정 설정 로드
+    framesize_t size;
+    if (g_config.hasKey("res_floor") && CameraModule::parseResolution(g_config.get<String>("res_floor"), size))
+    {
+        g_ladder.setFloor(size);
+    }
+    if (g_config.hasKey("res_ceiling") && CameraModule::parseResolution(g_config.get<String>("res_ceiling"), size))
+    {
+        g_ladder.setCeiling(size);
+    }
+    if (g_config.hasKey("res_headroom"))
+    {
+        g_ladder.setHeadroom(g_config.get<int>("res_headroom"));
+    }
+    if (g_config.hasKey("res_min_rssi"))
+    {
+        g_ladder.setMinRssi(g_config.get<int>("res_min_rssi"));
+    }
+    if (g_config.hasKey("res_adaptive"))
+    {
+        g_ladder.setEnabled(g_config.get<int>("res_adaptive") == 1);
+    }
+
+    // 움직임 감지 설정 로드
+    if (g_config.hasKey("motion_grid"))
+    {
+        g_motion.setGrid(g_config.get<int>("motion_grid"));
+    }
+    if (g_config.hasKey("motion_thresh"))
+    {
+        g_motion.setThreshold(g_config.get<int>("motion_thresh"));
+    }
+    if (g_config.hasKey("motion_blocks"))
+    {
+        g_motion.setMinBlocks(g_config.get<int>("motion_blocks"));
+    }
+    if (g_config.hasKey("motion_interval"))
+    {
+        g_motion.setInterval(g_config.get<int>("motion_interval"));
+    }
+    if (g_config.hasKey("motion"))
+    {
+        g_motion.setEnabled(g_config.get<int>("motion") == 1);
+    }
+
+    // 중복 프레임 필터 설정 로드
+    if (g_config.hasKey("dedup_dist"))
+    {
+        g_dedup.setMaxDistance(g_config.get<int>("dedup_dist"));
+    }
+    if (g_config.hasKey("dedup_heartbeat"))
+    {
+        g_dedup.setHeartbeat(g_config.get<int>("dedup_heartbeat"));
+    }
+    if (g_config.hasKey("dedup"))
+    {
+        g_dedup.setEnabled(g_config.get<int>("dedup") == 1);
+    }
+
+    // 업로드 스풀 설정 로드
+    if (g_config.hasKey("spool"))
+    {
+        g_spool.setEnabled(g_config.get<int>("spool") == 1);
+    }
+    if (g_config.hasKey("spool_max_kb"))
+    {
+        g_spool.setMaxKb(g_config.get<int>("spool_max_kb"));
+    }
+
+    // deep sleep 주기 모드 설정 로드 (주기는 upload_interval)
+    if (g_config.hasKey("upload_interval"))
+    {
+        g_duty.setIntervalMs(g_config.get<int>("upload_interval") * 1000);
+    }
+    if (g_config.hasKey("sleep_budget"))
+    {
+        g_duty.setBudgetMs(g_config.get<int>("sleep_budget"));
+    }
+    if (g_config.hasKey("sleep_warmup"))
+    {
+        g_duty.setWarmup(g_config.get<int>("sleep_warmup"));
+    }
+    if (g_config.hasKey("sleep_mode"))
+    {
+        g_duty.setEnabled(g_config.get<int>("sleep_mode") == 1);
+    }
+
     if (g_config.hasKey("device_id"))
     {
         g_uploader.setDeviceId(g_config.get<String>("device_id"));
@@ -67,6 +221,12 @@ void saveSettingsFromModules()
     {
         g_config.set("password", g_wifi.getPassword());
     }
+    g_config.set("wifi_fast", g_wifi.isFastJoin() ? 1 : 0);
+    g_config.set("wifi_lease", g_wifi.isReuseLease() ? 1 : 0);
+    g_config.set("static_ip", g_wifi.getStaticIp());
+    g_config.set("static_gw", g_wifi.getStaticGateway());
+    g_config.set("static_mask", g_wifi.getStaticSubnet());
+    g_config.set("static_dns", g_wifi.getStaticDns());
 
     // 서버 설정
     if (g_uploader.getServerUrl().length() > 0)
@@ -85,189 +245,395 @@ void saveSettingsFromModules()
     {
         g_config.set("device_id", g_uploader.getDeviceId());
     }
+    g_config.set("server_chunked", g_uploader.isChunked() ? 1 : 0);
+    g_config.set("batch_size", g_uploader.getBatchSize());
+    g_config.set("batch_max_age", g_uploader.getBatchMaxAge());
+
+    // JPEG 품질 (제어 중이면 마지막으로 정한 값에서 다시 시작)
+    if (g_camera.getJpegQuality() > 0)
+    {
+        g_config.set("jpeg_quality", g_camera.getJpegQuality());
+    }
+    g_config.set("target_bytes", (int)g_camera.getTargetBytes());
+    g_config.set("target_hyst", g_camera.getTargetHysteresis());
+    g_config.set("sensor_profile", String(g_camera.getProfileName()));
+
+    // 해상도 자동 조정 설정
+    g_config.set("res_adaptive", g_ladder.isEnabled() ? 1 : 0);
+    g_config.set("res_floor", String(CameraModule::frameSizeName(g_ladder.getFloor())));
+    g_config.set("res_ceiling", String(CameraModule::frameSizeName(g_ladder.getCeiling())));
+    g_config.set("res_headroom", g_ladder.getHeadroom());
+    g_config.set("res_min_rssi", g_ladder.getMinRssi());
+
+    // 움직임 감지 설정
+    g_config.set("motion", g_motion.isEnabled() ? 1 : 0);
+    g_config.set("motion_grid", g_motion.getGrid());
+    g_config.set("motion_thresh", g_motion.getThreshold());
+    g_config.set("motion_blocks", g_motion.getMinBlocks());
+    g_config.set("motion_interval", (int)g_motion.getInterval());
+
+    // 중복 프레임 필터 설정
+    g_config.set("dedup", g_dedup.isEnabled() ? 1 : 0);
+    g_config.set("dedup_dist", g_dedup.getMaxDistance());
+    g_config.set("dedup_heartbeat", (int)g_dedup.getHeartbeat());
+
+    // 업로드 스풀 설정
+    g_config.set("spool", g_spool.getEnabled() ? 1 : 0);
+    g_config.set("spool_max_kb", (int)g_spool.getMaxKb());
+
+    // deep sleep 주기 모드 설정
+    g_config.set("sleep_mode", g_duty.isEnabled() ? 1 : 0);
+    g_config.set("sleep_budget", (int)g_duty.getBudgetMs());
+    g_config.set("sleep_warmup", g_duty.getWarmup());
+
+    // 변경된 키를 한 번에 커밋
+    g_config.flush();
 }
 
-String parseCmd(String _strLine)
+static void cmdAbout(const tonkey &tokens, JsonDocument &_res_doc)
 {
-    JsonDocument _res_doc;
+    _res_doc["result"] = "ok";
+    _res_doc["os"] = "cronos-v1";
+    _res_doc["app"] = "esp32cam-uploader";
+    _res_doc["version"] = "1.0.0";
+    _res_doc["author"] = "gbox3d";
+    _res_doc["chipid"] = (uint32_t)(ESP.getEfuseMac() & 0xFFFFFFFF);
+    _res_doc["psram"] = psramFound();
+}
+
+static void cmdReboot(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "rebooting...";
+    g_config.flush();
+    g_cmdReader.sendResponse(_res_doc);
+    delay(100);
+    ESP.restart();
+}
 
-    g_MainParser.parse(_strLine);
-    if (g_MainParser.getTokenCount() > 0)
+static void cmdHeap(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["free_heap"] = ESP.getFreeHeap();
+    if (psramFound())
     {
-        String cmd = g_MainParser.getToken(0);
+        _res_doc["psram_size"] = ESP.getPsramSize();
+        _res_doc["psram_free"] = ESP.getFreePsram();
+    }
+}
 
-        // 토큰들을 벡터로 변환
-        std::vector<String> tokens;
-        for (int i = 0; i < g_MainParser.getTokenCount(); i++)
-        {
-            tokens.push_back(g_MainParser.getToken(i));
-        }
+static void cmdBoot(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 부팅 단계별 시각 (카메라/WiFi 는 동시에 진행되어 겹칠 수 있음)
+    _res_doc["result"] = "ok";
+    _res_doc["reset"] = BootTimeline::resetReason();
+    _res_doc["uptime_ms"] = millis();
+    BootTimeline::toJson(_res_doc["phases"].to<JsonObject>());
+}
 
-        if (cmd == "about")
-        {
-            _res_doc["result"] = "ok";
-            _res_doc["os"] = "cronos-v1";
-            _res_doc["app"] = "esp32cam-uploader";
-            _res_doc["version"] = "1.0.0";
-            _res_doc["author"] = "gbox3d";
-            _res_doc["chipid"] = (uint32_t)(ESP.getEfuseMac() & 0xFFFFFFFF);
-            _res_doc["psram"] = psramFound();
-        }
-        else if (cmd == "reboot")
+static void cmdUpload(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 단축 명령: upload [filename]
+    // 카메라 캡처 후 바로 업로드
+    if (!g_camera.isInitialized())
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "camera not initialized";
+    }
+    else if (!g_wifi.isConnected())
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "wifi not connected";
+    }
+    else if (g_uploader.getServerUrl().length() == 0)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "server url not set";
+    }
+    else
+    {
+        // 플래시 켜고 캡처
+        bool useFlash = g_config.get<int>("use_flash", 0) == 1;
+        if (useFlash)
         {
-            _res_doc["result"] = "ok";
-            _res_doc["ms"] = "rebooting...";
-            String response;
-            serializeJson(_res_doc, response);
-            Serial.println(response);
+            g_camera.flashOn();
             delay(100);
-            ESP.restart();
-        }
-        else if (cmd == "heap")
-        {
-            _res_doc["result"] = "ok";
-            _res_doc["free_heap"] = ESP.getFreeHeap();
-            if (psramFound())
-            {
-                _res_doc["psram_size"] = ESP.getPsramSize();
-                _res_doc["psram_free"] = ESP.getFreePsram();
-            }
-        }
-        else if (cmd == "config")
-        {
-            g_config.parseCmd(tokens, _res_doc);
-        }
-        else if (cmd == "wifi")
-        {
-            g_wifi.parseCmd(tokens, _res_doc);
-        }
-        else if (cmd == "camera" || cmd == "cam")
-        {
-            g_camera.parseCmd(tokens, _res_doc);
         }
-        else if (cmd == "server")
-        {
-            g_uploader.parseCmd(tokens, _res_doc);
-        }
-        else if (cmd == "upload")
+
+        // 콘솔 업로드는 캡처 태스크와 같은 grab/returnFrame 경로 (m_fb 에 프레임을 남기지 않음)
+        camera_fb_t *fb = g_camera.grab();
+        if (fb)
         {
-            // 단축 명령: upload [filename]
-            // 카메라 캡처 후 바로 업로드
-            if (!g_camera.isInitialized())
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "camera not initialized";
-            }
-            else if (!g_wifi.isConnected())
+            if (useFlash)
             {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "wifi not connected";
+                g_camera.flashOff();
             }
-            else if (g_uploader.getServerUrl().length() == 0)
+
+            String fileName = "";
+            if (tokens.size() > 1)
             {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "server url not set";
+                fileName = tokens[1];
             }
-            else
-            {
-                // 플래시 켜고 캡처
-                bool useFlash = g_config.get<int>("use_flash", 0) == 1;
-                if (useFlash)
-                {
-                    g_camera.flashOn();
-                    delay(100);
-                }
 
-                if (g_camera.capture())
+            String response;
+            int httpCode = g_uploader.uploadImage(
+                fb->buf,
+                fb->len,
+                response,
+                fileName
+            );
+
+            g_camera.returnFrame(fb);
+
+            if (httpCode == 200 || httpCode == 201)
+            {
+                _res_doc["result"] = "ok";
+                _res_doc["ms"] = "uploaded";
+                _res_doc["httpCode"] = httpCode;
+                
+                // 서버 응답 파싱 시도
+                JsonDocument serverRes;
+                if (deserializeJson(serverRes, response) == DeserializationError::Ok)
                 {
-                    if (useFlash)
-                    {
-                        g_camera.flashOff();
-                    }
-
-                    String fileName = "";
-                    if (tokens.size() > 1)
-                    {
-                        fileName = tokens[1];
-                    }
-
-                    String response;
-                    int httpCode = g_uploader.uploadImage(
-                        g_camera.getImageData(),
-                        g_camera.getImageSize(),
-                        response,
-                        fileName
-                    );
-
-                    g_camera.releaseBuffer();
-
-                    if (httpCode == 200 || httpCode == 201)
-                    {
-                        _res_doc["result"] = "ok";
-                        _res_doc["ms"] = "uploaded";
-                        _res_doc["httpCode"] = httpCode;
-                        
-                        // 서버 응답 파싱 시도
-                        JsonDocument serverRes;
-                        if (deserializeJson(serverRes, response) == DeserializationError::Ok)
-                        {
-                            _res_doc["server"] = serverRes;
-                        }
-                        else
-                        {
-                            _res_doc["serverResponse"] = response;
-                        }
-                    }
-                    else
-                    {
-                        _res_doc["result"] = "fail";
-                        _res_doc["ms"] = "upload failed";
-                        _res_doc["httpCode"] = httpCode;
-                    }
+                    _res_doc["server"] = serverRes;
                 }
                 else
                 {
-                    if (useFlash)
-                    {
-                        g_camera.flashOff();
-                    }
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "capture failed";
+                    _res_doc["serverResponse"] = response;
                 }
             }
-        }
-        else if (cmd == "saveall")
-        {
-            // 모든 설정 저장
-            saveSettingsFromModules();
-            _res_doc["result"] = "ok";
-            _res_doc["ms"] = "all settings saved";
-        }
-        else if (cmd == "autoconnect")
-        {
-            // 저장된 WiFi 설정으로 자동 연결
-            loadSettingsToModules();
-            if (g_wifi.connect())
-            {
-                _res_doc["result"] = "ok";
-                _res_doc["ms"] = "auto connected";
-                _res_doc["ip"] = g_wifi.getIP();
-            }
             else
             {
                 _res_doc["result"] = "fail";
-                _res_doc["ms"] = "auto connect failed";
+                _res_doc["ms"] = "upload failed";
+                _res_doc["httpCode"] = httpCode;
             }
         }
-        else if (cmd == "help")
+        else
         {
-            _res_doc["result"] = "ok";
-            _res_doc["commands"] = "about,reboot,heap,config,wifi,camera,server,upload,saveall,autoconnect,help";
-            _res_doc["config"] = "load/save/dump/clear/set/get";
-            _res_doc["wifi"] = "set ssid/password, connect, disconnect, status, scan";
-            _res_doc["camera"] = "init, capture, status, resolution, flash on/off/blink";
-            _res_doc["server"] = "set url/path/token/deviceid/timeout, status";
-            _res_doc["upload"] = "capture and upload (shortcut)";
+            if (useFlash)
+            {
+                g_camera.flashOff();
+            }
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "capture failed";
+        }
+    }
+}
+
+static void cmdSaveall(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 모든 설정 저장
+    saveSettingsFromModules();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "all settings saved";
+}
+
+static void cmdAutoconnect(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // 저장된 WiFi 설정으로 자동 연결
+    loadSettingsToModules();
+    if (g_wifi.connect())
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = g_wifi.isConnected() ? "connected" : "connecting";
+        _res_doc["state"] = WifiModule::stateName(g_wifi.getState());
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "auto connect failed";
+    }
+}
+
+static void cmdConfig(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_config.parseCmd(tokens, _res_doc);
+}
+
+static void cmdWifi(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_wifi.parseCmd(tokens, _res_doc);
+}
+
+static void cmdCamera(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_camera.parseCmd(tokens, _res_doc);
+}
+
+static void cmdServer(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_uploader.parseCmd(tokens, _res_doc);
+}
+
+static void cmdPipeline(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_pipeline.parseCmd(tokens, _res_doc);
+}
+
+static void cmdStream(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_stream.parseCmd(tokens, _res_doc);
+}
+
+static void cmdMotion(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_motion.parseCmd(tokens, _res_doc);
+}
+
+static void cmdDedup(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_dedup.parseCmd(tokens, _res_doc);
+}
+
+static void cmdSpool(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_spool.parseCmd(tokens, _res_doc);
+}
+
+static void cmdSleep(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_duty.parseCmd(tokens, _res_doc);
+}
+
+static void cmdAdaptive(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_ladder.parseCmd(tokens, _res_doc);
+}
+
+// stats 서브 커맨드
+static void statsCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    g_cmdReader.statsToJson(_res_doc);
+}
+
+static void statsLatency(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    LatencyStats::toJson(_res_doc["latency"].to<JsonObject>());
+}
+
+static void statsReset(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    g_cmdReader.resetStats();
+    LatencyStats::reset();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "stats reset";
+}
+
+typedef void (*StatsHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+static const CmdEntry<StatsHandler> STATS_COMMANDS[] = {
+    CMD_ENTRY("cmd", "cmd", statsCmd),
+    CMD_ENTRY("latency", "latency", statsLatency),
+    CMD_ENTRY("reset", "reset", statsReset),
+};
+
+static String statsUsage()
+{
+    return cmdUsage(STATS_COMMANDS, CMD_COUNT(STATS_COMMANDS));
+}
+
+static void cmdStats(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(STATS_COMMANDS, CMD_COUNT(STATS_COMMANDS), tokens, _res_doc);
+}
+
+// 콘솔 프로토콜 전환 (응답은 요청과 같은 인코딩, 다음 요청부터 새 모드로 수신)
+static void cmdProto(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 1)
+    {
+        if (tokens[1] == "text")
+        {
+            g_cmdReader.setMode(SerialCmdReader::MODE_TEXT);
+        }
+        else if (tokens[1] == "bin")
+        {
+            g_cmdReader.setMode(SerialCmdReader::MODE_BINARY);
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown protocol (text/bin)";
+            return;
+        }
+        _res_doc["result"] = "ok";
+        _res_doc["proto"] = tokens[1].c_str();
+        return;
+    }
+
+    _res_doc["result"] = "ok";
+    _res_doc["proto"] = g_cmdReader.getMode() == SerialCmdReader::MODE_BINARY ? "bin" : "text";
+}
+
+static void cmdHelp(const tonkey &tokens, JsonDocument &_res_doc);
+
+// 최상위 명령 테이블 (모듈 명령은 subUsage 로 서브 커맨드 사용법을 help 에 노출)
+struct MainCmd
+{
+    uint32_t hash;
+    const char *name;
+    const char *usage;
+    void (*handler)(const tonkey &tokens, JsonDocument &_res_doc);
+    String (*subUsage)();
+};
+
+static const MainCmd MAIN_COMMANDS[] = {
+    { cmdHash("about"), "about", "system info", cmdAbout, nullptr },
+    { cmdHash("reboot"), "reboot", "restart device", cmdReboot, nullptr },
+    { cmdHash("heap"), "heap", "memory info", cmdHeap, nullptr },
+    { cmdHash("boot"), "boot", "boot phase timeline", cmdBoot, nullptr },
+    { cmdHash("config"), "config", "settings", cmdConfig, Config::usage },
+    { cmdHash("wifi"), "wifi", "wifi control", cmdWifi, WifiModule::usage },
+    { cmdHash("camera"), "camera", "camera control", cmdCamera, CameraModule::usage },
+    { cmdHash("cam"), "cam", "alias of camera", cmdCamera, nullptr },
+    { cmdHash("server"), "server", "upload server", cmdServer, HttpUploader::usage },
+    { cmdHash("pipeline"), "pipeline", "auto upload pipeline", cmdPipeline, UploadPipeline::usage },
+    { cmdHash("stream"), "stream", "mjpeg stream server", cmdStream, StreamServer::usage },
+    { cmdHash("motion"), "motion", "motion gated upload", cmdMotion, MotionDetector::usage },
+    { cmdHash("dedup"), "dedup", "near-duplicate frame filter", cmdDedup, DuplicateFilter::usage },
+    { cmdHash("spool"), "spool", "on-flash upload spool", cmdSpool, FrameSpool::usage },
+    { cmdHash("sleep"), "sleep", "deep sleep duty cycle", cmdSleep, DutyCycle::usage },
+    { cmdHash("adaptive"), "adaptive", "bandwidth adaptive resolution", cmdAdaptive, ResolutionLadder::usage },
+    { cmdHash("stats"), "stats", "runtime statistics", cmdStats, statsUsage },
+    { cmdHash("upload"), "upload", "capture and upload (shortcut)", cmdUpload, nullptr },
+    { cmdHash("saveall"), "saveall", "save all module settings", cmdSaveall, nullptr },
+    { cmdHash("autoconnect"), "autoconnect", "connect with saved wifi settings", cmdAutoconnect, nullptr },
+    { cmdHash("proto"), "proto", "console protocol [text|bin]", cmdProto, nullptr },
+    { cmdHash("help"), "help", "this list", cmdHelp, nullptr },
+};
+
+static void cmdHelp(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    String names = cmdNames(MAIN_COMMANDS, CMD_COUNT(MAIN_COMMANDS));
+    names.replace('/', ',');
+    _res_doc["commands"] = names;
+    for (size_t i = 0; i < CMD_COUNT(MAIN_COMMANDS); i++)
+    {
+        const MainCmd &entry = MAIN_COMMANDS[i];
+        _res_doc[entry.name] = entry.subUsage ? entry.subUsage() : String(entry.usage);
+    }
+}
+
+// 명령 실행 (응답은 _res_doc 에 채움, 인코딩은 호출 측에서 결정)
+void execCmd(const char *_line, size_t _len, JsonDocument &_res_doc)
+{
+    // 토큰은 파서 라인 버퍼를 직접 가리킨다 (명령마다 복사 없음)
+    const tonkey &tokens = g_MainParser;
+
+    if (!g_MainParser.parse(_line, _len))
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = g_MainParser.getError();
+    }
+    else if (tokens.size() > 0)
+    {
+        const MainCmd *entry = findCmd(MAIN_COMMANDS, CMD_COUNT(MAIN_COMMANDS), tokens[0]);
+        if (entry)
+        {
+            entry->handler(tokens, _res_doc);
         }
         else
         {
@@ -280,8 +646,48 @@ String parseCmd(String _strLine)
         _res_doc["result"] = "fail";
         _res_doc["ms"] = "need command";
     }
+}
+
+String parseCmd(String _strLine)
+{
+    JsonDocument _res_doc;
+    execCmd(_strLine.c_str(), _strLine.length(), _res_doc);
 
     String response;
     serializeJson(_res_doc, response);
     return response;
 }
+
+// 시리얼에서 완성된 요청 하나를 꺼내 실행하고 같은 인코딩으로 응답 (없으면 false)
+bool serviceCmd()
+{
+    static SerialCmdReader::Line line;
+    if (!g_cmdReader.poll(line))
+    {
+        return false;
+    }
+
+    uint32_t dispatchUs = micros();
+    JsonDocument _res_doc;
+
+    const char *text = line.text;
+    size_t len = line.len;
+    if (line.overflow)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "line too long";
+    }
+    else if (line.binary && !SerialCmdReader::unpackRequest(line, text, len))
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "bad request frame";
+    }
+    else
+    {
+        execCmd(text, len, _res_doc);
+    }
+
+    g_cmdReader.sendResponse(_res_doc);
+    g_cmdReader.complete(line, dispatchUs);
+    return true;
+}
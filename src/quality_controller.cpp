@@ -0,0 +1,106 @@
+#include "quality_controller.hpp"
+
+static inline int clampInt(int value, int low, int high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+bool QualityController::update(size_t frameBytes)
+{
+    uint32_t bytes = (uint32_t)frameBytes;
+
+    m_frames++;
+    m_lastBytes = bytes;
+    if (m_minBytes == 0 || bytes < m_minBytes)
+    {
+        m_minBytes = bytes;
+    }
+    if (bytes > m_maxBytes)
+    {
+        m_maxBytes = bytes;
+    }
+
+    if (m_targetBytes == 0 || m_quality == 0)
+    {
+        return false;
+    }
+
+    // 품질 변경 전에 인코딩된 프레임
+    if (m_settle > 0)
+    {
+        m_settle--;
+        return false;
+    }
+
+    if (m_avgBytes == 0)
+    {
+        m_avgBytes = bytes;
+    }
+    else
+    {
+        m_avgBytes = (uint32_t)((int32_t)m_avgBytes + (((int32_t)bytes - (int32_t)m_avgBytes) >> AVG_SHIFT));
+    }
+
+    uint32_t band = (uint32_t)((uint64_t)m_targetBytes * m_hysteresis / 100);
+    if (m_avgBytes + band >= m_targetBytes && m_avgBytes <= m_targetBytes + band)
+    {
+        m_inBand++;
+        return false;
+    }
+
+    // quality 값이 클수록 파일이 작다: 평균이 크면 값을 올리고, 작으면 내린다
+    int wanted = (int)(((uint64_t)m_quality * m_avgBytes + m_targetBytes / 2) / m_targetBytes);
+    int step = clampInt(wanted - m_quality, -MAX_STEP, MAX_STEP);
+    if (step == 0)
+    {
+        step = (m_avgBytes > m_targetBytes) ? 1 : -1;
+    }
+
+    int next = clampInt(m_quality + step, QUALITY_MIN, QUALITY_MAX);
+    if (next == m_quality)
+    {
+        // 범위 끝에 걸림 (장면이 너무 복잡하거나 단순함)
+        return false;
+    }
+
+    m_quality = next;
+    m_adjustments++;
+    m_settle = m_settleFrames;
+    m_avgBytes = 0;
+    return true;
+}
+
+void QualityController::resetStats()
+{
+    m_frames = 0;
+    m_inBand = 0;
+    m_adjustments = 0;
+    m_lastBytes = 0;
+    m_minBytes = 0;
+    m_maxBytes = 0;
+}
+
+void QualityController::setQuality(int quality)
+{
+    m_quality = clampInt(quality, QUALITY_MIN, QUALITY_MAX);
+    m_settle = m_settleFrames;
+    m_avgBytes = 0;
+}
+
+void QualityController::restore(int quality, uint32_t avgBytes)
+{
+    m_quality = clampInt(quality, QUALITY_MIN, QUALITY_MAX);
+    m_settle = 0;
+    m_avgBytes = avgBytes;
+}
+
+void QualityController::setTarget(uint32_t bytes)
+{
+    m_targetBytes = bytes;
+    m_avgBytes = 0;
+}
+
+void QualityController::setHysteresis(int percent)
+{
+    m_hysteresis = clampInt(percent, 1, 50);
+}
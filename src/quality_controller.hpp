@@ -0,0 +1,66 @@
+#ifndef QUALITY_CONTROLLER_HPP
+#define QUALITY_CONTROLLER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// JPEG 품질 폐루프 제어 (프레임 크기를 target_bytes 근처로 유지)
+// - 캡처한 프레임 크기의 이동 평균이 target 의 ±hyst% 밖으로 나가면 품질 조정
+// - JPEG 크기는 대략 양자화 스케일(quality 값)에 반비례하므로 q * avg / target 으로 한 번에 이동
+//   (한 번에 MAX_STEP 까지, 진동 방지)
+// - 품질을 바꾼 직후 몇 프레임은 이전 품질로 인코딩된 프레임이므로 무시 (settle)
+// 센서/Arduino 에 의존하지 않으므로 기록해 둔 크기-품질 데이터로 호스트에서 돌려볼 수 있다.
+class QualityController
+{
+public:
+    static const int QUALITY_MIN = 6;     // 낮을수록 고품질 (너무 낮으면 프레임 버퍼 넘침)
+    static const int QUALITY_MAX = 50;
+    static const int MAX_STEP = 4;
+    static const int AVG_SHIFT = 2;       // 이동 평균 비율 1/4
+
+private:
+    int m_quality = 0;              // 현재 품질 (0 = 아직 정하지 않음, 보드 기본값 사용)
+    uint32_t m_targetBytes = 0;     // 0 = 제어 끔 (고정 품질)
+    int m_hysteresis = 15;          // 허용 범위 (%)
+    int m_settleFrames = 1;         // 품질 변경 후 버릴 프레임 수 (드라이버 프레임 버퍼 수)
+
+    int m_settle = 0;
+    uint32_t m_avgBytes = 0;        // 0 = 평균 없음
+
+    // 통계
+    uint32_t m_frames = 0;
+    uint32_t m_inBand = 0;
+    uint32_t m_adjustments = 0;
+    uint32_t m_lastBytes = 0;
+    uint32_t m_minBytes = 0;
+    uint32_t m_maxBytes = 0;
+
+public:
+    QualityController() {}
+
+    // 프레임 크기 관측, 품질을 바꿔야 하면 true (getQuality() 를 센서에 적용)
+    bool update(size_t frameBytes);
+    void resetStats();
+
+    // 설정
+    void setQuality(int quality);   // 고정 품질로 바꿀 때도 사용 (평균 초기화)
+    void restore(int quality, uint32_t avgBytes);   // deep sleep 전 상태로 복원 (settle 없음)
+    void setTarget(uint32_t bytes);
+    void setHysteresis(int percent);
+    inline void setSettleFrames(int frames) { m_settleFrames = frames < 0 ? 0 : frames; }
+
+    inline int getQuality() const { return m_quality; }
+    inline uint32_t getTarget() const { return m_targetBytes; }
+    inline int getHysteresis() const { return m_hysteresis; }
+    inline bool isEnabled() const { return m_targetBytes > 0; }
+
+    inline uint32_t getFrames() const { return m_frames; }
+    inline uint32_t getInBand() const { return m_inBand; }
+    inline uint32_t getAdjustments() const { return m_adjustments; }
+    inline uint32_t getLastBytes() const { return m_lastBytes; }
+    inline uint32_t getAvgBytes() const { return m_avgBytes; }
+    inline uint32_t getMinBytes() const { return m_minBytes; }
+    inline uint32_t getMaxBytes() const { return m_maxBytes; }
+};
+
+#endif // QUALITY_CONTROLLER_HPP
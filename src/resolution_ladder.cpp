@@ -0,0 +1,323 @@
+#include "resolution_ladder.hpp"
+
+static const framesize_t LADDER[] = {
+    FRAMESIZE_QQVGA,
+    FRAMESIZE_QCIF,
+    FRAMESIZE_HQVGA,
+    FRAMESIZE_QVGA,
+    FRAMESIZE_CIF,
+    FRAMESIZE_VGA,
+    FRAMESIZE_SVGA,
+    FRAMESIZE_XGA,
+    FRAMESIZE_SXGA,
+    FRAMESIZE_UXGA,
+};
+
+static inline uint32_t framePixels(framesize_t size)
+{
+    return (uint32_t)resolution[size].width * resolution[size].height;
+}
+
+static inline uint32_t averageOf(uint32_t avg, uint32_t value, uint8_t shift)
+{
+    return (uint32_t)((int32_t)avg + (((int32_t)value - (int32_t)avg) >> shift));
+}
+
+int ResolutionLadder::ladderIndex(framesize_t size)
+{
+    for (int i = 0; i < ladderCount(); i++)
+    {
+        if (LADDER[i] == size)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+framesize_t ResolutionLadder::ladderSize(int index)
+{
+    return LADDER[constrain(index, 0, ladderCount() - 1)];
+}
+
+int ResolutionLadder::ladderCount()
+{
+    return sizeof(LADDER) / sizeof(LADDER[0]);
+}
+
+int ResolutionLadder::ceilingIndex() const
+{
+    int ceiling = ladderIndex(m_ceiling);
+    int ring = ladderIndex(m_camera.getRingFrameSize());
+    if (ring >= 0 && ring < ceiling)
+    {
+        ceiling = ring;
+    }
+    return ceiling;
+}
+
+uint32_t ResolutionLadder::predictMs(int fromIndex, int toIndex) const
+{
+    if (m_avgBps == 0)
+    {
+        return 0;
+    }
+    uint64_t bytes = (uint64_t)m_avgBytes * framePixels(LADDER[toIndex]) / framePixels(LADDER[fromIndex]);
+    return m_avgRttMs + (uint32_t)(bytes * 1000 / m_avgBps);
+}
+
+void ResolutionLadder::resetSamples()
+{
+    m_samples = 0;
+    m_failures = 0;
+    m_avgBytes = 0;
+    m_avgBps = 0;
+    m_avgRttMs = 0;
+}
+
+void ResolutionLadder::step(int fromIndex, int toIndex, const char *reason)
+{
+    if (!m_camera.setResolution(LADDER[toIndex]))
+    {
+        Serial.printf("Adaptive resolution: %s failed\n", CameraModule::frameSizeName(LADDER[toIndex]));
+        return;
+    }
+
+    Decision &d = m_log[m_logHead];
+    d.timestamp = millis();
+    d.from = LADDER[fromIndex];
+    d.to = LADDER[toIndex];
+    d.reason = reason;
+    d.bps = m_avgBps;
+    d.rttMs = m_avgRttMs;
+    d.rssi = m_wifi.getRSSI();
+    d.predictedMs = m_lastPredictedMs;
+    m_logHead = (m_logHead + 1) % LOG_SIZE;
+    if (m_logCount < LOG_SIZE)
+    {
+        m_logCount++;
+    }
+
+    if (toIndex > fromIndex)
+    {
+        m_stepsUp++;
+    }
+    else
+    {
+        m_stepsDown++;
+    }
+
+    Serial.printf("Adaptive resolution: %s -> %s (%s, %u B/s, rtt %u ms, rssi %d)\n",
+                  CameraModule::frameSizeName(d.from), CameraModule::frameSizeName(d.to),
+                  reason, d.bps, d.rttMs, d.rssi);
+    resetSamples();
+}
+
+void ResolutionLadder::onUpload(int httpCode, const UploadTiming &timing)
+{
+    if (!m_enabled || m_intervalMs == 0 || m_camera.getTargetBytes() > 0)
+    {
+        return;
+    }
+
+    int current = ladderIndex(m_camera.getFrameSize());
+    int floor = ladderIndex(m_floor);
+    int ceiling = ceilingIndex();
+    if (current < 0 || floor < 0 || ceiling < 0)
+    {
+        return;
+    }
+
+    // 설정 범위 밖이면 측정 없이 바로 맞춤
+    if (current < floor)
+    {
+        step(current, floor, "floor");
+        return;
+    }
+    if (current > ceiling && ceiling >= floor)
+    {
+        step(current, ceiling, "ceiling");
+        return;
+    }
+
+    // 설정/WiFi 문제(-1, -2)나 서버 거부(4xx)는 링크 상태와 무관
+    if (httpCode == -1 || httpCode == -2 || (httpCode >= 400 && httpCode < 500))
+    {
+        return;
+    }
+
+    if (httpCode != 200 && httpCode != 201)
+    {
+        m_failures++;
+        if (m_failures >= FAIL_LIMIT && current > floor)
+        {
+            step(current, current - 1, "failures");
+        }
+        return;
+    }
+    m_failures = 0;
+
+    uint32_t bps = timing.throughput();
+    if (m_samples == 0)
+    {
+        m_avgBytes = timing.bytes;
+        m_avgBps = bps;
+        m_avgRttMs = timing.rttMs;
+    }
+    else
+    {
+        m_avgBytes = averageOf(m_avgBytes, timing.bytes, AVG_SHIFT);
+        m_avgBps = averageOf(m_avgBps, bps, AVG_SHIFT);
+        m_avgRttMs = averageOf(m_avgRttMs, timing.rttMs, AVG_SHIFT);
+    }
+    m_samples++;
+
+    m_lastPredictedMs = predictMs(current, current);
+    if (m_samples < MIN_SAMPLES)
+    {
+        return;
+    }
+
+    uint32_t budgetMs = (uint32_t)((uint64_t)m_intervalMs * m_headroom / 100);
+    if (m_lastPredictedMs > budgetMs && current > floor)
+    {
+        step(current, current - 1, "slow");
+    }
+    else if (current < ceiling &&
+             m_wifi.getRSSI() >= m_minRssi &&
+             predictMs(current, current + 1) <= budgetMs * UP_PERCENT / 100)
+    {
+        step(current, current + 1, "headroom");
+    }
+}
+
+void ResolutionLadder::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    resetSamples();
+}
+
+const CmdEntry<ResolutionLadder::CmdHandler> ResolutionLadder::COMMANDS[] = {
+    CMD_ENTRY("set", "set enabled/floor/ceiling/headroom/rssi <value>", &ResolutionLadder::cmdSet),
+    CMD_ENTRY("status", "status", &ResolutionLadder::cmdStatus),
+    CMD_ENTRY("log", "log", &ResolutionLadder::cmdLog),
+};
+
+void ResolutionLadder::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String ResolutionLadder::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void ResolutionLadder::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
+    {
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
+
+        if (key == "enabled" || key == "res_adaptive")
+        {
+            setEnabled(value.toInt() == 1);
+            _res_doc["result"] = "ok";
+            _res_doc["res_adaptive"] = m_enabled;
+        }
+        else if (key == "floor" || key == "res_floor" || key == "ceiling" || key == "res_ceiling")
+        {
+            framesize_t size;
+            if (!CameraModule::parseResolution(value, size))
+            {
+                _res_doc["result"] = "fail";
+                _res_doc["ms"] = "invalid resolution";
+                _res_doc["available"] = "QQVGA,QCIF,HQVGA,QVGA,CIF,VGA,SVGA,XGA,SXGA,UXGA";
+                return;
+            }
+
+            bool isFloor = (key == "floor" || key == "res_floor");
+            if (isFloor)
+            {
+                setFloor(size);
+            }
+            else
+            {
+                setCeiling(size);
+            }
+            _res_doc["result"] = "ok";
+            _res_doc[isFloor ? "res_floor" : "res_ceiling"] = CameraModule::frameSizeName(size);
+        }
+        else if (key == "headroom" || key == "res_headroom")
+        {
+            setHeadroom(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["res_headroom"] = m_headroom;
+        }
+        else if (key == "rssi" || key == "res_min_rssi")
+        {
+            setMinRssi(value.toInt());
+            _res_doc["result"] = "ok";
+            _res_doc["res_min_rssi"] = m_minRssi;
+        }
+        else
+        {
+            _res_doc["result"] = "fail";
+            _res_doc["ms"] = "unknown key (enabled/floor/ceiling/headroom/rssi)";
+        }
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void ResolutionLadder::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    int ceiling = ceilingIndex();
+
+    _res_doc["result"] = "ok";
+    _res_doc["enabled"] = m_enabled;
+    _res_doc["resolution"] = CameraModule::frameSizeName(m_camera.getFrameSize());
+    _res_doc["floor"] = CameraModule::frameSizeName(m_floor);
+    _res_doc["ceiling"] = ceiling >= 0 ? CameraModule::frameSizeName(LADDER[ceiling]) : "Unknown";
+    _res_doc["headroom"] = m_headroom;
+    _res_doc["min_rssi"] = m_minRssi;
+    _res_doc["interval_ms"] = m_intervalMs;
+    _res_doc["budget_ms"] = (uint32_t)((uint64_t)m_intervalMs * m_headroom / 100);
+    _res_doc["held"] = m_camera.getTargetBytes() > 0;   // 프레임 크기 목표가 켜져 있어 조정 안 함
+    _res_doc["samples"] = m_samples;
+    _res_doc["failures"] = m_failures;
+    _res_doc["avg_bytes"] = m_avgBytes;
+    _res_doc["avg_bps"] = m_avgBps;
+    _res_doc["avg_rtt_ms"] = m_avgRttMs;
+    _res_doc["predicted_ms"] = m_lastPredictedMs;
+    _res_doc["rssi"] = m_wifi.getRSSI();
+    _res_doc["steps_up"] = m_stepsUp;
+    _res_doc["steps_down"] = m_stepsDown;
+}
+
+void ResolutionLadder::cmdLog(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    JsonArray log = _res_doc["log"].to<JsonArray>();
+
+    // 오래된 순서
+    int start = (m_logHead - m_logCount + LOG_SIZE) % LOG_SIZE;
+    uint32_t now = millis();
+    for (int i = 0; i < m_logCount; i++)
+    {
+        const Decision &d = m_log[(start + i) % LOG_SIZE];
+        JsonObject entry = log.add<JsonObject>();
+        entry["age_ms"] = now - d.timestamp;
+        entry["from"] = CameraModule::frameSizeName(d.from);
+        entry["to"] = CameraModule::frameSizeName(d.to);
+        entry["reason"] = d.reason;
+        entry["bps"] = d.bps;
+        entry["rtt_ms"] = d.rttMs;
+        entry["rssi"] = d.rssi;
+        entry["predicted_ms"] = d.predictedMs;
+    }
+}
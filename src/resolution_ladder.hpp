@@ -0,0 +1,116 @@
+#ifndef RESOLUTION_LADDER_HPP
+#define RESOLUTION_LADDER_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "camera_module.hpp"
+#include "wifi_module.hpp"
+#include "http_upload.hpp"
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 업링크 상태에 따른 해상도 자동 조정 (스냅샷용 ABR)
+// - 업로드마다 본문 전송 속도(bytes/s), 응답 지연(RTT), RSSI 를 측정
+// - 예상 업로드 시간 = RTT + 프레임 크기 / 전송 속도
+//   (다른 단계의 프레임 크기는 픽셀 수 비율로 추정)
+// - 현재 단계의 예상 시간이 업로드 간격 x headroom% 를 넘거나 전송이 연속으로 실패하면 한 단계 내리고,
+//   한 단계 위의 예상 시간이 그 절반 이하이고 RSSI 가 충분하면 한 단계 올린다
+// - 단계를 바꾼 뒤에는 MIN_SAMPLES 번 업로드를 측정할 때까지 다시 판단하지 않는다
+// 상한은 링 버퍼 슬롯을 정한 해상도를 넘지 않는다 (보관 프레임이 슬롯에 들어가도록).
+// 프레임 크기 목표(camera target)가 켜져 있으면 크기가 해상도와 무관하므로 조정하지 않는다.
+// 파이프라인 업로드 태스크에서 호출된다.
+class ResolutionLadder
+{
+public:
+    static const int LOG_SIZE = 16;
+    static const int MIN_SAMPLES = 3;
+    static const int FAIL_LIMIT = 2;        // 연속 전송 실패 시 한 단계 내림
+    static const int UP_PERCENT = 50;       // 한 단계 위 예상 시간이 예산의 이 비율 이하일 때만 올림
+    static const uint8_t AVG_SHIFT = 2;     // 이동 평균 비율 1/4
+
+    // 결정 기록
+    struct Decision
+    {
+        uint32_t timestamp;     // millis
+        framesize_t from;
+        framesize_t to;
+        const char *reason;
+        uint32_t bps;
+        uint32_t rttMs;
+        int rssi;
+        uint32_t predictedMs;   // 결정 당시 현재 단계의 예상 업로드 시간
+    };
+
+private:
+    CameraModule &m_camera;
+    WifiModule &m_wifi;
+
+    bool m_enabled = false;
+    framesize_t m_floor = FRAMESIZE_QVGA;
+    framesize_t m_ceiling = FRAMESIZE_UXGA;
+    int m_headroom = 80;            // 업로드 간격 중 업로드에 쓸 비율 (%)
+    int m_minRssi = -75;            // 이보다 약하면 올리지 않음 (dBm)
+    uint32_t m_intervalMs = 0;      // 업로드 간격 (0 = 판단 안 함)
+
+    // 현재 단계 측정값 (단계가 바뀌면 초기화)
+    int m_samples = 0;
+    int m_failures = 0;
+    uint32_t m_avgBytes = 0;
+    uint32_t m_avgBps = 0;
+    uint32_t m_avgRttMs = 0;
+    uint32_t m_lastPredictedMs = 0;
+
+    // 통계
+    uint32_t m_stepsUp = 0;
+    uint32_t m_stepsDown = 0;
+    Decision m_log[LOG_SIZE];
+    int m_logHead = 0;
+    int m_logCount = 0;
+
+    int ceilingIndex() const;
+    uint32_t predictMs(int fromIndex, int toIndex) const;
+    void step(int fromIndex, int toIndex, const char *reason);
+    void resetSamples();
+
+public:
+    ResolutionLadder(CameraModule &camera, WifiModule &wifi) : m_camera(camera), m_wifi(wifi) {}
+    ~ResolutionLadder() {}
+
+    // 단일 프레임 업로드 결과 (배치 업로드는 넣지 않음)
+    void onUpload(int httpCode, const UploadTiming &timing);
+
+    // 설정
+    void setEnabled(bool enabled);
+    inline void setFloor(framesize_t size) { m_floor = size; }
+    inline void setCeiling(framesize_t size) { m_ceiling = size; }
+    inline void setHeadroom(int percent) { m_headroom = constrain(percent, 10, 100); }
+    inline void setMinRssi(int dbm) { m_minRssi = constrain(dbm, -100, 0); }
+    inline void setIntervalMs(uint32_t ms) { m_intervalMs = ms; }
+
+    inline bool isEnabled() const { return m_enabled; }
+    inline framesize_t getFloor() const { return m_floor; }
+    inline framesize_t getCeiling() const { return m_ceiling; }
+    inline int getHeadroom() const { return m_headroom; }
+    inline int getMinRssi() const { return m_minRssi; }
+
+    // 해상도 단계 (작은 순서, setResolutionByName 이 받는 이름과 같음)
+    static int ladderIndex(framesize_t size);
+    static framesize_t ladderSize(int index);
+    static int ladderCount();
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (ResolutionLadder::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdLog(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // RESOLUTION_LADDER_HPP
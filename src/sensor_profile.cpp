@@ -0,0 +1,103 @@
+#include "sensor_profile.hpp"
+#include <string.h>
+
+static const SensorProfile PROFILES[SensorProfile::COUNT] = {
+    //  name     bri con sat eff awb awbg wb aec aec2 ael aecv agc agcg ceil bpc wpc gma lenc hm vf dcw bar
+    { "day",     0,  0,  0,  0,  1,  1,   0, 1,  0,   0, 300, 1,  0,   0,   0,  1,  1,  1,   0, 0, 1,  0 },
+    // 어두운 장면: DSP 자동 노출, 게인 상한 16x, 노이즈가 늘어나는 만큼 블랙 픽셀 보정
+    { "night",   1,  0, -1,  0,  1,  1,   0, 1,  1,   1, 300, 1,  0,   3,   1,  1,  1,  1,   0, 0, 1,  0 },
+    // 플래시: 가까운 피사체가 날아가지 않게 노출을 낮추고 게인 상한 2x
+    { "flash",   0,  0,  0,  0,  1,  1,   0, 1,  0,  -1, 300, 1,  0,   0,   0,  1,  1,  1,   0, 0, 1,  0 },
+};
+
+typedef int (*SensorSetter)(sensor_t *s, int value);
+
+// 값이 다르면 setter 호출 (드라이버가 성공 시 s->status 를 갱신)
+static bool applyField(sensor_t *s, int current, int wanted, SensorSetter setter, int &writes)
+{
+    if (current == wanted)
+    {
+        return true;
+    }
+    if (!setter || setter(s, wanted) != 0)
+    {
+        return false;
+    }
+    writes++;
+    return true;
+}
+
+int SensorProfile::apply(sensor_t *s, const SensorProfile &profile)
+{
+    if (!s)
+    {
+        return -1;
+    }
+
+    const camera_status_t &st = s->status;
+    int writes = 0;
+    bool ok = true;
+
+    ok = ok && applyField(s, st.brightness, profile.brightness, s->set_brightness, writes);
+    ok = ok && applyField(s, st.contrast, profile.contrast, s->set_contrast, writes);
+    ok = ok && applyField(s, st.saturation, profile.saturation, s->set_saturation, writes);
+    ok = ok && applyField(s, st.special_effect, profile.specialEffect, s->set_special_effect, writes);
+
+    // 화이트밸런스 (모드를 바꾸기 전에 자동 WB 상태부터)
+    ok = ok && applyField(s, st.awb, profile.awb, s->set_whitebal, writes);
+    ok = ok && applyField(s, st.awb_gain, profile.awbGain, s->set_awb_gain, writes);
+    ok = ok && applyField(s, st.wb_mode, profile.wbMode, s->set_wb_mode, writes);
+
+    // 노출/게인 (자동이면 수동 값은 건너뜀)
+    ok = ok && applyField(s, st.aec, profile.aec, s->set_exposure_ctrl, writes);
+    ok = ok && applyField(s, st.aec2, profile.aec2, s->set_aec2, writes);
+    ok = ok && applyField(s, st.ae_level, profile.aeLevel, s->set_ae_level, writes);
+    if (!profile.aec)
+    {
+        ok = ok && applyField(s, st.aec_value, profile.aecValue, s->set_aec_value, writes);
+    }
+    ok = ok && applyField(s, st.agc, profile.agc, s->set_gain_ctrl, writes);
+    if (!profile.agc)
+    {
+        ok = ok && applyField(s, st.agc_gain, profile.agcGain, s->set_agc_gain, writes);
+    }
+    if (ok && st.gainceiling != profile.gainceiling)
+    {
+        ok = s->set_gainceiling && s->set_gainceiling(s, (gainceiling_t)profile.gainceiling) == 0;
+        writes += ok ? 1 : 0;
+    }
+
+    // 보정/방향
+    ok = ok && applyField(s, st.bpc, profile.bpc, s->set_bpc, writes);
+    ok = ok && applyField(s, st.wpc, profile.wpc, s->set_wpc, writes);
+    ok = ok && applyField(s, st.raw_gma, profile.rawGma, s->set_raw_gma, writes);
+    ok = ok && applyField(s, st.lenc, profile.lenc, s->set_lenc, writes);
+    ok = ok && applyField(s, st.hmirror, profile.hmirror, s->set_hmirror, writes);
+    ok = ok && applyField(s, st.vflip, profile.vflip, s->set_vflip, writes);
+    ok = ok && applyField(s, st.dcw, profile.dcw, s->set_dcw, writes);
+    ok = ok && applyField(s, st.colorbar, profile.colorbar, s->set_colorbar, writes);
+
+    return ok ? writes : -1;
+}
+
+const SensorProfile *SensorProfile::find(const char *name)
+{
+    for (int i = 0; i < COUNT; i++)
+    {
+        if (strcmp(PROFILES[i].name, name) == 0)
+        {
+            return &PROFILES[i];
+        }
+    }
+    return nullptr;
+}
+
+const SensorProfile &SensorProfile::defaultProfile()
+{
+    return PROFILES[0];
+}
+
+const SensorProfile &SensorProfile::at(int index)
+{
+    return PROFILES[index];
+}
@@ -0,0 +1,49 @@
+#ifndef SENSOR_PROFILE_HPP
+#define SENSOR_PROFILE_HPP
+
+#include <stdint.h>
+#include "esp_camera.h"
+
+// 센서 설정 묶음 (day / night / flash)
+// 적용할 때는 드라이버가 들고 있는 센서 상태(s->status)와 다른 항목만 set_*() 로 쓴다.
+// set_*() 하나가 SCCB 트랜잭션 하나 이상이므로 기본값과 같은 항목을 건너뛰면
+// 초기화와 프로필 전환이 빨라지고, esp_camera_deinit 없이 바로 바꿀 수 있다.
+// 자동 노출/게인이 켜져 있으면 수동 값(aec_value/agc_gain)은 센서가 덮어쓰므로 쓰지 않는다.
+// esp_camera.h 의 sensor_t 에만 의존하므로 호스트에서 가짜 센서로 쓰기 횟수를 셀 수 있다.
+struct SensorProfile
+{
+    const char *name;
+    int8_t brightness;        // -2 ~ 2
+    int8_t contrast;          // -2 ~ 2
+    int8_t saturation;        // -2 ~ 2
+    uint8_t specialEffect;    // 0 = 없음
+    uint8_t awb;              // 자동 화이트밸런스
+    uint8_t awbGain;
+    uint8_t wbMode;           // 0 = 자동
+    uint8_t aec;              // 자동 노출
+    uint8_t aec2;             // DSP 자동 노출 (야간)
+    int8_t aeLevel;           // -2 ~ 2
+    uint16_t aecValue;        // 수동 노출 (aec = 0 일 때만)
+    uint8_t agc;              // 자동 게인
+    uint8_t agcGain;          // 수동 게인 (agc = 0 일 때만)
+    uint8_t gainceiling;      // 자동 게인 상한 (0 = 2x ~ 6 = 128x)
+    uint8_t bpc;              // 블랙 픽셀 보정
+    uint8_t wpc;              // 화이트 픽셀 보정
+    uint8_t rawGma;
+    uint8_t lenc;             // 렌즈 보정
+    uint8_t hmirror;
+    uint8_t vflip;
+    uint8_t dcw;              // 다운사이즈 활성화
+    uint8_t colorbar;
+
+    static const int COUNT = 3;
+
+    // 다른 항목만 적용, 호출한 set_*() 수 (실패하면 -1)
+    static int apply(sensor_t *s, const SensorProfile &profile);
+
+    static const SensorProfile *find(const char *name);
+    static const SensorProfile &defaultProfile();
+    static const SensorProfile &at(int index);
+};
+
+#endif // SENSOR_PROFILE_HPP
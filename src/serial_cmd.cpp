@@ -0,0 +1,367 @@
+#include "serial_cmd.hpp"
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+static inline uint16_t crc16Update(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t)data << 8;
+    for (int i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+// 응답 프레임 payload 를 그대로 흘려보내며 CRC 계산 (버퍼 없음)
+class CrcPrint : public Print
+{
+private:
+    Print &m_out;
+
+public:
+    uint16_t crc = 0xFFFF;
+
+    CrcPrint(Print &out) : m_out(out) {}
+
+    size_t write(uint8_t c) override
+    {
+        crc = crc16Update(crc, c);
+        return m_out.write(c);
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = crc16Update(crc, buffer[i]);
+        }
+        return m_out.write(buffer, size);
+    }
+};
+
+bool SerialCmdReader::begin()
+{
+    if (m_queue)
+    {
+        return true;
+    }
+
+    m_queue = xQueueCreate(QUEUE_DEPTH, sizeof(Line));
+    if (!m_queue)
+    {
+        Serial.println("Serial cmd queue create failed");
+        return false;
+    }
+
+    m_line.len = 0;
+    m_line.overflow = false;
+    m_line.binary = false;
+
+#if ARDUINO_USB_CDC_ON_BOOT
+    // USB CDC 콘솔은 UART RX 이벤트가 없으므로 poll() 에서 비블로킹으로 비운다
+    m_polled = true;
+#else
+    // UART 이벤트 태스크에서 호출됨 (수신 바이트가 쌓이거나 RX 타임아웃 시)
+    Serial.onReceive([this]() { feed(); });
+#endif
+    return true;
+}
+
+void SerialCmdReader::feed()
+{
+    int avail;
+    while ((avail = Serial.available()) > 0)
+    {
+        while (avail-- > 0)
+        {
+            int ch = Serial.read();
+            if (ch < 0)
+            {
+                break;
+            }
+
+            // 요청된 모드는 줄/프레임 사이에서만 적용 (조립 중인 요청은 원래 모드로 마침)
+            Mode requested = m_requestedMode.load();
+            if (requested != m_mode && atBoundary())
+            {
+                m_mode = requested;
+                m_frameState = FRAME_IDLE;
+                m_line.len = 0;
+            }
+
+            if (m_mode == MODE_BINARY)
+            {
+                feedFrame((uint8_t)ch);
+            }
+            else
+            {
+                feedText((uint8_t)ch);
+            }
+        }
+    }
+}
+
+bool SerialCmdReader::atBoundary() const
+{
+    if (m_mode == MODE_BINARY)
+    {
+        // 중간에 끊긴 프레임은 FRAME_TIMEOUT_MS 뒤 경계로 본다
+        return m_frameState == FRAME_IDLE || millis() - m_frameStartMs > FRAME_TIMEOUT_MS;
+    }
+    return m_line.len == 0 && !m_discarding;
+}
+
+void SerialCmdReader::feedText(uint8_t ch)
+{
+    if (ch == '\n' || ch == '\r')
+    {
+        if (m_discarding)
+        {
+            // 너무 긴 줄은 끝까지 버린 뒤 오류 응답용으로 넘긴다
+            m_discarding = false;
+            m_line.len = 0;
+            m_line.overflow = true;
+            pushLine();
+        }
+        else if (m_line.len > 0)
+        {
+            pushLine();
+        }
+        return;
+    }
+
+    if (m_discarding)
+    {
+        return;
+    }
+
+    if (m_line.len >= MAXLINE - 1)
+    {
+        m_discarding = true;
+        return;
+    }
+
+    m_line.text[m_line.len++] = (char)ch;
+}
+
+void SerialCmdReader::feedFrame(uint8_t ch)
+{
+    if (m_frameState != FRAME_IDLE && millis() - m_frameStartMs > FRAME_TIMEOUT_MS)
+    {
+        // 프레임이 중간에 끊김 → 새 프레임 시작으로 다시 동기화
+        m_frameTimeouts++;
+        m_frameState = FRAME_IDLE;
+    }
+
+    switch (m_frameState)
+    {
+    case FRAME_IDLE:
+        if (ch == FRAME_START)
+        {
+            m_frameState = FRAME_LEN0;
+            m_frameStartMs = millis();
+        }
+        break;
+
+    case FRAME_LEN0:
+        m_frameLen = ch;
+        m_frameState = FRAME_LEN1;
+        break;
+
+    case FRAME_LEN1:
+        m_frameLen |= (uint16_t)ch << 8;
+        m_frameRead = 0;
+        m_frameCrc = 0xFFFF;
+        m_line.len = 0;
+        m_discarding = m_frameLen > MAXLINE - 1;
+        m_frameState = m_frameLen ? FRAME_PAYLOAD : FRAME_CRC0;
+        break;
+
+    case FRAME_PAYLOAD:
+        m_frameCrc = crc16Update(m_frameCrc, ch);
+        if (!m_discarding)
+        {
+            m_line.text[m_line.len++] = (char)ch;
+        }
+        if (++m_frameRead >= m_frameLen)
+        {
+            m_frameState = FRAME_CRC0;
+        }
+        break;
+
+    case FRAME_CRC0:
+        m_frameCrc ^= ch;
+        m_frameState = FRAME_CRC1;
+        break;
+
+    case FRAME_CRC1:
+        m_frameCrc ^= (uint16_t)ch << 8;
+        m_frameState = FRAME_IDLE;
+        if (m_frameCrc != 0)
+        {
+            m_crcErrors++;
+            m_discarding = false;
+            m_line.len = 0;
+            break;
+        }
+        m_frames++;
+        m_line.binary = true;
+        m_line.overflow = m_discarding;
+        m_discarding = false;
+        if (m_line.overflow)
+        {
+            m_line.len = 0;
+        }
+        pushLine();
+        break;
+    }
+}
+
+void SerialCmdReader::pushLine()
+{
+    m_line.text[m_line.len] = '\0';
+    m_line.receivedUs = micros();
+
+    if (m_line.overflow)
+    {
+        m_overflows++;
+    }
+
+    if (xQueueSend(m_queue, &m_line, 0) != pdTRUE)
+    {
+        // 처리 중인 명령이 밀려 있음 → 이번 줄은 버림
+        m_dropped++;
+    }
+
+    m_line.len = 0;
+    m_line.overflow = false;
+    m_line.binary = false;
+}
+
+bool SerialCmdReader::poll(Line &line)
+{
+    if (!m_queue)
+    {
+        return false;
+    }
+
+    if (m_polled)
+    {
+        feed();
+    }
+
+    if (xQueueReceive(m_queue, &line, 0) != pdTRUE)
+    {
+        return false;
+    }
+
+    m_activeBinary = line.binary;
+    return true;
+}
+
+bool SerialCmdReader::unpackRequest(const Line &line, const char *&text, size_t &len)
+{
+    const uint8_t *p = (const uint8_t *)line.text;
+    size_t size = line.len;
+    if (size < 1)
+    {
+        return false;
+    }
+
+    // fixstr / str8 / str16
+    size_t header;
+    if ((p[0] & 0xE0) == 0xA0)
+    {
+        len = p[0] & 0x1F;
+        header = 1;
+    }
+    else if (p[0] == 0xD9 && size >= 2)
+    {
+        len = p[1];
+        header = 2;
+    }
+    else if (p[0] == 0xDA && size >= 3)
+    {
+        len = ((size_t)p[1] << 8) | p[2];
+        header = 3;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (header + len > size)
+    {
+        return false;
+    }
+
+    text = line.text + header;
+    return true;
+}
+
+void SerialCmdReader::sendResponse(const JsonDocument &_res_doc)
+{
+    if (!m_activeBinary)
+    {
+        m_txTextBytes += serializeJson(_res_doc, Serial);
+        m_txTextBytes += Serial.println();
+        return;
+    }
+
+    size_t len = measureMsgPack(_res_doc);
+    uint8_t header[3] = { FRAME_START, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8) };
+    Serial.write(header, sizeof(header));
+
+    CrcPrint out(Serial);
+    serializeMsgPack(_res_doc, out);
+
+    uint8_t crc[2] = { (uint8_t)(out.crc & 0xFF), (uint8_t)(out.crc >> 8) };
+    Serial.write(crc, sizeof(crc));
+    m_txBinaryBytes += sizeof(header) + len + sizeof(crc);
+}
+
+void SerialCmdReader::complete(const Line &line, uint32_t dispatchUs)
+{
+    m_lines++;
+    m_waitStat.add(dispatchUs - line.receivedUs);
+    m_latencyStat.add(micros() - line.receivedUs);
+}
+
+void SerialCmdReader::statsToJson(JsonDocument &_res_doc) const
+{
+    _res_doc["lines"] = m_lines;
+    _res_doc["overflows"] = m_overflows;
+    _res_doc["dropped"] = m_dropped;
+    _res_doc["max_line"] = MAXLINE - 1;
+    _res_doc["mode"] = m_polled ? "poll" : "rx_event";
+    _res_doc["proto"] = getMode() == MODE_BINARY ? "bin" : "text";
+    _res_doc["frames"] = m_frames;
+    _res_doc["crc_errors"] = m_crcErrors;
+    _res_doc["frame_timeouts"] = m_frameTimeouts;
+    _res_doc["tx_text_bytes"] = m_txTextBytes;
+    _res_doc["tx_bin_bytes"] = m_txBinaryBytes;
+
+    JsonObject wait = _res_doc["wait"].to<JsonObject>();
+    wait["last_us"] = m_waitStat.lastUs;
+    wait["avg_us"] = m_waitStat.avgUs();
+    wait["max_us"] = m_waitStat.maxUs;
+
+    JsonObject latency = _res_doc["latency"].to<JsonObject>();
+    latency["count"] = m_latencyStat.count;
+    latency["last_us"] = m_latencyStat.lastUs;
+    latency["avg_us"] = m_latencyStat.avgUs();
+    latency["max_us"] = m_latencyStat.maxUs;
+}
+
+void SerialCmdReader::resetStats()
+{
+    m_lines = 0;
+    m_overflows = 0;
+    m_dropped = 0;
+    m_frames = 0;
+    m_crcErrors = 0;
+    m_frameTimeouts = 0;
+    m_txTextBytes = 0;
+    m_txBinaryBytes = 0;
+    m_waitStat.reset();
+    m_latencyStat.reset();
+}
@@ -0,0 +1,141 @@
+#ifndef SERIAL_CMD_HPP
+#define SERIAL_CMD_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <atomic>
+
+#include "tonkey.hpp"
+
+// 시리얼 명령 라인 수신기
+// - UART RX 이벤트(onReceive)에서 바이트를 받아 고정 버퍼에 한 줄씩 조립
+// - 완성된 줄은 큐로 넘기고 스케줄러 태스크는 큐를 비블로킹으로 확인만 한다
+//   (readStringUntil 처럼 줄 끝을 기다리며 g_ts 를 막지 않음)
+// - MAXLINE 을 넘는 줄은 줄 끝까지 버리고 "line too long" 으로 응답
+// - 수신(줄 끝) → 응답 출력까지의 지연을 기록 (stats cmd)
+//
+// 바이너리 모드 (proto bin): 요청/응답을 프레임 단위로 주고받는다
+//   [0x7E][len u16 LE][payload][crc16 u16 LE]  (CRC-16/CCITT-FALSE, payload 만 대상)
+//   요청 payload: 명령 라인 MessagePack str
+//   응답 payload: _res_doc 을 MessagePack 으로 직렬화 (JSON 텍스트와 같은 핸들러 결과)
+// 모드 전환: 명령 태스크는 요청 모드만 기록하고 (전환 명령의 응답을 쓰기 전),
+//   수신 측이 줄/프레임 경계에서 받아 적용한다. 조립 상태는 수신 측만 건드린다.
+class SerialCmdReader
+{
+public:
+    static const int QUEUE_DEPTH = 4;
+    static const uint8_t FRAME_START = 0x7E;
+    static const uint32_t FRAME_TIMEOUT_MS = 500;   // 프레임 중간에 멈추면 버림
+
+    enum Mode
+    {
+        MODE_TEXT,
+        MODE_BINARY
+    };
+
+    struct Line
+    {
+        char text[MAXLINE];    // 텍스트 줄 또는 프레임 payload
+        uint16_t len;
+        bool overflow;
+        bool binary;
+        uint32_t receivedUs;   // 줄 끝 수신 시각 (micros)
+    };
+
+    // 수신 → 응답 지연 통계 (us)
+    struct LatencyStat
+    {
+        uint32_t count = 0;
+        uint32_t lastUs = 0;
+        uint32_t maxUs = 0;
+        uint64_t totalUs = 0;
+
+        inline void add(uint32_t us)
+        {
+            count++;
+            lastUs = us;
+            totalUs += us;
+            if (us > maxUs)
+            {
+                maxUs = us;
+            }
+        }
+
+        inline uint32_t avgUs() const { return count ? (uint32_t)(totalUs / count) : 0; }
+        inline void reset() { count = 0; lastUs = 0; maxUs = 0; totalUs = 0; }
+    };
+
+private:
+    enum FrameState
+    {
+        FRAME_IDLE,
+        FRAME_LEN0,
+        FRAME_LEN1,
+        FRAME_PAYLOAD,
+        FRAME_CRC0,
+        FRAME_CRC1
+    };
+
+    QueueHandle_t m_queue = nullptr;
+    bool m_polled = false;
+    std::atomic<Mode> m_requestedMode{MODE_TEXT};   // 명령 태스크가 기록, 수신 측이 적용
+    bool m_activeBinary = false;   // 처리 중인 요청의 인코딩
+
+    // 조립 중인 줄/프레임 (수신 콜백 컨텍스트에서만 접근)
+    Mode m_mode = MODE_TEXT;
+    Line m_line;
+    bool m_discarding = false;
+    FrameState m_frameState = FRAME_IDLE;
+    uint16_t m_frameLen = 0;
+    uint16_t m_frameRead = 0;
+    uint16_t m_frameCrc = 0;
+    uint32_t m_frameStartMs = 0;
+
+    // 통계
+    uint32_t m_lines = 0;
+    uint32_t m_overflows = 0;
+    uint32_t m_dropped = 0;
+    uint32_t m_frames = 0;
+    uint32_t m_crcErrors = 0;
+    uint32_t m_frameTimeouts = 0;
+    uint32_t m_txTextBytes = 0;
+    uint32_t m_txBinaryBytes = 0;
+    LatencyStat m_waitStat;      // 수신 → 디스패치 시작
+    LatencyStat m_latencyStat;   // 수신 → 응답 출력 완료
+
+    void feed();
+    bool atBoundary() const;
+    void feedText(uint8_t ch);
+    void feedFrame(uint8_t ch);
+    void pushLine();
+
+public:
+    SerialCmdReader() {}
+    ~SerialCmdReader() {}
+
+    // Serial.begin() 이후 호출
+    bool begin();
+
+    // 완성된 줄 하나를 꺼낸다 (없으면 즉시 false)
+    bool poll(Line &line);
+
+    // 바이너리 요청 payload(MessagePack str)에서 명령 라인을 꺼낸다
+    static bool unpackRequest(const Line &line, const char *&text, size_t &len);
+
+    // 처리 중인 요청과 같은 인코딩(JSON 텍스트/프레임)으로 응답 출력
+    void sendResponse(const JsonDocument &_res_doc);
+
+    // 응답 출력 후 호출 (지연 통계)
+    void complete(const Line &line, uint32_t dispatchUs);
+
+    // 응답을 쓰기 전에 호출 → 응답을 받은 상대가 바로 보내는 다음 요청부터 새 모드로 받는다
+    inline void setMode(Mode mode) { m_requestedMode.store(mode); }
+    inline Mode getMode() const { return m_requestedMode.load(); }
+
+    void statsToJson(JsonDocument &_res_doc) const;
+    void resetStats();
+};
+
+#endif // SERIAL_CMD_HPP
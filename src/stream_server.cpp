@@ -0,0 +1,590 @@
+#include "stream_server.hpp"
+#include <lwip/sockets.h>
+#include <fcntl.h>
+#include <errno.h>
+
+bool StreamServer::start(uint16_t port)
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+    if (m_task)
+    {
+        // 이전 태스크가 아직 m_clients/m_frames 를 쓰고 있음
+        Serial.println("Stream: previous task still stopping");
+        return false;
+    }
+
+    if (!m_camera.isInitialized())
+    {
+        Serial.println("Stream: camera not initialized");
+        return false;
+    }
+
+    m_port = port;
+    m_running = true;
+    if (xTaskCreatePinnedToCore(taskEntry, "stream", TASK_STACK_SIZE, this, 1, &m_task, TASK_CORE) != pdPASS)
+    {
+        m_running = false;
+        m_task = nullptr;
+        Serial.println("Stream task create failed");
+        return false;
+    }
+
+    Serial.printf("Stream server started on port %d\n", m_port);
+    return true;
+}
+
+void StreamServer::stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    // 태스크가 클라이언트/프레임을 정리하고 종료를 알릴 때까지 대기
+    // (스트림 루프는 블로킹 호출이 없으므로 길어야 한 바퀴)
+    m_stopWaiter = xTaskGetCurrentTaskHandle();
+    m_running = false;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    m_stopWaiter = nullptr;
+    Serial.println("Stream server stopped");
+}
+
+int StreamServer::getClientCount() const
+{
+    Status status = readStatus();
+    int count = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (status.clients[i].active || status.clients[i].pending)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// 스트림 태스크에서만 호출: 잠금 밖에서 복사본을 만든 뒤 잠금 안에서는 memcpy 만
+void StreamServer::publishStatus()
+{
+    Status status;
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        const Client &c = m_clients[i];
+        ClientStatus &out = status.clients[i];
+        out.active = c.active;
+        out.pending = c.pending;
+        snprintf(out.ip, sizeof(out.ip), "%s", c.ip.c_str());
+        out.sent = c.sent;
+        out.skipped = c.skipped;
+        out.intervalMs = c.intervalMs;
+    }
+    status.framesGrabbed = m_framesGrabbed;
+    status.clientsServed = m_clientsServed;
+    status.clientsRejected = m_clientsRejected;
+
+    portENTER_CRITICAL(&m_statusLock);
+    memcpy(&m_status, &status, sizeof(status));
+    portEXIT_CRITICAL(&m_statusLock);
+}
+
+StreamServer::Status StreamServer::readStatus() const
+{
+    Status status;
+    portENTER_CRITICAL(&m_statusLock);
+    memcpy(&status, &m_status, sizeof(status));
+    portEXIT_CRITICAL(&m_statusLock);
+    return status;
+}
+
+void StreamServer::taskEntry(void *arg)
+{
+    StreamServer *self = static_cast<StreamServer *>(arg);
+    self->run();
+
+    // run() 은 m_running 이 꺼진 뒤에만 끝나므로 stop() 이 이미 대기 중
+    TaskHandle_t waiter = self->m_stopWaiter;
+    self->m_task = nullptr;
+    if (waiter)
+    {
+        xTaskNotifyGive(waiter);
+    }
+    vTaskDelete(NULL);
+}
+
+void StreamServer::run()
+{
+    m_server.begin(m_port);
+    m_server.setNoDelay(true);
+
+    while (m_running)
+    {
+        uint32_t now = millis();
+        acceptClients(now);
+
+        bool wantFrame = false;
+        int newest = newestFrame();
+
+        // 대기 중인 클라이언트: 아직 안 보낸 최신 프레임이 있으면 붙이고, 없으면 새 프레임 요청
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            Client &c = m_clients[i];
+            if (!c.active || c.frame >= 0 || now - c.lastSendMs < c.intervalMs)
+            {
+                continue;
+            }
+            if (newest >= 0 && m_frames[newest].id > c.lastFrameId)
+            {
+                attach(c, newest);
+            }
+            else
+            {
+                wantFrame = true;
+            }
+        }
+
+        if (wantFrame)
+        {
+            int index = grabFrame();
+            if (index >= 0)
+            {
+                for (int i = 0; i < MAX_CLIENTS; i++)
+                {
+                    Client &c = m_clients[i];
+                    if (!c.active)
+                    {
+                        continue;
+                    }
+                    if (c.frame >= 0)
+                    {
+                        // 이전 프레임을 아직 보내는 중 → 이번 프레임은 건너뜀
+                        c.skipped++;
+                    }
+                    else if (now - c.lastSendMs >= c.intervalMs)
+                    {
+                        attach(c, index);
+                    }
+                }
+            }
+        }
+
+        bool progress = false;
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            if (m_clients[i].active && m_clients[i].frame >= 0)
+            {
+                progress |= pump(m_clients[i], now);
+            }
+        }
+
+        releaseUnused();
+        publishStatus();
+
+        if (!progress)
+        {
+            vTaskDelay(1);
+        }
+    }
+
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (m_clients[i].active)
+        {
+            dropClient(m_clients[i]);
+        }
+        else if (m_clients[i].pending)
+        {
+            m_clients[i].conn.stop();
+            m_clients[i].pending = false;
+        }
+    }
+    releaseUnused();
+    publishStatus();
+    m_server.end();
+}
+
+void StreamServer::acceptClients(uint32_t now)
+{
+    WiFiClient conn = m_server.available();
+    if (conn)
+    {
+        // 게시본이 아니라 실제 표로 셈 (이번 루프에서 바뀐 슬롯 포함)
+        int slot = -1;
+        int used = 0;
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            if (m_clients[i].active || m_clients[i].pending)
+            {
+                used++;
+            }
+            else if (slot < 0)
+            {
+                slot = i;
+            }
+        }
+        if (used >= m_maxClients)
+        {
+            slot = -1;
+        }
+
+        if (slot < 0)
+        {
+            const char *busy = "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n";
+            conn.write((const uint8_t *)busy, strlen(busy));
+            conn.stop();
+            m_clientsRejected++;
+        }
+        else
+        {
+            // 요청 라인부터 논블로킹 소켓으로 읽는다 (루프마다 도착한 만큼만)
+            int flags = fcntl(conn.fd(), F_GETFL, 0);
+            fcntl(conn.fd(), F_SETFL, flags | O_NONBLOCK);
+
+            Client &c = m_clients[slot];
+            c.conn = conn;
+            c.pending = true;
+            c.requestLen = 0;
+            c.acceptMs = now;
+        }
+    }
+
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (m_clients[i].pending)
+        {
+            readRequest(m_clients[i], now);
+        }
+    }
+}
+
+void StreamServer::readRequest(Client &c, uint32_t now)
+{
+    // 요청 라인에서 fps 파라미터만 확인 (GET /stream?fps=5 HTTP/1.1)
+    bool done = false;
+    while (!done && c.conn.available() > 0)
+    {
+        int ch = c.conn.read();
+        if (ch < 0)
+        {
+            break;
+        }
+        if (ch == '\n' || c.requestLen >= REQUEST_MAX)
+        {
+            done = true;
+            break;
+        }
+        c.request[c.requestLen++] = (char)ch;
+    }
+
+    if (!done && !c.conn.connected())
+    {
+        c.conn.stop();
+        c.pending = false;
+        return;
+    }
+
+    // 요청 라인이 늦으면 기본 설정으로 시작 (이전과 같은 1초)
+    if (done || now - c.acceptMs > REQUEST_TIMEOUT_MS)
+    {
+        beginStream(c);
+    }
+}
+
+void StreamServer::beginStream(Client &c)
+{
+    c.request[c.requestLen] = '\0';
+    uint32_t intervalMs = 0;
+    const char *fpsParam = strstr(c.request, "fps=");
+    if (fpsParam)
+    {
+        int fps = atoi(fpsParam + 4);
+        if (fps > 0)
+        {
+            intervalMs = 1000 / fps;
+        }
+    }
+    while (c.conn.available() > 0)
+    {
+        c.conn.read();
+    }
+
+    // 헤더는 새 소켓의 송신 버퍼에 한 번에 들어간다
+    const char *header =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Connection: close\r\n\r\n";
+    size_t headerLen = strlen(header);
+    c.pending = false;
+    if (send(c.conn.fd(), header, headerLen, MSG_DONTWAIT) != (int)headerLen)
+    {
+        c.conn.stop();
+        return;
+    }
+
+    c.active = true;
+    c.frame = -1;
+    c.offset = 0;
+    c.lastFrameId = 0;
+    c.lastSendMs = 0;
+    c.intervalMs = intervalMs;
+    c.sent = 0;
+    c.skipped = 0;
+    c.ip = c.conn.remoteIP().toString();
+    m_clientsServed++;
+
+    Serial.printf("Stream client connected: %s\n", c.ip.c_str());
+}
+
+void StreamServer::attach(Client &c, int frameIndex)
+{
+    HeldFrame &f = m_frames[frameIndex];
+    f.refs++;
+    c.frame = frameIndex;
+    c.offset = 0;
+    c.frameStartMs = millis();
+    c.headerLen = snprintf(c.header, sizeof(c.header),
+                           "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n",
+                           (unsigned)f.fb->len);
+}
+
+void StreamServer::detach(Client &c)
+{
+    if (c.frame >= 0)
+    {
+        m_frames[c.frame].refs--;
+        c.frame = -1;
+    }
+}
+
+void StreamServer::dropClient(Client &c)
+{
+    detach(c);
+    c.conn.stop();
+    c.active = false;
+    Serial.printf("Stream client disconnected: %s\n", c.ip.c_str());
+}
+
+bool StreamServer::pump(Client &c, uint32_t now)
+{
+    const HeldFrame &f = m_frames[c.frame];
+    size_t total = c.headerLen + f.fb->len + 2;
+    bool progress = false;
+
+    while (c.offset < total)
+    {
+        const uint8_t *ptr;
+        size_t remain;
+        if (c.offset < c.headerLen)
+        {
+            ptr = (const uint8_t *)c.header + c.offset;
+            remain = c.headerLen - c.offset;
+        }
+        else if (c.offset < c.headerLen + f.fb->len)
+        {
+            ptr = f.fb->buf + (c.offset - c.headerLen);
+            remain = f.fb->len - (c.offset - c.headerLen);
+        }
+        else
+        {
+            ptr = (const uint8_t *)"\r\n" + (c.offset - c.headerLen - f.fb->len);
+            remain = total - c.offset;
+        }
+        if (remain > SEND_CHUNK)
+        {
+            remain = SEND_CHUNK;
+        }
+
+        // PSRAM 프레임 버퍼에서 바로 전송 (lwIP 가 pbuf 로 복사)
+        int n = send(c.conn.fd(), ptr, remain, MSG_DONTWAIT);
+        if (n > 0)
+        {
+            c.offset += n;
+            progress = true;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        dropClient(c);
+        return progress;
+    }
+
+    if (c.offset >= total)
+    {
+        c.lastFrameId = f.id;
+        c.lastSendMs = now;
+        c.sent++;
+        detach(c);
+    }
+    else if (now - c.frameStartMs > STALL_TIMEOUT_MS)
+    {
+        // 프레임 하나를 너무 오래 잡고 있으면 캡처가 막히므로 끊는다
+        dropClient(c);
+    }
+    return progress;
+}
+
+int StreamServer::grabFrame()
+{
+    int limit = m_camera.getFrameBufferCount();
+    if (limit > MAX_CLIENTS)
+    {
+        limit = MAX_CLIENTS;
+    }
+    if (heldCount() >= limit)
+    {
+        // 모든 프레임 버퍼를 느린 클라이언트가 잡고 있음
+        return -1;
+    }
+
+    // 업로드 파이프라인 캡처 몫으로 드라이버 버퍼 하나는 남긴다
+    // (파이프라인/콘솔이 잡은 버퍼도 함께 세므로 esp_camera_fb_get() 이 막히지 않음)
+    int reserve = m_camera.getFrameBufferCount() > 1 ? 1 : 0;
+    if (m_camera.getFreeFrameBuffers() <= reserve)
+    {
+        return -1;
+    }
+
+    camera_fb_t *fb = m_camera.grab();
+    if (!fb)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (!m_frames[i].fb)
+        {
+            m_frames[i].fb = fb;
+            m_frames[i].id = ++m_frameId;
+            m_frames[i].refs = 0;
+            m_framesGrabbed++;
+            return i;
+        }
+    }
+
+    m_camera.returnFrame(fb);
+    return -1;
+}
+
+int StreamServer::newestFrame() const
+{
+    int newest = -1;
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (m_frames[i].fb && (newest < 0 || m_frames[i].id > m_frames[newest].id))
+        {
+            newest = i;
+        }
+    }
+    return newest;
+}
+
+int StreamServer::heldCount() const
+{
+    int count = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (m_frames[i].fb)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void StreamServer::releaseUnused()
+{
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (m_frames[i].fb && m_frames[i].refs <= 0)
+        {
+            m_camera.returnFrame(m_frames[i].fb);
+            m_frames[i].fb = nullptr;
+            m_frames[i].refs = 0;
+        }
+    }
+}
+
+const CmdEntry<StreamServer::CmdHandler> StreamServer::COMMANDS[] = {
+    CMD_ENTRY("start", "start [port]", &StreamServer::cmdStart),
+    CMD_ENTRY("stop", "stop", &StreamServer::cmdStop),
+    CMD_ENTRY("clients", "clients <n>", &StreamServer::cmdClients),
+    CMD_ENTRY("status", "status", &StreamServer::cmdStatus),
+};
+
+void StreamServer::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String StreamServer::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void StreamServer::cmdStart(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    uint16_t port = (tokens.size() > 2) ? tokens[2].toInt() : m_port;
+    if (start(port))
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = "stream started";
+        _res_doc["url"] = "http://" + WiFi.localIP().toString() + ":" + String(m_port) + "/stream";
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "stream start failed";
+    }
+}
+
+void StreamServer::cmdStop(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    stop();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "stream stopped";
+}
+
+void StreamServer::cmdClients(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 2)
+    {
+        setMaxClients(tokens[2].toInt());
+    }
+    _res_doc["result"] = "ok";
+    _res_doc["max_clients"] = m_maxClients;
+}
+
+void StreamServer::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["running"] = isRunning();
+    _res_doc["port"] = m_port;
+    _res_doc["max_clients"] = m_maxClients;
+    Status status = readStatus();
+    _res_doc["frames"] = status.framesGrabbed;
+    _res_doc["served"] = status.clientsServed;
+    _res_doc["rejected"] = status.clientsRejected;
+
+    JsonArray clients = _res_doc["clients"].to<JsonArray>();
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        const ClientStatus &c = status.clients[i];
+        if (!c.active)
+        {
+            continue;
+        }
+        JsonObject client = clients.add<JsonObject>();
+        client["ip"] = c.ip;
+        client["sent"] = c.sent;
+        client["skipped"] = c.skipped;
+        client["fps_limit"] = c.intervalMs ? 1000 / c.intervalMs : 0;
+    }
+}
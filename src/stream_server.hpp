@@ -0,0 +1,143 @@
+#ifndef STREAM_SERVER_HPP
+#define STREAM_SERVER_HPP
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "camera_module.hpp"
+
+// MJPEG(multipart/x-mixed-replace) 스트리밍 서버
+// - 카메라 프레임 버퍼를 복사하지 않고 모든 클라이언트가 공유 (참조 카운트)
+// - 클라이언트마다 논블로킹 전송 + 프레임 스킵: 느린 클라이언트는 전송 중인
+//   프레임을 끝낼 때까지 새 프레임을 건너뛰고, 끝나면 가장 최신 프레임을 받는다
+// - ?fps=N 으로 클라이언트별 최대 프레임 속도 지정
+// - 요청 라인도 논블로킹으로 조금씩 읽어 접속 중인 클라이언트가 다른 클라이언트 전송을 막지 않음
+// - 드라이버 버퍼 하나는 업로드 파이프라인 캡처 몫으로 남긴다 (fb_count 가 1 이면 제외)
+// - m_clients 는 스트림 태스크만 만지고, 다른 태스크는 루프마다 게시하는 m_status 복사본을 읽는다
+class StreamServer
+{
+public:
+    static const int MAX_CLIENTS = 4;
+    static const uint16_t DEFAULT_PORT = 81;
+    static const uint32_t STALL_TIMEOUT_MS = 5000;   // 한 프레임 전송 제한 시간
+    static const uint32_t REQUEST_TIMEOUT_MS = 1000; // 요청 라인 대기 (지나면 기본 설정으로 전송 시작)
+    static const size_t REQUEST_MAX = 128;           // 요청 라인에서 보는 최대 길이
+    static const size_t SEND_CHUNK = 8192;
+    static const uint32_t TASK_STACK_SIZE = 6144;
+    static const BaseType_t TASK_CORE = 0;
+
+private:
+    struct HeldFrame
+    {
+        camera_fb_t *fb = nullptr;
+        uint32_t id = 0;
+        int refs = 0;
+    };
+
+    struct Client
+    {
+        WiFiClient conn;
+        bool active = false;
+        bool pending = false;      // 접속 후 요청 라인 수신 중 (슬롯은 차지)
+        char request[REQUEST_MAX + 1];
+        size_t requestLen = 0;
+        uint32_t acceptMs = 0;
+        int frame = -1;            // 전송 중인 m_frames 인덱스 (-1 = 대기)
+        size_t offset = 0;         // 파트 헤더 + JPEG + CRLF 기준 전송 위치
+        char header[96];
+        size_t headerLen = 0;
+        uint32_t lastFrameId = 0;
+        uint32_t frameStartMs = 0;
+        uint32_t lastSendMs = 0;
+        uint32_t intervalMs = 0;   // 최소 프레임 간격 (fps 제한)
+        uint32_t sent = 0;
+        uint32_t skipped = 0;
+        String ip;
+    };
+
+    // 커맨드 태스크에 보여 줄 클라이언트 상태 (String/소켓 없이 값만)
+    struct ClientStatus
+    {
+        bool active = false;
+        bool pending = false;
+        char ip[16] = "";
+        uint32_t sent = 0;
+        uint32_t skipped = 0;
+        uint32_t intervalMs = 0;
+    };
+
+    struct Status
+    {
+        ClientStatus clients[MAX_CLIENTS];
+        uint32_t framesGrabbed = 0;
+        uint32_t clientsServed = 0;
+        uint32_t clientsRejected = 0;
+    };
+
+    CameraModule &m_camera;
+    WiFiServer m_server;
+    uint16_t m_port = DEFAULT_PORT;
+    int m_maxClients = 2;
+    volatile bool m_running = false;
+    TaskHandle_t m_task = nullptr;                  // 스트림 태스크가 끝날 때 스스로 비움
+    TaskHandle_t volatile m_stopWaiter = nullptr;   // stop() 을 호출한 태스크 (종료 알림 대상)
+
+    HeldFrame m_frames[MAX_CLIENTS];
+    Client m_clients[MAX_CLIENTS];
+    uint32_t m_frameId = 0;
+    uint32_t m_framesGrabbed = 0;
+    uint32_t m_clientsServed = 0;
+    uint32_t m_clientsRejected = 0;
+
+    Status m_status;                                // 스트림 태스크가 게시, m_statusLock 으로 보호
+    mutable portMUX_TYPE m_statusLock = portMUX_INITIALIZER_UNLOCKED;
+
+    static void taskEntry(void *arg);
+    void run();
+    void acceptClients(uint32_t now);
+    void readRequest(Client &c, uint32_t now);
+    void beginStream(Client &c);
+    void attach(Client &c, int frameIndex);
+    void detach(Client &c);
+    void dropClient(Client &c);
+    bool pump(Client &c, uint32_t now);
+    int grabFrame();
+    int newestFrame() const;
+    int heldCount() const;
+    void releaseUnused();
+    void publishStatus();
+    Status readStatus() const;
+
+public:
+    StreamServer(CameraModule &camera) : m_camera(camera) {}
+    ~StreamServer() {}
+
+    // 이전 스트림 태스크가 아직 끝나지 않았으면 실패
+    bool start(uint16_t port);
+    // 스트림 태스크가 클라이언트/프레임을 모두 정리하고 끝날 때까지 대기
+    void stop();
+    inline bool isRunning() const { return m_running; }
+    inline void setMaxClients(int n) { m_maxClients = constrain(n, 1, MAX_CLIENTS); }
+    inline int getMaxClients() const { return m_maxClients; }
+    int getClientCount() const;   // 마지막으로 게시된 상태 기준
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (StreamServer::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdStart(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStop(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdClients(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // STREAM_SERVER_HPP
@@ -0,0 +1,525 @@
+#include "upload_pipeline.hpp"
+#include <WiFi.h>
+
+bool UploadPipeline::begin()
+{
+    if (m_queue)
+    {
+        return true;
+    }
+
+    // 동시에 잡고 있을 수 있는 프레임 수 = 카메라 프레임 버퍼 수
+    m_queueDepth = m_camera.getFrameBufferCount();
+    if (m_queueDepth < 1)
+    {
+        m_queueDepth = 1;
+    }
+
+    m_queue = xQueueCreate(m_queueDepth, sizeof(Frame));
+    if (!m_queue)
+    {
+        Serial.println("Pipeline queue create failed");
+        return false;
+    }
+
+    xTaskCreatePinnedToCore(captureTaskEntry, "cap", CAPTURE_STACK_SIZE, this, 2, &m_captureTask, CAPTURE_CORE);
+    xTaskCreatePinnedToCore(uploadTaskEntry, "upl", UPLOAD_STACK_SIZE, this, 1, &m_uploadTask, UPLOAD_CORE);
+
+    if (!m_captureTask || !m_uploadTask)
+    {
+        Serial.println("Pipeline task create failed");
+        return false;
+    }
+
+    Serial.printf("Pipeline started (queue depth: %d)\n", m_queueDepth);
+    return true;
+}
+
+bool UploadPipeline::trigger(bool useFlash)
+{
+    if (!m_captureTask)
+    {
+        return false;
+    }
+
+    m_triggered++;
+
+    // 프레임 버퍼가 모두 사용 중이면 esp_camera_fb_get()이 막히므로 이번 틱은 건너뜀
+    // (링 버퍼가 있으면 캡처용 버퍼 하나는 항상 비워 둔다)
+    // 스트림 서버나 콘솔이 잡고 있는 버퍼도 카메라의 빌려 간 프레임 수로 함께 센다
+    if (m_inFlight.load() >= m_queueDepth || m_camera.getFreeFrameBuffers() <= 0)
+    {
+        m_dropped++;
+        return false;
+    }
+
+    m_useFlash = useFlash;
+    xTaskNotifyGive(m_captureTask);
+    return true;
+}
+
+int UploadPipeline::getQueueDepth() const
+{
+    return m_queue ? (int)uxQueueMessagesWaiting(m_queue) : 0;
+}
+
+void UploadPipeline::resetStats()
+{
+    m_triggered = 0;
+    m_captured = 0;
+    m_captureFailed = 0;
+    m_dropped = 0;
+    m_uploaded = 0;
+    m_uploadFailed = 0;
+    m_stored = 0;
+    m_drained = 0;
+    m_spooled = 0;
+    m_batches = 0;
+    m_motionSkipped = 0;
+    m_dedupSkipped = 0;
+    m_maxQueueDepth = 0;
+    m_captureStat.reset();
+    m_queueStat.reset();
+    m_uploadStat.reset();
+}
+
+void UploadPipeline::captureTaskEntry(void *arg)
+{
+    static_cast<UploadPipeline *>(arg)->captureLoop();
+}
+
+void UploadPipeline::uploadTaskEntry(void *arg)
+{
+    static_cast<UploadPipeline *>(arg)->uploadLoop();
+}
+
+bool UploadPipeline::isLinkUp() const
+{
+    return WiFi.status() == WL_CONNECTED;
+}
+
+bool UploadPipeline::canQueueLive() const
+{
+    // 링 버퍼가 있으면 캡처 태스크가 프레임을 받아 복사할 수 있도록 버퍼 하나를 남긴다
+    // (다른 태스크가 잡고 있는 버퍼 때문에 남은 것이 없으면 큐에 넣지 않고 복사 후 반환)
+    if (m_camera.hasFrameRing())
+    {
+        return m_inFlight.load() < m_queueDepth - 1 && m_camera.getFreeFrameBuffers() > 0;
+    }
+    return m_inFlight.load() < m_queueDepth;
+}
+
+bool UploadPipeline::isBatching() const
+{
+    return m_camera.hasFrameRing() && m_uploader.getBatchSize() > 1;
+}
+
+bool UploadPipeline::isBatchReady()
+{
+    int count = m_camera.getStoredCount();
+    if (count == 0)
+    {
+        return false;
+    }
+    if (count >= m_uploader.getBatchSize())
+    {
+        return true;
+    }
+    return millis() - m_camera.getOldestStoredTimestamp() >= (uint32_t)m_uploader.getBatchMaxAge() * 1000;
+}
+
+bool UploadPipeline::hasBacklog() const
+{
+    return m_camera.getStoredCount() > 0 || m_spool.hasPending();
+}
+
+void UploadPipeline::storeFrame(camera_fb_t *fb, uint32_t capturedAt)
+{
+    // 스풀에 밀린 프레임이 있거나 링 버퍼가 가득 차면 덮어쓰지 않고 스풀 뒤에 붙인다
+    // (링 버퍼 → 스풀 순서가 곧 캡처 순서)
+    if (m_spool.isEnabled() && (m_spool.hasPending() || m_camera.isRingFull()))
+    {
+        if (m_spool.append(fb->buf, fb->len, capturedAt))
+        {
+            m_spooled++;
+            return;
+        }
+    }
+
+    if (m_camera.storeFrame(fb->buf, fb->len, capturedAt))
+    {
+        m_stored++;
+    }
+    else if (m_spool.append(fb->buf, fb->len, capturedAt))
+    {
+        // 링 버퍼가 없거나 슬롯보다 큰 프레임
+        m_spooled++;
+    }
+    else
+    {
+        m_dropped++;
+    }
+}
+
+bool UploadPipeline::filterFrame(camera_fb_t *fb)
+{
+    if (!m_motion.isEnabled() && !m_dedup.isEnabled())
+    {
+        return true;
+    }
+
+    // 두 필터가 같은 썸네일을 쓴다 (실패하면 각 필터가 통과시킴)
+    m_thumb.decode(fb);
+
+    if (m_motion.isEnabled() && !m_motion.check())
+    {
+        m_motionSkipped++;
+        return false;
+    }
+
+    if (m_dedup.isEnabled() && !m_dedup.check())
+    {
+        m_dedupSkipped++;
+        return false;
+    }
+
+    return true;
+}
+
+void UploadPipeline::captureLoop()
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool useFlash = m_useFlash.load();
+        if (useFlash)
+        {
+            m_camera.flashOn();
+            vTaskDelay(pdMS_TO_TICKS(100));
+        }
+
+        uint32_t startMs = millis();
+        camera_fb_t *fb = m_camera.grab();
+
+        if (useFlash)
+        {
+            m_camera.flashOff();
+        }
+
+        if (!fb)
+        {
+            m_captureFailed++;
+            Serial.println("Auto capture failed");
+            continue;
+        }
+
+        uint32_t capturedAt = millis();
+        m_captureStat.add(capturedAt - startMs);
+        m_captured++;
+
+        // 변화 없는 장면/중복 프레임은 업로드/보관하지 않음
+        if (!filterFrame(fb))
+        {
+            m_camera.returnFrame(fb);
+            continue;
+        }
+
+        // 링크가 살아 있고 밀린 프레임이 없으면 바로 업로드 큐로 (복사 없음)
+        // 그렇지 않거나 배치 모드이면 순서 유지를 위해 링 버퍼(또는 스풀) 뒤에 붙인다
+        bool live = !isBatching() && isLinkUp() && !hasBacklog() && canQueueLive();
+        if (live)
+        {
+            Frame frame = { fb, capturedAt };
+            m_inFlight++;
+            if (xQueueSend(m_queue, &frame, 0) == pdTRUE)
+            {
+                uint32_t depth = uxQueueMessagesWaiting(m_queue);
+                if (depth > m_maxQueueDepth)
+                {
+                    m_maxQueueDepth = depth;
+                }
+                continue;
+            }
+            m_inFlight--;
+        }
+
+        storeFrame(fb, capturedAt);
+        m_camera.returnFrame(fb);
+    }
+}
+
+void UploadPipeline::uploadLive(Frame &frame)
+{
+    m_queueStat.add(millis() - frame.capturedAt);
+
+    uint32_t startMs = millis();
+    String response;
+    int httpCode = m_uploader.uploadImage(frame.fb->buf, frame.fb->len, response);
+    m_uploadStat.add(millis() - startMs);
+    m_ladder.onUpload(httpCode, m_uploader.getLastTiming());
+
+    if (httpCode == 200 || httpCode == 201)
+    {
+        m_uploaded++;
+        Serial.println("Auto upload success");
+    }
+    else
+    {
+        m_uploadFailed++;
+        Serial.printf("Auto upload failed: %d\n", httpCode);
+        // 나중에 재전송하도록 보관
+        storeFrame(frame.fb, frame.capturedAt);
+    }
+
+    m_camera.returnFrame(frame.fb);
+    m_inFlight--;
+}
+
+bool UploadPipeline::drainStored()
+{
+    if (!isLinkUp())
+    {
+        return false;
+    }
+
+    StoredFrame stored;
+    if (!m_camera.peekStoredFrame(stored))
+    {
+        return true;
+    }
+
+    uint32_t startMs = millis();
+    String response;
+    int httpCode = m_uploader.uploadImage(stored.data, stored.len, response, "", startMs - stored.timestamp);
+    m_uploadStat.add(millis() - startMs);
+    m_ladder.onUpload(httpCode, m_uploader.getLastTiming());
+
+    if (httpCode == 200 || httpCode == 201)
+    {
+        m_camera.popStoredFrame();
+        m_uploaded++;
+        m_drained++;
+        Serial.printf("Stored frame uploaded (%d left)\n", m_camera.getStoredCount());
+        return true;
+    }
+
+    m_uploadFailed++;
+    if (httpCode >= 400 && httpCode < 500)
+    {
+        // 서버가 거부한 프레임은 다시 보내도 소용없으므로 버림
+        m_camera.popStoredFrame();
+        Serial.printf("Stored frame rejected: %d\n", httpCode);
+        return true;
+    }
+
+    m_camera.releaseStoredFrame();
+    Serial.printf("Stored frame upload failed: %d\n", httpCode);
+    return false;
+}
+
+bool UploadPipeline::drainBatch()
+{
+    if (!isLinkUp())
+    {
+        return false;
+    }
+
+    StoredFrame stored[HttpUploader::MAX_BATCH_SIZE];
+    int count = m_camera.peekStoredFrames(stored, m_uploader.getBatchSize());
+    if (count == 0)
+    {
+        return true;
+    }
+
+    UploadFrame frames[HttpUploader::MAX_BATCH_SIZE];
+    for (int i = 0; i < count; i++)
+    {
+        frames[i].data = stored[i].data;
+        frames[i].len = stored[i].len;
+        frames[i].timestamp = stored[i].timestamp;
+    }
+
+    uint32_t startMs = millis();
+    String response;
+    int httpCode = m_uploader.uploadBatch(frames, count, response);
+    m_uploadStat.add(millis() - startMs);
+
+    if (httpCode == 200 || httpCode == 201)
+    {
+        m_camera.popStoredFrame();
+        m_uploaded += count;
+        m_drained += count;
+        m_batches++;
+        Serial.printf("Batch uploaded: %d frames (%d left)\n", count, m_camera.getStoredCount());
+        return true;
+    }
+
+    m_uploadFailed++;
+    if (httpCode >= 400 && httpCode < 500)
+    {
+        m_camera.popStoredFrame();
+        Serial.printf("Batch rejected: %d\n", httpCode);
+        return true;
+    }
+
+    m_camera.releaseStoredFrame();
+    Serial.printf("Batch upload failed: %d\n", httpCode);
+    return false;
+}
+
+bool UploadPipeline::drainSpool()
+{
+    if (!isLinkUp())
+    {
+        return false;
+    }
+
+    SpoolRecord record;
+    if (!m_spool.peek(record))
+    {
+        return true;
+    }
+
+    // 플래시에서 조각씩 읽어 바로 전송 (PSRAM 복사 없음)
+    UploadReader reader = [this, &record](uint8_t *dst, size_t offset, size_t maxLen) -> size_t
+    {
+        return m_spool.read(record, offset, dst, maxLen);
+    };
+
+    // 이전 부팅에 기록한 프레임은 millis 기준이 달라 나이를 알 수 없음
+    uint32_t startMs = millis();
+    uint32_t ageMs = record.sameBoot ? startMs - record.timestamp : 0;
+    String response;
+    int httpCode = m_uploader.uploadImageStream(reader, record.len, response, "", ageMs);
+    m_uploadStat.add(millis() - startMs);
+    m_ladder.onUpload(httpCode, m_uploader.getLastTiming());
+
+    if (httpCode == 200 || httpCode == 201)
+    {
+        m_spool.pop(record);
+        m_uploaded++;
+        m_drained++;
+        Serial.printf("Spooled frame uploaded (%u left)\n", (unsigned)m_spool.getPendingCount());
+        return true;
+    }
+
+    m_uploadFailed++;
+    if (httpCode >= 400 && httpCode < 500)
+    {
+        m_spool.pop(record);
+        Serial.printf("Spooled frame rejected: %d\n", httpCode);
+        return true;
+    }
+
+    m_spool.release();
+    Serial.printf("Spooled frame upload failed: %d\n", httpCode);
+    return false;
+}
+
+void UploadPipeline::uploadLoop()
+{
+    bool backoff = false;
+
+    for (;;)
+    {
+        // 새 프레임이 우선, 큐가 비면 링 버퍼 백로그를 오래된 순서대로 전송
+        TickType_t wait = pdMS_TO_TICKS(IDLE_POLL_MS);
+        if (m_spool.takeReplayRequest())
+        {
+            backoff = false;
+        }
+        if (hasBacklog())
+        {
+            if (backoff)
+            {
+                wait = pdMS_TO_TICKS(RETRY_DELAY_MS);
+            }
+            else if (!isBatching() || isBatchReady() || m_camera.getStoredCount() == 0)
+            {
+                wait = 0;
+            }
+        }
+
+        Frame frame;
+        if (xQueueReceive(m_queue, &frame, wait) == pdTRUE)
+        {
+            uploadLive(frame);
+            continue;
+        }
+
+        if (m_camera.getStoredCount() == 0)
+        {
+            // 링 버퍼를 다 비운 뒤 스풀 (배치 모드에서도 한 장씩)
+            backoff = !drainSpool();
+        }
+        else if (isBatching())
+        {
+            if (isBatchReady())
+            {
+                backoff = !drainBatch();
+            }
+        }
+        else
+        {
+            backoff = !drainStored();
+        }
+    }
+}
+
+static void stageStatToJson(const PipelineStageStat &stat, JsonObject obj)
+{
+    obj["count"] = stat.count;
+    obj["last_ms"] = stat.lastMs;
+    obj["avg_ms"] = stat.avgMs();
+    obj["max_ms"] = stat.maxMs;
+}
+
+const CmdEntry<UploadPipeline::CmdHandler> UploadPipeline::COMMANDS[] = {
+    CMD_ENTRY("status", "status", &UploadPipeline::cmdStatus),
+    CMD_ENTRY("reset", "reset", &UploadPipeline::cmdReset),
+};
+
+void UploadPipeline::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
+
+String UploadPipeline::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void UploadPipeline::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["running"] = isRunning();
+    _res_doc["queue_depth"] = getQueueDepth();
+    _res_doc["queue_max"] = m_maxQueueDepth.load();
+    _res_doc["queue_size"] = m_queueDepth;
+    _res_doc["in_flight"] = getInFlight();
+    _res_doc["triggered"] = m_triggered.load();
+    _res_doc["captured"] = m_captured.load();
+    _res_doc["capture_failed"] = m_captureFailed.load();
+    _res_doc["dropped"] = m_dropped.load();
+    _res_doc["uploaded"] = m_uploaded.load();
+    _res_doc["upload_failed"] = m_uploadFailed.load();
+    _res_doc["stored"] = m_stored.load();
+    _res_doc["drained"] = m_drained.load();
+    _res_doc["spooled"] = m_spooled.load();
+    _res_doc["batches"] = m_batches.load();
+    _res_doc["motion_skipped"] = m_motionSkipped.load();
+    _res_doc["dedup_skipped"] = m_dedupSkipped.load();
+    _res_doc["backlog"] = m_camera.getStoredCount();
+    _res_doc["spool_backlog"] = m_spool.getPendingCount();
+    stageStatToJson(m_captureStat, _res_doc["capture"].to<JsonObject>());
+    stageStatToJson(m_queueStat, _res_doc["queue_wait"].to<JsonObject>());
+    stageStatToJson(m_uploadStat, _res_doc["upload"].to<JsonObject>());
+}
+
+void UploadPipeline::cmdReset(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    resetStats();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "pipeline stats reset";
+}
@@ -0,0 +1,163 @@
+#ifndef UPLOAD_PIPELINE_HPP
+#define UPLOAD_PIPELINE_HPP
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+#include "camera_module.hpp"
+#include "http_upload.hpp"
+#include "luma_thumb.hpp"
+#include "motion_detector.hpp"
+#include "dup_filter.hpp"
+#include "resolution_ladder.hpp"
+#include "frame_spool.hpp"
+
+// 파이프라인 단계별 소요 시간 통계 (ms)
+struct PipelineStageStat
+{
+    uint32_t count = 0;
+    uint32_t lastMs = 0;
+    uint32_t maxMs = 0;
+    uint64_t totalMs = 0;
+
+    inline void add(uint32_t ms)
+    {
+        count++;
+        lastMs = ms;
+        totalMs += ms;
+        if (ms > maxMs)
+        {
+            maxMs = ms;
+        }
+    }
+
+    inline uint32_t avgMs() const { return count ? (uint32_t)(totalMs / count) : 0; }
+    inline void reset() { count = 0; lastMs = 0; maxMs = 0; totalMs = 0; }
+};
+
+// 캡처 → 업로드 생산자/소비자 파이프라인
+// - 캡처 태스크(APP CPU)가 프레임을 큐에 넣고
+// - 업로드 태스크(PRO CPU, WiFi 스택과 같은 코어)가 큐를 비운다
+// 큐에는 camera_fb_t 포인터만 들어가므로 복사는 없고,
+// 동시에 잡고 있는 프레임 수는 카메라 fb_count 를 넘지 않는다.
+// 업링크가 끊겼거나 업로드가 실패하면 프레임을 카메라의 PSRAM 링 버퍼에
+// 보관했다가 링크가 복구되면 오래된 순서대로 다시 보낸다.
+// 링 버퍼가 가득 차면 그 뒤 프레임은 플래시 스풀(FrameSpool)에 이어 쓰고,
+// 링 버퍼 → 스풀 순서로 비운 뒤에야 다시 바로 업로드한다.
+// 배치 모드(batch_size > 1)에서는 모든 프레임을 링 버퍼에 모았다가
+// batch_size 개가 차거나 가장 오래된 프레임이 batch_max_age 를 넘으면 한 번에 보낸다.
+// 움직임 감지/중복 프레임 필터가 켜져 있으면 캡처한 프레임의 1/8 썸네일을 한 번 디코드해
+// 변화가 없거나 직전 업로드와 거의 같은 프레임은 바로 버린다.
+// 단일 프레임 업로드 결과는 해상도 자동 조정(ResolutionLadder)에 넘긴다.
+class UploadPipeline
+{
+private:
+    struct Frame
+    {
+        camera_fb_t *fb;
+        uint32_t capturedAt;  // millis()
+    };
+
+    CameraModule &m_camera;
+    HttpUploader &m_uploader;
+    LumaThumbnail &m_thumb;
+    MotionDetector &m_motion;
+    DuplicateFilter &m_dedup;
+    ResolutionLadder &m_ladder;
+    FrameSpool &m_spool;
+
+    QueueHandle_t m_queue = nullptr;
+    TaskHandle_t m_captureTask = nullptr;
+    TaskHandle_t m_uploadTask = nullptr;
+    int m_queueDepth = 0;
+
+    std::atomic<bool> m_useFlash{false};  // trigger() → 캡처 태스크
+    std::atomic<int> m_inFlight{0};   // 큐 대기 + 업로드 중인 프레임 수
+
+    // 통계 (스케줄러/캡처/업로드 태스크가 함께 올리고 콘솔이 읽음)
+    std::atomic<uint32_t> m_triggered{0};
+    std::atomic<uint32_t> m_captured{0};
+    std::atomic<uint32_t> m_captureFailed{0};
+    std::atomic<uint32_t> m_dropped{0};
+    std::atomic<uint32_t> m_uploaded{0};
+    std::atomic<uint32_t> m_uploadFailed{0};
+    std::atomic<uint32_t> m_stored{0};
+    std::atomic<uint32_t> m_drained{0};
+    std::atomic<uint32_t> m_spooled{0};
+    std::atomic<uint32_t> m_batches{0};
+    std::atomic<uint32_t> m_motionSkipped{0};
+    std::atomic<uint32_t> m_dedupSkipped{0};
+    std::atomic<uint32_t> m_maxQueueDepth{0};
+    PipelineStageStat m_captureStat;
+    PipelineStageStat m_queueStat;
+    PipelineStageStat m_uploadStat;
+
+    static void captureTaskEntry(void *arg);
+    static void uploadTaskEntry(void *arg);
+    void captureLoop();
+    void uploadLoop();
+    void uploadLive(Frame &frame);
+    bool drainStored();
+    bool drainBatch();
+    bool drainSpool();
+    bool hasBacklog() const;
+    bool isBatching() const;
+    bool isBatchReady();
+    void storeFrame(camera_fb_t *fb, uint32_t capturedAt);
+    bool filterFrame(camera_fb_t *fb);
+    bool isLinkUp() const;
+    bool canQueueLive() const;
+
+public:
+    static const BaseType_t CAPTURE_CORE = 1;
+    static const BaseType_t UPLOAD_CORE = 0;
+    static const uint32_t CAPTURE_STACK_SIZE = 4096;
+    static const uint32_t UPLOAD_STACK_SIZE = 8192;
+    static const uint32_t IDLE_POLL_MS = 1000;     // 링 버퍼 확인 주기
+    static const uint32_t RETRY_DELAY_MS = 5000;   // 재전송 실패 후 대기
+
+    UploadPipeline(CameraModule &camera, HttpUploader &uploader, LumaThumbnail &thumb,
+                   MotionDetector &motion, DuplicateFilter &dedup, ResolutionLadder &ladder, FrameSpool &spool)
+        : m_camera(camera), m_uploader(uploader), m_thumb(thumb), m_motion(motion), m_dedup(dedup), m_ladder(ladder),
+          m_spool(spool) {}
+    ~UploadPipeline() {}
+
+    // 카메라 초기화 이후 호출 (큐/태스크 생성)
+    bool begin();
+    inline bool isRunning() const { return m_queue != nullptr; }
+
+    // 캡처 요청 (스케줄러 태스크에서 호출, 블로킹 없음)
+    bool trigger(bool useFlash);
+
+    // 상태
+    int getQueueDepth() const;
+    inline int getInFlight() const { return m_inFlight.load(); }
+    inline uint32_t getTriggered() const { return m_triggered.load(); }
+    inline uint32_t getCaptured() const { return m_captured.load(); }
+    inline uint32_t getDropped() const { return m_dropped.load(); }
+    inline uint32_t getUploaded() const { return m_uploaded.load(); }
+    inline uint32_t getUploadFailed() const { return m_uploadFailed.load(); }
+    inline uint32_t getStored() const { return m_stored.load(); }
+    inline uint32_t getDrained() const { return m_drained.load(); }
+    inline uint32_t getSpooled() const { return m_spooled.load(); }
+    void resetStats();
+
+    // 커맨드 파싱
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (UploadPipeline::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdReset(const tonkey &tokens, JsonDocument &_res_doc);
+};
+
+#endif // UPLOAD_PIPELINE_HPP
@@ -0,0 +1,128 @@
+#include "wake_cycle.hpp"
+
+void WakeCycle::reset()
+{
+    m_state = STATE_DONE;
+    m_spoolPending = false;
+    m_uploaded = false;
+    for (int i = 0; i < MARK_COUNT; i++)
+    {
+        m_marks[i] = NOT_REACHED;
+    }
+}
+
+void WakeCycle::begin(uint32_t nowMs, uint32_t intervalMs, uint32_t budgetMs)
+{
+    reset();
+    m_wakeMs = nowMs;
+    m_intervalMs = intervalMs;
+    m_budgetMs = budgetMs;
+    m_state = STATE_INIT;
+}
+
+void WakeCycle::mark(Mark mark, uint32_t nowMs)
+{
+    if (m_marks[mark] == NOT_REACHED)
+    {
+        m_marks[mark] = nowMs - m_wakeMs;
+    }
+}
+
+WakeCycle::Action WakeCycle::step(uint32_t nowMs, bool cameraReady, bool cameraFailed, bool linkUp)
+{
+    uint32_t elapsed = nowMs - m_wakeMs;
+    if (cameraReady)
+    {
+        mark(MARK_CAMERA, nowMs);
+    }
+    if (linkUp)
+    {
+        mark(MARK_LINK, nowMs);
+    }
+
+    switch (m_state)
+    {
+    case STATE_INIT:
+        if (cameraReady)
+        {
+            m_state = STATE_CAPTURE;
+            return ACTION_CAPTURE;
+        }
+        if (cameraFailed || elapsed >= m_budgetMs)
+        {
+            m_state = STATE_DONE;
+        }
+        return ACTION_NONE;
+
+    case STATE_WAIT_LINK:
+        if (linkUp)
+        {
+            m_state = STATE_UPLOAD;
+            return ACTION_UPLOAD;
+        }
+        if (elapsed >= m_budgetMs)
+        {
+            // 링크를 기다리다 시간 초과: 다음에 보내도록 보관
+            m_spoolPending = true;
+            m_state = STATE_DONE;
+        }
+        return ACTION_NONE;
+
+    case STATE_CAPTURE:
+    case STATE_UPLOAD:
+        return ACTION_NONE;
+
+    case STATE_DONE:
+        if (m_spoolPending)
+        {
+            m_spoolPending = false;
+            return ACTION_SPOOL;
+        }
+        mark(MARK_SLEEP, nowMs);
+        return ACTION_SLEEP;
+    }
+    return ACTION_NONE;
+}
+
+void WakeCycle::onCaptured(uint32_t nowMs, bool ok)
+{
+    if (ok)
+    {
+        mark(MARK_CAPTURE, nowMs);
+    }
+    m_state = ok ? STATE_WAIT_LINK : STATE_DONE;
+}
+
+void WakeCycle::onUploaded(uint32_t nowMs, bool ok)
+{
+    if (ok)
+    {
+        mark(MARK_UPLOAD, nowMs);
+    }
+    m_uploaded = ok;
+    m_spoolPending = !ok;
+    m_state = STATE_DONE;
+}
+
+uint32_t WakeCycle::sleepMs(uint32_t nowMs) const
+{
+    uint32_t awake = nowMs - m_wakeMs;
+    if (awake + MIN_SLEEP_MS >= m_intervalMs)
+    {
+        return MIN_SLEEP_MS;
+    }
+    return m_intervalMs - awake;
+}
+
+const char *WakeCycle::markName(Mark mark)
+{
+    switch (mark)
+    {
+    case MARK_CAMERA: return "camera";
+    case MARK_LINK: return "link";
+    case MARK_CAPTURE: return "capture";
+    case MARK_UPLOAD: return "upload";
+    case MARK_SLEEP: return "sleep";
+    default: return "unknown";
+    }
+}
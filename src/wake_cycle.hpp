@@ -0,0 +1,78 @@
+#ifndef WAKE_CYCLE_HPP
+#define WAKE_CYCLE_HPP
+
+#include <stdint.h>
+
+// deep sleep 한 주기(깨어남 → 캡처 → 업로드 → 잠듦)의 진행 순서
+// - 카메라 초기화와 WiFi 접속은 동시에 진행되고, 카메라가 먼저 준비되면 링크를 기다리지 않고 캡처
+// - 깨어 있는 시간이 budget 을 넘도록 링크가 없거나 업로드가 실패하면 스풀에 넣고 잠든다
+// - 잠드는 시간은 주기(interval)에서 깨어 있던 시간을 뺀 값
+// 각 단계에 도달한 시각(깨어난 뒤 ms)을 타임라인으로 남긴다.
+// 시각과 입력을 호출자가 넘기므로 Arduino 없이 호스트에서 가상 시간으로 돌려볼 수 있다.
+class WakeCycle
+{
+public:
+    enum State
+    {
+        STATE_INIT,         // 카메라 준비 대기
+        STATE_CAPTURE,      // 캡처 중
+        STATE_WAIT_LINK,    // 캡처 완료, 링크 대기
+        STATE_UPLOAD,       // 업로드 중
+        STATE_DONE          // 잠들 준비
+    };
+
+    enum Action
+    {
+        ACTION_NONE,
+        ACTION_CAPTURE,
+        ACTION_UPLOAD,
+        ACTION_SPOOL,       // 캡처한 프레임을 스풀에 보관
+        ACTION_SLEEP
+    };
+
+    enum Mark
+    {
+        MARK_CAMERA,        // 카메라 준비
+        MARK_LINK,          // WiFi 연결
+        MARK_CAPTURE,       // 캡처 완료
+        MARK_UPLOAD,        // 업로드 성공
+        MARK_SLEEP,         // 잠들기 시작
+        MARK_COUNT
+    };
+
+    static const uint32_t NOT_REACHED = 0xFFFFFFFF;
+    static const uint32_t MIN_SLEEP_MS = 1000;
+
+private:
+    State m_state = STATE_DONE;
+    uint32_t m_wakeMs = 0;
+    uint32_t m_intervalMs = 60000;
+    uint32_t m_budgetMs = 15000;        // 최대 깨어 있는 시간
+    bool m_spoolPending = false;
+    bool m_uploaded = false;
+    uint32_t m_marks[MARK_COUNT];
+
+    void mark(Mark mark, uint32_t nowMs);
+
+public:
+    WakeCycle() { reset(); }
+
+    // 깨어난 시각(nowMs)부터 한 주기 시작
+    void begin(uint32_t nowMs, uint32_t intervalMs, uint32_t budgetMs);
+    void reset();
+
+    // 주기적으로 호출, 호출자가 수행할 동작을 돌려준다
+    Action step(uint32_t nowMs, bool cameraReady, bool cameraFailed, bool linkUp);
+    void onCaptured(uint32_t nowMs, bool ok);
+    void onUploaded(uint32_t nowMs, bool ok);
+
+    // 다음 깨어날 때까지 잘 시간
+    uint32_t sleepMs(uint32_t nowMs) const;
+
+    inline State getState() const { return m_state; }
+    inline bool isUploaded() const { return m_uploaded; }
+    inline uint32_t getMark(Mark mark) const { return m_marks[mark]; }
+    static const char *markName(Mark mark);
+};
+
+#endif // WAKE_CYCLE_HPP
@@ -1,38 +1,355 @@
 #include "wifi_module.hpp"
+#include <nvs.h>
+#include <esp_rom_crc.h>
 
-bool WifiModule::connect()
+// deep sleep 에서 깨어날 때는 NVS 를 읽지 않고 RTC 메모리의 캐시를 쓴다
+static RTC_DATA_ATTR WifiJoinCache s_rtcCache;
+
+static const char *CACHE_NVS_NAMESPACE = "wifi";
+static const char *CACHE_NVS_KEY = "join";
+
+uint32_t WifiModule::cacheCrc(const WifiJoinCache &cache)
 {
-    if (m_ssid.length() == 0)
+    return esp_rom_crc32_le(0, (const uint8_t *)&cache, offsetof(WifiJoinCache, crc));
+}
+
+IPAddress WifiModule::parseAddress(const String &text)
+{
+    IPAddress address;
+    if (text.length() == 0 || text == "0" || text == "none" || !address.fromString(text))
     {
-        Serial.println("SSID not set");
-        return false;
+        return IPAddress();
     }
+    return address;
+}
 
-    Serial.printf("Connecting to WiFi: %s\n", m_ssid.c_str());
-    
+bool WifiModule::setStaticIp(const String &ip, const String &gateway, const String &subnet, const String &dns)
+{
+    m_staticIp = parseAddress(ip);
+    m_staticGateway = parseAddress(gateway);
+    m_staticSubnet = parseAddress(subnet);
+    m_staticDns = parseAddress(dns);
+    return ip.length() == 0 || ip == "0" || ip == "none" || (uint32_t)m_staticIp != 0;
+}
+
+// ===========================================
+// 접속 캐시
+// ===========================================
+void WifiModule::loadCache()
+{
+    m_cacheLoaded = true;
+    if (s_rtcCache.magic == MAGIC && s_rtcCache.crc == cacheCrc(s_rtcCache))
+    {
+        m_cache = s_rtcCache;
+        return;
+    }
+
+    memset(&m_cache, 0, sizeof(m_cache));
+    nvs_handle_t handle;
+    if (nvs_open(CACHE_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK)
+    {
+        size_t len = sizeof(m_cache);
+        if (nvs_get_blob(handle, CACHE_NVS_KEY, &m_cache, &len) != ESP_OK || len != sizeof(m_cache))
+        {
+            memset(&m_cache, 0, sizeof(m_cache));
+        }
+        nvs_close(handle);
+    }
+    s_rtcCache = m_cache;
+}
+
+bool WifiModule::hasCache()
+{
+    if (!m_cacheLoaded)
+    {
+        loadCache();
+    }
+    uint32_t ssidCrc = esp_rom_crc32_le(0, (const uint8_t *)m_ssid.c_str(), m_ssid.length());
+    return m_cache.magic == MAGIC && m_cache.crc == cacheCrc(m_cache) &&
+           m_cache.ssidCrc == ssidCrc && m_cache.channel > 0;
+}
+
+void WifiModule::saveCache()
+{
+    WifiJoinCache cache;
+    memset(&cache, 0, sizeof(cache));
+    cache.magic = MAGIC;
+    cache.ssidCrc = esp_rom_crc32_le(0, (const uint8_t *)m_ssid.c_str(), m_ssid.length());
+    const uint8_t *bssid = WiFi.BSSID();
+    if (bssid)
+    {
+        memcpy(cache.bssid, bssid, sizeof(cache.bssid));
+    }
+    cache.channel = (uint8_t)WiFi.channel();
+    cache.ip = (uint32_t)WiFi.localIP();
+    cache.gateway = (uint32_t)WiFi.gatewayIP();
+    cache.subnet = (uint32_t)WiFi.subnetMask();
+    cache.dns = (uint32_t)WiFi.dnsIP();
+    cache.crc = cacheCrc(cache);
+
+    s_rtcCache = cache;
+    // 같은 AP/임대면 플래시에 다시 쓰지 않음
+    if (m_cacheLoaded && memcmp(&cache, &m_cache, sizeof(cache)) == 0)
+    {
+        return;
+    }
+    m_cache = cache;
+    m_cacheLoaded = true;
+
+    nvs_handle_t handle;
+    if (nvs_open(CACHE_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK)
+    {
+        nvs_set_blob(handle, CACHE_NVS_KEY, &cache, sizeof(cache));
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+void WifiModule::forgetCache()
+{
+    memset(&m_cache, 0, sizeof(m_cache));
+    m_cacheLoaded = true;
+    s_rtcCache = m_cache;
+
+    nvs_handle_t handle;
+    if (nvs_open(CACHE_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK)
+    {
+        nvs_erase_key(handle, CACHE_NVS_KEY);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+// ===========================================
+// 접속
+// ===========================================
+void WifiModule::registerEvents()
+{
+    if (m_eventsRegistered)
+    {
+        return;
+    }
+    m_eventsRegistered = true;
+
+    // 이벤트 태스크에서는 시각만 기록하고 상태 전이는 tick() 에서
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info)
+    {
+        m_assocUs = micros();
+    }, ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info)
+    {
+        m_gotIpUs = micros();
+    }, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info)
+    {
+        m_disconnectReason = info.wifi_sta_disconnected.reason;
+    }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+void WifiModule::applyIpConfig(bool fast)
+{
+    if (hasStaticIp())
+    {
+        IPAddress subnet = (uint32_t)m_staticSubnet ? m_staticSubnet : IPAddress(255, 255, 255, 0);
+        IPAddress dns = (uint32_t)m_staticDns ? m_staticDns : m_staticGateway;
+        WiFi.config(m_staticIp, m_staticGateway, subnet, dns);
+    }
+    else if (fast && m_reuseLease && m_cache.ip != 0 && m_cache.gateway != 0)
+    {
+        WiFi.config(IPAddress(m_cache.ip), IPAddress(m_cache.gateway), IPAddress(m_cache.subnet), IPAddress(m_cache.dns));
+    }
+    else
+    {
+        // DHCP
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+}
+
+// ===========================================
+// 상태 머신
+// ===========================================
+const char *WifiModule::stateName(State state)
+{
+    switch (state)
+    {
+    case STATE_IDLE: return "idle";
+    case STATE_FAST_JOIN: return "fast_join";
+    case STATE_SCAN_JOIN: return "scan_join";
+    case STATE_CONNECTED: return "connected";
+    case STATE_BACKOFF: return "backoff";
+    }
+    return "unknown";
+}
+
+void WifiModule::startJoin()
+{
+    registerEvents();
+    m_timing = WifiJoinTiming();
+    m_joinStartUs = micros();
+
+    // 접속 정보를 매번 플래시에 쓰지 않고, 재접속은 코어가 아니라 상태 머신이 맡는다
+    WiFi.persistent(false);
     WiFi.mode(WIFI_STA);
-    WiFi.begin(m_ssid.c_str(), m_password.c_str());
+    WiFi.setAutoReconnect(false);
+    m_timing.radioMs = (micros() - m_joinStartUs) / 1000;
+
+    m_fastTried = m_fastJoin && hasCache();
+    beginJoin(m_fastTried ? STATE_FAST_JOIN : STATE_SCAN_JOIN);
+}
+
+void WifiModule::beginJoin(State state)
+{
+    bool fast = state == STATE_FAST_JOIN;
+    m_timing.method = fast ? "fast" : (m_fastTried ? "fallback" : "scan");
+    applyIpConfig(fast);
+
+    m_assocUs = 0;
+    m_gotIpUs = 0;
+    m_phaseStartUs = micros();
+    m_state = state;
+    if (fast)
+    {
+        // 캐시한 BSSID/채널로 스캔 없이 바로 연결
+        WiFi.begin(m_ssid.c_str(), m_password.c_str(), m_cache.channel, m_cache.bssid);
+    }
+    else
+    {
+        WiFi.begin(m_ssid.c_str(), m_password.c_str());
+    }
+}
+
+void WifiModule::onJoined()
+{
+    uint32_t doneUs = m_gotIpUs ? m_gotIpUs : micros();
+    uint32_t assocUs = m_assocUs ? m_assocUs : doneUs;
+    m_timing.assocMs = (assocUs - m_phaseStartUs) / 1000;
+    m_timing.dhcpMs = (doneUs - assocUs) / 1000;
+    if (m_state == STATE_FAST_JOIN)
+    {
+        m_timing.fastMs = (doneUs - m_phaseStartUs) / 1000;
+        m_fastJoins++;
+    }
+    m_timing.totalMs = (doneUs - m_joinStartUs) / 1000;
+    m_lastJoin = m_timing;
+
+    saveCache();
+    m_joins++;
+    m_attempt = 0;
+    m_backoffMs = 0;
+    m_state = STATE_CONNECTED;
+    Serial.printf("WiFi connected (%s, %u ms), IP: %s\n", m_lastJoin.method, (unsigned)m_lastJoin.totalMs,
+                  WiFi.localIP().toString().c_str());
+}
+
+void WifiModule::onJoinTimeout()
+{
+    WiFi.disconnect();
+
+    if (m_state == STATE_FAST_JOIN)
+    {
+        // AP 가 바뀌었거나 채널이 달라짐: 바로 전체 스캔
+        m_timing.fastMs = (micros() - m_phaseStartUs) / 1000;
+        m_fastFailures++;
+        Serial.println("Fast join failed, scanning");
+        beginJoin(STATE_SCAN_JOIN);
+        return;
+    }
+
+    m_timing.totalMs = (micros() - m_joinStartUs) / 1000;
+    m_lastJoin = m_timing;
+    m_failures++;
+    if (m_fastTried)
+    {
+        forgetCache();
+    }
+    Serial.println("WiFi connection timeout");
+    scheduleRetry();
+}
+
+void WifiModule::scheduleRetry()
+{
+    // 1s, 2s, 4s ... 60s, 지터 ±50% (AP 재부팅 후 같은 현장의 카메라가 동시에 몰리지 않도록)
+    int shift = m_attempt < 6 ? m_attempt : 6;
+    uint32_t base = BACKOFF_MIN_MS << shift;
+    if (base > BACKOFF_MAX_MS)
+    {
+        base = BACKOFF_MAX_MS;
+    }
+    m_backoffMs = base / 2 + esp_random() % (base + 1);
+    m_retryAtMs = millis() + m_backoffMs;
+    m_attempt++;
+    m_state = STATE_BACKOFF;
+    Serial.printf("WiFi retry in %u ms (attempt %d)\n", (unsigned)m_backoffMs, m_attempt);
+}
+
+void WifiModule::tick()
+{
+    switch (m_state)
+    {
+    case STATE_IDLE:
+        break;
 
-    unsigned long startTime = millis();
-    while (WiFi.status() != WL_CONNECTED)
+    case STATE_FAST_JOIN:
+    case STATE_SCAN_JOIN:
     {
-        if (millis() - startTime > m_connectTimeout)
+        if (WiFi.status() == WL_CONNECTED)
+        {
+            onJoined();
+            break;
+        }
+        uint32_t timeoutMs = m_state == STATE_FAST_JOIN ? FAST_JOIN_TIMEOUT_MS : m_connectTimeout;
+        if (micros() - m_phaseStartUs > timeoutMs * 1000)
+        {
+            onJoinTimeout();
+        }
+        break;
+    }
+
+    case STATE_CONNECTED:
+        if (WiFi.status() != WL_CONNECTED)
+        {
+            // 끊기면 한 번은 바로 다시 붙어 보고, 실패하면 백오프
+            m_linkLost++;
+            Serial.printf("WiFi link lost (reason %d), rejoining\n", m_disconnectReason);
+            startJoin();
+        }
+        break;
+
+    case STATE_BACKOFF:
+        if ((int32_t)(millis() - m_retryAtMs) >= 0)
         {
-            Serial.println("WiFi connection timeout");
-            return false;
+            startJoin();
         }
-        delay(500);
-        Serial.print(".");
+        break;
+    }
+}
+
+bool WifiModule::connect()
+{
+    if (m_ssid.length() == 0)
+    {
+        Serial.println("SSID not set");
+        return false;
+    }
+
+    if ((m_state == STATE_CONNECTED && isConnected()) || isConnecting())
+    {
+        return true;
     }
 
-    Serial.println();
-    Serial.printf("WiFi connected, IP: %s\n", WiFi.localIP().toString().c_str());
-    m_connected = true;
+    Serial.printf("Connecting to WiFi: %s\n", m_ssid.c_str());
+    m_attempt = 0;
+    startJoin();
     return true;
 }
 
 bool WifiModule::connect(const String& ssid, const String& password)
 {
+    // 다른 AP 로 바꾸면 현재 연결은 끊고 새로 접속
+    if (ssid != m_ssid || password != m_password)
+    {
+        m_state = STATE_IDLE;
+    }
     m_ssid = ssid;
     m_password = password;
     return connect();
@@ -40,134 +357,214 @@ bool WifiModule::connect(const String& ssid, const String& password)
 
 void WifiModule::disconnect()
 {
+    m_state = STATE_IDLE;
     WiFi.disconnect();
-    m_connected = false;
     Serial.println("WiFi disconnected");
 }
 
-void WifiModule::parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc)
+void WifiModule::reconnect()
+{
+    if (m_ssid.length() == 0)
+    {
+        return;
+    }
+    m_attempt = 0;
+    WiFi.disconnect();
+    startJoin();
+}
+
+const CmdEntry<WifiModule::CmdHandler> WifiModule::COMMANDS[] = {
+    CMD_ENTRY("set", "set ssid/password/timeout/fast/lease/ip/gateway/subnet/dns <value>", &WifiModule::cmdSet),
+    CMD_ENTRY("connect", "connect [ssid password]", &WifiModule::cmdConnect),
+    CMD_ENTRY("reconnect", "reconnect", &WifiModule::cmdReconnect),
+    CMD_ENTRY("disconnect", "disconnect", &WifiModule::cmdDisconnect),
+    CMD_ENTRY("status", "status", &WifiModule::cmdStatus),
+    CMD_ENTRY("scan", "scan", &WifiModule::cmdScan),
+    CMD_ENTRY("forget", "forget", &WifiModule::cmdForget),
+};
+
+void WifiModule::parseCmd(const tonkey &tokens, JsonDocument &_res_doc)
 {
-    int _tokenCount = tokens.size();
+    dispatchSubCmd(this, COMMANDS, CMD_COUNT(COMMANDS), tokens, _res_doc);
+}
 
-    if (_tokenCount > 1)
+String WifiModule::usage()
+{
+    return cmdUsage(COMMANDS, CMD_COUNT(COMMANDS));
+}
+
+void WifiModule::cmdSet(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (tokens.size() > 3)
     {
-        String subCmd = tokens[1];
+        const TokenView &key = tokens[2];
+        const TokenView &value = tokens[3];
 
-        if (subCmd == "set")
+        if (key == "ssid")
         {
-            if (_tokenCount > 3)
-            {
-                String key = tokens[2];
-                String value = tokens[3];
-
-                if (key == "ssid")
-                {
-                    setSSID(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "ssid set";
-                }
-                else if (key == "password" || key == "pass" || key == "pw")
-                {
-                    setPassword(value);
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "password set";
-                }
-                else if (key == "timeout")
-                {
-                    setConnectTimeout(value.toInt());
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "timeout set";
-                }
-                else
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "unknown key (ssid/password/timeout)";
-                }
-            }
-            else
-            {
-                _res_doc["result"] = "fail";
-                _res_doc["ms"] = "need key and value";
-            }
+            setSSID(value);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "ssid set";
         }
-        else if (subCmd == "connect")
+        else if (key == "password" || key == "pass" || key == "pw")
         {
-            // wifi connect ssid password 형태도 지원
-            if (_tokenCount > 3)
-            {
-                if (connect(tokens[2], tokens[3]))
-                {
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "connected";
-                    _res_doc["ip"] = getIP();
-                }
-                else
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "connection failed";
-                }
-            }
-            else
-            {
-                if (connect())
-                {
-                    _res_doc["result"] = "ok";
-                    _res_doc["ms"] = "connected";
-                    _res_doc["ip"] = getIP();
-                }
-                else
-                {
-                    _res_doc["result"] = "fail";
-                    _res_doc["ms"] = "connection failed";
-                }
-            }
+            setPassword(value);
+            _res_doc["result"] = "ok";
+            _res_doc["ms"] = "password set";
         }
-        else if (subCmd == "disconnect")
+        else if (key == "timeout")
         {
-            disconnect();
+            setConnectTimeout(value.toInt());
             _res_doc["result"] = "ok";
-            _res_doc["ms"] = "disconnected";
+            _res_doc["ms"] = "timeout set";
         }
-        else if (subCmd == "status")
+        else if (key == "fast")
         {
+            setFastJoin(value.toInt() == 1);
             _res_doc["result"] = "ok";
-            _res_doc["connected"] = isConnected();
-            _res_doc["ssid"] = m_ssid;
-            if (isConnected())
-            {
-                _res_doc["ip"] = getIP();
-                _res_doc["rssi"] = getRSSI();
-                _res_doc["mac"] = getMac();
-            }
+            _res_doc["wifi_fast"] = m_fastJoin;
         }
-        else if (subCmd == "scan")
+        else if (key == "lease")
         {
-            Serial.println("Scanning WiFi networks...");
-            int n = WiFi.scanNetworks();
-            
+            setReuseLease(value.toInt() == 1);
             _res_doc["result"] = "ok";
-            _res_doc["count"] = n;
-            
-            JsonArray networks = _res_doc["networks"].to<JsonArray>();
-            for (int i = 0; i < n && i < 10; i++)  // 최대 10개까지만
-            {
-                JsonObject network = networks.add<JsonObject>();
-                network["ssid"] = WiFi.SSID(i);
-                network["rssi"] = WiFi.RSSI(i);
-                network["enc"] = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
-            }
-            
-            WiFi.scanDelete();
+            _res_doc["wifi_lease"] = m_reuseLease;
+        }
+        else if (key == "ip" || key == "gateway" || key == "subnet" || key == "dns")
+        {
+            // ip none 이면 DHCP
+            String address = value;
+            bool ok = setStaticIp(key == "ip" ? address : getStaticIp(),
+                                  key == "gateway" ? address : getStaticGateway(),
+                                  key == "subnet" ? address : getStaticSubnet(),
+                                  key == "dns" ? address : getStaticDns());
+            _res_doc["result"] = ok ? "ok" : "fail";
+            _res_doc["static_ip"] = getStaticIp();
+            _res_doc["static_gw"] = getStaticGateway();
+            _res_doc["static_mask"] = getStaticSubnet();
+            _res_doc["static_dns"] = getStaticDns();
         }
         else
         {
             _res_doc["result"] = "fail";
-            _res_doc["ms"] = "unknown sub command";
+            _res_doc["ms"] = "unknown key (ssid/password/timeout/fast/lease/ip/gateway/subnet/dns)";
         }
     }
     else
     {
         _res_doc["result"] = "fail";
-        _res_doc["ms"] = "need sub command (set/connect/disconnect/status/scan)";
+        _res_doc["ms"] = "need key and value";
+    }
+}
+
+void WifiModule::cmdConnect(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    // wifi connect ssid password 형태도 지원
+    // 접속은 백그라운드로 진행하고 바로 응답 (진행 상황은 wifi status)
+    bool started = tokens.size() > 3 ? connect(tokens[2], tokens[3]) : connect();
+    if (started)
+    {
+        _res_doc["result"] = "ok";
+        _res_doc["ms"] = isConnected() ? "connected" : "connecting";
+        _res_doc["state"] = stateName(m_state);
+    }
+    else
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "ssid not set";
+    }
+}
+
+void WifiModule::cmdReconnect(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    if (m_ssid.length() == 0)
+    {
+        _res_doc["result"] = "fail";
+        _res_doc["ms"] = "ssid not set";
+        return;
     }
+    reconnect();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "reconnecting";
+    _res_doc["state"] = stateName(m_state);
+}
+
+void WifiModule::cmdDisconnect(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    disconnect();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "disconnected";
+}
+
+void WifiModule::cmdStatus(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    _res_doc["result"] = "ok";
+    _res_doc["connected"] = isConnected();
+    _res_doc["state"] = stateName(m_state);
+    _res_doc["ssid"] = m_ssid;
+    if (isConnecting())
+    {
+        _res_doc["elapsed_ms"] = (micros() - m_joinStartUs) / 1000;
+    }
+    if (m_state == STATE_BACKOFF)
+    {
+        int32_t remaining = (int32_t)(m_retryAtMs - millis());
+        _res_doc["retry_in_ms"] = remaining > 0 ? remaining : 0;
+        _res_doc["backoff_ms"] = m_backoffMs;
+    }
+    _res_doc["attempt"] = m_attempt;
+    if (isConnected())
+    {
+        _res_doc["ip"] = getIP();
+        _res_doc["rssi"] = getRSSI();
+        _res_doc["mac"] = getMac();
+        _res_doc["bssid"] = WiFi.BSSIDstr();
+        _res_doc["channel"] = WiFi.channel();
+    }
+
+    _res_doc["fast"] = m_fastJoin;
+    _res_doc["lease"] = m_reuseLease;
+    _res_doc["static_ip"] = hasStaticIp() ? getStaticIp() : "";
+    _res_doc["cached"] = hasCache();
+
+    JsonObject join = _res_doc["join"].to<JsonObject>();
+    join["method"] = m_lastJoin.method;
+    join["radio_ms"] = m_lastJoin.radioMs;
+    join["fast_ms"] = m_lastJoin.fastMs;
+    join["assoc_ms"] = m_lastJoin.assocMs;
+    join["dhcp_ms"] = m_lastJoin.dhcpMs;
+    join["total_ms"] = m_lastJoin.totalMs;
+    join["joins"] = m_joins;
+    join["fast_ok"] = m_fastJoins;
+    join["fast_failed"] = m_fastFailures;
+    join["failed"] = m_failures;
+    join["link_lost"] = m_linkLost;
+    join["disconnect_reason"] = m_disconnectReason;
+}
+
+void WifiModule::cmdScan(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    Serial.println("Scanning WiFi networks...");
+    int n = WiFi.scanNetworks();
+    
+    _res_doc["result"] = "ok";
+    _res_doc["count"] = n;
+    
+    JsonArray networks = _res_doc["networks"].to<JsonArray>();
+    for (int i = 0; i < n && i < 10; i++)  // 최대 10개까지만
+    {
+        JsonObject network = networks.add<JsonObject>();
+        network["ssid"] = WiFi.SSID(i);
+        network["rssi"] = WiFi.RSSI(i);
+        network["enc"] = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
+    }
+    
+    WiFi.scanDelete();
+}
+
+void WifiModule::cmdForget(const tonkey &tokens, JsonDocument &_res_doc)
+{
+    forgetCache();
+    _res_doc["result"] = "ok";
+    _res_doc["ms"] = "join cache cleared";
 }
@@ -6,22 +6,123 @@
 #include <ArduinoJson.h>
 #include <vector>
 
+#include "tonkey.hpp"
+#include "cmd_registry.hpp"
+
+// 마지막으로 접속에 성공한 AP 정보 (RTC 메모리 + NVS)
+// 다음 접속 때 스캔 없이 이 BSSID/채널로 바로 붙는다
+struct WifiJoinCache
+{
+    uint32_t magic;
+    uint32_t ssidCrc;         // 다른 SSID 로 바뀌면 무시
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+    uint32_t ip;              // 마지막 DHCP 임대 (lease 재사용 시)
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t crc;
+};
+
+// 마지막 접속의 단계별 소요 시간 (ms)
+struct WifiJoinTiming
+{
+    const char *method = "none";   // fast / scan / fallback
+    uint32_t radioMs = 0;          // STA 모드 전환 (무선 초기화)
+    uint32_t fastMs = 0;           // 캐시 BSSID/채널로 시도한 시간 (실패 포함)
+    uint32_t assocMs = 0;          // begin → 연결 (스캔 + 인증/연결)
+    uint32_t dhcpMs = 0;           // 연결 → IP 획득
+    uint32_t totalMs = 0;
+};
+
+// WiFi 접속 상태 머신
+// connect()/disconnect()/reconnect() 는 바로 반환하고, 진행은 스케줄러 태스크의 tick() 과
+// WiFi 이벤트로 처리한다 (접속을 기다리는 동안 다른 태스크가 멈추지 않음).
+// 접속을 원하는 동안 링크가 끊기면 곧바로 한 번 다시 붙고, 실패하면 지터를 준 지수 백오프로 재시도한다.
 class WifiModule
 {
+public:
+    enum State
+    {
+        STATE_IDLE,         // 접속하지 않음 (disconnect 또는 SSID 없음)
+        STATE_FAST_JOIN,    // 캐시 BSSID/채널로 접속 중
+        STATE_SCAN_JOIN,    // 전체 스캔 후 접속 중
+        STATE_CONNECTED,
+        STATE_BACKOFF       // 재시도 대기
+    };
+
+    static const uint32_t MAGIC = 0x4A4F494E;        // "JOIN"
+    static const uint32_t FAST_JOIN_TIMEOUT_MS = 2000;
+    static const uint32_t TICK_MS = 10;              // tick() 호출 주기
+    static const uint32_t BACKOFF_MIN_MS = 1000;
+    static const uint32_t BACKOFF_MAX_MS = 60000;
+
 private:
     String m_ssid;
     String m_password;
-    bool m_connected = false;
     unsigned long m_connectTimeout = 10000;  // 10초
 
+    // 상태 머신
+    State m_state = STATE_IDLE;
+    bool m_fastTried = false;                // 이번 시도에서 빠른 접속을 했는지
+    uint32_t m_joinStartUs = 0;
+    uint32_t m_phaseStartUs = 0;
+    uint32_t m_retryAtMs = 0;
+    uint32_t m_backoffMs = 0;
+    int m_attempt = 0;                       // 연속 실패 횟수
+    WifiJoinTiming m_timing;                 // 진행 중인 접속
+
+    // 빠른 재접속
+    bool m_fastJoin = true;                  // 캐시 BSSID/채널로 먼저 시도
+    bool m_reuseLease = false;               // 빠른 접속 때 캐시 IP 를 고정 IP 로 사용 (DHCP 생략)
+    IPAddress m_staticIp;                    // 설정하면 항상 고정 IP
+    IPAddress m_staticGateway;
+    IPAddress m_staticSubnet;
+    IPAddress m_staticDns;
+    WifiJoinCache m_cache;
+    bool m_cacheLoaded = false;
+    bool m_eventsRegistered = false;
+    volatile uint32_t m_assocUs = 0;         // STA_CONNECTED 이벤트 시각
+    volatile uint32_t m_gotIpUs = 0;         // STA_GOT_IP 이벤트 시각
+    volatile uint8_t m_disconnectReason = 0;
+    WifiJoinTiming m_lastJoin;
+    uint32_t m_joins = 0;
+    uint32_t m_fastJoins = 0;
+    uint32_t m_fastFailures = 0;
+    uint32_t m_failures = 0;                 // 스캔 접속까지 실패한 횟수
+    uint32_t m_linkLost = 0;                 // 접속 중 끊긴 횟수
+
+    void registerEvents();
+    void startJoin();
+    void beginJoin(State state);
+    void onJoined();
+    void onJoinTimeout();
+    void scheduleRetry();
+    void applyIpConfig(bool fast);
+    bool hasCache();
+    void loadCache();
+    void saveCache();
+    void forgetCache();
+    static uint32_t cacheCrc(const WifiJoinCache &cache);
+    static IPAddress parseAddress(const String &text);
+    static inline String addressString(const IPAddress &address) { return (uint32_t)address ? address.toString() : String(""); }
+
 public:
     WifiModule() {}
     ~WifiModule() {}
 
-    // WiFi 연결
+    // WiFi 연결 (바로 반환, 결과는 getState()/isConnected() 로 확인)
     bool connect();
     bool connect(const String& ssid, const String& password);
     void disconnect();
+    void reconnect();
+
+    // 스케줄러 태스크에서 TICK_MS 주기로 호출
+    void tick();
+    inline State getState() const { return m_state; }
+    static const char *stateName(State state);
+    inline bool isConnecting() const { return m_state == STATE_FAST_JOIN || m_state == STATE_SCAN_JOIN; }
     
     // 상태 확인
     inline bool isConnected() const { return WiFi.status() == WL_CONNECTED; }
@@ -35,9 +136,35 @@ public:
     inline void setSSID(const String& ssid) { m_ssid = ssid; }
     inline void setPassword(const String& password) { m_password = password; }
     inline void setConnectTimeout(unsigned long timeout) { m_connectTimeout = timeout; }
+    inline void setFastJoin(bool enabled) { m_fastJoin = enabled; }
+    inline void setReuseLease(bool enabled) { m_reuseLease = enabled; }
+    bool setStaticIp(const String &ip, const String &gateway, const String &subnet, const String &dns);
+
+    inline bool isFastJoin() const { return m_fastJoin; }
+    inline bool isReuseLease() const { return m_reuseLease; }
+    inline bool hasStaticIp() const { return (uint32_t)m_staticIp != 0 && (uint32_t)m_staticGateway != 0; }
+    inline String getStaticIp() const { return addressString(m_staticIp); }
+    inline String getStaticGateway() const { return addressString(m_staticGateway); }
+    inline String getStaticSubnet() const { return addressString(m_staticSubnet); }
+    inline String getStaticDns() const { return addressString(m_staticDns); }
+    inline const WifiJoinTiming &getLastJoin() const { return m_lastJoin; }
 
     // 커맨드 파싱
-    void parseCmd(std::vector<String> &tokens, JsonDocument &_res_doc);
+    void parseCmd(const tonkey &tokens, JsonDocument &_res_doc);
+    static String usage();
+
+private:
+    // 서브 커맨드 (COMMANDS 테이블에 등록)
+    typedef void (WifiModule::*CmdHandler)(const tonkey &tokens, JsonDocument &_res_doc);
+    static const CmdEntry<CmdHandler> COMMANDS[];
+
+    void cmdSet(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdConnect(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdReconnect(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdDisconnect(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdStatus(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdScan(const tonkey &tokens, JsonDocument &_res_doc);
+    void cmdForget(const tonkey &tokens, JsonDocument &_res_doc);
 };
 
 #endif // WIFI_MODULE_HPP
@@ -0,0 +1,209 @@
+// Config 시험 (호스트, 메모리 NVS)
+// 이전 EEPROM JSON 마이그레이션이 모든 쓰기가 성공했을 때만 완료로 표시되는지,
+// 커밋에서 실패한 키가 dirty 로 남아 다시 기록되는지,
+// NVS 키 길이(15 자)를 넘는 이름도 옮겨지고 다시 읽었을 때 같은 JSON 이 되는지 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <nvs.h>
+#include <nvs_flash.h>
+
+#include "config.hpp"
+#include "native_host.hpp"
+
+static Config *s_config = nullptr;
+static nvs_handle_t s_nvs = 0;
+
+static void writeLegacy(const char *json)
+{
+    EEPROM.begin(Config::EEPROM_SIZE);
+    size_t len = strlen(json);
+    for (size_t i = 0; i < Config::EEPROM_SIZE; i++)
+    {
+        EEPROM.write(Config::EEPROM_START_ADDRESS + i, i < len ? json[i] : (i == len ? 0 : 0xFF));
+    }
+    EEPROM.commit();
+    EEPROM.end();
+}
+
+static void runCmd(const char *line, JsonDocument &res)
+{
+    tonkey tokens;
+    tokens.parse(line, strlen(line));
+    res.clear();
+    s_config->parseCmd(tokens, res);
+}
+
+static bool isMigrated()
+{
+    uint8_t migrated = 0;
+    return nvs_get_u8(s_nvs, "_migrated", &migrated) == ESP_OK && migrated == 1;
+}
+
+void setUp()
+{
+    // 새 장치: NVS 와 EEPROM 비움, 쓰기 실패 없음
+    nativeNvsFailAfter(-1);
+    nvs_flash_erase();
+    writeLegacy("");
+}
+
+void tearDown()
+{
+    nativeNvsFailAfter(-1);
+}
+
+static void test_legacy_config_is_migrated()
+{
+    writeLegacy("{\"wifi_ssid\":\"home\",\"upload_interval\":30,\"server_url\":\"http://10.0.0.2\"}");
+    s_config->load();
+
+    TEST_ASSERT_TRUE(isMigrated());
+    TEST_ASSERT_EQUAL_STRING("home", s_config->get<String>("wifi_ssid").c_str());
+    TEST_ASSERT_EQUAL_INT(30, s_config->get<int>("upload_interval"));
+    TEST_ASSERT_EQUAL_STRING("http://10.0.0.2", s_config->get<String>("server_url").c_str());
+}
+
+static void test_failed_write_leaves_marker_unset_and_retries()
+{
+    writeLegacy("{\"wifi_ssid\":\"home\",\"upload_interval\":30,\"server_url\":\"http://10.0.0.2\"}");
+
+    // 첫 키만 쓰이고 나머지는 실패 (플래시 공간 부족)
+    nativeNvsFailAfter(1);
+    s_config->load();
+    TEST_ASSERT_FALSE(isMigrated());
+
+    // 다음 부팅: 다시 옮기고 이번에는 표시
+    nativeNvsFailAfter(-1);
+    s_config->load();
+    TEST_ASSERT_TRUE(isMigrated());
+    TEST_ASSERT_EQUAL_STRING("home", s_config->get<String>("wifi_ssid").c_str());
+    TEST_ASSERT_EQUAL_INT(30, s_config->get<int>("upload_interval"));
+    TEST_ASSERT_EQUAL_STRING("http://10.0.0.2", s_config->get<String>("server_url").c_str());
+}
+
+static void test_marker_write_failure_retries()
+{
+    writeLegacy("{\"wifi_ssid\":\"home\"}");
+
+    // 키는 쓰였지만 표시 쓰기가 실패
+    nativeNvsFailAfter(1);
+    s_config->load();
+    TEST_ASSERT_FALSE(isMigrated());
+
+    nativeNvsFailAfter(-1);
+    s_config->load();
+    TEST_ASSERT_TRUE(isMigrated());
+}
+
+static void test_migrated_device_ignores_eeprom()
+{
+    writeLegacy("{\"wifi_ssid\":\"home\"}");
+    s_config->load();
+    TEST_ASSERT_TRUE(isMigrated());
+
+    writeLegacy("{\"wifi_ssid\":\"other\"}");
+    s_config->load();
+    TEST_ASSERT_EQUAL_STRING("home", s_config->get<String>("wifi_ssid").c_str());
+}
+
+static void test_unreadable_legacy_is_not_retried()
+{
+    writeLegacy("{\"wifi_ssid\":");
+    s_config->load();
+    TEST_ASSERT_TRUE(isMigrated());
+    TEST_ASSERT_FALSE(s_config->hasKey("wifi_ssid"));
+}
+
+static void test_long_keys_survive_migration()
+{
+    const char *legacy = "{\"wifi_ssid\":\"home\",\"site_upload_interval_override\":45,"
+                         "\"site_camera_profile_name\":\"night\"}";
+    writeLegacy(legacy);
+    s_config->load();
+    TEST_ASSERT_TRUE(isMigrated());
+
+    // 다음 부팅: NVS 에서만 읽어도 이름과 값이 그대로
+    s_config->load();
+    TEST_ASSERT_EQUAL_INT(45, s_config->get<int>("site_upload_interval_override"));
+    TEST_ASSERT_EQUAL_STRING("night", s_config->get<String>("site_camera_profile_name").c_str());
+
+    JsonDocument expected;
+    deserializeJson(expected, legacy);
+    String expectedJson;
+    serializeJson(expected, expectedJson);
+    JsonDocument res;
+    runCmd("config dump", res);
+    String dumped;
+    serializeJson(res["ms"], dumped);
+    // NVS 반복 순서는 정해져 있지 않으므로 키 수와 값으로 비교
+    TEST_ASSERT_EQUAL_INT(expected.size(), res["ms"].size());
+    TEST_ASSERT_EQUAL_UINT32(expectedJson.length(), dumped.length());
+    for (JsonPair kv : expected.as<JsonObject>())
+    {
+        TEST_ASSERT_EQUAL_STRING(kv.value().as<String>().c_str(), res["ms"][kv.key().c_str()].as<String>().c_str());
+    }
+
+    // 긴 이름도 콘솔에서 바꾸고 저장할 수 있음
+    runCmd("config set site_upload_interval_override 90", res);
+    TEST_ASSERT_EQUAL_STRING("ok", res["result"].as<String>().c_str());
+    runCmd("config save", res);
+    TEST_ASSERT_EQUAL_STRING("ok", res["result"].as<String>().c_str());
+    s_config->load();
+    TEST_ASSERT_EQUAL_INT(90, s_config->get<int>("site_upload_interval_override"));
+    TEST_ASSERT_EQUAL_INT(3, s_config->doc().size());
+}
+
+static void test_failed_save_keeps_keys_dirty()
+{
+    s_config->load();
+    s_config->set("wifi_ssid", String("home"));
+    s_config->set("upload_interval", 30);
+    s_config->set("server_url", String("http://10.0.0.2"));
+
+    // 첫 키만 쓰이고 나머지는 실패
+    nativeNvsFailAfter(1);
+    JsonDocument res;
+    runCmd("config save", res);
+    TEST_ASSERT_EQUAL_STRING("error", res["result"].as<String>().c_str());
+    TEST_ASSERT_TRUE(s_config->isDirty());
+
+    runCmd("config stats", res);
+    TEST_ASSERT_EQUAL_INT(1, res["write_failures"].as<int>());
+    TEST_ASSERT_EQUAL_INT(2, res["dirty"].size());
+
+    // 공간이 생기면 COMMIT_DELAY_MS 뒤 다시 커밋
+    nativeNvsFailAfter(-1);
+    s_config->commitIfDue();
+    TEST_ASSERT_TRUE(s_config->isDirty());
+    nativeTimeAdvance(Config::COMMIT_DELAY_MS);
+    s_config->commitIfDue();
+    TEST_ASSERT_FALSE(s_config->isDirty());
+
+    // 다시 읽어도 세 키가 모두 남아 있음
+    s_config->load();
+    TEST_ASSERT_EQUAL_STRING("home", s_config->get<String>("wifi_ssid").c_str());
+    TEST_ASSERT_EQUAL_INT(30, s_config->get<int>("upload_interval"));
+    TEST_ASSERT_EQUAL_STRING("http://10.0.0.2", s_config->get<String>("server_url").c_str());
+
+    runCmd("config stats", res);
+    TEST_ASSERT_EQUAL_INT(1, res["write_failures"].as<int>());
+    TEST_ASSERT_EQUAL_INT(0, res["dirty"].size());
+}
+
+int main(int argc, char **argv)
+{
+    s_config = new Config();
+    nvs_open("config", NVS_READWRITE, &s_nvs);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_legacy_config_is_migrated);
+    RUN_TEST(test_failed_write_leaves_marker_unset_and_retries);
+    RUN_TEST(test_marker_write_failure_retries);
+    RUN_TEST(test_migrated_device_ignores_eeprom);
+    RUN_TEST(test_unreadable_legacy_is_not_retried);
+    RUN_TEST(test_long_keys_survive_migration);
+    RUN_TEST(test_failed_save_keeps_keys_dirty);
+    return UNITY_END();
+}
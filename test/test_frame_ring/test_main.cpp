@@ -0,0 +1,206 @@
+// 카메라 PSRAM 링 버퍼 시험 (호스트)
+// 덮어쓰기 순서, 업로드 중인 슬롯 보호, 여러 태스크의 동시 저장을 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+#include "camera_module.hpp"
+
+static CameraModule *s_cam = nullptr;
+
+// 프레임 내용은 timestamp 로 정해진다 (찢긴 복사를 찾기 위해)
+static size_t frameLen(uint32_t ts)
+{
+    return 1000 + ts % 3000;
+}
+
+static std::vector<uint8_t> makeFrame(uint32_t ts)
+{
+    std::vector<uint8_t> frame(frameLen(ts));
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+        frame[i] = (uint8_t)(ts * 31 + i);
+    }
+    return frame;
+}
+
+static bool frameIntact(const StoredFrame &stored)
+{
+    if (stored.len != frameLen(stored.timestamp))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < stored.len; i++)
+    {
+        if (stored.data[i] != (uint8_t)(stored.timestamp * 31 + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool store(uint32_t ts)
+{
+    std::vector<uint8_t> frame = makeFrame(ts);
+    return s_cam->storeFrame(frame.data(), frame.size(), ts);
+}
+
+static void drainAll()
+{
+    StoredFrame frame;
+    while (s_cam->peekStoredFrame(frame))
+    {
+        s_cam->popStoredFrame();
+    }
+}
+
+void setUp()
+{
+    drainAll();
+}
+
+void tearDown()
+{
+}
+
+static void test_full_ring_overwrites_oldest()
+{
+    int slots = s_cam->getRingSlots();
+    for (int i = 0; i < slots + 2; i++)
+    {
+        TEST_ASSERT_TRUE(store(100 + i));
+    }
+    TEST_ASSERT_EQUAL_INT(slots, s_cam->getStoredCount());
+
+    // 앞의 두 장이 덮어써졌으므로 102 부터 순서대로
+    for (int i = 2; i < slots + 2; i++)
+    {
+        StoredFrame frame;
+        TEST_ASSERT_TRUE(s_cam->peekStoredFrame(frame));
+        TEST_ASSERT_EQUAL_UINT32(100 + i, frame.timestamp);
+        TEST_ASSERT_TRUE(frameIntact(frame));
+        s_cam->popStoredFrame();
+    }
+    TEST_ASSERT_EQUAL_INT(0, s_cam->getStoredCount());
+}
+
+static void test_full_ring_skips_frames_being_read()
+{
+    int slots = s_cam->getRingSlots();
+    for (int i = 0; i < slots; i++)
+    {
+        TEST_ASSERT_TRUE(store(200 + i));
+    }
+
+    // 업로드 태스크가 가장 오래된 두 장을 잡고 있는 동안 새 프레임 저장
+    StoredFrame held[2];
+    TEST_ASSERT_EQUAL_INT(2, s_cam->peekStoredFrames(held, 2));
+    TEST_ASSERT_TRUE(store(300));
+    TEST_ASSERT_TRUE(store(301));
+    TEST_ASSERT_EQUAL_INT(slots, s_cam->getStoredCount());
+
+    // 잡고 있던 프레임은 그대로, 그 다음 두 장(202, 203)이 버려짐
+    TEST_ASSERT_TRUE(frameIntact(held[0]));
+    TEST_ASSERT_TRUE(frameIntact(held[1]));
+    TEST_ASSERT_EQUAL_UINT32(200, held[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT32(201, held[1].timestamp);
+    s_cam->popStoredFrame();
+
+    std::vector<uint32_t> order;
+    StoredFrame frame;
+    while (s_cam->peekStoredFrame(frame))
+    {
+        TEST_ASSERT_TRUE(frameIntact(frame));
+        order.push_back(frame.timestamp);
+        s_cam->popStoredFrame();
+    }
+    TEST_ASSERT_EQUAL_INT(slots - 2, (int)order.size());
+    TEST_ASSERT_EQUAL_UINT32(204, order.front());
+    TEST_ASSERT_EQUAL_UINT32(300, order[order.size() - 2]);
+    TEST_ASSERT_EQUAL_UINT32(301, order.back());
+}
+
+static void test_reader_holding_whole_ring_rejects()
+{
+    int slots = s_cam->getRingSlots();
+    for (int i = 0; i < slots; i++)
+    {
+        TEST_ASSERT_TRUE(store(400 + i));
+    }
+    std::vector<StoredFrame> held(slots);
+    TEST_ASSERT_EQUAL_INT(slots, s_cam->peekStoredFrames(held.data(), slots));
+    TEST_ASSERT_FALSE(store(500));
+    s_cam->releaseStoredFrame();
+    TEST_ASSERT_TRUE(store(500));
+}
+
+// 캡처 태스크와 업로드 태스크가 동시에 저장하고 한 태스크가 비우는 경우
+static void test_concurrent_writers_never_share_a_slot()
+{
+    const int WRITERS = 4;
+    const int PER_WRITER = 400;
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::atomic<int> read(0);
+
+    std::thread reader([&]() {
+        StoredFrame frames[4];
+        while (!done.load() || s_cam->getStoredCount() > 0)
+        {
+            int n = s_cam->peekStoredFrames(frames, 4);
+            for (int i = 0; i < n; i++)
+            {
+                if (!frameIntact(frames[i]))
+                {
+                    torn++;
+                }
+            }
+            read += n;
+            if (n > 0)
+            {
+                s_cam->popStoredFrame();
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; w++)
+    {
+        writers.emplace_back([w]() {
+            for (int i = 0; i < PER_WRITER; i++)
+            {
+                store(1000 + w * PER_WRITER + i);
+            }
+        });
+    }
+    for (std::thread &t : writers)
+    {
+        t.join();
+    }
+    done.store(true);
+    reader.join();
+
+    TEST_ASSERT_EQUAL_INT(0, torn.load());
+    TEST_ASSERT_GREATER_THAN(0, read.load());
+    TEST_ASSERT_EQUAL_INT(0, s_cam->getStoredCount());
+}
+
+int main(int argc, char **argv)
+{
+    s_cam = new CameraModule();
+    UNITY_BEGIN();
+    if (!s_cam->initFrameRing() || s_cam->getRingSlots() < 4)
+    {
+        TEST_MESSAGE("frame ring init failed");
+        return UNITY_END() + 1;
+    }
+    RUN_TEST(test_full_ring_overwrites_oldest);
+    RUN_TEST(test_full_ring_skips_frames_being_read);
+    RUN_TEST(test_reader_holding_whole_ring_rejects);
+    RUN_TEST(test_concurrent_writers_never_share_a_slot);
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+// 업로드 스풀 시험 (호스트, 임시 디렉터리 LittleFS)
+// 쓰다 끊긴 세그먼트 꼬리가 부팅 시 버려지는지, 재전송이 /spool/cursor 에서 이어지는지,
+// 깨진 cursor 면 가장 오래된 세그먼트부터 다시 보내는지, max_kb 를 넘으면 가장 오래된
+// 세그먼트를 버리는지, 본문 CRC 가 틀린 레코드를 건너뛰는지 확인한다.
+// 재부팅은 FrameSpool 을 새로 만들어 begin() 하는 것으로 흉내 낸다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+#include "frame_spool.hpp"
+#include "native_host.hpp"
+
+static const size_t HEADER_SIZE = 24;    // RecordHeader
+static const size_t FRAME_SIZE = 1000;
+
+static char s_root[] = "/tmp/test_frame_spool_XXXXXX";
+static std::unique_ptr<FrameSpool> s_spool;
+
+// 전원을 껐다 켠 것처럼 열린 파일을 모두 닫고 처음부터 복구
+static void reboot()
+{
+    s_spool.reset();
+    s_spool.reset(new FrameSpool(LittleFS));
+    TEST_ASSERT_TRUE(s_spool->begin(LittleFS.totalBytes()));
+}
+
+static String hostPath(const char *path)
+{
+    return String(s_root) + path;
+}
+
+// 프레임 n 은 모든 바이트가 n
+static bool appendFrame(uint8_t n, size_t size = FRAME_SIZE)
+{
+    std::vector<uint8_t> frame(size, n);
+    return s_spool->append(frame.data(), frame.size(), millis());
+}
+
+static void appendFrames(uint8_t first, int count, size_t size = FRAME_SIZE)
+{
+    for (int i = 0; i < count; i++)
+    {
+        TEST_ASSERT_TRUE(appendFrame(first + i, size));
+    }
+}
+
+// 업로드 태스크처럼 peek → read → pop, 본문이 프레임 번호로 채워져 있는지 확인
+static std::vector<int> drain(int limit = 1000)
+{
+    std::vector<int> frames;
+    SpoolRecord record;
+    while ((int)frames.size() < limit && s_spool->peek(record))
+    {
+        std::vector<uint8_t> body(record.len);
+        TEST_ASSERT_EQUAL_UINT32(record.len, s_spool->read(record, 0, body.data(), body.size()));
+        for (uint8_t b : body)
+        {
+            TEST_ASSERT_EQUAL_UINT8(body[0], b);
+        }
+        frames.push_back(body[0]);
+        s_spool->pop(record);
+    }
+    return frames;
+}
+
+static void assertFrames(std::vector<int> expected, std::vector<int> actual)
+{
+    TEST_ASSERT_EQUAL_INT(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        TEST_ASSERT_EQUAL_INT(expected[i], actual[i]);
+    }
+}
+
+static uint32_t status(const char *key)
+{
+    tonkey tokens;
+    tokens.parse("spool status", 12);
+    JsonDocument res;
+    s_spool->parseCmd(tokens, res);
+    return res[key].as<uint32_t>();
+}
+
+// 호스트 파일의 offset 바이트를 뒤집는다 (플래시 비트 오류)
+static void corruptByte(const char *path, long offset)
+{
+    FILE *file = fopen(hostPath(path).c_str(), "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, offset, SEEK_SET);
+    int c = fgetc(file);
+    fseek(file, offset, SEEK_SET);
+    fputc(c ^ 0xFF, file);
+    fclose(file);
+}
+
+void setUp()
+{
+    nativeFsFailAfter(-1);
+    s_spool.reset();
+    LittleFS.format();
+    TEST_ASSERT_TRUE(LittleFS.begin());
+    reboot();
+}
+
+void tearDown()
+{
+    nativeFsFailAfter(-1);
+    s_spool.reset();
+}
+
+static void test_torn_tail_is_dropped_on_begin()
+{
+    appendFrames(0, 3);
+
+    // 네 번째 레코드는 헤더와 본문 절반만 쓰이고 전원 차단
+    nativeFsFailAfter(HEADER_SIZE + FRAME_SIZE / 2);
+    TEST_ASSERT_FALSE(appendFrame(3));
+    nativeFsFailAfter(-1);
+
+    reboot();
+    TEST_ASSERT_EQUAL_UINT32(3, s_spool->getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(3, status("recovered"));
+    TEST_ASSERT_EQUAL_UINT32(HEADER_SIZE + FRAME_SIZE / 2, status("torn_bytes"));
+
+    // 복구 뒤 기록은 새 세그먼트에 이어지고 찢어진 레코드는 나오지 않는다
+    appendFrames(4, 1);
+    assertFrames({ 0, 1, 2, 4 }, drain());
+    TEST_ASSERT_EQUAL_UINT32(0, status("corrupt"));
+}
+
+static void test_replay_resumes_from_cursor()
+{
+    appendFrames(0, 5);
+    assertFrames({ 0, 1 }, drain(2));
+
+    reboot();
+    TEST_ASSERT_EQUAL_UINT32(3, s_spool->getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(3, status("recovered"));
+    assertFrames({ 2, 3, 4 }, drain());
+
+    // 다 보낸 세그먼트는 다음 부팅에 남지 않는다
+    reboot();
+    TEST_ASSERT_EQUAL_UINT32(0, s_spool->getPendingCount());
+    TEST_ASSERT_EQUAL_UINT32(0, status("segments"));
+}
+
+static void test_corrupt_cursor_replays_from_oldest_segment()
+{
+    appendFrames(0, 5);
+    assertFrames({ 0, 1 }, drain(2));
+
+    // 읽기 위치를 덮어쓰다 꺼진 것처럼 CRC 가 맞지 않는 cursor
+    corruptByte("/spool/cursor", 4);
+
+    reboot();
+    TEST_ASSERT_EQUAL_UINT32(5, s_spool->getPendingCount());
+    assertFrames({ 0, 1, 2, 3, 4 }, drain());
+}
+
+static void test_retention_drops_oldest_segment()
+{
+    // 세그먼트당 4장 (60000 + 헤더) × 4 < 256 KB < × 5
+    const size_t size = 60000;
+    const uint32_t maxKb = 600;
+    s_spool->setMaxKb(maxKb);
+
+    // 11 번째 프레임에서 600 KB 를 넘어 첫 세그먼트 (0..3) 를 버린다
+    appendFrames(0, 10, size);
+    TEST_ASSERT_EQUAL_UINT32(0, status("dropped"));
+    TEST_ASSERT_EQUAL_UINT32(3, status("segments"));
+    appendFrames(10, 1, size);
+
+    TEST_ASSERT_EQUAL_UINT32(4, status("dropped"));
+    TEST_ASSERT_EQUAL_UINT32(2, status("segments"));
+    TEST_ASSERT_EQUAL_UINT32(7, s_spool->getPendingCount());
+    TEST_ASSERT_LESS_OR_EQUAL(maxKb, status("used_kb"));
+    TEST_ASSERT_FALSE(LittleFS.exists("/spool/00000001.seg"));
+
+    assertFrames({ 4, 5, 6, 7, 8, 9, 10 }, drain());
+}
+
+static void test_bad_payload_crc_is_skipped()
+{
+    appendFrames(0, 3);
+
+    // 두 번째 레코드 본문 한가운데
+    corruptByte("/spool/00000001.seg", (HEADER_SIZE + FRAME_SIZE) + HEADER_SIZE + FRAME_SIZE / 2);
+
+    reboot();
+    // 부팅 시에는 헤더만 보므로 세 장 모두 대기, 재전송 직전에 걸러낸다
+    TEST_ASSERT_EQUAL_UINT32(3, s_spool->getPendingCount());
+    assertFrames({ 0, 2 }, drain());
+    TEST_ASSERT_EQUAL_UINT32(1, status("corrupt"));
+    TEST_ASSERT_EQUAL_UINT32(2, status("replayed"));
+    TEST_ASSERT_EQUAL_UINT32(0, s_spool->getPendingCount());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    if (!mkdtemp(s_root))
+    {
+        TEST_MESSAGE("temp dir create failed");
+        return UNITY_END() + 1;
+    }
+    nativeFsSetRoot(s_root);
+    RUN_TEST(test_torn_tail_is_dropped_on_begin);
+    RUN_TEST(test_replay_resumes_from_cursor);
+    RUN_TEST(test_corrupt_cursor_replays_from_oldest_segment);
+    RUN_TEST(test_retention_drops_oldest_segment);
+    RUN_TEST(test_bad_payload_crc_is_skipped);
+    int failures = UNITY_END();
+    LittleFS.format();
+    rmdir(s_root);
+    return failures;
+}
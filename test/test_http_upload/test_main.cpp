@@ -0,0 +1,116 @@
+// HttpUploader 시험 (호스트, 루프백 서버)
+// server_url 의 경로 유지, 지원하지 않는 스킴 거부, keep-alive 재사용,
+// 본문이 덜 온 응답 뒤에는 연결을 버리고 다음 업로드가 새 연결로 성공하는지 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+
+#include "http_upload.hpp"
+#include "native_host.hpp"
+
+static HttpUploader *s_uploader = nullptr;
+static String s_base;
+static uint8_t s_body[2048];
+
+static int upload()
+{
+    return s_uploader->uploadImage(s_body, sizeof(s_body));
+}
+
+void setUp()
+{
+    nativeLoopbackSetStatus(200);
+    nativeLoopbackShortBody(0);
+    s_uploader->setTimeout(30000);
+    s_uploader->setServerUrl(s_base);
+    s_uploader->setUploadPath("/api/v1/camera/upload");
+}
+
+void tearDown()
+{
+}
+
+static void test_upload_path_only()
+{
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    TEST_ASSERT_EQUAL_STRING("/api/v1/camera/upload", nativeLoopbackLastPath().c_str());
+}
+
+static void test_server_url_path_is_prefix()
+{
+    TEST_ASSERT_TRUE(s_uploader->setServerUrl(s_base + "/cam/"));
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    TEST_ASSERT_EQUAL_STRING("/cam/api/v1/camera/upload", nativeLoopbackLastPath().c_str());
+
+    // 업로드 경로에 / 가 없어도 한 번만 이어 붙임
+    s_uploader->setUploadPath("frames");
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    TEST_ASSERT_EQUAL_STRING("/cam/frames", nativeLoopbackLastPath().c_str());
+}
+
+static void test_https_is_rejected_by_setter()
+{
+    TEST_ASSERT_FALSE(s_uploader->setServerUrl("https://example.com/upload"));
+    TEST_ASSERT_FALSE(s_uploader->setServerUrl("ftp://example.com"));
+    // 이전 설정은 그대로
+    TEST_ASSERT_EQUAL_STRING(s_base.c_str(), s_uploader->getServerUrl().c_str());
+    TEST_ASSERT_EQUAL_INT(200, upload());
+}
+
+static void test_server_error_code_is_returned()
+{
+    nativeLoopbackSetStatus(503);
+    TEST_ASSERT_EQUAL_INT(503, upload());
+    nativeLoopbackSetStatus(200);
+    TEST_ASSERT_EQUAL_INT(200, upload());
+}
+
+static void test_keep_alive_connection_is_reused()
+{
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    uint32_t opened = s_uploader->getConnectionsOpened();
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(200, upload());
+    }
+    TEST_ASSERT_EQUAL_UINT32(opened, s_uploader->getConnectionsOpened());
+}
+
+static void test_short_body_drops_connection()
+{
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    uint32_t opened = s_uploader->getConnectionsOpened();
+
+    // Content-Length 보다 4 바이트 모자란 본문, 남은 바이트는 다음 응답 앞에 늦게 도착
+    s_uploader->setTimeout(300);
+    nativeLoopbackShortBody(4);
+    TEST_ASSERT_EQUAL_INT(200, upload());
+
+    // 늦은 바이트를 상태 라인으로 읽지 않도록 새 연결로 보낸다
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    TEST_ASSERT_EQUAL_UINT32(opened + 1, s_uploader->getConnectionsOpened());
+    TEST_ASSERT_EQUAL_INT(200, upload());
+    TEST_ASSERT_EQUAL_UINT32(opened + 1, s_uploader->getConnectionsOpened());
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port = nativeLoopbackServerStart();
+    s_base = "http://127.0.0.1:" + String((unsigned int)port);
+    s_uploader = new HttpUploader();
+    memset(s_body, 0xA5, sizeof(s_body));
+
+    UNITY_BEGIN();
+    if (port == 0)
+    {
+        TEST_MESSAGE("loopback server start failed");
+        return UNITY_END() + 1;
+    }
+    RUN_TEST(test_upload_path_only);
+    RUN_TEST(test_server_url_path_is_prefix);
+    RUN_TEST(test_https_is_rejected_by_setter);
+    RUN_TEST(test_server_error_code_is_returned);
+    RUN_TEST(test_keep_alive_connection_is_reused);
+    RUN_TEST(test_short_body_drops_connection);
+    return UNITY_END();
+}
@@ -0,0 +1,155 @@
+// 업로드 파이프라인 시험 (호스트)
+// 재생 카메라 → 캡처/업로드 태스크 → 루프백 서버 경로를 펌웨어와 같은 전역 객체로 돌린다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <thread>
+#include <atomic>
+
+#include "camera_module.hpp"
+#include "http_upload.hpp"
+#include "upload_pipeline.hpp"
+#include "native_host.hpp"
+
+extern CameraModule g_camera;
+extern HttpUploader g_uploader;
+extern UploadPipeline g_pipeline;
+extern String parseCmd(String _strLine);
+
+static String s_serverUrl;
+
+// cond 가 참이 될 때까지 최대 timeoutMs 기다림
+template <typename Cond>
+static bool waitFor(Cond cond, uint32_t timeoutMs)
+{
+    uint32_t start = millis();
+    while (!cond())
+    {
+        if (millis() - start > timeoutMs)
+        {
+            return false;
+        }
+        delay(5);
+    }
+    return true;
+}
+
+void setUp()
+{
+    nativeLoopbackSetStatus(200);
+    g_uploader.setServerUrl(s_serverUrl);
+    g_uploader.setDeviceId("native-test");
+}
+
+void tearDown()
+{
+}
+
+static void test_trigger_uploads_live_frame()
+{
+    uint32_t uploaded = g_pipeline.getUploaded();
+    uint64_t requests = nativeLoopbackRequests();
+
+    TEST_ASSERT_TRUE(g_pipeline.trigger(false));
+    TEST_ASSERT_TRUE(waitFor([&]() { return g_pipeline.getUploaded() == uploaded + 1; }, 3000));
+    TEST_ASSERT_EQUAL_UINT32(requests + 1, nativeLoopbackRequests());
+    TEST_ASSERT_EQUAL_INT(0, g_pipeline.getInFlight());
+}
+
+static void test_flash_trigger_uploads()
+{
+    uint32_t uploaded = g_pipeline.getUploaded();
+
+    TEST_ASSERT_TRUE(g_pipeline.trigger(true));
+    TEST_ASSERT_TRUE(waitFor([&]() { return g_pipeline.getUploaded() == uploaded + 1; }, 3000));
+}
+
+static void test_failed_upload_is_stored_then_drained()
+{
+    uint32_t failed = g_pipeline.getUploadFailed();
+    uint32_t stored = g_pipeline.getStored();
+    uint32_t drained = g_pipeline.getDrained();
+
+    nativeLoopbackSetStatus(503);
+    TEST_ASSERT_TRUE(g_pipeline.trigger(false));
+    TEST_ASSERT_TRUE(waitFor([&]() { return g_pipeline.getStored() == stored + 1; }, 3000));
+    TEST_ASSERT_GREATER_OR_EQUAL(failed + 1, g_pipeline.getUploadFailed());
+
+    // 서버가 살아나면 재시도 대기 뒤 링 버퍼에서 다시 보낸다
+    nativeLoopbackSetStatus(200);
+    uint32_t waitMs = UploadPipeline::RETRY_DELAY_MS + 3000;
+    TEST_ASSERT_TRUE(waitFor([&]() { return g_pipeline.getDrained() == drained + 1; }, waitMs));
+    TEST_ASSERT_EQUAL_INT(0, g_camera.getStoredCount());
+}
+
+// 업로드 중에 콘솔이 설정을 바꿔도 요청은 항상 한 가지 설정으로 완성된다
+static void test_config_changes_during_uploads()
+{
+    const int FRAMES = 20;
+    uint32_t uploaded = g_pipeline.getUploaded();
+    uint32_t failed = g_pipeline.getUploadFailed();
+
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        int i = 0;
+        while (!stop.load())
+        {
+            g_uploader.setDeviceId("native-test-" + String(i));
+            g_uploader.setAuthToken(String(i % 2 ? "token-a" : "token-bb"));
+            g_uploader.setUploadPath(String(i % 2 ? "/upload" : "/api/v1/camera/upload"));
+            i++;
+        }
+    });
+
+    for (int i = 0; i < FRAMES; i++)
+    {
+        uint32_t target = uploaded + i + 1;
+        TEST_ASSERT_TRUE(g_pipeline.trigger(false));
+        TEST_ASSERT_TRUE(waitFor([&]() { return g_pipeline.getUploaded() >= target; }, 3000));
+    }
+
+    stop.store(true);
+    writer.join();
+    TEST_ASSERT_EQUAL_UINT32(failed, g_pipeline.getUploadFailed());
+    TEST_ASSERT_EQUAL_UINT32(uploaded + FRAMES, g_pipeline.getUploaded());
+}
+
+// 콘솔 캡처 뒤에는 드라이버 버퍼를 모두 돌려받아 캡처 태스크가 fb_count 만큼 쓸 수 있다
+static void test_console_capture_returns_buffer()
+{
+    String response = parseCmd("camera capture");
+    TEST_ASSERT_TRUE(response.indexOf("\"captured\"") >= 0);
+
+    int count = g_camera.getFrameBufferCount();
+    camera_fb_t *held[4] = {};
+    TEST_ASSERT_TRUE(count <= 4);
+    for (int i = 0; i < count; i++)
+    {
+        held[i] = g_camera.grab();
+        TEST_ASSERT_TRUE(held[i] != nullptr);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        g_camera.returnFrame(held[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port = nativeLoopbackServerStart();
+    s_serverUrl = "http://127.0.0.1:" + String((unsigned int)port);
+
+    UNITY_BEGIN();
+    if (port == 0 || !nativeCameraReplay(nullptr, 0) || !g_camera.init() || !g_camera.initFrameRing() ||
+        !g_pipeline.begin())
+    {
+        TEST_MESSAGE("pipeline setup failed");
+        return UNITY_END() + 1;
+    }
+    RUN_TEST(test_trigger_uploads_live_frame);
+    RUN_TEST(test_flash_trigger_uploads);
+    RUN_TEST(test_failed_upload_is_stored_then_drained);
+    RUN_TEST(test_config_changes_during_uploads);
+    RUN_TEST(test_console_capture_returns_buffer);
+    return UNITY_END();
+}
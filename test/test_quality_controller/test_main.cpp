@@ -0,0 +1,204 @@
+// JPEG 품질 제어 시험 (호스트)
+// 크기-품질 표로 만든 프레임 크기 흐름을 넣어 target ± hysteresis 로 수렴하는지,
+// 범위 안에서는 품질을 바꾸지 않는지, 바꾼 뒤 settleFrames 만큼 기다리는지,
+// 한 번의 변경이 MAX_STEP 과 QUALITY_MIN..QUALITY_MAX 를 지키는지 확인한다.
+
+#include <unity.h>
+#include <stdlib.h>
+#include <deque>
+
+#include "quality_controller.hpp"
+
+// 품질 값별 프레임 크기 (VGA 실내 장면 규모, 사이 값은 선형 보간)
+struct TracePoint
+{
+    int quality;
+    uint32_t bytes;
+};
+
+static const TracePoint TRACE[] = {
+    { 6, 62000 }, { 8, 50000 }, { 10, 42000 }, { 12, 36500 }, { 15, 30500 },
+    { 20, 24000 }, { 25, 20000 }, { 30, 17200 }, { 40, 13500 }, { 50, 11000 },
+};
+static const int TRACE_COUNT = sizeof(TRACE) / sizeof(TRACE[0]);
+
+static const uint32_t TARGET = 24000;
+static const int HYSTERESIS = 15;
+static const int SETTLE = 2;   // PSRAM 보드 fb_count
+
+static uint32_t s_seed = 1;
+
+static uint32_t traceBytes(int quality)
+{
+    for (int i = 1; i < TRACE_COUNT; i++)
+    {
+        if (quality <= TRACE[i].quality)
+        {
+            const TracePoint &a = TRACE[i - 1];
+            const TracePoint &b = TRACE[i];
+            return a.bytes - (uint32_t)((int64_t)(a.bytes - b.bytes) * (quality - a.quality) / (b.quality - a.quality));
+        }
+    }
+    return TRACE[TRACE_COUNT - 1].bytes;
+}
+
+// 장면 잡음 ±4%
+static uint32_t noisy(uint32_t bytes)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    int permille = (int)((s_seed >> 16) % 81) - 40;
+    return bytes + (int32_t)bytes * permille / 1000;
+}
+
+// 드라이버처럼 SETTLE 장은 바꾸기 전 품질로 인코딩된 프레임이 나온다
+class SensorSim
+{
+private:
+    std::deque<int> m_inFlight;
+
+public:
+    explicit SensorSim(int quality) : m_inFlight(SETTLE, quality) {}
+
+    uint32_t nextFrame(int currentQuality)
+    {
+        int encoded = m_inFlight.front();
+        m_inFlight.pop_front();
+        m_inFlight.push_back(currentQuality);
+        return noisy(traceBytes(encoded));
+    }
+};
+
+static QualityController makeController(int quality, uint32_t target)
+{
+    QualityController qc;
+    qc.setSettleFrames(SETTLE);
+    qc.setHysteresis(HYSTERESIS);
+    qc.setTarget(target);
+    qc.setQuality(quality);
+    return qc;
+}
+
+static bool inBand(uint32_t bytes, uint32_t target)
+{
+    uint32_t band = target * HYSTERESIS / 100;
+    return bytes + band >= target && bytes <= target + band;
+}
+
+void setUp()
+{
+    s_seed = 1;
+}
+
+void tearDown()
+{
+}
+
+static void test_converges_into_band_from_both_sides()
+{
+    const int starts[] = { QualityController::QUALITY_MIN, 10, 40, QualityController::QUALITY_MAX };
+    for (int start : starts)
+    {
+        QualityController qc = makeController(start, TARGET);
+        SensorSim sensor(start);
+
+        for (int i = 0; i < 60; i++)
+        {
+            qc.update(sensor.nextFrame(qc.getQuality()));
+        }
+
+        // 수렴한 뒤에는 품질이 그대로이고 크기가 범위 안
+        int settled = qc.getQuality();
+        uint32_t adjustments = qc.getAdjustments();
+        for (int i = 0; i < 60; i++)
+        {
+            qc.update(sensor.nextFrame(qc.getQuality()));
+        }
+        TEST_ASSERT_EQUAL_INT(settled, qc.getQuality());
+        TEST_ASSERT_EQUAL_UINT32(adjustments, qc.getAdjustments());
+        TEST_ASSERT_TRUE(inBand(traceBytes(settled), TARGET));
+        TEST_ASSERT_TRUE(inBand(qc.getAvgBytes(), TARGET));
+    }
+}
+
+static void test_no_adjustment_while_in_band()
+{
+    // 표에서 20 은 target 그대로
+    QualityController qc = makeController(20, TARGET);
+    SensorSim sensor(20);
+
+    for (int i = 0; i < 200; i++)
+    {
+        TEST_ASSERT_FALSE(qc.update(sensor.nextFrame(qc.getQuality())));
+    }
+    TEST_ASSERT_EQUAL_INT(20, qc.getQuality());
+    TEST_ASSERT_EQUAL_UINT32(0, qc.getAdjustments());
+    TEST_ASSERT_EQUAL_UINT32(200 - SETTLE, qc.getInBand());
+}
+
+static void test_each_change_is_bounded_and_settles()
+{
+    // 목표를 여러 번 바꿔 조정을 많이 일으킨다
+    const uint32_t targets[] = { 12000, 55000, 30000, 16000 };
+    QualityController qc = makeController(20, targets[0]);
+    SensorSim sensor(20);
+
+    int changes = 0;
+    for (uint32_t target : targets)
+    {
+        qc.setTarget(target);
+        for (int i = 0; i < 80; i++)
+        {
+            int before = qc.getQuality();
+            if (!qc.update(sensor.nextFrame(qc.getQuality())))
+            {
+                TEST_ASSERT_EQUAL_INT(before, qc.getQuality());
+                continue;
+            }
+            changes++;
+
+            int after = qc.getQuality();
+            TEST_ASSERT_TRUE(after != before);
+            TEST_ASSERT_LESS_OR_EQUAL(QualityController::MAX_STEP, abs(after - before));
+            TEST_ASSERT_GREATER_OR_EQUAL(QualityController::QUALITY_MIN, after);
+            TEST_ASSERT_LESS_OR_EQUAL(QualityController::QUALITY_MAX, after);
+
+            // 다음 SETTLE 장은 이전 품질로 인코딩된 것 → 평균에 넣지도, 조정하지도 않음
+            for (int s = 0; s < SETTLE; s++, i++)
+            {
+                TEST_ASSERT_FALSE(qc.update(sensor.nextFrame(qc.getQuality())));
+                TEST_ASSERT_EQUAL_UINT32(0, qc.getAvgBytes());
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(changes > 8);
+    TEST_ASSERT_EQUAL_UINT32(changes, qc.getAdjustments());
+}
+
+static void test_stops_at_range_end()
+{
+    // 표의 가장 작은 크기보다 작은 목표 → QUALITY_MAX 에서 멈추고 더 바꾸지 않음
+    QualityController qc = makeController(30, 5000);
+    SensorSim sensor(30);
+
+    for (int i = 0; i < 100; i++)
+    {
+        qc.update(sensor.nextFrame(qc.getQuality()));
+    }
+    TEST_ASSERT_EQUAL_INT(QualityController::QUALITY_MAX, qc.getQuality());
+    uint32_t adjustments = qc.getAdjustments();
+    for (int i = 0; i < 50; i++)
+    {
+        TEST_ASSERT_FALSE(qc.update(sensor.nextFrame(qc.getQuality())));
+    }
+    TEST_ASSERT_EQUAL_UINT32(adjustments, qc.getAdjustments());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_converges_into_band_from_both_sides);
+    RUN_TEST(test_no_adjustment_while_in_band);
+    RUN_TEST(test_each_change_is_bounded_and_settles);
+    RUN_TEST(test_stops_at_range_end);
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+// 센서 프로필 시험 (호스트, 가짜 OV2640)
+// 리셋 상태 센서에 day 를 적용하면 쓰기가 없는지, day → night 는 다른 항목 수만큼만 쓰는지,
+// 자동 노출/게인이 켜져 있으면 aec_value/agc_gain 을 쓰지 않는지,
+// setter 가 실패하면 -1 을 돌려주는지, 그때 CameraModule 이 이전 프로필을 유지하고
+// 중간까지 쓴 항목을 되돌리는지 확인한다.
+
+#include <unity.h>
+#include <string.h>
+#include <esp_camera.h>
+
+#include "sensor_profile.hpp"
+#include "camera_module.hpp"
+#include "native_host.hpp"
+
+static sensor_t *s_sensor = nullptr;
+
+// apply() 가 써야 하는 항목 수 (자동이면 수동 값은 세지 않음)
+static int differingFields(const SensorProfile &from, const SensorProfile &to)
+{
+    int n = 0;
+    n += from.brightness != to.brightness;
+    n += from.contrast != to.contrast;
+    n += from.saturation != to.saturation;
+    n += from.specialEffect != to.specialEffect;
+    n += from.awb != to.awb;
+    n += from.awbGain != to.awbGain;
+    n += from.wbMode != to.wbMode;
+    n += from.aec != to.aec;
+    n += from.aec2 != to.aec2;
+    n += from.aeLevel != to.aeLevel;
+    n += !to.aec && from.aecValue != to.aecValue;
+    n += from.agc != to.agc;
+    n += !to.agc && from.agcGain != to.agcGain;
+    n += from.gainceiling != to.gainceiling;
+    n += from.bpc != to.bpc;
+    n += from.wpc != to.wpc;
+    n += from.rawGma != to.rawGma;
+    n += from.lenc != to.lenc;
+    n += from.hmirror != to.hmirror;
+    n += from.vflip != to.vflip;
+    n += from.dcw != to.dcw;
+    n += from.colorbar != to.colorbar;
+    return n;
+}
+
+static int failingSetter(sensor_t *s, int value)
+{
+    return -1;
+}
+
+void setUp()
+{
+    // 센서를 리셋 직후 상태로
+    camera_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.frame_size = FRAMESIZE_VGA;
+    config.jpeg_quality = 12;
+    config.fb_count = 1;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, esp_camera_init(&config));
+    s_sensor = esp_camera_sensor_get();
+    TEST_ASSERT_NOT_NULL(s_sensor);
+}
+
+void tearDown()
+{
+    esp_camera_deinit();
+    s_sensor = nullptr;
+}
+
+static void test_day_on_reset_sensor_writes_nothing()
+{
+    uint32_t before = nativeSensorWrites();
+    TEST_ASSERT_EQUAL_INT(0, SensorProfile::apply(s_sensor, *SensorProfile::find("day")));
+    TEST_ASSERT_EQUAL_UINT32(before, nativeSensorWrites());
+}
+
+static void test_day_to_night_writes_only_differences()
+{
+    const SensorProfile &day = *SensorProfile::find("day");
+    const SensorProfile &night = *SensorProfile::find("night");
+    TEST_ASSERT_EQUAL_INT(0, SensorProfile::apply(s_sensor, day));
+
+    // brightness, saturation, aec2, ae_level, gainceiling, bpc
+    int expected = differingFields(day, night);
+    TEST_ASSERT_EQUAL_INT(6, expected);
+
+    uint32_t before = nativeSensorWrites();
+    TEST_ASSERT_EQUAL_INT(expected, SensorProfile::apply(s_sensor, night));
+    TEST_ASSERT_EQUAL_UINT32(before + expected, nativeSensorWrites());
+    TEST_ASSERT_EQUAL_INT(night.brightness, s_sensor->status.brightness);
+    TEST_ASSERT_EQUAL_INT(night.gainceiling, s_sensor->status.gainceiling);
+
+    // 같은 프로필을 다시 적용하면 쓰기 없음, 되돌릴 때도 다른 항목만
+    TEST_ASSERT_EQUAL_INT(0, SensorProfile::apply(s_sensor, night));
+    TEST_ASSERT_EQUAL_INT(differingFields(night, day), SensorProfile::apply(s_sensor, day));
+    TEST_ASSERT_EQUAL_UINT32(before + expected * 2, nativeSensorWrites());
+}
+
+static void test_manual_values_skipped_while_auto()
+{
+    TEST_ASSERT_EQUAL_INT(0, SensorProfile::apply(s_sensor, *SensorProfile::find("day")));
+    s_sensor->status.aec_value = 1200;
+    s_sensor->status.agc_gain = 20;
+
+    // 자동 노출/게인: 수동 값이 달라도 쓰지 않음
+    SensorProfile profile = *SensorProfile::find("day");
+    profile.aecValue = 100;
+    profile.agcGain = 5;
+    TEST_ASSERT_EQUAL_INT(0, SensorProfile::apply(s_sensor, profile));
+    TEST_ASSERT_EQUAL_INT(1200, s_sensor->status.aec_value);
+    TEST_ASSERT_EQUAL_INT(20, s_sensor->status.agc_gain);
+
+    // 수동으로 바꾸면 aec, aec_value, agc, agc_gain 네 번
+    profile.aec = 0;
+    profile.agc = 0;
+    TEST_ASSERT_EQUAL_INT(4, SensorProfile::apply(s_sensor, profile));
+    TEST_ASSERT_EQUAL_INT(100, s_sensor->status.aec_value);
+    TEST_ASSERT_EQUAL_INT(5, s_sensor->status.agc_gain);
+}
+
+static void test_failing_setter_returns_error()
+{
+    const SensorProfile &night = *SensorProfile::find("night");
+
+    // SCCB 쓰기 실패 (bpc 는 day → night 에서 바뀌는 항목)
+    s_sensor->set_bpc = failingSetter;
+    TEST_ASSERT_EQUAL_INT(-1, SensorProfile::apply(s_sensor, night));
+
+    // setter 가 없는 센서도 실패
+    s_sensor->set_bpc = nullptr;
+    TEST_ASSERT_EQUAL_INT(-1, SensorProfile::apply(s_sensor, night));
+
+    TEST_ASSERT_EQUAL_INT(-1, SensorProfile::apply(nullptr, night));
+}
+
+static void test_camera_keeps_profile_on_failed_apply()
+{
+    CameraModule camera;
+    TEST_ASSERT_TRUE(nativeCameraReplay(nullptr, 0));
+    TEST_ASSERT_TRUE(camera.init());
+    s_sensor = esp_camera_sensor_get();
+    const SensorProfile &current = SensorProfile::defaultProfile();
+    TEST_ASSERT_EQUAL_STRING(current.name, camera.getProfileName());
+
+    // bpc 앞의 brightness, saturation 등은 쓰인 뒤 실패
+    int (*setBpc)(sensor_t *, int) = s_sensor->set_bpc;
+    s_sensor->set_bpc = failingSetter;
+    TEST_ASSERT_FALSE(camera.setProfile("night"));
+    TEST_ASSERT_EQUAL_STRING(current.name, camera.getProfileName());
+    TEST_ASSERT_EQUAL_INT(current.brightness, s_sensor->status.brightness);
+    TEST_ASSERT_EQUAL_INT(current.saturation, s_sensor->status.saturation);
+
+    // 센서가 돌아오면 바뀜
+    s_sensor->set_bpc = setBpc;
+    TEST_ASSERT_TRUE(camera.setProfile("night"));
+    TEST_ASSERT_EQUAL_STRING("night", camera.getProfileName());
+    TEST_ASSERT_EQUAL_INT(SensorProfile::find("night")->bpc, s_sensor->status.bpc);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_day_on_reset_sensor_writes_nothing);
+    RUN_TEST(test_day_to_night_writes_only_differences);
+    RUN_TEST(test_manual_values_skipped_while_auto);
+    RUN_TEST(test_failing_setter_returns_error);
+    RUN_TEST(test_camera_keeps_profile_on_failed_apply);
+    return UNITY_END();
+}
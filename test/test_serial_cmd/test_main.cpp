@@ -0,0 +1,346 @@
+// 시리얼 콘솔 시험 (호스트)
+// 최상위 명령과 각 모듈 usage() 의 읽기 전용 서브 커맨드를 텍스트 줄과 MessagePack 프레임으로
+// 보내 (바뀌는 값만 가리고) 같은 응답이 나오는지, 응답 프레임이 텍스트 줄보다 작은지,
+// proto 전환 응답을 받은 직후(응답을 쓰기 전이라도) 보낸 요청이 새 모드로 처리되는지,
+// 조립 중이던 줄은 전환 요청이 와도 원래 모드로 끝나는지 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <algorithm>
+#include <vector>
+
+#include "serial_cmd.hpp"
+#include "cmd_registry.hpp"
+#include "native_host.hpp"
+
+extern SerialCmdReader g_cmdReader;
+extern bool serviceCmd();
+
+// 응답마다 값이 바뀌는 필드 (시각, 힙, 누적 통계), 이름이 같으면 어느 깊이에서든 가린다
+static const char *const VOLATILE_KEYS[] = {
+    "uptime_ms", "free_heap", "psram_free",
+    "lines", "frames", "tx_text_bytes", "tx_bin_bytes", "count", "last_us", "avg_us", "max_us",
+    "proto",    // 요청 인코딩에 따라 다름 (proto 명령은 따로 확인)
+};
+
+// 상태를 바꾸는 명령/서브 커맨드 (인자 없이 불러도 동작하므로 보내지 않는다)
+static const char *const SIDE_EFFECT_COMMANDS[] = {
+    "reboot", "upload", "saveall", "autoconnect",
+    "load", "save", "clear", "init", "capture", "connect", "reconnect", "disconnect", "scan",
+    "forget", "close", "reset", "start", "stop", "flush", "bench",
+};
+
+static uint16_t crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void sendText(const String &line)
+{
+    String data = line + "\n";
+    nativeSerialInput((const uint8_t *)data.c_str(), data.length());
+}
+
+// [0x7E][len LE][MessagePack str][crc16 LE]
+static void sendFrame(const String &line)
+{
+    std::vector<uint8_t> payload;
+    if (line.length() < 32)
+    {
+        payload.push_back(0xA0 | line.length());
+    }
+    else
+    {
+        payload.push_back(0xD9);
+        payload.push_back(line.length());
+    }
+    payload.insert(payload.end(), line.c_str(), line.c_str() + line.length());
+
+    uint16_t crc = crc16(payload.data(), payload.size());
+    std::vector<uint8_t> frame = { SerialCmdReader::FRAME_START, (uint8_t)(payload.size() & 0xFF), (uint8_t)(payload.size() >> 8) };
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.push_back(crc & 0xFF);
+    frame.push_back(crc >> 8);
+    nativeSerialInput(frame.data(), frame.size());
+}
+
+// 요청 하나를 처리하고 텍스트 응답(마지막 줄)을 해석 (앞의 줄은 핸들러 로그)
+static bool takeText(JsonDocument &doc, size_t *wireBytes = nullptr)
+{
+    if (!serviceCmd())
+    {
+        return false;
+    }
+    String out = nativeSerialTakeOutput();
+    out.trim();
+    String line = out.substring(out.lastIndexOf('\n') + 1);
+    if (wireBytes)
+    {
+        *wireBytes = line.length() + 2;   // CRLF
+    }
+    return deserializeJson(doc, line) == DeserializationError::Ok;
+}
+
+// 요청 하나를 처리하고 출력 끝의 응답 프레임을 검사/해석
+static bool takeFrame(JsonDocument &doc, size_t *wireBytes = nullptr)
+{
+    if (!serviceCmd())
+    {
+        return false;
+    }
+    String out = nativeSerialTakeOutput();
+    const uint8_t *p = (const uint8_t *)out.c_str();
+    size_t size = out.length();
+    for (size_t i = 0; i + 5 <= size; i++)
+    {
+        size_t len = p[i + 1] | ((size_t)p[i + 2] << 8);
+        if (p[i] != SerialCmdReader::FRAME_START || i + len + 5 != size)
+        {
+            continue;
+        }
+        if (wireBytes)
+        {
+            *wireBytes = len + 5;
+        }
+        const uint8_t *payload = p + i + 3;
+        uint16_t crc = payload[len] | ((uint16_t)payload[len + 1] << 8);
+        if (crc != crc16(payload, len))
+        {
+            return false;
+        }
+        return deserializeMsgPack(doc, (const char *)payload, len) == DeserializationError::Ok;
+    }
+    return false;
+}
+
+static bool contains(const char *const *list, size_t count, const String &name)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (name == list[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 바뀌는 값을 null 로 바꾼다 (키 구성은 그대로 비교)
+static void maskVolatile(JsonVariant value)
+{
+    if (value.is<JsonObject>())
+    {
+        for (JsonPair pair : value.as<JsonObject>())
+        {
+            if (contains(VOLATILE_KEYS, CMD_COUNT(VOLATILE_KEYS), pair.key().c_str()))
+            {
+                pair.value().set(nullptr);
+            }
+            else
+            {
+                maskVolatile(pair.value());
+            }
+        }
+    }
+    else if (value.is<JsonArray>())
+    {
+        for (JsonVariant item : value.as<JsonArray>())
+        {
+            maskVolatile(item);
+        }
+    }
+}
+
+// 보낼 명령 목록: 상태를 바꾸지 않는 최상위 명령과, 모듈 usage() 에서 인자가 없거나
+// 선택 인자([...])뿐인 서브 커맨드 중 상태를 바꾸지 않는 것
+static std::vector<String> commandNames()
+{
+    sendText("help");
+    JsonDocument help;
+    TEST_ASSERT_TRUE(takeText(help));
+
+    std::vector<String> names;
+    String list = help["commands"].as<String>();
+    int start = 0;
+    while (start < (int)list.length())
+    {
+        int comma = list.indexOf(',', start);
+        if (comma < 0)
+        {
+            comma = list.length();
+        }
+        String name = list.substring(start, comma);
+        start = comma + 1;
+        if (contains(SIDE_EFFECT_COMMANDS, CMD_COUNT(SIDE_EFFECT_COMMANDS), name))
+        {
+            continue;
+        }
+
+        // 서브 커맨드가 필요한 모듈 명령인지 (그 응답도 두 인코딩으로 비교)
+        names.push_back(name);
+        sendText(name);
+        JsonDocument bare;
+        TEST_ASSERT_TRUE_MESSAGE(takeText(bare), name.c_str());
+        if (!bare["ms"].as<String>().startsWith("need sub command"))
+        {
+            continue;
+        }
+
+        String usage = help[name].as<String>();
+        int pos = 0;
+        while (pos < (int)usage.length())
+        {
+            int end = usage.indexOf(", ", pos);
+            if (end < 0)
+            {
+                end = usage.length();
+            }
+            String entry = usage.substring(pos, end);
+            pos = end + 2;
+
+            int space = entry.indexOf(' ');
+            String sub = space < 0 ? entry : entry.substring(0, space);
+            bool requiredArgs = space >= 0 && entry.charAt(space + 1) != '[';
+            if (!requiredArgs && !contains(SIDE_EFFECT_COMMANDS, CMD_COUNT(SIDE_EFFECT_COMMANDS), sub))
+            {
+                names.push_back(name + " " + sub);
+            }
+        }
+    }
+    return names;
+}
+
+void setUp()
+{
+    nativeSerialCapture(true);
+}
+
+void tearDown()
+{
+    // 다음 시험은 텍스트 모드에서 시작
+    g_cmdReader.setMode(SerialCmdReader::MODE_TEXT);
+    nativeSerialCapture(false);
+}
+
+static void test_every_command_matches_in_text_and_binary()
+{
+    std::vector<String> names = commandNames();
+    const char *const expected[] = { "camera status", "server status", "config dump", "pipeline status",
+                                     "wifi status", "spool status", "dedup status", "stats latency" };
+    for (const char *name : expected)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(std::find(names.begin(), names.end(), String(name)) != names.end(), name);
+    }
+
+    // 명령마다 텍스트 → 바이너리로 바로 이어 보내 그 사이에 상태가 바뀌지 않게 한다
+    for (const String &name : names)
+    {
+        JsonDocument text;
+        size_t textBytes = 0;
+        sendText(name);
+        TEST_ASSERT_TRUE_MESSAGE(takeText(text, &textBytes), name.c_str());
+
+        JsonDocument ack;
+        sendText("proto bin");
+        TEST_ASSERT_TRUE(takeText(ack));
+
+        JsonDocument binary;
+        size_t binaryBytes = 0;
+        sendFrame(name);
+        TEST_ASSERT_TRUE_MESSAGE(takeFrame(binary, &binaryBytes), name.c_str());
+
+        sendFrame("proto text");
+        TEST_ASSERT_TRUE(takeFrame(ack));
+
+        // 같은 응답을 더 적은 바이트로
+        TEST_ASSERT_LESS_THAN_MESSAGE(textBytes, binaryBytes, name.c_str());
+
+        if (name == "proto")
+        {
+            // 모드만 다르고 나머지는 같음
+            TEST_ASSERT_EQUAL_STRING("text", text["proto"].as<String>().c_str());
+            TEST_ASSERT_EQUAL_STRING("bin", binary["proto"].as<String>().c_str());
+        }
+        maskVolatile(text.as<JsonVariant>());
+        maskVolatile(binary.as<JsonVariant>());
+
+        String textJson, binaryJson;
+        serializeJson(text, textJson);
+        serializeJson(binary, binaryJson);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(textJson.c_str(), binaryJson.c_str(), name.c_str());
+    }
+}
+
+static void test_request_after_ack_uses_new_mode()
+{
+    // 텍스트로 전환 요청 → 텍스트 응답, 바로 다음 프레임은 바이너리로 처리
+    sendText("proto bin");
+    JsonDocument doc;
+    TEST_ASSERT_TRUE(takeText(doc));
+    TEST_ASSERT_EQUAL_STRING("bin", doc["proto"].as<String>().c_str());
+
+    sendFrame("proto");
+    TEST_ASSERT_TRUE(takeFrame(doc));
+    TEST_ASSERT_EQUAL_STRING("bin", doc["proto"].as<String>().c_str());
+
+    // 프레임으로 되돌리기 → 프레임 응답, 다음 줄은 텍스트
+    sendFrame("proto text");
+    TEST_ASSERT_TRUE(takeFrame(doc));
+    TEST_ASSERT_EQUAL_STRING("text", doc["proto"].as<String>().c_str());
+
+    sendText("proto");
+    TEST_ASSERT_TRUE(takeText(doc));
+    TEST_ASSERT_EQUAL_STRING("text", doc["proto"].as<String>().c_str());
+}
+
+static void test_switch_applies_before_ack_is_written()
+{
+    // 핸들러가 모드를 바꾼 직후 (응답/complete() 전) 도착한 프레임도 바이너리로 받는다
+    g_cmdReader.setMode(SerialCmdReader::MODE_BINARY);
+    sendFrame("proto");
+
+    JsonDocument doc;
+    TEST_ASSERT_TRUE(takeFrame(doc));
+    TEST_ASSERT_EQUAL_STRING("bin", doc["proto"].as<String>().c_str());
+}
+
+static void test_partial_line_finishes_in_old_mode()
+{
+    // 줄 중간에 전환 요청이 와도 그 줄은 텍스트로 끝나고, 다음 요청부터 바이너리
+    nativeSerialInput((const uint8_t *)"pro", 3);
+    g_cmdReader.setMode(SerialCmdReader::MODE_BINARY);
+    nativeSerialInput((const uint8_t *)"to\n", 3);
+
+    JsonDocument doc;
+    TEST_ASSERT_TRUE(takeText(doc));
+    TEST_ASSERT_EQUAL_STRING("ok", doc["result"].as<String>().c_str());
+
+    sendFrame("proto");
+    TEST_ASSERT_TRUE(takeFrame(doc));
+    TEST_ASSERT_EQUAL_STRING("bin", doc["proto"].as<String>().c_str());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    if (!g_cmdReader.begin())
+    {
+        TEST_MESSAGE("serial reader setup failed");
+        return UNITY_END() + 1;
+    }
+    RUN_TEST(test_every_command_matches_in_text_and_binary);
+    RUN_TEST(test_request_after_ack_uses_new_mode);
+    RUN_TEST(test_switch_applies_before_ack_is_written);
+    RUN_TEST(test_partial_line_finishes_in_old_mode);
+    return UNITY_END();
+}
@@ -0,0 +1,275 @@
+// MJPEG 스트림 서버 시험 (호스트)
+// 요청을 보내지 않는 접속이 다른 클라이언트를 막지 않는지, 파이프라인 몫의 드라이버 버퍼를
+// 남기는지, stop() 직후 start() 가 새 태스크로 바로 시작하는지,
+// 클라이언트가 붙고 떨어지는 동안 다른 스레드의 stream status 가 게시된 상태를 일관되게 읽는지 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "camera_module.hpp"
+#include "stream_server.hpp"
+#include "native_host.hpp"
+
+extern CameraModule g_camera;
+extern StreamServer g_stream;
+
+static uint16_t s_port = 0;
+
+static int connectClient(int rcvBuf = 0)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvBuf > 0)
+    {
+        // 읽지 않는 느린 클라이언트 흉내 (수신 창을 작게)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(s_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; i++)
+    {
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        {
+            return fd;
+        }
+        delay(10);
+    }
+    close(fd);
+    return -1;
+}
+
+static void sendRequest(int fd, const char *path)
+{
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: test\r\n\r\n";
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+}
+
+// 응답에서 marker 를 count 번 볼 때까지 읽음 (받은 바이트 수, 시간 초과면 -1)
+static long readUntil(int fd, const char *marker, int count, uint32_t timeoutMs)
+{
+    std::string data;
+    uint32_t start = millis();
+    char buffer[4096];
+    while (millis() - start < timeoutMs)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 10) <= 0)
+        {
+            continue;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+        {
+            return -1;
+        }
+        data.append(buffer, n);
+
+        int seen = 0;
+        for (size_t pos = data.find(marker); pos != std::string::npos; pos = data.find(marker, pos + 1))
+        {
+            seen++;
+        }
+        if (seen >= count)
+        {
+            return (long)data.size();
+        }
+    }
+    return -1;
+}
+
+static void status(JsonDocument &res)
+{
+    tonkey tokens;
+    tokens.parse("stream status", 13);
+    res.clear();
+    g_stream.parseCmd(tokens, res);
+}
+
+// 스트림 태스크가 게시할 때까지 기다림
+static bool waitClientCount(int expected, uint32_t timeoutMs)
+{
+    uint32_t start = millis();
+    while (g_stream.getClientCount() != expected)
+    {
+        if (millis() - start > timeoutMs)
+        {
+            return false;
+        }
+        delay(5);
+    }
+    return true;
+}
+
+void setUp()
+{
+    TEST_ASSERT_TRUE(g_stream.start(s_port));
+}
+
+void tearDown()
+{
+    g_stream.stop();
+}
+
+static void test_silent_connection_does_not_block_viewer()
+{
+    // 접속만 하고 요청 라인을 보내지 않는 클라이언트
+    int idle = connectClient();
+    TEST_ASSERT_TRUE(idle >= 0);
+    delay(50);
+
+    int viewer = connectClient();
+    TEST_ASSERT_TRUE(viewer >= 0);
+    uint32_t start = millis();
+    sendRequest(viewer, "/stream");
+
+    // 요청 라인 대기(REQUEST_TIMEOUT_MS)를 기다리지 않고 프레임이 와야 한다
+    TEST_ASSERT_TRUE(readUntil(viewer, "--frame", 2, 3000) > 0);
+    TEST_ASSERT_TRUE(millis() - start < StreamServer::REQUEST_TIMEOUT_MS / 2);
+
+    close(idle);
+    close(viewer);
+}
+
+static void test_viewers_leave_buffer_for_pipeline()
+{
+    // 멈춘 클라이언트가 프레임 하나를 잡고 있는 동안 빠른 클라이언트가 새 프레임을 원하는 상황
+    int slow = connectClient(4096);
+    TEST_ASSERT_TRUE(slow >= 0);
+    sendRequest(slow, "/stream");
+
+    int fast = connectClient();
+    TEST_ASSERT_TRUE(fast >= 0);
+    sendRequest(fast, "/stream");
+    TEST_ASSERT_TRUE(readUntil(fast, "--frame", 1, 3000) > 0);
+
+    std::atomic<bool> stop(false);
+    std::thread reader([&]() {
+        char buffer[8192];
+        while (!stop.load())
+        {
+            struct pollfd pfd = { fast, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) > 0 && recv(fast, buffer, sizeof(buffer), 0) <= 0)
+            {
+                break;
+            }
+        }
+    });
+
+    // 스트림이 계속 프레임을 잡는 동안에도 파이프라인 캡처용 버퍼는 비어 있다
+    int minFree = g_camera.getFrameBufferCount();
+    for (int i = 0; i < 300; i++)
+    {
+        minFree = std::min(minFree, g_camera.getFreeFrameBuffers());
+        delay(3);
+    }
+    stop.store(true);
+    reader.join();
+
+    TEST_ASSERT_GREATER_OR_EQUAL(1, minFree);
+    close(slow);
+    close(fast);
+}
+
+static void test_restart_right_after_stop()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        g_stream.stop();
+        TEST_ASSERT_FALSE(g_stream.isRunning());
+        TEST_ASSERT_EQUAL_INT(0, g_stream.getClientCount());
+        // stop() 은 태스크가 끝난 뒤 반환하므로 바로 다시 시작할 수 있다
+        TEST_ASSERT_TRUE(g_stream.start(s_port));
+    }
+
+    int viewer = connectClient();
+    TEST_ASSERT_TRUE(viewer >= 0);
+    sendRequest(viewer, "/stream?fps=50");
+    TEST_ASSERT_TRUE(readUntil(viewer, "--frame", 2, 3000) > 0);
+    close(viewer);
+
+    // 모든 프레임을 돌려받음
+    g_stream.stop();
+    TEST_ASSERT_EQUAL_INT(g_camera.getFrameBufferCount(), g_camera.getFreeFrameBuffers());
+    TEST_ASSERT_TRUE(g_stream.start(s_port));
+}
+
+static void test_status_while_clients_come_and_go()
+{
+    JsonDocument res;
+    status(res);
+    uint32_t served = res["served"].as<uint32_t>();
+
+    // 커맨드 태스크 흉내: 스트림 태스크가 표를 바꾸는 동안 계속 status 를 읽음
+    std::atomic<bool> stop(false);
+    std::atomic<int> polls(0);
+    std::atomic<int> bad(0);
+    std::thread poller([&]() {
+        JsonDocument local;
+        while (!stop.load())
+        {
+            tonkey tokens;
+            tokens.parse("stream status", 13);
+            local.clear();
+            g_stream.parseCmd(tokens, local);
+            for (JsonVariant client : local["clients"].as<JsonArray>())
+            {
+                if (client["ip"].as<String>() != "127.0.0.1")
+                {
+                    bad++;
+                }
+            }
+            polls++;
+        }
+    });
+
+    for (int round = 0; round < 3; round++)
+    {
+        int viewer = connectClient();
+        TEST_ASSERT_TRUE(viewer >= 0);
+        sendRequest(viewer, "/stream?fps=50");
+        TEST_ASSERT_TRUE(readUntil(viewer, "--frame", 2, 3000) > 0);
+        TEST_ASSERT_TRUE(waitClientCount(1, 1000));
+        close(viewer);
+        // 닫힌 소켓으로 보내다 실패하면 떨어짐
+        TEST_ASSERT_TRUE(waitClientCount(0, 3000));
+    }
+
+    stop.store(true);
+    poller.join();
+    TEST_ASSERT_GREATER_THAN(0, polls.load());
+    TEST_ASSERT_EQUAL_INT(0, bad.load());
+
+    status(res);
+    TEST_ASSERT_EQUAL_UINT32(served + 3, res["served"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_INT(0, res["clients"].size());
+}
+
+int main(int argc, char **argv)
+{
+    s_port = 20000 + getpid() % 20000;
+    // 닫힌 소켓에 send() 해도 lwIP 처럼 오류만 돌려받도록 (호스트 전용)
+    signal(SIGPIPE, SIG_IGN);
+
+    UNITY_BEGIN();
+    if (!nativeCameraReplay(nullptr, 0) || !g_camera.init())
+    {
+        TEST_MESSAGE("camera setup failed");
+        return UNITY_END() + 1;
+    }
+    RUN_TEST(test_silent_connection_does_not_block_viewer);
+    RUN_TEST(test_viewers_leave_buffer_for_pipeline);
+    RUN_TEST(test_restart_right_after_stop);
+    RUN_TEST(test_status_while_clients_come_and_go);
+    return UNITY_END();
+}
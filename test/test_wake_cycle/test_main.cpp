@@ -0,0 +1,127 @@
+// deep sleep 주기 시험 (호스트, 가상 시간)
+// 카메라가 링크보다 먼저 준비되면 캡처 후 WAIT_LINK 에서 링크를 기다려 업로드하는지,
+// 링크가 끝내 없으면 budget 뒤 ACTION_SPOOL, 그다음 ACTION_SLEEP 을 내는지,
+// 카메라가 실패하면 바로 잠드는지, 업로드 실패가 스풀 보관으로 이어지는지,
+// 깨어 있던 시간이 주기를 넘으면 sleepMs() 가 MIN_SLEEP_MS 로 제한되는지 확인한다.
+
+#include <unity.h>
+
+#include "wake_cycle.hpp"
+
+static const uint32_t WAKE_MS = 500;        // 부트로더 이후 깨어난 시각
+static const uint32_t INTERVAL_MS = 60000;
+static const uint32_t BUDGET_MS = 15000;
+
+static WakeCycle s_cycle;
+
+void setUp()
+{
+    s_cycle.begin(WAKE_MS, INTERVAL_MS, BUDGET_MS);
+}
+
+void tearDown()
+{
+}
+
+static void test_capture_before_link_then_upload()
+{
+    // 링크 없이 카메라 준비 → 캡처
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + 100, false, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_CAPTURE, s_cycle.step(WAKE_MS + 300, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_CAPTURE, s_cycle.getState());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + 310, true, false, false));
+    s_cycle.onCaptured(WAKE_MS + 350, true);
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_WAIT_LINK, s_cycle.getState());
+
+    // 링크를 기다리는 동안은 아무것도 하지 않음
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + 1000, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_WAIT_LINK, s_cycle.getState());
+
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_UPLOAD, s_cycle.step(WAKE_MS + 1200, true, false, true));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_UPLOAD, s_cycle.getState());
+    s_cycle.onUploaded(WAKE_MS + 1500, true);
+    TEST_ASSERT_TRUE(s_cycle.isUploaded());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + 1510, true, false, true));
+
+    // 타임라인은 깨어난 뒤 처음 도달한 시각
+    TEST_ASSERT_EQUAL_UINT32(300, s_cycle.getMark(WakeCycle::MARK_CAMERA));
+    TEST_ASSERT_EQUAL_UINT32(350, s_cycle.getMark(WakeCycle::MARK_CAPTURE));
+    TEST_ASSERT_EQUAL_UINT32(1200, s_cycle.getMark(WakeCycle::MARK_LINK));
+    TEST_ASSERT_EQUAL_UINT32(1500, s_cycle.getMark(WakeCycle::MARK_UPLOAD));
+    TEST_ASSERT_EQUAL_UINT32(1510, s_cycle.getMark(WakeCycle::MARK_SLEEP));
+    TEST_ASSERT_EQUAL_UINT32(INTERVAL_MS - 1510, s_cycle.sleepMs(WAKE_MS + 1510));
+}
+
+static void test_no_link_spools_after_budget_then_sleeps()
+{
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_CAPTURE, s_cycle.step(WAKE_MS + 200, true, false, false));
+    s_cycle.onCaptured(WAKE_MS + 250, true);
+
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + BUDGET_MS - 1, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_WAIT_LINK, s_cycle.getState());
+
+    // budget 에서 포기하고 다음 step 에 스풀, 그다음 잠듦 (스풀은 한 번만)
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + BUDGET_MS, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_DONE, s_cycle.getState());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SPOOL, s_cycle.step(WAKE_MS + BUDGET_MS + 10, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + BUDGET_MS + 20, true, false, false));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + BUDGET_MS + 30, true, false, false));
+
+    TEST_ASSERT_FALSE(s_cycle.isUploaded());
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::NOT_REACHED, s_cycle.getMark(WakeCycle::MARK_LINK));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::NOT_REACHED, s_cycle.getMark(WakeCycle::MARK_UPLOAD));
+    TEST_ASSERT_EQUAL_UINT32(BUDGET_MS + 20, s_cycle.getMark(WakeCycle::MARK_SLEEP));
+}
+
+static void test_camera_failure_sleeps()
+{
+    // 초기화 실패: 캡처 없이 잠듦
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_NONE, s_cycle.step(WAKE_MS + 400, false, true, true));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_DONE, s_cycle.getState());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + 410, false, true, true));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::NOT_REACHED, s_cycle.getMark(WakeCycle::MARK_CAPTURE));
+
+    // 캡처 실패: 보낼 것이 없으니 스풀도 하지 않음
+    s_cycle.begin(WAKE_MS, INTERVAL_MS, BUDGET_MS);
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_CAPTURE, s_cycle.step(WAKE_MS + 200, true, false, true));
+    s_cycle.onCaptured(WAKE_MS + 250, false);
+    TEST_ASSERT_EQUAL_INT(WakeCycle::STATE_DONE, s_cycle.getState());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + 260, true, false, true));
+}
+
+static void test_upload_failure_spools()
+{
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_CAPTURE, s_cycle.step(WAKE_MS + 200, true, false, true));
+    s_cycle.onCaptured(WAKE_MS + 250, true);
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_UPLOAD, s_cycle.step(WAKE_MS + 260, true, false, true));
+    s_cycle.onUploaded(WAKE_MS + 3000, false);
+
+    TEST_ASSERT_FALSE(s_cycle.isUploaded());
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SPOOL, s_cycle.step(WAKE_MS + 3010, true, false, true));
+    TEST_ASSERT_EQUAL_INT(WakeCycle::ACTION_SLEEP, s_cycle.step(WAKE_MS + 3020, true, false, true));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::NOT_REACHED, s_cycle.getMark(WakeCycle::MARK_UPLOAD));
+}
+
+static void test_sleep_clamps_to_minimum()
+{
+    // 깨어 있던 시간이 주기에 가깝거나 넘으면 최소 시간만 잔다
+    TEST_ASSERT_EQUAL_UINT32(INTERVAL_MS - 5000, s_cycle.sleepMs(WAKE_MS + 5000));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::MIN_SLEEP_MS, s_cycle.sleepMs(WAKE_MS + INTERVAL_MS - WakeCycle::MIN_SLEEP_MS));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::MIN_SLEEP_MS, s_cycle.sleepMs(WAKE_MS + INTERVAL_MS));
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::MIN_SLEEP_MS, s_cycle.sleepMs(WAKE_MS + INTERVAL_MS * 3));
+
+    // budget 이 주기보다 긴 설정
+    s_cycle.begin(WAKE_MS, 10000, BUDGET_MS);
+    TEST_ASSERT_EQUAL_UINT32(WakeCycle::MIN_SLEEP_MS, s_cycle.sleepMs(WAKE_MS + BUDGET_MS));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_before_link_then_upload);
+    RUN_TEST(test_no_link_spools_after_budget_then_sleeps);
+    RUN_TEST(test_camera_failure_sleeps);
+    RUN_TEST(test_upload_failure_spools);
+    RUN_TEST(test_sleep_clamps_to_minimum);
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+// WiFi 접속 상태 머신 시험 (호스트)
+// nativeWifiEvent() 로 STA 이벤트를 넣고 tick() 을 돌려 connect() 가 기다리지 않고 반환하는지,
+// 링크가 끊기면 다시 접속하는지 (disconnect() 뒤에는 하지 않는지),
+// 실패가 이어지면 백오프가 1 s 에서 60 s 까지 늘어나고 지터 범위를 지키는지 확인한다.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFi.h>
+
+#include "wifi_module.hpp"
+#include "native_host.hpp"
+
+// 이벤트 콜백이 this 를 잡으므로 시험 전체에서 하나만 쓴다
+static WifiModule s_wifi;
+
+static void status(JsonDocument &res)
+{
+    tonkey tokens;
+    tokens.parse("wifi status", 11);
+    res.clear();
+    s_wifi.parseCmd(tokens, res);
+}
+
+static void joinNow()
+{
+    nativeWifiEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    nativeWifiEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    s_wifi.tick();
+}
+
+void setUp()
+{
+    s_wifi.disconnect();
+    tonkey tokens;
+    tokens.parse("wifi forget", 11);
+    JsonDocument res;
+    s_wifi.parseCmd(tokens, res);
+
+    s_wifi.setSSID("home");
+    s_wifi.setPassword("secret");
+    s_wifi.setFastJoin(true);
+    s_wifi.setConnectTimeout(10000);
+}
+
+void tearDown()
+{
+    s_wifi.disconnect();
+}
+
+static void test_connect_returns_immediately()
+{
+    uint32_t begins = nativeWifiBeginCount();
+    unsigned long startUs = micros();
+    TEST_ASSERT_TRUE(s_wifi.connect());
+    unsigned long elapsedUs = micros() - startUs;
+
+    // 접속을 시작만 하고 연결을 기다리지 않는다
+    TEST_ASSERT_TRUE(elapsedUs < WifiModule::TICK_MS * 1000);
+    TEST_ASSERT_EQUAL_UINT32(begins + 1, nativeWifiBeginCount());
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_SCAN_JOIN, s_wifi.getState());
+    TEST_ASSERT_FALSE(s_wifi.isConnected());
+
+    // 접속 중 다시 부르면 새로 시작하지 않음
+    TEST_ASSERT_TRUE(s_wifi.connect());
+    s_wifi.tick();
+    TEST_ASSERT_EQUAL_UINT32(begins + 1, nativeWifiBeginCount());
+    TEST_ASSERT_TRUE(s_wifi.isConnecting());
+
+    joinNow();
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_CONNECTED, s_wifi.getState());
+    TEST_ASSERT_TRUE(s_wifi.isConnected());
+    TEST_ASSERT_EQUAL_STRING("scan", s_wifi.getLastJoin().method);
+}
+
+static void test_disconnect_triggers_reconnect()
+{
+    TEST_ASSERT_TRUE(s_wifi.connect());
+    joinNow();
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_CONNECTED, s_wifi.getState());
+
+    // AP 가 끊음 → 다음 tick 에서 캐시한 채널로 바로 다시 접속
+    uint32_t begins = nativeWifiBeginCount();
+    nativeWifiEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 8);
+    s_wifi.tick();
+    TEST_ASSERT_EQUAL_UINT32(begins + 1, nativeWifiBeginCount());
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_FAST_JOIN, s_wifi.getState());
+    TEST_ASSERT_TRUE(nativeWifiLastChannel() > 0);
+
+    joinNow();
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_CONNECTED, s_wifi.getState());
+    TEST_ASSERT_EQUAL_STRING("fast", s_wifi.getLastJoin().method);
+
+    JsonDocument res;
+    status(res);
+    TEST_ASSERT_EQUAL_UINT32(1, res["join"]["link_lost"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_UINT32(8, res["join"]["disconnect_reason"].as<uint32_t>());
+
+    // 스스로 끊은 뒤에는 링크가 끊겨도 다시 붙지 않는다
+    s_wifi.disconnect();
+    begins = nativeWifiBeginCount();
+    nativeWifiEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 8);
+    s_wifi.tick();
+    TEST_ASSERT_EQUAL_UINT32(begins, nativeWifiBeginCount());
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_IDLE, s_wifi.getState());
+}
+
+static void test_backoff_grows_within_jitter_bounds()
+{
+    const uint32_t timeoutMs = 1000;
+    s_wifi.setFastJoin(false);
+    s_wifi.setConnectTimeout(timeoutMs);
+    TEST_ASSERT_TRUE(s_wifi.connect());
+
+    JsonDocument res;
+    for (int attempt = 0; attempt < 10; attempt++)
+    {
+        // AP 가 응답하지 않아 접속 시간 초과
+        TEST_ASSERT_TRUE(s_wifi.isConnecting());
+        nativeTimeAdvance(timeoutMs + 1);
+        s_wifi.tick();
+        TEST_ASSERT_EQUAL_INT(WifiModule::STATE_BACKOFF, s_wifi.getState());
+
+        // 1 s, 2 s, 4 s ... 60 s 에 ±50% 지터
+        uint32_t base = WifiModule::BACKOFF_MIN_MS << (attempt < 6 ? attempt : 6);
+        if (base > WifiModule::BACKOFF_MAX_MS)
+        {
+            base = WifiModule::BACKOFF_MAX_MS;
+        }
+        status(res);
+        uint32_t backoffMs = res["backoff_ms"].as<uint32_t>();
+        TEST_ASSERT_EQUAL_INT(attempt + 1, res["attempt"].as<int>());
+        TEST_ASSERT_GREATER_OR_EQUAL(base / 2, backoffMs);
+        TEST_ASSERT_LESS_OR_EQUAL(base + base / 2, backoffMs);
+
+        // 대기 시간이 지나기 전에는 다시 시도하지 않음
+        uint32_t begins = nativeWifiBeginCount();
+        nativeTimeAdvance(backoffMs / 2);
+        s_wifi.tick();
+        TEST_ASSERT_EQUAL_UINT32(begins, nativeWifiBeginCount());
+        nativeTimeAdvance(backoffMs - backoffMs / 2);
+        s_wifi.tick();
+        TEST_ASSERT_EQUAL_UINT32(begins + 1, nativeWifiBeginCount());
+    }
+
+    // 접속에 성공하면 백오프는 처음부터
+    joinNow();
+    status(res);
+    TEST_ASSERT_EQUAL_INT(WifiModule::STATE_CONNECTED, s_wifi.getState());
+    TEST_ASSERT_EQUAL_INT(0, res["attempt"].as<int>());
+    TEST_ASSERT_EQUAL_UINT32(10, res["join"]["failed"].as<uint32_t>());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_connect_returns_immediately);
+    RUN_TEST(test_disconnect_triggers_reconnect);
+    RUN_TEST(test_backoff_grows_within_jitter_bounds);
+    return UNITY_END();
+}